@@ -147,6 +147,27 @@
  * }
  * ~~~~~~~~~~~~~~~~~~~~~~~~
  *
+ * Lock-free message queues
+ * ------------------------
+ * By default, all accesses to a message queue are serialized by disabling
+ * interrupts. When the `core_msg_mpsc` module is used, senders (threads and
+ * ISRs) instead reserve queue slots with an atomic compare-and-swap and publish
+ * messages without disabling interrupts. Interrupts are then only disabled to
+ * wake up a receiver blocked in @ref msg_receive() or when a queue is full. The
+ * receiving thread remains the only consumer of its queue. This reduces the
+ * time spent with interrupts disabled when many threads or ISRs feed a single
+ * thread.
+ *
+ * @note    With `core_msg_mpsc`, the sender PID is used to mark a queue slot as
+ *          occupied, so messages from a slot are only received once its sender
+ *          finished writing it.
+ *
+ * Bulk transfers
+ * --------------
+ * @ref msg_send_bulk() and @ref msg_receive_bulk() move several messages with
+ * a single call, so that the receiver is woken up only once and the queue is
+ * locked (or reserved) only once per batch.
+ *
  * Timing & messages
  * =================
  * Timing out the reception of a message or sending messages at a certain time
@@ -309,6 +330,39 @@ int msg_receive(msg_t *m);
  */
 int msg_try_receive(msg_t *m);
 
+/**
+ * @brief Send multiple messages (non-blocking).
+ *
+ * Delivers as many messages of @p m as possible in order to the message queue
+ * of thread @p target_pid. If the target is waiting in @ref msg_receive(),
+ * it is woken up only once. If the target has no message queue, at most a
+ * single message is delivered when the target is receive blocked. Can be
+ * called from an interrupt. This function will never block.
+ *
+ * @param[in] m             Array of @p num messages, must not be NULL if
+ *                          @p num > 0. msg_t::sender_pid is filled in.
+ * @param[in] num           Number of messages in @p m
+ * @param[in] target_pid    PID of target thread
+ *
+ * @return  number of messages delivered (0 if the queue was full)
+ * @return  -1, on error (invalid PID)
+ */
+int msg_send_bulk(msg_t *m, unsigned num, kernel_pid_t target_pid);
+
+/**
+ * @brief Receive multiple messages.
+ *
+ * Blocks until at least one message was received, then takes up to
+ * @p num - 1 additional messages from the message queue without blocking.
+ *
+ * @param[out] m    Array of @p num preallocated ``msg_t`` structures, must not
+ *                  be NULL.
+ * @param[in] num   Maximum number of messages to receive, must be > 0.
+ *
+ * @return  number of messages received (>= 1)
+ */
+int msg_receive_bulk(msg_t *m, unsigned num);
+
 /**
  * @brief Send a message, block until reply received.
  *
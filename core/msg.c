@@ -32,6 +32,9 @@
 #endif
 #include "irq.h"
 #include "cib.h"
+#ifdef MODULE_KTRACE
+#include "ktrace.h"
+#endif
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
@@ -39,32 +42,264 @@
 static int _msg_receive(msg_t *m, int block);
 static int _msg_send(msg_t *m, kernel_pid_t target_pid, bool block, unsigned state);
 
-static int queue_msg(thread_t *target, const msg_t *m)
+#ifdef MODULE_CORE_MSG_MPSC
+/*
+ * Lock-free multi-producer single-consumer variant of the message queue.
+ *
+ * Producers reserve slots by advancing msg_queue.write_count with a CAS and
+ * publish a message by storing its (never undefined) sender PID last. The
+ * receiving thread is the only consumer: it waits for the sender PID of the
+ * slot at msg_queue.read_count to become valid, copies the message, marks the
+ * slot empty again and only then advances msg_queue.read_count.
+ */
+static unsigned _queue_put(thread_t *target, const msg_t *m, unsigned num)
+{
+    cib_t *q = &target->msg_queue;
+    unsigned wc = __atomic_load_n(&q->write_count, __ATOMIC_RELAXED);
+    unsigned n;
+
+    do {
+        unsigned used = wc - __atomic_load_n(&q->read_count, __ATOMIC_ACQUIRE);
+        n = (q->mask + 1) - used;
+        if (n > num) {
+            n = num;
+        }
+        if (n == 0) {
+            return 0;
+        }
+    } while (!__atomic_compare_exchange_n(&q->write_count, &wc, wc + n, false,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+    for (unsigned i = 0; i < n; i++) {
+        msg_t *dest = &target->msg_array[(wc + i) & q->mask];
+        assert(m[i].sender_pid != KERNEL_PID_UNDEF);
+        dest->type = m[i].type;
+        dest->content = m[i].content;
+        __atomic_store_n(&dest->sender_pid, m[i].sender_pid, __ATOMIC_RELEASE);
+    }
+    return n;
+}
+
+static int _queue_get(thread_t *me, msg_t *m)
+{
+    cib_t *q = &me->msg_queue;
+    msg_t *src = &me->msg_array[q->read_count & q->mask];
+    kernel_pid_t sender_pid = __atomic_load_n(&src->sender_pid,
+                                              __ATOMIC_ACQUIRE);
+
+    /* slot is either empty or its producer was preempted while writing */
+    if (sender_pid == KERNEL_PID_UNDEF) {
+        return 0;
+    }
+    m->sender_pid = sender_pid;
+    m->type = src->type;
+    m->content = src->content;
+    __atomic_store_n(&src->sender_pid, KERNEL_PID_UNDEF, __ATOMIC_RELAXED);
+    __atomic_store_n(&q->read_count, q->read_count + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+static int _queue_ready(const thread_t *me)
+{
+    const cib_t *q = &me->msg_queue;
+    return __atomic_load_n(&me->msg_array[q->read_count & q->mask].sender_pid,
+                           __ATOMIC_ACQUIRE) != KERNEL_PID_UNDEF;
+}
+
+/* A receive blocked thread with a lock-free queue collects its messages from
+ * the queue itself, so they must never be copied to thread_t::wait_data. */
+static inline int _direct_copy(const thread_t *target)
+{
+    return !thread_has_msg_queue(target);
+}
+#else
+static unsigned _queue_put(thread_t *target, const msg_t *m, unsigned num)
 {
-    int n = cib_put(&(target->msg_queue));
-    if (n < 0) {
+    unsigned n;
+
+    for (n = 0; n < num; n++) {
+        int idx = cib_put(&(target->msg_queue));
+        if (idx < 0) {
+            break;
+        }
+        target->msg_array[idx] = m[n];
+    }
+    return n;
+}
+
+static inline int _direct_copy(const thread_t *target)
+{
+    (void)target;
+    return 1;
+}
+#endif /* MODULE_CORE_MSG_MPSC */
+
+static unsigned queue_msgs(thread_t *target, const msg_t *m, unsigned num)
+{
+    unsigned n = _queue_put(target, m, num);
+    if (n == 0) {
         DEBUG("queue_msg(): message queue is full (or there is none)\n");
         return 0;
     }
 
-    DEBUG("queue_msg(): queuing message\n");
-    msg_t *dest = &target->msg_array[n];
-    *dest = *m;
+    DEBUG("queue_msg(): queued %u message(s)\n", n);
 #if MODULE_CORE_THREAD_FLAGS
+    unsigned state = irq_disable();
     target->flags |= THREAD_FLAG_MSG_WAITING;
     thread_flags_wake(target);
+    irq_restore(state);
 #endif
+    return n;
+}
+
+static int queue_msg(thread_t *target, const msg_t *m)
+{
+    return queue_msgs(target, m, 1);
+}
+
+/**
+ * @brief   Moves messages of send blocked threads into free queue space
+ *
+ * Must be called with interrupts disabled.
+ *
+ * @return  priority of the highest priority thread that was unblocked
+ */
+static uint16_t _queue_waiters(thread_t *me)
+{
+    uint16_t prio = THREAD_PRIORITY_IDLE;
+    list_node_t *next;
+
+    while ((next = me->msg_waiters.next) != NULL) {
+        thread_t *sender = container_of((clist_node_t*)next, thread_t, rq_entry);
+
+        if (_queue_put(me, (msg_t*) sender->wait_data, 1) == 0) {
+            break;
+        }
+        list_remove_head(&me->msg_waiters);
+        if (sender->status != STATUS_REPLY_BLOCKED) {
+            sender->wait_data = NULL;
+            sched_set_status(sender, STATUS_PENDING);
+            if (sender->priority < prio) {
+                prio = sender->priority;
+            }
+        }
+    }
+    return prio;
+}
+
+#ifdef MODULE_CORE_MSG_MPSC
+static void _wake_receiver(thread_t *target)
+{
+    if (target->status != STATUS_RECEIVE_BLOCKED) {
+        return;
+    }
+
+    unsigned state = irq_disable();
+    int wake = (target->status == STATUS_RECEIVE_BLOCKED);
+    if (wake) {
+        sched_set_status(target, STATUS_PENDING);
+    }
+    irq_restore(state);
+
+    if (wake) {
+        if (irq_is_in()) {
+            sched_context_switch_request = 1;
+        }
+        else {
+            thread_yield_higher();
+        }
+    }
+}
+
+static int _mpsc_send(msg_t *m, kernel_pid_t target_pid)
+{
+    thread_t *target = (thread_t *) sched_threads[target_pid];
+
+    if ((target == NULL) || !thread_has_msg_queue(target)) {
+        return 0;
+    }
+
+    m->sender_pid = irq_is_in() ? KERNEL_PID_ISR : sched_active_pid;
+    if (!queue_msg(target, m)) {
+        return 0;
+    }
+    _wake_receiver(target);
     return 1;
 }
 
+static int _mpsc_receive(thread_t *me, msg_t *m, int block)
+{
+    while (1) {
+        if (_queue_get(me, m)) {
+            if (me->msg_waiters.next) {
+                unsigned state = irq_disable();
+                uint16_t prio = _queue_waiters(me);
+                irq_restore(state);
+                if (prio < THREAD_PRIORITY_IDLE) {
+                    sched_switch(prio);
+                }
+            }
+            return 1;
+        }
+
+        unsigned state = irq_disable();
+        list_node_t *next = list_remove_head(&me->msg_waiters);
+
+        if (next != NULL) {
+            /* the queue only ran empty because its producers are blocked */
+            thread_t *sender = container_of((clist_node_t*)next, thread_t,
+                                            rq_entry);
+            *m = *((msg_t*) sender->wait_data);
+
+            uint16_t sender_prio = THREAD_PRIORITY_IDLE;
+            if (sender->status != STATUS_REPLY_BLOCKED) {
+                sender->wait_data = NULL;
+                sched_set_status(sender, STATUS_PENDING);
+                sender_prio = sender->priority;
+            }
+            irq_restore(state);
+            if (sender_prio < THREAD_PRIORITY_IDLE) {
+                sched_switch(sender_prio);
+            }
+            return 1;
+        }
+
+        if (_queue_ready(me)) {
+            /* a message was published after the check above */
+            irq_restore(state);
+            continue;
+        }
+
+        if (!block) {
+            irq_restore(state);
+            return -1;
+        }
+
+        DEBUG("_msg_receive(): %" PRIkernel_pid ": No msg in queue. Going blocked.\n",
+              sched_active_thread->pid);
+        sched_set_status(me, STATUS_RECEIVE_BLOCKED);
+        irq_restore(state);
+        thread_yield_higher();
+    }
+}
+#endif /* MODULE_CORE_MSG_MPSC */
+
 int msg_send(msg_t *m, kernel_pid_t target_pid)
 {
     if (irq_is_in()) {
         return msg_send_int(m, target_pid);
     }
+#ifdef MODULE_KTRACE
+    ktrace_record(KTRACE_EVENT_MSG_SEND, target_pid, m->type);
+#endif
     if (sched_active_pid == target_pid) {
         return msg_send_to_self(m);
     }
+#ifdef MODULE_CORE_MSG_MPSC
+    if (_mpsc_send(m, target_pid)) {
+        return 1;
+    }
+#endif
     return _msg_send(m, target_pid, true, irq_disable());
 }
 
@@ -73,9 +308,17 @@ int msg_try_send(msg_t *m, kernel_pid_t target_pid)
     if (irq_is_in()) {
         return msg_send_int(m, target_pid);
     }
+#ifdef MODULE_KTRACE
+    ktrace_record(KTRACE_EVENT_MSG_SEND, target_pid, m->type);
+#endif
     if (sched_active_pid == target_pid) {
         return msg_send_to_self(m);
     }
+#ifdef MODULE_CORE_MSG_MPSC
+    if (_mpsc_send(m, target_pid)) {
+        return 1;
+    }
+#endif
     return _msg_send(m, target_pid, false, irq_disable());
 }
 
@@ -104,7 +347,7 @@ static int _msg_send(msg_t *m, kernel_pid_t target_pid, bool block, unsigned sta
           __LINE__, sched_active_pid, target_pid,
           block, me->status, target->status);
 
-    if (target->status != STATUS_RECEIVE_BLOCKED) {
+    if ((target->status != STATUS_RECEIVE_BLOCKED) || !_direct_copy(target)) {
         DEBUG("msg_send() %s:%i: Target %" PRIkernel_pid " is not RECEIVE_BLOCKED.\n",
               RIOT_FILE_RELATIVE, __LINE__, target_pid);
 
@@ -112,8 +355,13 @@ static int _msg_send(msg_t *m, kernel_pid_t target_pid, bool block, unsigned sta
             DEBUG("msg_send() %s:%i: Target %" PRIkernel_pid
                   " has a msg_queue. Queueing message.\n", RIOT_FILE_RELATIVE,
                   __LINE__, target_pid);
+            int yield = (me->status == STATUS_REPLY_BLOCKED);
+            if (target->status == STATUS_RECEIVE_BLOCKED) {
+                sched_set_status(target, STATUS_PENDING);
+                yield = 1;
+            }
             irq_restore(state);
-            if (me->status == STATUS_REPLY_BLOCKED) {
+            if (yield) {
                 thread_yield_higher();
             }
             return 1;
@@ -190,6 +438,16 @@ int msg_send_int(msg_t *m, kernel_pid_t target_pid)
     }
 #endif /* DEVELHELP */
 
+#ifdef MODULE_KTRACE
+    ktrace_record(KTRACE_EVENT_MSG_SEND, target_pid, m->type);
+#endif
+
+#ifdef MODULE_CORE_MSG_MPSC
+    if (_mpsc_send(m, target_pid)) {
+        return 1;
+    }
+#endif
+
     thread_t *target = (thread_t *) sched_threads[target_pid];
 
     if (target == NULL) {
@@ -198,7 +456,7 @@ int msg_send_int(msg_t *m, kernel_pid_t target_pid)
     }
 
     m->sender_pid = KERNEL_PID_ISR;
-    if (target->status == STATUS_RECEIVE_BLOCKED) {
+    if ((target->status == STATUS_RECEIVE_BLOCKED) && _direct_copy(target)) {
         DEBUG("msg_send_int: Direct msg copy from %" PRIkernel_pid " to %"
               PRIkernel_pid ".\n", thread_getpid(), target_pid);
 
@@ -217,9 +475,70 @@ int msg_send_int(msg_t *m, kernel_pid_t target_pid)
     }
 }
 
+int msg_send_bulk(msg_t *m, unsigned num, kernel_pid_t target_pid)
+{
+#ifdef DEVELHELP
+    if (!pid_is_valid(target_pid)) {
+        DEBUG("msg_send_bulk(): target_pid is invalid, continuing anyways\n");
+    }
+#endif /* DEVELHELP */
+
+    thread_t *target = (thread_t *) sched_threads[target_pid];
+
+    if (target == NULL) {
+        DEBUG("msg_send_bulk(): target thread does not exist\n");
+        return -1;
+    }
+
+    kernel_pid_t sender_pid = irq_is_in() ? KERNEL_PID_ISR : sched_active_pid;
+    for (unsigned i = 0; i < num; i++) {
+        m[i].sender_pid = sender_pid;
+    }
+
+#ifdef MODULE_CORE_MSG_MPSC
+    if (thread_has_msg_queue(target)) {
+        unsigned n = queue_msgs(target, m, num);
+        if ((n > 0) && (target_pid != sched_active_pid)) {
+            _wake_receiver(target);
+        }
+        return n;
+    }
+#endif
+
+    unsigned state = irq_disable();
+    unsigned n = 0;
+    int wake = 0;
+
+    if ((num > 0) && (target->status == STATUS_RECEIVE_BLOCKED)) {
+        DEBUG("msg_send_bulk: Direct msg copy to %" PRIkernel_pid ".\n",
+              target_pid);
+        *((msg_t*) target->wait_data) = m[0];
+        sched_set_status(target, STATUS_PENDING);
+        wake = 1;
+        n = 1;
+    }
+    if (n < num) {
+        n += queue_msgs(target, &m[n], num - n);
+    }
+    irq_restore(state);
+
+    if (wake) {
+        if (irq_is_in()) {
+            sched_context_switch_request = 1;
+        }
+        else {
+            thread_yield_higher();
+        }
+    }
+    return n;
+}
+
 int msg_send_receive(msg_t *m, msg_t *reply, kernel_pid_t target_pid)
 {
     assert(sched_active_pid != target_pid);
+#ifdef MODULE_KTRACE
+    ktrace_record(KTRACE_EVENT_MSG_SEND, target_pid, m->type);
+#endif
     unsigned state = irq_disable();
     thread_t *me = (thread_t*) sched_threads[sched_active_pid];
     sched_set_status(me, STATUS_REPLY_BLOCKED);
@@ -278,16 +597,32 @@ int msg_reply_int(msg_t *m, msg_t *reply)
 
 int msg_try_receive(msg_t *m)
 {
-    return _msg_receive(m, 0);
+    int res = _msg_receive(m, 0);
+#ifdef MODULE_KTRACE
+    if (res == 1) {
+        ktrace_record(KTRACE_EVENT_MSG_RECV, m->sender_pid, m->type);
+    }
+#endif
+    return res;
 }
 
 int msg_receive(msg_t *m)
 {
-    return _msg_receive(m, 1);
+    int res = _msg_receive(m, 1);
+#ifdef MODULE_KTRACE
+    ktrace_record(KTRACE_EVENT_MSG_RECV, m->sender_pid, m->type);
+#endif
+    return res;
 }
 
 static int _msg_receive(msg_t *m, int block)
 {
+#ifdef MODULE_CORE_MSG_MPSC
+    if (thread_has_msg_queue(sched_active_thread)) {
+        return _mpsc_receive((thread_t *) sched_active_thread, m, block);
+    }
+#endif
+
     unsigned state = irq_disable();
     DEBUG("_msg_receive: %" PRIkernel_pid ": _msg_receive.\n",
           sched_active_thread->pid);
@@ -373,6 +708,47 @@ static int _msg_receive(msg_t *m, int block)
     DEBUG("This should have never been reached!\n");
 }
 
+int msg_receive_bulk(msg_t *m, unsigned num)
+{
+    assert(num > 0);
+
+    _msg_receive(&m[0], 1);
+
+    thread_t *me = (thread_t*) sched_active_thread;
+    unsigned n = 1;
+
+    if (!thread_has_msg_queue(me)) {
+        return n;
+    }
+
+#ifdef MODULE_CORE_MSG_MPSC
+    while ((n < num) && _queue_get(me, &m[n])) {
+        n++;
+    }
+    if (!me->msg_waiters.next) {
+        return n;
+    }
+#endif
+
+    unsigned state = irq_disable();
+#ifndef MODULE_CORE_MSG_MPSC
+    while (n < num) {
+        int queue_index = cib_get(&(me->msg_queue));
+        if (queue_index < 0) {
+            break;
+        }
+        m[n++] = me->msg_array[queue_index];
+    }
+#endif
+    uint16_t prio = _queue_waiters(me);
+    irq_restore(state);
+
+    if (prio < THREAD_PRIORITY_IDLE) {
+        sched_switch(prio);
+    }
+    return n;
+}
+
 int msg_avail(void)
 {
     DEBUG("msg_available: %" PRIkernel_pid ": msg_available.\n",
@@ -394,6 +770,11 @@ void msg_init_queue(msg_t *array, int num)
     thread_t *me = (thread_t*) sched_active_thread;
     me->msg_array = array;
     cib_init(&(me->msg_queue), num);
+#ifdef MODULE_CORE_MSG_MPSC
+    for (int i = 0; i < num; i++) {
+        array[i].sender_pid = KERNEL_PID_UNDEF;
+    }
+#endif
 }
 
 void msg_queue_print(void)
@@ -29,6 +29,10 @@
 #include "irq.h"
 #include "list.h"
 
+#ifdef MODULE_KTRACE
+#include "ktrace.h"
+#endif
+
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
@@ -58,6 +62,9 @@ int _mutex_lock(mutex_t *mutex, int blocking)
         else {
             thread_add_to_list(&mutex->queue, me);
         }
+#ifdef MODULE_KTRACE
+        ktrace_record(KTRACE_EVENT_MUTEX_BLOCK, (uintptr_t)mutex, 0);
+#endif
         irq_restore(irqstate);
         thread_yield_higher();
         /* We were woken up by scheduler. Waker removed us from queue.
@@ -97,6 +104,9 @@ void mutex_unlock(mutex_t *mutex)
     DEBUG("mutex_unlock: waking up waiting thread %" PRIkernel_pid "\n",
           process->pid);
     sched_set_status(process, STATUS_PENDING);
+#ifdef MODULE_KTRACE
+    ktrace_record(KTRACE_EVENT_MUTEX_UNBLOCK, (uintptr_t)mutex, process->pid);
+#endif
 
     if (!mutex->queue.next) {
         mutex->queue.next = MUTEX_LOCKED;
@@ -123,6 +133,9 @@ void mutex_unlock_and_sleep(mutex_t *mutex)
                                              rq_entry);
             DEBUG("PID[%" PRIkernel_pid "]: waking up waiter.\n", process->pid);
             sched_set_status(process, STATUS_PENDING);
+#ifdef MODULE_KTRACE
+            ktrace_record(KTRACE_EVENT_MUTEX_UNBLOCK, (uintptr_t)mutex, process->pid);
+#endif
             if (!mutex->queue.next) {
                 mutex->queue.next = MUTEX_LOCKED;
             }
@@ -33,6 +33,10 @@
 #include "mpu.h"
 #endif
 
+#ifdef MODULE_KTRACE
+#include "ktrace.h"
+#endif
+
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
@@ -116,6 +120,10 @@ int __attribute__((used)) sched_run(void)
     }
 #endif
 
+#ifdef MODULE_KTRACE
+    ktrace_record(KTRACE_EVENT_SWITCH, next_thread->pid, 0);
+#endif
+
     next_thread->status = STATUS_RUNNING;
     sched_active_pid = next_thread->pid;
     sched_active_thread = (volatile thread_t *) next_thread;
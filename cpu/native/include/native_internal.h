@@ -122,6 +122,9 @@ extern int (*real_setitimer)(int which, const struct itimerval
 extern int (*real_setsid)(void);
 extern int (*real_setsockopt)(int socket, ...);
 extern int (*real_socket)(int domain, int type, int protocol);
+/* The ... is a hack to save includes: */
+extern ssize_t (*real_sendto)(int socket, const void *buffer, size_t length,
+                              int flags, ...);
 extern int (*real_printf)(const char *format, ...);
 extern int (*real_unlink)(const char *);
 extern long int (*real_random)(void);
@@ -27,6 +27,7 @@ extern "C" {
 #include <stdint.h>
 #include "net/netdev.h"
 
+#include "net/ethernet.h"
 #include "net/ethernet/hdr.h"
 
 #ifdef __MACH__
@@ -35,6 +36,40 @@ extern "C" {
 #include "net/if.h"
 #endif
 
+/**
+ * @brief   Number of frames buffered per receive batch
+ *
+ * Only used with the `netdev_tap_batch` module. On every interrupt, all
+ * frames readable from the TAP interface (up to this number) are read into a
+ * ring and handed to the upper layer in one go, instead of taking a signal,
+ * an ISR event and two system calls per frame.
+ */
+#ifndef NETDEV_TAP_RX_BATCH_SIZE
+#define NETDEV_TAP_RX_BATCH_SIZE    (8U)
+#endif
+
+#if defined(MODULE_NETDEV_TAP_BATCH) || defined(DOXYGEN)
+/**
+ * @brief   Frame buffered by the receive batch ring
+ */
+typedef struct {
+    uint16_t len;                       /**< length of the frame */
+    uint8_t data[ETHERNET_FRAME_LEN];   /**< the frame */
+} netdev_tap_frame_t;
+
+/**
+ * @brief   Statistics of the batched receive mode
+ */
+typedef struct {
+    uint32_t rx_frames;     /**< frames read from the TAP interface */
+    uint32_t rx_batches;    /**< interrupts that yielded at least one frame */
+    uint32_t rx_filtered;   /**< frames not addressed to this interface */
+    uint32_t rx_dropped;    /**< frames dropped by the upper layer */
+    uint32_t tx_frames;     /**< frames written to the TAP interface */
+    uint16_t rx_max_batch;  /**< largest number of frames read at once */
+} netdev_tap_stats_t;
+#endif
+
 /**
  * @brief tap interface state
  */
@@ -44,6 +79,12 @@ typedef struct netdev_tap {
     int tap_fd;                         /**< host file descriptor for the TAP */
     uint8_t addr[ETHERNET_ADDR_LEN];    /**< The MAC address of the TAP */
     uint8_t promiscous;                 /**< Flag for promiscous mode */
+#if defined(MODULE_NETDEV_TAP_BATCH) || defined(DOXYGEN)
+    uint8_t rx_head;                    /**< next frame to hand up */
+    uint8_t rx_avail;                   /**< number of frames in rx_ring */
+    netdev_tap_stats_t stats;           /**< batched receive statistics */
+    netdev_tap_frame_t rx_ring[NETDEV_TAP_RX_BATCH_SIZE]; /**< receive ring */
+#endif
 } netdev_tap_t;
 
 /**
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    drivers_shm_radio  Shared memory radio medium
+ * @ingroup     drivers_netdev
+ * @brief       IEEE 802.15.4 device for native sharing a medium in host memory
+ *
+ * All `native` instances on one host that attach to a medium with the same
+ * name map a common POSIX shared memory region. Every attached node owns a
+ * lock-free multi-producer/single-consumer ring in that region. Sending a
+ * frame copies it into the ring of every other node on the same channel, so
+ * no system call is needed on the data path. A node is only woken up by a
+ * datagram to its (abstract) UNIX doorbell socket when it announced that its
+ * ring ran empty, so under load frames are received in batches.
+ *
+ * Loss and delay are applied by the receiving node and can be configured per
+ * node on the command line:
+ *
+ *     -r <medium>[,node=<n>][,loss=<per mille>][,delay=<usec>]
+ *
+ * Without `node=` the first free node slot of the medium is used.
+ *
+ * @note    The medium is Linux only and does not synchronize with crashed
+ *          nodes: a node killed while writing a frame may stall the ring of
+ *          the receiver of that frame.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Shared memory radio medium definitions
+ */
+#ifndef SHM_RADIO_H
+#define SHM_RADIO_H
+
+#include <stdint.h>
+
+#include "net/ieee802154.h"
+#include "net/netdev.h"
+#include "net/netdev/ieee802154.h"
+#include "xtimer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Maximum number of nodes attached to a medium
+ *
+ * @note    All nodes sharing a medium must use the same value.
+ */
+#ifndef SHM_RADIO_NODES_MAX
+#define SHM_RADIO_NODES_MAX         (128U)
+#endif
+
+/**
+ * @brief   Number of frames buffered per node, must be a power of 2
+ *
+ * @note    All nodes sharing a medium must use the same value.
+ */
+#ifndef SHM_RADIO_RING_SIZE
+#define SHM_RADIO_RING_SIZE         (32U)
+#endif
+
+/**
+ * @brief   Frame slot in a node's receive ring
+ */
+typedef struct {
+    uint32_t seq;                           /**< slot sequence number */
+    uint16_t src;                           /**< sending node */
+    uint8_t len;                            /**< frame length */
+    uint8_t pad;                            /**< unused */
+    uint64_t time;                          /**< send time in usec */
+    uint8_t data[IEEE802154_FRAME_LEN_MAX]; /**< frame without FCS */
+} shm_radio_slot_t;
+
+/**
+ * @brief   Per node part of the shared medium
+ */
+typedef struct {
+    uint32_t pid;                           /**< owning process, 0 if free */
+    uint32_t chan;                          /**< channel the node listens on */
+    uint32_t waiting;                       /**< owner waits for a doorbell */
+    uint32_t head;                          /**< next slot to read */
+    uint32_t tail;                          /**< next slot to write */
+    uint32_t dropped;                       /**< frames dropped, ring full */
+    shm_radio_slot_t ring[SHM_RADIO_RING_SIZE]; /**< receive ring */
+} shm_radio_node_t;
+
+/**
+ * @brief   Layout of the shared memory region
+ */
+typedef struct {
+    uint32_t magic;                         /**< layout identifier */
+    uint32_t size;                          /**< size of the region */
+    shm_radio_node_t nodes[SHM_RADIO_NODES_MAX]; /**< attached nodes */
+} shm_radio_medium_t;
+
+/**
+ * @brief   Device statistics
+ */
+typedef struct {
+    uint32_t rx_frames;         /**< frames handed to the upper layer */
+    uint32_t rx_lost;           /**< frames dropped by simulated loss */
+    uint32_t rx_filtered;       /**< frames not addressed to this node */
+    uint32_t tx_frames;         /**< frames sent */
+    uint32_t tx_copies;         /**< frames put into other nodes' rings */
+    uint32_t doorbells;         /**< wake-ups sent to other nodes */
+} shm_radio_stats_t;
+
+/**
+ * @brief   Shared memory radio device state
+ */
+typedef struct {
+    netdev_ieee802154_t netdev;     /**< netdev internal member */
+    const char *name;               /**< name of the medium */
+    shm_radio_medium_t *medium;     /**< mapped medium */
+    shm_radio_node_t *node;         /**< own node in shm_radio_t::medium */
+    int node_idx;                   /**< index of shm_radio_t::node */
+    int sock_fd;                    /**< doorbell socket */
+    uint16_t loss;                  /**< RX loss in per mille */
+    uint32_t delay;                 /**< RX delay in usec */
+    xtimer_t delay_timer;           /**< timer for delayed frames */
+    shm_radio_stats_t stats;        /**< device statistics */
+} shm_radio_t;
+
+/**
+ * @brief   Shared memory radio initialization parameters
+ */
+typedef struct {
+    char *medium;       /**< name of the medium */
+    int node;           /**< node index on the medium, -1 for first free */
+    uint16_t loss;      /**< RX loss in per mille */
+    uint32_t delay;     /**< RX delay in usec */
+} shm_radio_params_t;
+
+/**
+ * @brief   Setup shm_radio_t structure
+ *
+ * Maps the medium (creating it if needed) and attaches to a free node slot.
+ *
+ * @param[in] dev       the preallocated shm_radio_t device handle to setup
+ * @param[in] params    initialization parameters
+ */
+void shm_radio_setup(shm_radio_t *dev, const shm_radio_params_t *params);
+
+/**
+ * @brief   Detach from the medium and release resources
+ *
+ * @param[in] dev       the shm_radio device handle to cleanup
+ */
+void shm_radio_cleanup(shm_radio_t *dev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SHM_RADIO_H */
+/** @} */
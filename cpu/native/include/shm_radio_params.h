@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup drivers_shm_radio
+ * @{
+ *
+ * @file
+ * @brief   Configuration parameters for the @ref drivers_shm_radio driver
+ */
+#ifndef SHM_RADIO_PARAMS_H
+#define SHM_RADIO_PARAMS_H
+
+#include "shm_radio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of allocated parameters at @ref shm_radio_params
+ *
+ * @note    Like @ref SOCKET_ZEP_MAX only configurable at compile-time
+ */
+#ifndef SHM_RADIO_MAX
+#define SHM_RADIO_MAX               (1)
+#endif
+
+/**
+ * @brief   shm_radio configurations
+ */
+extern shm_radio_params_t shm_radio_params[SHM_RADIO_MAX];
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SHM_RADIO_PARAMS_H */
+/** @} */
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     cpu_native
+ * @ingroup     sys_ktrace
+ * @{
+ *
+ * @file
+ * @brief       Trace clock and file sink of the kernel event tracer on native
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ktrace.h"
+#include "native_internal.h"
+
+uint64_t native_ktrace_clock(void)
+{
+    struct timespec t;
+
+    /* interrupts are disabled by ktrace_record(), no need to enter a syscall */
+#ifdef __MACH__
+    clock_gettime(CLOCK_MONOTONIC, &t);
+#else
+    real_clock_gettime(CLOCK_MONOTONIC, &t);
+#endif
+    return (uint64_t)t.tv_sec * 1000000000LU + t.tv_nsec;
+}
+
+static int _write(void *arg, const void *data, size_t len)
+{
+    int fd = *(int *)arg;
+    const uint8_t *pos = data;
+
+    while (len > 0) {
+        ssize_t res = real_write(fd, pos, len);
+        if (res < 0) {
+            return -errno;
+        }
+        pos += res;
+        len -= res;
+    }
+    return 0;
+}
+
+int ktrace_dump_file(const char *path)
+{
+    int res;
+
+    _native_syscall_enter();
+    int fd = real_open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        res = -errno;
+    }
+    else {
+        res = ktrace_dump(_write, &fd);
+        real_close(fd);
+    }
+    _native_syscall_leave();
+
+    return res;
+}
@@ -64,6 +64,10 @@
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
+#if defined(MODULE_NETDEV_TAP_BATCH) && (NETDEV_TAP_RX_BATCH_SIZE > UINT8_MAX)
+#error "NETDEV_TAP_RX_BATCH_SIZE must not exceed 255"
+#endif
+
 /* netdev interface */
 static int _init(netdev_t *netdev);
 static int _send(netdev_t *netdev, const iolist_t *iolist);
@@ -94,6 +98,9 @@ static inline int _set_promiscous(netdev_t *netdev, int value)
     return value;
 }
 
+#ifdef MODULE_NETDEV_TAP_BATCH
+static void _isr(netdev_t *netdev);
+#else
 static inline void _isr(netdev_t *netdev)
 {
     if (netdev->event_callback) {
@@ -105,6 +112,7 @@ static inline void _isr(netdev_t *netdev)
     }
 #endif
 }
+#endif
 
 static int _get(netdev_t *dev, netopt_t opt, void *value, size_t max_len)
 {
@@ -204,6 +212,136 @@ static void _continue_reading(netdev_tap_t *dev)
     _native_in_syscall--;
 }
 
+static bool _is_addr_filtered(netdev_tap_t *dev, uint8_t *frame)
+{
+    ethernet_hdr_t *hdr = (ethernet_hdr_t *)frame;
+
+    if (!(dev->promiscous) && !_is_addr_multicast(hdr->dst) &&
+        !_is_addr_broadcast(hdr->dst) &&
+        (memcmp(hdr->dst, dev->addr, ETHERNET_ADDR_LEN) != 0)) {
+        DEBUG("netdev_tap: received for %02x:%02x:%02x:%02x:%02x:%02x\n"
+              "That's not me => Dropped\n",
+              hdr->dst[0], hdr->dst[1], hdr->dst[2],
+              hdr->dst[3], hdr->dst[4], hdr->dst[5]);
+        return true;
+    }
+    return false;
+}
+
+#ifdef MODULE_NETDEV_TAP_BATCH
+/**
+ * @brief   Reads all available frames from the TAP interface into the ring
+ *
+ * @return  number of frames read
+ */
+static unsigned _rx_fill(netdev_tap_t *dev)
+{
+    unsigned n = 0;
+
+    while (dev->rx_avail < NETDEV_TAP_RX_BATCH_SIZE) {
+        unsigned idx = dev->rx_head + dev->rx_avail;
+        if (idx >= NETDEV_TAP_RX_BATCH_SIZE) {
+            idx -= NETDEV_TAP_RX_BATCH_SIZE;
+        }
+        netdev_tap_frame_t *frame = &dev->rx_ring[idx];
+
+        int nread = real_read(dev->tap_fd, frame->data, sizeof(frame->data));
+        if (nread < 0) {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                err(EXIT_FAILURE, "netdev_tap: read");
+            }
+            break;
+        }
+        else if (nread == 0) {
+            DEBUG("_native_handle_tap_input: ignoring null-event\n");
+            break;
+        }
+        if (_is_addr_filtered(dev, frame->data)) {
+            dev->stats.rx_filtered++;
+            continue;
+        }
+        frame->len = nread;
+        dev->rx_avail++;
+        n++;
+    }
+    DEBUG("netdev_tap: read %u frames\n", n);
+
+    dev->stats.rx_frames += n;
+    if (n > 0) {
+        dev->stats.rx_batches++;
+        if (n > dev->stats.rx_max_batch) {
+            dev->stats.rx_max_batch = n;
+        }
+    }
+    return n;
+}
+
+static void _rx_pop(netdev_tap_t *dev)
+{
+    if (++dev->rx_head == NETDEV_TAP_RX_BATCH_SIZE) {
+        dev->rx_head = 0;
+    }
+    dev->rx_avail--;
+}
+
+static void _isr(netdev_t *netdev)
+{
+    netdev_tap_t *dev = (netdev_tap_t*)netdev;
+
+    if (!netdev->event_callback) {
+#if DEVELHELP
+        puts("netdev_tap: _isr(): no event_callback set.");
+#endif
+        return;
+    }
+
+    _rx_fill(dev);
+    while (dev->rx_avail) {
+        unsigned avail = dev->rx_avail;
+        netdev->event_callback(netdev, NETDEV_EVENT_RX_COMPLETE);
+        if (dev->rx_avail == avail) {
+            /* upper layer did not fetch the frame */
+            dev->stats.rx_dropped++;
+            _rx_pop(dev);
+        }
+    }
+    /* the ring may have filled up before all frames were read */
+    _continue_reading(dev);
+}
+
+static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
+{
+    netdev_tap_t *dev = (netdev_tap_t*)netdev;
+    (void)info;
+
+    if (dev->rx_avail == 0) {
+        return 0;
+    }
+
+    netdev_tap_frame_t *frame = &dev->rx_ring[dev->rx_head];
+    int res = frame->len;
+
+    if (!buf) {
+        if (len > 0) {
+            /* no memory available in pktbuf, discarding the frame */
+            DEBUG("netdev_tap: discarding the frame\n");
+            dev->stats.rx_dropped++;
+            _rx_pop(dev);
+        }
+        return res;
+    }
+
+    if (len < frame->len) {
+        res = -ENOBUFS;
+        dev->stats.rx_dropped++;
+    }
+    else {
+        memcpy(buf, frame->data, frame->len);
+    }
+    _rx_pop(dev);
+    return res;
+}
+#else
 static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
 {
     netdev_tap_t *dev = (netdev_tap_t*)netdev;
@@ -238,15 +376,7 @@ static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
     DEBUG("netdev_tap: read %d bytes\n", nread);
 
     if (nread > 0) {
-        ethernet_hdr_t *hdr = (ethernet_hdr_t *)buf;
-        if (!(dev->promiscous) && !_is_addr_multicast(hdr->dst) &&
-            !_is_addr_broadcast(hdr->dst) &&
-            (memcmp(hdr->dst, dev->addr, ETHERNET_ADDR_LEN) != 0)) {
-            DEBUG("netdev_tap: received for %02x:%02x:%02x:%02x:%02x:%02x\n"
-                  "That's not me => Dropped\n",
-                  hdr->dst[0], hdr->dst[1], hdr->dst[2],
-                  hdr->dst[3], hdr->dst[4], hdr->dst[5]);
-
+        if (_is_addr_filtered(dev, buf)) {
             native_async_read_continue(dev->tap_fd);
 
             return 0;
@@ -272,6 +402,7 @@ static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
 
     return -1;
 }
+#endif /* MODULE_NETDEV_TAP_BATCH */
 
 static int _send(netdev_t *netdev, const iolist_t *iolist)
 {
@@ -283,6 +414,11 @@ static int _send(netdev_t *netdev, const iolist_t *iolist)
     iolist_to_iovec(iolist, iov, &n);
 
     int res = _native_writev(dev->tap_fd, iov, n);
+#ifdef MODULE_NETDEV_TAP_BATCH
+    if (res > 0) {
+        dev->stats.tx_frames++;
+    }
+#endif
 
     if (netdev->event_callback) {
         netdev->event_callback(netdev, NETDEV_EVENT_TX_COMPLETE);
@@ -333,6 +469,11 @@ static int _init(netdev_t *netdev)
 #endif
     /* initialize device descriptor */
     dev->promiscous = 0;
+#ifdef MODULE_NETDEV_TAP_BATCH
+    dev->rx_head = 0;
+    dev->rx_avail = 0;
+    memset(&dev->stats, 0, sizeof(dev->stats));
+#endif
     /* implicitly create the tap interface */
     if ((dev->tap_fd = real_open(clonedev, O_RDWR | O_NONBLOCK)) == -1) {
         err(EXIT_FAILURE, "open(%s)", clonedev);
@@ -18,6 +18,7 @@
  */
 
 #include <err.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -36,8 +37,17 @@
 
 void pm_set_lowest(void)
 {
+    sigset_t all, old;
+
+    sigfillset(&all);
     _native_in_syscall++; /* no switching here */
-    real_pause();
+    /* a signal arriving between the check and the wait would only be recorded
+     * in _native_sigpend and not wake us up, so do both atomically */
+    sigprocmask(SIG_SETMASK, &all, &old);
+    if (_native_sigpend == 0) {
+        sigsuspend(&old);
+    }
+    sigprocmask(SIG_SETMASK, &old, NULL);
     _native_in_syscall--;
 
     if (_native_sigpend > 0) {
@@ -0,0 +1,498 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief   Shared memory radio medium for native
+ *
+ * Every node ring is a bounded MPMC queue in the style of D. Vyukov, used with
+ * a single consumer: each slot carries a sequence number telling producers
+ * and the consumer whose turn it is. Sequence numbers are stored relative to
+ * the slot index, so a zero-filled region is a valid, empty medium.
+ */
+
+#ifndef __linux__
+#error "shm_radio is only available on Linux"
+#endif
+
+#include <assert.h>
+#include <err.h>
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* needs to be included before native's declarations of ntohl etc. */
+#include "byteorder.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "async_read.h"
+#include "iolist.h"
+#include "native_internal.h"
+#include "random.h"
+
+#include "shm_radio.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#define SHM_RADIO_MAGIC     (0x53484d31)    /* "SHM1" */
+#define RING_MASK           (SHM_RADIO_RING_SIZE - 1)
+
+#if (SHM_RADIO_RING_SIZE & RING_MASK) != 0
+#error "SHM_RADIO_RING_SIZE must be a power of 2"
+#endif
+
+static uint64_t _now_us(void)
+{
+    struct timespec ts;
+
+    real_clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000U) + (ts.tv_nsec / 1000U);
+}
+
+static inline uint32_t _seq_get(shm_radio_slot_t *slot, unsigned idx)
+{
+    return __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) + idx;
+}
+
+static inline void _seq_set(shm_radio_slot_t *slot, unsigned idx, uint32_t seq)
+{
+    __atomic_store_n(&slot->seq, seq - idx, __ATOMIC_RELEASE);
+}
+
+static int _push(shm_radio_node_t *node, uint16_t src, const void *data,
+                 uint8_t len, uint64_t time)
+{
+    uint32_t pos = __atomic_load_n(&node->tail, __ATOMIC_RELAXED);
+    shm_radio_slot_t *slot;
+
+    while (1) {
+        slot = &node->ring[pos & RING_MASK];
+        int32_t diff = (int32_t)(_seq_get(slot, pos & RING_MASK) - pos);
+
+        if (diff == 0) {
+            /* slot is free, try to claim it */
+            if (__atomic_compare_exchange_n(&node->tail, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            /* slot still holds an unread frame: ring is full */
+            __atomic_fetch_add(&node->dropped, 1, __ATOMIC_RELAXED);
+            return -ENOBUFS;
+        }
+        else {
+            /* another producer claimed the slot */
+            pos = __atomic_load_n(&node->tail, __ATOMIC_RELAXED);
+        }
+    }
+    slot->src = src;
+    slot->len = len;
+    slot->time = time;
+    memcpy(slot->data, data, len);
+    _seq_set(slot, pos & RING_MASK, pos + 1);
+    return 0;
+}
+
+static shm_radio_slot_t *_peek(shm_radio_node_t *node)
+{
+    uint32_t pos = node->head;
+    shm_radio_slot_t *slot = &node->ring[pos & RING_MASK];
+
+    if (_seq_get(slot, pos & RING_MASK) != (pos + 1)) {
+        return NULL;
+    }
+    return slot;
+}
+
+static void _pop(shm_radio_node_t *node)
+{
+    uint32_t pos = node->head;
+
+    _seq_set(&node->ring[pos & RING_MASK], pos & RING_MASK,
+             pos + SHM_RADIO_RING_SIZE);
+    __atomic_store_n(&node->head, pos + 1, __ATOMIC_RELAXED);
+}
+
+static socklen_t _doorbell_addr(struct sockaddr_un *addr, const char *name,
+                                unsigned idx)
+{
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    /* abstract address: leading '\0', removed with the socket */
+    int len = snprintf(&addr->sun_path[1], sizeof(addr->sun_path) - 1,
+                       "riot-shm-radio/%s/%u", name, idx);
+    return offsetof(struct sockaddr_un, sun_path) + 1 + len;
+}
+
+static void _ring_doorbell(shm_radio_t *dev, unsigned idx)
+{
+    struct sockaddr_un addr;
+    socklen_t len = _doorbell_addr(&addr, dev->name, idx);
+    char c = 0;
+
+    real_sendto(dev->sock_fd, &c, sizeof(c), MSG_DONTWAIT | MSG_NOSIGNAL,
+                &addr, len);
+    dev->stats.doorbells++;
+}
+
+static int _send(netdev_t *netdev, const iolist_t *iolist)
+{
+    shm_radio_t *dev = (shm_radio_t *)netdev;
+    uint8_t frame[IEEE802154_FRAME_LEN_MAX];
+    size_t len = 0;
+
+    for (const iolist_t *iol = iolist; iol; iol = iol->iol_next) {
+        if ((len + iol->iol_len) > (sizeof(frame) - IEEE802154_FCS_LEN)) {
+            return -EOVERFLOW;
+        }
+        memcpy(&frame[len], iol->iol_base, iol->iol_len);
+        len += iol->iol_len;
+    }
+    DEBUG("shm_radio::send(%p, %u)\n", (void *)netdev, (unsigned)len);
+
+    uint64_t now = _now_us();
+    uint32_t chan = dev->netdev.chan;
+
+    for (unsigned i = 0; i < SHM_RADIO_NODES_MAX; i++) {
+        shm_radio_node_t *node = &dev->medium->nodes[i];
+
+        if ((node == dev->node) ||
+            (__atomic_load_n(&node->pid, __ATOMIC_RELAXED) == 0) ||
+            (__atomic_load_n(&node->chan, __ATOMIC_RELAXED) != chan)) {
+            continue;
+        }
+        if (_push(node, dev->node_idx, frame, len, now) < 0) {
+            continue;
+        }
+        dev->stats.tx_copies++;
+        /* pairs with the store in _wait_for_frames() */
+        if (__atomic_exchange_n(&node->waiting, 0, __ATOMIC_SEQ_CST)) {
+            _ring_doorbell(dev, i);
+        }
+    }
+    dev->stats.tx_frames++;
+
+    if (netdev->event_callback) {
+        netdev->event_callback(netdev, NETDEV_EVENT_TX_COMPLETE);
+    }
+    return len;
+}
+
+/* returns the next frame to hand to the upper layer, if it is due */
+static shm_radio_slot_t *_next_frame(shm_radio_t *dev)
+{
+    shm_radio_slot_t *slot;
+
+    while ((slot = _peek(dev->node)) != NULL) {
+        if (dev->delay) {
+            uint64_t due = slot->time + dev->delay;
+            uint64_t now = _now_us();
+
+            if (now < due) {
+                xtimer_set(&dev->delay_timer, (uint32_t)(due - now));
+                return NULL;
+            }
+        }
+        if (dev->loss && (random_uint32_range(0, 1000) < dev->loss)) {
+            dev->stats.rx_lost++;
+        }
+        else if (netdev_ieee802154_dst_filter(&dev->netdev, slot->data)) {
+            dev->stats.rx_filtered++;
+        }
+        else {
+            return slot;
+        }
+        _pop(dev->node);
+    }
+    return NULL;
+}
+
+static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
+{
+    shm_radio_t *dev = (shm_radio_t *)netdev;
+    shm_radio_slot_t *slot = _peek(dev->node);
+    int res;
+
+    DEBUG("shm_radio::recv(%p, %p, %u, %p)\n", (void *)netdev, buf,
+          (unsigned)len, info);
+    if (slot == NULL) {
+        return 0;
+    }
+    res = slot->len;
+    if (buf == NULL) {
+        if (len > 0) {
+            /* drop frame */
+            _pop(dev->node);
+        }
+        return res;
+    }
+    if (len < slot->len) {
+        _pop(dev->node);
+        return -ENOBUFS;
+    }
+    memcpy(buf, slot->data, slot->len);
+    if (info != NULL) {
+        netdev_ieee802154_rx_info_t *rx_info = info;
+
+        rx_info->lqi = 0xff;
+        rx_info->rssi = UINT8_MAX;
+    }
+    dev->stats.rx_frames++;
+    _pop(dev->node);
+    return res;
+}
+
+/* tell producers to ring the doorbell, returns true if frames arrived
+ * meanwhile */
+static bool _wait_for_frames(shm_radio_t *dev)
+{
+    __atomic_store_n(&dev->node->waiting, 1, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (_peek(dev->node) == NULL) {
+        return false;
+    }
+    __atomic_store_n(&dev->node->waiting, 0, __ATOMIC_RELAXED);
+    return true;
+}
+
+static void _isr(netdev_t *netdev)
+{
+    shm_radio_t *dev = (shm_radio_t *)netdev;
+
+    if (netdev->event_callback == NULL) {
+        return;
+    }
+    do {
+        uint32_t head;
+
+        while (_next_frame(dev) != NULL) {
+            head = dev->node->head;
+            netdev->event_callback(netdev, NETDEV_EVENT_RX_COMPLETE);
+            if (head == dev->node->head) {
+                /* upper layer did not fetch the frame */
+                _pop(dev->node);
+            }
+        }
+        if (_peek(dev->node) != NULL) {
+            /* frame not due yet, timer is set */
+            return;
+        }
+    } while (_wait_for_frames(dev));
+}
+
+static void _doorbell_isr(int fd, void *arg)
+{
+    netdev_t *netdev = arg;
+    char buf[16];
+
+    while (real_read(fd, buf, sizeof(buf)) > 0) {}
+    native_async_read_continue(fd);
+    if (netdev->event_callback) {
+        netdev->event_callback(netdev, NETDEV_EVENT_ISR);
+    }
+}
+
+static void _delay_cb(void *arg)
+{
+    netdev_t *netdev = arg;
+
+    if (netdev->event_callback) {
+        netdev->event_callback(netdev, NETDEV_EVENT_ISR);
+    }
+}
+
+static int _init(netdev_t *netdev)
+{
+    shm_radio_t *dev = (shm_radio_t *)netdev;
+
+    netdev_ieee802154_reset(&dev->netdev);
+    dev->netdev.chan = IEEE802154_DEFAULT_CHANNEL;
+    __atomic_store_n(&dev->node->chan, dev->netdev.chan, __ATOMIC_RELAXED);
+    /* frames may have arrived before the upper layer was ready */
+    if (_peek(dev->node) && netdev->event_callback) {
+        netdev->event_callback(netdev, NETDEV_EVENT_ISR);
+    }
+    return 0;
+}
+
+static int _get(netdev_t *netdev, netopt_t opt, void *value, size_t max_len)
+{
+    assert(netdev != NULL);
+    return netdev_ieee802154_get((netdev_ieee802154_t *)netdev, opt, value,
+                                 max_len);
+}
+
+static int _set(netdev_t *netdev, netopt_t opt, const void *value,
+                size_t value_len)
+{
+    shm_radio_t *dev = (shm_radio_t *)netdev;
+    int res;
+
+    assert(netdev != NULL);
+    res = netdev_ieee802154_set(&dev->netdev, opt, value, value_len);
+    if ((opt == NETOPT_CHANNEL) && (res >= 0)) {
+        __atomic_store_n(&dev->node->chan, dev->netdev.chan, __ATOMIC_RELAXED);
+    }
+    return res;
+}
+
+static const netdev_driver_t shm_radio_driver = {
+    .send = _send,
+    .recv = _recv,
+    .init = _init,
+    .isr = _isr,
+    .get = _get,
+    .set = _set,
+};
+
+static shm_radio_medium_t *_map_medium(const char *name)
+{
+    char path[NAME_MAX];
+    uint32_t exp = 0;
+    shm_radio_medium_t *medium;
+    int fd;
+
+    snprintf(path, sizeof(path), "/riot-shm-radio.%s", name);
+    if ((fd = shm_open(path, O_RDWR | O_CREAT, 0600)) < 0) {
+        err(EXIT_FAILURE, "shm_radio: unable to open medium %s", path);
+    }
+    /* no-op if the medium exists already with the same layout */
+    if (ftruncate(fd, sizeof(shm_radio_medium_t)) < 0) {
+        err(EXIT_FAILURE, "shm_radio: unable to size medium");
+    }
+    medium = mmap(NULL, sizeof(shm_radio_medium_t), PROT_READ | PROT_WRITE,
+                  MAP_SHARED, fd, 0);
+    real_close(fd);
+    if (medium == MAP_FAILED) {
+        err(EXIT_FAILURE, "shm_radio: unable to map medium");
+    }
+    __atomic_compare_exchange_n(&medium->size, &exp, sizeof(*medium), false,
+                                __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    exp = 0;
+    __atomic_compare_exchange_n(&medium->magic, &exp, SHM_RADIO_MAGIC, false,
+                                __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    if ((medium->magic != SHM_RADIO_MAGIC) ||
+        (medium->size != sizeof(*medium))) {
+        errx(EXIT_FAILURE, "shm_radio: medium %s has a different layout, "
+             "check SHM_RADIO_NODES_MAX and SHM_RADIO_RING_SIZE", path);
+    }
+    return medium;
+}
+
+static bool _claim_node(shm_radio_t *dev, unsigned idx)
+{
+    shm_radio_node_t *node = &dev->medium->nodes[idx];
+    uint32_t pid = __atomic_load_n(&node->pid, __ATOMIC_RELAXED);
+
+    /* take over slots of nodes that exited without cleanup */
+    if ((pid != 0) && ((kill(pid, 0) == 0) || (errno != ESRCH))) {
+        return false;
+    }
+    if (!__atomic_compare_exchange_n(&node->pid, &pid, _native_pid, false,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+        return false;
+    }
+    dev->node = node;
+    dev->node_idx = idx;
+    /* discard what was sent to the previous owner */
+    while (_peek(node)) {
+        _pop(node);
+    }
+    return true;
+}
+
+void shm_radio_setup(shm_radio_t *dev, const shm_radio_params_t *params)
+{
+    struct sockaddr_un addr;
+    socklen_t addr_len;
+
+    DEBUG("shm_radio_setup(%p, %p)\n", (void *)dev, (void *)params);
+    assert(params->medium != NULL);
+    memset(dev, 0, sizeof(shm_radio_t));
+    dev->netdev.netdev.driver = &shm_radio_driver;
+    dev->name = params->medium;
+    dev->loss = params->loss;
+    dev->delay = params->delay;
+    dev->delay_timer.callback = _delay_cb;
+    dev->delay_timer.arg = dev;
+    dev->medium = _map_medium(params->medium);
+
+    if (params->node >= 0) {
+        if (((unsigned)params->node >= SHM_RADIO_NODES_MAX) ||
+            !_claim_node(dev, params->node)) {
+            errx(EXIT_FAILURE, "shm_radio: node %d not available",
+                 params->node);
+        }
+    }
+    else {
+        for (unsigned i = 0; (dev->node == NULL) && (i < SHM_RADIO_NODES_MAX);
+             i++) {
+            _claim_node(dev, i);
+        }
+        if (dev->node == NULL) {
+            errx(EXIT_FAILURE, "shm_radio: medium %s is full", params->medium);
+        }
+    }
+
+    if ((dev->sock_fd = real_socket(AF_UNIX, SOCK_DGRAM, 0)) < 0) {
+        err(EXIT_FAILURE, "shm_radio: unable to create doorbell");
+    }
+    addr_len = _doorbell_addr(&addr, dev->name, dev->node_idx);
+    if (real_bind(dev->sock_fd, &addr, addr_len) < 0) {
+        err(EXIT_FAILURE, "shm_radio: unable to bind doorbell");
+    }
+
+    /* generate hardware address from medium name and node index */
+    uint16_t hash = 5381;
+    for (const char *c = dev->name; *c; c++) {
+        hash = (hash * 33) ^ *c;
+    }
+    dev->netdev.long_addr[1] = 'S';     /* The "OUI" */
+    dev->netdev.long_addr[2] = 'H';
+    dev->netdev.long_addr[3] = 'M';
+    dev->netdev.long_addr[4] = hash >> 8;
+    dev->netdev.long_addr[5] = hash & 0xff;
+    dev->netdev.long_addr[6] = (dev->node_idx + 1) >> 8;
+    dev->netdev.long_addr[7] = (dev->node_idx + 1) & 0xff;
+    dev->netdev.short_addr[0] = dev->netdev.long_addr[6];
+    dev->netdev.short_addr[1] = dev->netdev.long_addr[7];
+
+    native_async_read_setup();
+    native_async_read_add_handler(dev->sock_fd, dev, _doorbell_isr);
+    __atomic_store_n(&dev->node->waiting, 1, __ATOMIC_SEQ_CST);
+}
+
+void shm_radio_cleanup(shm_radio_t *dev)
+{
+    uint32_t pid = _native_pid;
+
+    assert(dev != NULL);
+    native_async_read_cleanup();
+    real_close(dev->sock_fd);
+    __atomic_compare_exchange_n(&dev->node->pid, &pid, 0, false,
+                                __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    munmap(dev->medium, sizeof(shm_radio_medium_t));
+    dev->medium = NULL;
+    dev->node = NULL;
+}
+
+/** @} */
@@ -129,18 +129,27 @@ static int _send(netdev_t *netdev, const iolist_t *iolist)
     return res - v[0].iov_len - v[n + 1].iov_len;
 }
 
-static void _continue_reading(socket_zep_t *dev)
+static bool _readable(socket_zep_t *dev)
 {
-    /* work around lost signals */
     fd_set rfds;
     struct timeval t;
     memset(&t, 0, sizeof(t));
     FD_ZERO(&rfds);
     FD_SET(dev->sock_fd, &rfds);
 
+    _native_in_syscall++; /* no switching here */
+    int res = real_select(dev->sock_fd + 1, &rfds, NULL, NULL, &t);
+    _native_in_syscall--;
+
+    return res == 1;
+}
+
+static void _continue_reading(socket_zep_t *dev)
+{
+    /* work around lost signals */
     _native_in_syscall++; /* no switching here */
 
-    if (real_select(dev->sock_fd + 1, &rfds, NULL, NULL, &t) == 1) {
+    if (_readable(dev)) {
         int sig = SIGIO;
         extern int _sig_pipefd[2];
         extern ssize_t (*real_write)(int fd, const void * buf, size_t count);
@@ -260,9 +269,17 @@ static void _isr(netdev_t *netdev)
 {
     if (netdev->event_callback) {
         socket_zep_t *dev = (socket_zep_t *)netdev;
-
-        DEBUG("socket_zep::isr: firing %u\n", (unsigned)dev->last_event);
-        netdev->event_callback(netdev, dev->last_event);
+        netdev_event_t event = dev->last_event;
+
+        DEBUG("socket_zep::isr: firing %u\n", (unsigned)event);
+        netdev->event_callback(netdev, event);
+        /* a frame received while sending had its RX_COMPLETE overwritten by
+         * the simulated TX interrupts */
+        if ((event != NETDEV_EVENT_RX_COMPLETE) && _readable(dev)) {
+            DEBUG("socket_zep::isr: firing pending RX_COMPLETE\n");
+            dev->last_event = NETDEV_EVENT_RX_COMPLETE;
+            netdev->event_callback(netdev, NETDEV_EVENT_RX_COMPLETE);
+        }
     }
     return;
 }
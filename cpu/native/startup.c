@@ -84,6 +84,11 @@ netdev_tap_params_t netdev_tap_params[NETDEV_TAP_MAX];
 
 socket_zep_params_t socket_zep_params[SOCKET_ZEP_MAX];
 #endif
+#ifdef MODULE_SHM_RADIO
+#include "shm_radio_params.h"
+
+shm_radio_params_t shm_radio_params[SHM_RADIO_MAX];
+#endif
 
 static const char short_opts[] = ":hi:s:deEoc:"
 #ifdef MODULE_MTD_NATIVE
@@ -95,6 +100,9 @@ static const char short_opts[] = ":hi:s:deEoc:"
 #ifdef MODULE_SOCKET_ZEP
     "z:"
 #endif
+#ifdef MODULE_SHM_RADIO
+    "r:"
+#endif
 #ifdef MODULE_PERIPH_SPIDEV_LINUX
     "p:"
 #endif
@@ -118,6 +126,9 @@ static const struct option long_opts[] = {
 #ifdef MODULE_SOCKET_ZEP
     { "zep", required_argument, NULL, 'z' },
 #endif
+#ifdef MODULE_SHM_RADIO
+    { "shm-radio", required_argument, NULL, 'r' },
+#endif
 #ifdef MODULE_PERIPH_SPIDEV_LINUX
     { "spi", required_argument, NULL, 'p' },
 #endif
@@ -259,6 +270,11 @@ void usage_exit(int status)
         real_printf(" -z <laddr>:<lport>,<raddr>:<rport>\n");
     }
 #endif
+#if defined(MODULE_SHM_RADIO) && (SHM_RADIO_MAX > 0)
+    for (int i = 0; i < SHM_RADIO_MAX; i++) {
+        real_printf(" -r <medium>[,node=<n>][,loss=<permille>][,delay=<usec>]\n");
+    }
+#endif
 #ifdef MODULE_PERIPH_SPIDEV_LINUX
     real_printf(" [-p <b>:<d>:<spidev>]\n");
 #endif
@@ -291,6 +307,14 @@ void usage_exit(int status)
 "        provide a ZEP interface with local address and port (<laddr>, <lport>)\n"
 "        and remote address and port (default local: [::]:17754).\n"
 "        Required to be provided SOCKET_ZEP_MAX times\n"
+#endif
+#if defined(MODULE_SHM_RADIO) && (SHM_RADIO_MAX > 0)
+"    -r <medium>[,node=<n>][,loss=<permille>][,delay=<usec>]\n"
+"    --shm-radio=<medium>[,node=<n>][,loss=<permille>][,delay=<usec>]\n"
+"        attach an IEEE 802.15.4 interface to the shared memory medium\n"
+"        <medium>, optionally as node <n>, dropping <permille> of the\n"
+"        received frames and delaying them by <usec>.\n"
+"        Required to be provided SHM_RADIO_MAX times\n"
 #endif
     );
 #ifdef MODULE_MTD_NATIVE
@@ -375,6 +399,39 @@ static void _zep_params_setup(char *zep_str, int zep)
 }
 #endif
 
+#ifdef MODULE_SHM_RADIO
+static void _shm_radio_params_setup(char *str, int radio)
+{
+    char *save_ptr, *opt;
+    shm_radio_params_t *p = &shm_radio_params[radio];
+
+    if ((p->medium = strtok_r(str, ",", &save_ptr)) == NULL) {
+        usage_exit(EXIT_FAILURE);
+    }
+    p->node = -1;
+    while ((opt = strtok_r(NULL, ",", &save_ptr)) != NULL) {
+        char *val = strchr(opt, '=');
+
+        if (val == NULL) {
+            usage_exit(EXIT_FAILURE);
+        }
+        *(val++) = '\0';
+        if (strcmp(opt, "node") == 0) {
+            p->node = atoi(val);
+        }
+        else if (strcmp(opt, "loss") == 0) {
+            p->loss = atoi(val);
+        }
+        else if (strcmp(opt, "delay") == 0) {
+            p->delay = strtoul(val, NULL, 10);
+        }
+        else {
+            usage_exit(EXIT_FAILURE);
+        }
+    }
+}
+#endif
+
 /** @brief Initialization function pointer type */
 typedef void (*init_func_t)(int argc, char **argv, char **envp);
 #ifdef __APPLE__
@@ -404,6 +461,9 @@ __attribute__((constructor)) static void startup(int argc, char **argv, char **e
     int c, opt_idx = 0, uart = 0;
 #ifdef MODULE_SOCKET_ZEP
     unsigned zeps = 0;
+#endif
+#ifdef MODULE_SHM_RADIO
+    unsigned shm_radios = 0;
 #endif
     bool dmn = false, force_stderr = false;
     _stdiotype_t stderrtype = _STDIOTYPE_STDIO;
@@ -476,6 +536,14 @@ __attribute__((constructor)) static void startup(int argc, char **argv, char **e
                 _zep_params_setup(optarg, zeps++);
                 break;
 #endif
+#ifdef MODULE_SHM_RADIO
+            case 'r':
+                if (shm_radios >= SHM_RADIO_MAX) {
+                    usage_exit(EXIT_FAILURE);
+                }
+                _shm_radio_params_setup(optarg, shm_radios++);
+                break;
+#endif
 #ifdef MODULE_PERIPH_SPIDEV_LINUX
             case 'p': {
                     long bus = strtol(optarg, &optarg, 10);
@@ -511,6 +579,12 @@ __attribute__((constructor)) static void startup(int argc, char **argv, char **e
         usage_exit(EXIT_FAILURE);
     }
 #endif
+#ifdef MODULE_SHM_RADIO
+    if (shm_radios != SHM_RADIO_MAX) {
+        /* not enough shared memory radios given */
+        usage_exit(EXIT_FAILURE);
+    }
+#endif
 
     if (dmn) {
         filter_daemonize_argv(_native_argv);
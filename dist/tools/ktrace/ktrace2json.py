@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2020 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+"""Convert a dump of the ktrace module into the Chrome trace event format.
+
+The input is either a binary dump written by `ktrace dump <file>` on native or
+a terminal log containing the hex dump printed by `ktrace dump`. The output
+can be opened with https://ui.perfetto.dev or chrome://tracing.
+"""
+
+import argparse
+import json
+import re
+import struct
+import sys
+
+MAGIC = 0x4b545243
+VERSION = 2
+
+HDR_FMT = 'IHHIIIHH'
+ENTRY_FMT = 'IBBhII'
+
+EVENT_SWITCH = 0
+EVENT_ISR_ENTER = 1
+EVENT_ISR_EXIT = 2
+EVENT_MSG_SEND = 3
+EVENT_MSG_RECV = 4
+EVENT_MUTEX_BLOCK = 5
+EVENT_MUTEX_UNBLOCK = 6
+EVENT_MARKER = 7
+EVENT_BEGIN = 8
+EVENT_END = 9
+EVENT_SYNC = 10
+
+FLAG_ISR = 0x01
+
+# RIOT PIDs start at 1, the otherwise unused 0 is the ISR track
+ISR_TID = 0
+PROCESS_ID = 1
+
+
+def extract_hex_dump(text):
+    """Return the binary content of the last hex dump in a terminal log."""
+    dumps = re.findall(r'ktrace: begin\s*\n(.*?)ktrace: end', text, re.S)
+    if not dumps:
+        return None
+    # terminal programs may prefix each line, e.g. with a timestamp
+    hexstr = ''
+    for line in dumps[-1].splitlines():
+        tokens = line.split()
+        if tokens and re.fullmatch(r'(?:[0-9a-f]{2})+', tokens[-1]):
+            hexstr += tokens[-1]
+    return bytes.fromhex(hexstr)
+
+
+def parse_dump(data):
+    """Parse a binary dump, return header fields, entries and thread names."""
+    for order in '<>':
+        if struct.unpack_from(order + 'I', data)[0] == MAGIC:
+            break
+    else:
+        raise ValueError('no ktrace dump (bad magic)')
+
+    hdr_fmt = order + HDR_FMT
+    (_, version, entry_size, clock_hz, count, lost, threads, _) = \
+        struct.unpack_from(hdr_fmt, data)
+    if version != VERSION:
+        raise ValueError('unsupported dump version {}'.format(version))
+    entry_fmt = order + ENTRY_FMT
+    if entry_size != struct.calcsize(entry_fmt):
+        raise ValueError('unexpected entry size {}'.format(entry_size))
+
+    offset = struct.calcsize(hdr_fmt)
+    entries = [struct.unpack_from(entry_fmt, data, offset + i * entry_size)
+               for i in range(count)]
+    offset += count * entry_size
+
+    # the node may report fewer names than announced
+    names = {}
+    for _ in range(threads):
+        if offset + 3 > len(data):
+            break
+        pid, length = struct.unpack_from(order + 'hB', data, offset)
+        offset += 3
+        names[pid] = data[offset:offset + length].decode('utf-8', 'replace')
+        offset += length
+
+    return clock_hz, lost, entries, names
+
+
+def to_chrome_trace(clock_hz, lost, entries, names):
+    """Convert parsed entries into a Chrome trace event dict."""
+    events = []
+    # the upper 32 bit of the time of the entries preceding the first sync
+    high = next((e[5] for e in entries if e[1] == EVENT_SYNC), 0)
+    start = None
+    running = None
+
+    def emit(ph, name, tid, ts, **kwargs):
+        event = {'ph': ph, 'name': name, 'pid': PROCESS_ID, 'tid': tid, 'ts': ts}
+        event.update(kwargs)
+        events.append(event)
+
+    for time, event, flags, pid, arg0, arg1 in entries:
+        # entries hold the lower 32 bit of the time, sync entries the upper
+        if event == EVENT_SYNC:
+            high = arg0
+            continue
+        now = (high << 32) | time
+        if start is None:
+            start = now
+        ts = (now - start) * 1e6 / clock_hz
+        tid = ISR_TID if flags & FLAG_ISR else pid
+
+        if running is None:
+            running = (pid, 0.0)
+
+        if event == EVENT_SWITCH:
+            emit('X', 'running', running[0], running[1], dur=ts - running[1])
+            running = (arg0, ts)
+        elif event == EVENT_ISR_ENTER:
+            emit('B', 'irq {}'.format(arg0), ISR_TID, ts)
+        elif event == EVENT_ISR_EXIT:
+            emit('E', 'irq {}'.format(arg0), ISR_TID, ts)
+        elif event == EVENT_MSG_SEND:
+            emit('i', 'msg_send', tid, ts, s='t',
+                 args={'to': arg0, 'type': '0x{:04x}'.format(arg1)})
+        elif event == EVENT_MSG_RECV:
+            emit('i', 'msg_receive', tid, ts, s='t',
+                 args={'from': arg0, 'type': '0x{:04x}'.format(arg1)})
+        elif event == EVENT_MUTEX_BLOCK:
+            emit('i', 'mutex_block', tid, ts, s='t',
+                 args={'mutex': '0x{:08x}'.format(arg0)})
+        elif event == EVENT_MUTEX_UNBLOCK:
+            emit('i', 'mutex_unblock', tid, ts, s='t',
+                 args={'mutex': '0x{:08x}'.format(arg0), 'woken': arg1})
+        elif event == EVENT_MARKER:
+            emit('i', 'marker {}'.format(arg0), tid, ts, s='t', args={'value': arg1})
+        elif event == EVENT_BEGIN:
+            emit('B', 'span {}'.format(arg0), tid, ts)
+        elif event == EVENT_END:
+            emit('E', 'span {}'.format(arg0), tid, ts)
+
+    if running is not None:
+        emit('X', 'running', running[0], running[1], dur=ts - running[1])
+
+    meta = [{'ph': 'M', 'name': 'process_name', 'pid': PROCESS_ID,
+             'args': {'name': 'RIOT'}},
+            {'ph': 'M', 'name': 'thread_name', 'pid': PROCESS_ID, 'tid': ISR_TID,
+             'args': {'name': 'ISR'}}]
+    for pid, name in sorted(names.items()):
+        meta.append({'ph': 'M', 'name': 'thread_name', 'pid': PROCESS_ID,
+                     'tid': pid, 'args': {'name': '{} ({})'.format(name, pid)}})
+
+    return {'traceEvents': meta + events,
+            'displayTimeUnit': 'ns',
+            'otherData': {'clock_hz': clock_hz, 'lost_entries': lost}}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('input', help='binary dump or terminal log')
+    parser.add_argument('-o', '--output', default='-',
+                        help='output JSON file (default: stdout)')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        data = f.read()
+
+    # terminal logs contain the dump as hex lines
+    dump = extract_hex_dump(data.decode('utf-8', 'replace'))
+    if dump is not None:
+        data = dump
+
+    try:
+        clock_hz, lost, entries, names = parse_dump(data)
+    except (ValueError, struct.error) as e:
+        sys.exit('{}: {}'.format(args.input, e))
+
+    if lost:
+        print('{} entries were overwritten before the dump'.format(lost), file=sys.stderr)
+
+    trace = to_chrome_trace(clock_hz, lost, entries, names)
+    if args.output == '-':
+        json.dump(trace, sys.stdout)
+    else:
+        with open(args.output, 'w') as f:
+            json.dump(trace, f)
+
+
+if __name__ == '__main__':
+    main()
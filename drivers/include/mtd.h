@@ -14,6 +14,10 @@
  *
  * Generic memory technology device interface
  *
+ * With the `mtd_async` module, operations can also be started without
+ * blocking the caller, e.g. to continue sampling during a sector erase. See
+ * mtd_async.h for details.
+ *
  * @file
  *
  * @author      Aurelien Gonce <aurelien.gonce@altran.com>
@@ -62,6 +66,13 @@ typedef struct {
     uint32_t page_size;        /**< Size of the pages in the MTD */
 } mtd_dev_t;
 
+#if defined(MODULE_MTD_ASYNC) || defined(DOXYGEN)
+/**
+ * @brief   Asynchronous MTD operation, see mtd_async.h
+ */
+typedef struct mtd_async mtd_async_t;
+#endif
+
 /**
  * @brief   MTD driver interface
  *
@@ -146,6 +157,52 @@ struct mtd_desc {
      * @return < 0 value on error
      */
     int (*power)(mtd_dev_t *dev, enum mtd_power_state power);
+
+    /**
+     * @brief   Write back data buffered by the driver, optional
+     *
+     * Drivers acknowledging writes before they reach the medium, like
+     * @ref drivers_mtd_cache, must implement this.
+     *
+     * @param[in] dev       Pointer to the selected driver
+     *
+     * @return 0 on success
+     * @return < 0 value on error
+     */
+    int (*flush)(mtd_dev_t *dev);
+
+#if defined(MODULE_MTD_ASYNC) || defined(DOXYGEN)
+    /**
+     * @brief   Start writing to the Memory Technology Device (MTD), optional
+     *
+     * Same constraints as mtd_desc::write. The parameters are found in @p op.
+     * Once done, the driver calls @ref mtd_async_done from the thread
+     * serving mtd_async_t::queue.
+     *
+     * If not implemented, mtd_desc::write is called by that thread.
+     *
+     * @param[in] dev       Pointer to the selected driver
+     * @param[in] op        Operation to start
+     *
+     * @return 0 if the operation was started
+     * @return < 0 value on error, the callback is not called
+     */
+    int (*write_async)(mtd_dev_t *dev, mtd_async_t *op);
+
+    /**
+     * @brief   Start erasing sector(s) of the Memory Technology Device (MTD),
+     *          optional
+     *
+     * Same constraints as mtd_desc::erase, see mtd_desc::write_async.
+     *
+     * @param[in] dev       Pointer to the selected driver
+     * @param[in] op        Operation to start
+     *
+     * @return 0 if the operation was started
+     * @return < 0 value on error, the callback is not called
+     */
+    int (*erase_async)(mtd_dev_t *dev, mtd_async_t *op);
+#endif
 };
 
 /**
@@ -231,6 +288,21 @@ int mtd_erase(mtd_dev_t *mtd, uint32_t addr, uint32_t count);
  */
 int mtd_power(mtd_dev_t *mtd, enum mtd_power_state power);
 
+/**
+ * @brief   Write back data buffered by a MTD device
+ *
+ * File systems call this whenever they need written data to be persistent,
+ * e.g. on a sync request or before unmounting.
+ *
+ * @param      mtd   the device to flush
+ *
+ * @return 0 on success, also if @p mtd does not buffer writes
+ * @return < 0 if an error occured
+ * @return -ENODEV if @p mtd is not a valid device
+ * @return -EIO if I/O error occured
+ */
+int mtd_flush(mtd_dev_t *mtd);
+
 #if defined(MODULE_VFS) || defined(DOXYGEN)
 /**
  * @brief   MTD driver for VFS
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     drivers_mtd
+ * @{
+ *
+ * @file
+ * @brief       Asynchronous MTD operations
+ *
+ * Enabled by the `mtd_async` module. An operation is processed by the thread
+ * serving an @ref event_queue_t, which may be the calling thread. Drivers
+ * implementing mtd_desc::write_async or mtd_desc::erase_async only occupy
+ * that thread for bus transfers and wait for the device with a timeout. For
+ * other operations that thread runs the synchronous function. Only one
+ * operation may run on a device at a time.
+ *
+ * Drivers only implementing asynchronous functions can be used with the
+ * synchronous API, the calling thread then serves a private queue until the
+ * operation is done.
+ */
+
+#ifndef MTD_ASYNC_H
+#define MTD_ASYNC_H
+
+#include <stdint.h>
+
+#include "event/timeout.h"
+#include "mtd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Completion callback of an asynchronous MTD operation
+ *
+ * @param[in] arg   argument given to @ref mtd_async_init
+ * @param[in] res   result, as the corresponding synchronous function
+ *                  returns it
+ */
+typedef void (*mtd_async_cb_t)(void *arg, int res);
+
+/**
+ * @brief   Asynchronous MTD operation
+ *
+ * Set up once with @ref mtd_async_init, then started with one of
+ * @ref mtd_read_async, @ref mtd_write_async or @ref mtd_erase_async. The
+ * operation is processed by the thread serving mtd_async_t::queue, which
+ * also calls the callback. It must not be modified until the callback was
+ * called and can be started again afterwards.
+ */
+struct mtd_async {
+    event_t event;              /**< event processing the operation */
+    event_timeout_t timeout;    /**< timeout posting mtd_async_t::event */
+    event_queue_t *queue;       /**< queue processing the operation */
+    mtd_async_cb_t cb;          /**< completion callback */
+    void *arg;                  /**< argument of the callback */
+    mtd_dev_t *mtd;             /**< device of the running operation */
+    void *buf;                  /**< data buffer of a read or write */
+    uint32_t addr;              /**< start address */
+    uint32_t size;              /**< number of bytes */
+    uint32_t pos;               /**< driver private: bytes processed */
+    uint32_t wait;              /**< driver private: poll interval */
+    uint8_t op;                 /**< type of operation, internal */
+};
+
+/**
+ * @brief   Set up an asynchronous MTD operation
+ *
+ * @param[out] op       the operation to set up
+ * @param[in]  queue    queue processing the operation
+ * @param[in]  cb       completion callback
+ * @param[in]  arg      argument of @p cb
+ */
+void mtd_async_init(mtd_async_t *op, event_queue_t *queue,
+                    mtd_async_cb_t cb, void *arg);
+
+/**
+ * @brief   Read data from a MTD device without blocking
+ *
+ * The data is read by the thread serving the queue of @p op, see
+ * @ref mtd_read for the result passed to the callback.
+ *
+ * @param      mtd   the device to read from
+ * @param      op    the operation, set up with @ref mtd_async_init
+ * @param[out] dest  the buffer to fill in, must stay valid until completion
+ * @param[in]  addr  the start address to read from
+ * @param[in]  count the number of bytes to read
+ *
+ * @return 0 if the operation was started
+ * @return -ENODEV if @p mtd is not a valid device
+ */
+int mtd_read_async(mtd_dev_t *mtd, mtd_async_t *op, void *dest, uint32_t addr,
+                   uint32_t count);
+
+/**
+ * @brief   Write data to a MTD device without blocking
+ *
+ * See @ref mtd_write for the constraints and the result passed to the
+ * callback.
+ *
+ * @param      mtd   the device to write to
+ * @param      op    the operation, set up with @ref mtd_async_init
+ * @param[in]  src   the buffer to write, must stay valid until completion
+ * @param[in]  addr  the start address to write to
+ * @param[in]  count the number of bytes to write
+ *
+ * @return 0 if the operation was started
+ * @return < 0 if the operation could not be started, the callback is not
+ *         called
+ * @return -ENODEV if @p mtd is not a valid device
+ * @return -EBUSY if another operation is running on @p mtd
+ */
+int mtd_write_async(mtd_dev_t *mtd, mtd_async_t *op, const void *src,
+                    uint32_t addr, uint32_t count);
+
+/**
+ * @brief   Erase sectors of a MTD device without blocking
+ *
+ * See @ref mtd_erase for the constraints and the result passed to the
+ * callback.
+ *
+ * @param      mtd   the device to erase
+ * @param      op    the operation, set up with @ref mtd_async_init
+ * @param[in]  addr  the address of the first sector to erase
+ * @param[in]  count the number of bytes to erase
+ *
+ * @return 0 if the operation was started
+ * @return < 0 if the operation could not be started, the callback is not
+ *         called
+ * @return -ENODEV if @p mtd is not a valid device
+ * @return -EOVERFLOW if @p addr or @p count are not valid
+ * @return -EBUSY if another operation is running on @p mtd
+ */
+int mtd_erase_async(mtd_dev_t *mtd, mtd_async_t *op, uint32_t addr,
+                    uint32_t count);
+
+/**
+ * @brief   Finish an asynchronous operation, for use by drivers
+ *
+ * @param[in] op    the finished operation
+ * @param[in] res   result of the operation
+ */
+void mtd_async_done(mtd_async_t *op, int res);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MTD_ASYNC_H */
+/** @} */
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    drivers_mtd_cache MTD read cache and write coalescing
+ * @ingroup     drivers_storage
+ * @brief       Stackable MTD device caching accesses to another MTD device
+ *
+ * File systems like littlefs or spiffs access their storage in small,
+ * mostly page sized chunks, each resulting in a transaction on the bus of
+ * the underlying device. mtd_cache wraps any @ref mtd_dev_t and
+ *
+ * - keeps the @ref MTD_CACHE_LINES least recently used lines of
+ *   @ref MTD_CACHE_LINE_SIZE bytes in RAM,
+ * - reads @ref MTD_CACHE_READAHEAD lines with a single call when a miss
+ *   follows an access to the preceding line,
+ * - passes reads of whole uncached lines directly to the parent, so that
+ *   bulk reads do not evict the cache,
+ * - merges writes continuing a pending write into one program operation
+ *   per page of the parent.
+ *
+ * The parent device is set up in the initializer and initialized by
+ * @ref mtd_init on the cache device:
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~{.c}
+ * static mtd_cache_t mtd0_cached = {
+ *     .base.driver = &mtd_cache_driver,
+ *     .parent = MTD_0,
+ * };
+ * ~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * Writes not covering a whole page are acknowledged once they are buffered.
+ * A pending write is programmed when it completes its page, before any
+ * access touching its line, before any erase, when the device is powered
+ * down, when a write not continuing it arrives, or when
+ * @ref mtd_cache_flush or @ref mtd_flush is called. An error of the deferred
+ * program operation is returned by the operation causing it.
+ *
+ * @warning Until then, a partial page write exists in RAM only and is lost on
+ *          reset or power loss. The littlefs, spiffs and FatFs glue call
+ *          @ref mtd_flush on sync, close or unmount. Any other user of the
+ *          cache must call @ref mtd_flush itself before relying on the data
+ *          being stored.
+ *
+ * @note    Lines are invalidated when they are written to, so the cache
+ *          makes no assumption on the programming semantics of the parent.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Interface definition for the mtd_cache device
+ */
+
+#ifndef MTD_CACHE_H
+#define MTD_CACHE_H
+
+#include <stdint.h>
+
+#include "mtd.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief   Size of a cache line in bytes
+ *
+ * Must be a multiple of the page size of the parent device.
+ */
+#ifndef MTD_CACHE_LINE_SIZE
+#define MTD_CACHE_LINE_SIZE         (256U)
+#endif
+
+/**
+ * @brief   Number of cached lines
+ */
+#ifndef MTD_CACHE_LINES
+#define MTD_CACHE_LINES             (4U)
+#endif
+
+/**
+ * @brief   Number of lines fetched on a sequential miss
+ *
+ * Must not exceed @ref MTD_CACHE_LINES, 1 disables read-ahead.
+ */
+#ifndef MTD_CACHE_READAHEAD
+#define MTD_CACHE_READAHEAD         (2U)
+#endif
+
+/**
+ * @brief   Cache statistics
+ */
+typedef struct {
+    uint32_t read_hits;         /**< lines read from the cache */
+    uint32_t read_misses;       /**< lines read from the parent */
+    uint32_t read_ahead;        /**< lines fetched ahead of a miss */
+    uint32_t write_merged;      /**< writes merged into a pending write */
+    uint32_t dev_reads;         /**< read calls to the parent */
+    uint32_t dev_writes;        /**< write calls to the parent */
+    uint32_t dev_erases;        /**< erase calls to the parent */
+} mtd_cache_stats_t;
+
+/**
+ * @brief   Device descriptor for mtd_cache device
+ *
+ * This is an extension of the @c mtd_dev_t struct
+ */
+typedef struct {
+    mtd_dev_t base;                     /**< inherit from mtd_dev_t object */
+    mtd_dev_t *parent;                  /**< cached device */
+    uint32_t stamp;                     /**< LRU clock */
+    uint32_t next_line;                 /**< line following the last access */
+    uint32_t line[MTD_CACHE_LINES];     /**< cached line numbers */
+    uint32_t used[MTD_CACHE_LINES];     /**< LRU clock of last use */
+    /** cached data, lines of a read-ahead are adjacent */
+    uint8_t data[MTD_CACHE_LINES][MTD_CACHE_LINE_SIZE];
+    uint32_t wr_line;                   /**< line of the pending write */
+    uint16_t wr_start;                  /**< pending write start in line */
+    uint16_t wr_end;                    /**< pending write end in line */
+    uint8_t wr_buf[MTD_CACHE_LINE_SIZE]; /**< pending write data */
+    mtd_cache_stats_t stats;            /**< cache statistics, cumulative */
+} mtd_cache_t;
+
+/**
+ * @brief   mtd_cache device operations table for mtd
+ */
+extern const mtd_desc_t mtd_cache_driver;
+
+/**
+ * @brief   Program the pending write, if any, to the parent device
+ *
+ * @param[in] cache     the cache device
+ *
+ * @return 0 on success
+ * @return < 0 error returned by the parent device
+ */
+int mtd_cache_flush(mtd_cache_t *cache);
+
+/**
+ * @brief   Drop all cached lines
+ *
+ * Must be called if the parent device was modified bypassing the cache.
+ * A pending write is kept.
+ *
+ * @param[in] cache     the cache device
+ */
+void mtd_cache_invalidate(mtd_cache_t *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MTD_CACHE_H */
+/** @} */
@@ -82,6 +82,43 @@ typedef struct __attribute__((packed)) {
  * @brief   Flag to set when the device support 32KiB block erase (block_erase_32k opcode)
  */
 #define SPI_NOR_F_SECT_32K  (2)
+/**
+ * @brief   Flag to set to read with the read_fast opcode
+ *
+ * Fast read inserts 8 dummy cycles after the address, most devices require
+ * it for clock speeds above 30 - 50 MHz.
+ */
+#define SPI_NOR_F_FAST_READ (4)
+
+/**
+ * @name    Typical duration of operations
+ *
+ * Without xtimer the driver yields until the device is ready. With xtimer it
+ * sleeps for the typical duration of the operation before polling the status
+ * register, then polls in intervals of an eighth of it, but not shorter than
+ * @ref MTD_SPI_NOR_WAIT_MIN_US. Defaults are typical values of common 16 -
+ * 128 MBit parts.
+ * @{
+ */
+#ifndef MTD_SPI_NOR_WAIT_PAGE_PROGRAM_US
+#define MTD_SPI_NOR_WAIT_PAGE_PROGRAM_US    (500U)      /**< page program */
+#endif
+#ifndef MTD_SPI_NOR_WAIT_4K_ERASE_US
+#define MTD_SPI_NOR_WAIT_4K_ERASE_US        (40000LU)   /**< 4 KiB sector erase */
+#endif
+#ifndef MTD_SPI_NOR_WAIT_32K_ERASE_US
+#define MTD_SPI_NOR_WAIT_32K_ERASE_US       (120000LU)  /**< 32 KiB block erase */
+#endif
+#ifndef MTD_SPI_NOR_WAIT_BLOCK_ERASE_US
+#define MTD_SPI_NOR_WAIT_BLOCK_ERASE_US     (150000LU)  /**< block erase */
+#endif
+#ifndef MTD_SPI_NOR_WAIT_CHIP_ERASE_US
+#define MTD_SPI_NOR_WAIT_CHIP_ERASE_US      (3000000LU) /**< chip erase */
+#endif
+#ifndef MTD_SPI_NOR_WAIT_MIN_US
+#define MTD_SPI_NOR_WAIT_MIN_US             (50U)       /**< shortest sleep */
+#endif
+/** @} */
 
 /**
  * @brief   Device descriptor for serial flash memory devices
@@ -122,6 +159,14 @@ typedef struct {
      * Computed by mtd_spi_nor_init, no need to touch outside the driver.
      */
     uint8_t sec_addr_shift;
+#if defined(MODULE_MTD_ASYNC) || defined(DOXYGEN)
+    /**
+     * @brief   asynchronous operation in progress, if any
+     *
+     * Synchronous operations fail with -EBUSY while it is set.
+     */
+    mtd_async_t *async;
+#endif
 } mtd_spi_nor_t;
 
 /**
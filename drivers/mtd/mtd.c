@@ -19,9 +19,58 @@
  */
 
 #include <errno.h>
+#include <stdbool.h>
 
 #include "mtd.h"
 
+#ifdef MODULE_MTD_ASYNC
+#include "kernel_defines.h"
+#include "mtd_async.h"
+
+enum {
+    MTD_ASYNC_READ,
+    MTD_ASYNC_WRITE,
+    MTD_ASYNC_ERASE,
+};
+
+typedef struct {
+    int res;
+    bool done;
+} _sync_state_t;
+
+static void _sync_done(void *arg, int res)
+{
+    _sync_state_t *state = arg;
+
+    state->res = res;
+    state->done = true;
+}
+
+/* runs an asynchronous operation of a driver lacking the synchronous one
+ * with a queue served by the calling thread */
+static int _sync_from_async(mtd_dev_t *mtd, mtd_async_t *op,
+                            int (*start)(mtd_dev_t *, mtd_async_t *))
+{
+    event_queue_t queue;
+    _sync_state_t state = { .done = false };
+
+    event_queue_init(&queue);
+    mtd_async_init(op, &queue, _sync_done, &state);
+    op->mtd = mtd;
+
+    int res = start(mtd, op);
+    if (res < 0) {
+        return res;
+    }
+    while (!state.done) {
+        event_t *event = event_wait(&queue);
+        event->handler(event);
+    }
+
+    return state.res;
+}
+#endif
+
 int mtd_init(mtd_dev_t *mtd)
 {
     if (!mtd || !mtd->driver) {
@@ -59,6 +108,13 @@ int mtd_write(mtd_dev_t *mtd, const void *src, uint32_t addr, uint32_t count)
     if (mtd->driver->write) {
         return mtd->driver->write(mtd, src, addr, count);
     }
+#ifdef MODULE_MTD_ASYNC
+    else if (mtd->driver->write_async) {
+        mtd_async_t op = { .buf = (void *)src, .addr = addr, .size = count,
+                           .op = MTD_ASYNC_WRITE };
+        return _sync_from_async(mtd, &op, mtd->driver->write_async);
+    }
+#endif
     else {
         return -ENOTSUP;
     }
@@ -73,6 +129,12 @@ int mtd_erase(mtd_dev_t *mtd, uint32_t addr, uint32_t count)
     if (mtd->driver->erase) {
         return mtd->driver->erase(mtd, addr, count);
     }
+#ifdef MODULE_MTD_ASYNC
+    else if (mtd->driver->erase_async) {
+        mtd_async_t op = { .addr = addr, .size = count, .op = MTD_ASYNC_ERASE };
+        return _sync_from_async(mtd, &op, mtd->driver->erase_async);
+    }
+#endif
     else {
         return -ENOTSUP;
     }
@@ -92,4 +154,111 @@ int mtd_power(mtd_dev_t *mtd, enum mtd_power_state power)
     }
 }
 
+int mtd_flush(mtd_dev_t *mtd)
+{
+    if (!mtd || !mtd->driver) {
+        return -ENODEV;
+    }
+
+    if (mtd->driver->flush) {
+        return mtd->driver->flush(mtd);
+    }
+    else {
+        return 0;
+    }
+}
+
+#ifdef MODULE_MTD_ASYNC
+/* processes an operation the driver has no asynchronous function for */
+static void _async_sync_handler(event_t *event)
+{
+    mtd_async_t *op = container_of(event, mtd_async_t, event);
+    int res;
+
+    switch (op->op) {
+        case MTD_ASYNC_READ:
+            res = mtd_read(op->mtd, op->buf, op->addr, op->size);
+            break;
+        case MTD_ASYNC_WRITE:
+            res = mtd_write(op->mtd, op->buf, op->addr, op->size);
+            break;
+        default:
+            res = mtd_erase(op->mtd, op->addr, op->size);
+            break;
+    }
+    mtd_async_done(op, res);
+}
+
+static int _async_start(mtd_dev_t *mtd, mtd_async_t *op,
+                        int (*start)(mtd_dev_t *, mtd_async_t *))
+{
+    op->mtd = mtd;
+    op->pos = 0;
+
+    if (start) {
+        return start(mtd, op);
+    }
+
+    op->event.handler = _async_sync_handler;
+    event_post(op->queue, &op->event);
+    return 0;
+}
+
+void mtd_async_init(mtd_async_t *op, event_queue_t *queue,
+                    mtd_async_cb_t cb, void *arg)
+{
+    op->event.list_node.next = NULL;
+    op->queue = queue;
+    op->cb = cb;
+    op->arg = arg;
+    event_timeout_init(&op->timeout, queue, &op->event);
+}
+
+int mtd_read_async(mtd_dev_t *mtd, mtd_async_t *op, void *dest, uint32_t addr,
+                   uint32_t count)
+{
+    if (!mtd || !mtd->driver) {
+        return -ENODEV;
+    }
+
+    op->buf = dest;
+    op->addr = addr;
+    op->size = count;
+    op->op = MTD_ASYNC_READ;
+    return _async_start(mtd, op, NULL);
+}
+
+int mtd_write_async(mtd_dev_t *mtd, mtd_async_t *op, const void *src,
+                    uint32_t addr, uint32_t count)
+{
+    if (!mtd || !mtd->driver) {
+        return -ENODEV;
+    }
+
+    op->buf = (void *)src;
+    op->addr = addr;
+    op->size = count;
+    op->op = MTD_ASYNC_WRITE;
+    return _async_start(mtd, op, mtd->driver->write_async);
+}
+
+int mtd_erase_async(mtd_dev_t *mtd, mtd_async_t *op, uint32_t addr,
+                    uint32_t count)
+{
+    if (!mtd || !mtd->driver) {
+        return -ENODEV;
+    }
+
+    op->addr = addr;
+    op->size = count;
+    op->op = MTD_ASYNC_ERASE;
+    return _async_start(mtd, op, mtd->driver->erase_async);
+}
+
+void mtd_async_done(mtd_async_t *op, int res)
+{
+    op->cb(op->arg, res);
+}
+#endif
+
 /** @} */
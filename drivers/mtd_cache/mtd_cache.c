@@ -0,0 +1,361 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     drivers_mtd_cache
+ * @{
+ *
+ * @file
+ * @brief       Read cache and write coalescing for mtd devices
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "mtd.h"
+#include "mtd_cache.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#if MTD_CACHE_READAHEAD > MTD_CACHE_LINES
+#error "mtd_cache: MTD_CACHE_READAHEAD must not exceed MTD_CACHE_LINES"
+#endif
+
+#define LINE_INVALID    (UINT32_MAX)
+
+static inline uint32_t _size(const mtd_dev_t *dev)
+{
+    return dev->sector_count * dev->pages_per_sector * dev->page_size;
+}
+
+static int _lookup(const mtd_cache_t *cache, uint32_t line)
+{
+    for (unsigned i = 0; i < MTD_CACHE_LINES; i++) {
+        if (cache->line[i] == line) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* reads up to n lines starting at line into adjacent slots, returns the slot
+ * of line */
+static int _fetch(mtd_cache_t *cache, uint32_t line, unsigned n)
+{
+    uint32_t size = _size(&cache->base);
+    uint32_t addr = line * MTD_CACHE_LINE_SIZE;
+
+    /* don't read ahead past the end of the device, into cached lines or into
+     * the line of a pending write, whose data isn't on the device yet */
+    for (unsigned i = 1; i < n; i++) {
+        if ((addr + i * MTD_CACHE_LINE_SIZE >= size) ||
+            (_lookup(cache, line + i) >= 0) || (line + i == cache->wr_line)) {
+            n = i;
+            break;
+        }
+    }
+
+    /* evict the n adjacent slots whose most recent use is the oldest */
+    unsigned slot = 0;
+    uint32_t oldest = UINT32_MAX;
+    for (unsigned s = 0; s + n <= MTD_CACHE_LINES; s++) {
+        uint32_t newest = 0;
+        for (unsigned i = s; i < s + n; i++) {
+            if (cache->used[i] > newest) {
+                newest = cache->used[i];
+            }
+        }
+        if (newest < oldest) {
+            oldest = newest;
+            slot = s;
+        }
+    }
+
+    uint32_t len = n * MTD_CACHE_LINE_SIZE;
+    if (len > size - addr) {
+        len = size - addr;
+    }
+
+    DEBUG("mtd_cache: fetch line %" PRIu32 " (+%u) into slot %u\n",
+          line, n - 1, slot);
+
+    for (unsigned i = slot; i < slot + n; i++) {
+        cache->line[i] = LINE_INVALID;
+    }
+    cache->stats.dev_reads++;
+    int res = mtd_read(cache->parent, cache->data[slot], addr, len);
+    if (res < 0) {
+        return res;
+    }
+
+    cache->stamp++;
+    for (unsigned i = 0; i < n; i++) {
+        cache->line[slot + i] = line + i;
+        cache->used[slot + i] = cache->stamp;
+    }
+    cache->stats.read_ahead += n - 1;
+
+    return slot;
+}
+
+int mtd_cache_flush(mtd_cache_t *cache)
+{
+    if (cache->wr_line == LINE_INVALID) {
+        return 0;
+    }
+
+    uint32_t addr = cache->wr_line * MTD_CACHE_LINE_SIZE + cache->wr_start;
+
+    DEBUG("mtd_cache: flush 0x%" PRIx32 " count %u\n", addr,
+          cache->wr_end - cache->wr_start);
+
+    /* cached data of the line predates the write */
+    int slot = _lookup(cache, cache->wr_line);
+    if (slot >= 0) {
+        cache->line[slot] = LINE_INVALID;
+        cache->used[slot] = 0;
+    }
+
+    /* a pending write never spans two pages, it is flushed when complete */
+    cache->wr_line = LINE_INVALID;
+    cache->stats.dev_writes++;
+    int res = mtd_write(cache->parent, &cache->wr_buf[cache->wr_start], addr,
+                        cache->wr_end - cache->wr_start);
+
+    return (res < 0) ? res : 0;
+}
+
+void mtd_cache_invalidate(mtd_cache_t *cache)
+{
+    for (unsigned i = 0; i < MTD_CACHE_LINES; i++) {
+        cache->line[i] = LINE_INVALID;
+        cache->used[i] = 0;
+    }
+    cache->next_line = LINE_INVALID;
+}
+
+static int _init(mtd_dev_t *dev)
+{
+    mtd_cache_t *cache = (mtd_cache_t *)dev;
+    mtd_dev_t *parent = cache->parent;
+    int res;
+
+    /* file systems initialize the device on every mount */
+    if (dev->page_size) {
+        res = mtd_cache_flush(cache);
+        if (res < 0) {
+            return res;
+        }
+    }
+
+    res = mtd_init(parent);
+    if (res < 0) {
+        return res;
+    }
+    if (!parent->page_size || (MTD_CACHE_LINE_SIZE % parent->page_size)) {
+        return -ENOTSUP;
+    }
+
+    dev->sector_count = parent->sector_count;
+    dev->pages_per_sector = parent->pages_per_sector;
+    dev->page_size = parent->page_size;
+
+    cache->stamp = 0;
+    cache->wr_line = LINE_INVALID;
+    mtd_cache_invalidate(cache);
+
+    return 0;
+}
+
+static int _read(mtd_dev_t *dev, void *buff, uint32_t addr, uint32_t size)
+{
+    mtd_cache_t *cache = (mtd_cache_t *)dev;
+    uint32_t mtd_size = _size(dev);
+    uint8_t *dst = buff;
+
+    DEBUG("mtd_cache: read from 0x%" PRIx32 " count %" PRIu32 "\n", addr, size);
+
+    if ((addr > mtd_size) || (size > mtd_size - addr)) {
+        return -EOVERFLOW;
+    }
+    if (!size) {
+        return 0;
+    }
+
+    uint32_t end = addr + size;
+    if ((cache->wr_line >= addr / MTD_CACHE_LINE_SIZE) &&
+        (cache->wr_line <= (end - 1) / MTD_CACHE_LINE_SIZE)) {
+        int res = mtd_cache_flush(cache);
+        if (res < 0) {
+            return res;
+        }
+    }
+
+    while (addr < end) {
+        uint32_t line = addr / MTD_CACHE_LINE_SIZE;
+        uint32_t off = addr % MTD_CACHE_LINE_SIZE;
+        uint32_t len = MTD_CACHE_LINE_SIZE - off;
+        if (len > end - addr) {
+            len = end - addr;
+        }
+
+        int slot = _lookup(cache, line);
+        if ((slot < 0) && (len == MTD_CACHE_LINE_SIZE)) {
+            /* read a run of whole uncached lines without caching them */
+            uint32_t run = MTD_CACHE_LINE_SIZE;
+            while ((end - (addr + run) >= MTD_CACHE_LINE_SIZE) &&
+                   (_lookup(cache, line + run / MTD_CACHE_LINE_SIZE) < 0)) {
+                run += MTD_CACHE_LINE_SIZE;
+            }
+            cache->stats.read_misses += run / MTD_CACHE_LINE_SIZE;
+            cache->stats.dev_reads++;
+            int res = mtd_read(cache->parent, dst, addr, run);
+            if (res < 0) {
+                return res;
+            }
+            cache->next_line = line + run / MTD_CACHE_LINE_SIZE;
+            dst += run;
+            addr += run;
+            continue;
+        }
+
+        if (slot < 0) {
+            cache->stats.read_misses++;
+            slot = _fetch(cache, line, (line == cache->next_line)
+                                       ? MTD_CACHE_READAHEAD : 1);
+            if (slot < 0) {
+                return slot;
+            }
+        }
+        else {
+            cache->stats.read_hits++;
+            cache->used[slot] = ++cache->stamp;
+        }
+
+        memcpy(dst, &cache->data[slot][off], len);
+        cache->next_line = line + 1;
+        dst += len;
+        addr += len;
+    }
+
+    return size;
+}
+
+static int _write(mtd_dev_t *dev, const void *buff, uint32_t addr, uint32_t size)
+{
+    mtd_cache_t *cache = (mtd_cache_t *)dev;
+    uint32_t mtd_size = _size(dev);
+
+    DEBUG("mtd_cache: write to 0x%" PRIx32 " count %" PRIu32 "\n", addr, size);
+
+    if ((addr > mtd_size) || (size > mtd_size - addr)) {
+        return -EOVERFLOW;
+    }
+    if (((addr % dev->page_size) + size) > dev->page_size) {
+        return -EOVERFLOW;
+    }
+    if (!size) {
+        return 0;
+    }
+
+    uint32_t line = addr / MTD_CACHE_LINE_SIZE;
+    uint32_t off = addr % MTD_CACHE_LINE_SIZE;
+
+    /* written data is not tracked, the parent knows what programming does */
+    int slot = _lookup(cache, line);
+    if (slot >= 0) {
+        cache->line[slot] = LINE_INVALID;
+        cache->used[slot] = 0;
+    }
+
+    if ((cache->wr_line == line) && (cache->wr_end == off)) {
+        cache->stats.write_merged++;
+    }
+    else {
+        int res = mtd_cache_flush(cache);
+        if (res < 0) {
+            return res;
+        }
+        if (size == dev->page_size) {
+            /* nothing to merge into a whole page */
+            cache->stats.dev_writes++;
+            return mtd_write(cache->parent, buff, addr, size);
+        }
+        cache->wr_line = line;
+        cache->wr_start = off;
+        cache->wr_end = off;
+    }
+
+    memcpy(&cache->wr_buf[off], buff, size);
+    cache->wr_end += size;
+
+    if ((cache->wr_end % dev->page_size) == 0) {
+        int res = mtd_cache_flush(cache);
+        if (res < 0) {
+            return res;
+        }
+    }
+
+    return size;
+}
+
+static int _erase(mtd_dev_t *dev, uint32_t addr, uint32_t size)
+{
+    mtd_cache_t *cache = (mtd_cache_t *)dev;
+
+    DEBUG("mtd_cache: erase from 0x%" PRIx32 " count %" PRIu32 "\n", addr, size);
+
+    int res = mtd_cache_flush(cache);
+    if (res < 0) {
+        return res;
+    }
+
+    for (unsigned i = 0; i < MTD_CACHE_LINES; i++) {
+        uint32_t start = cache->line[i] * MTD_CACHE_LINE_SIZE;
+        if ((cache->line[i] != LINE_INVALID) &&
+            (start < addr + size) && (start + MTD_CACHE_LINE_SIZE > addr)) {
+            cache->line[i] = LINE_INVALID;
+            cache->used[i] = 0;
+        }
+    }
+
+    cache->stats.dev_erases++;
+    return mtd_erase(cache->parent, addr, size);
+}
+
+static int _power(mtd_dev_t *dev, enum mtd_power_state power)
+{
+    mtd_cache_t *cache = (mtd_cache_t *)dev;
+
+    if (power == MTD_POWER_DOWN) {
+        int res = mtd_cache_flush(cache);
+        if (res < 0) {
+            return res;
+        }
+    }
+
+    return mtd_power(cache->parent, power);
+}
+
+static int _flush(mtd_dev_t *dev)
+{
+    return mtd_cache_flush((mtd_cache_t *)dev);
+}
+
+const mtd_desc_t mtd_cache_driver = {
+    .init = _init,
+    .read = _read,
+    .write = _write,
+    .erase = _erase,
+    .power = _power,
+    .flush = _flush,
+};
@@ -32,7 +32,12 @@
 #include "thread.h"
 #endif
 #include "byteorder.h"
+#include "kernel_defines.h"
 #include "mtd_spi_nor.h"
+#if MODULE_MTD_ASYNC
+#include "irq.h"
+#include "mtd_async.h"
+#endif
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
@@ -44,9 +49,7 @@
 #define TRACE(...)
 #endif
 
-#ifndef MTD_SPI_NOR_WRITE_WAIT_US
-#define MTD_SPI_NOR_WRITE_WAIT_US (50 * US_PER_MS)
-#endif
+#define SPI_NOR_STATUS_WIP  (1)   /**< write in progress */
 
 #define MTD_32K             (32768ul)
 #define MTD_32K_ADDR_MASK   (0x7FFF)
@@ -58,6 +61,10 @@ static int mtd_spi_nor_read(mtd_dev_t *mtd, void *dest, uint32_t addr, uint32_t
 static int mtd_spi_nor_write(mtd_dev_t *mtd, const void *src, uint32_t addr, uint32_t size);
 static int mtd_spi_nor_erase(mtd_dev_t *mtd, uint32_t addr, uint32_t size);
 static int mtd_spi_nor_power(mtd_dev_t *mtd, enum mtd_power_state power);
+#if MODULE_MTD_ASYNC
+static int mtd_spi_nor_write_async(mtd_dev_t *mtd, mtd_async_t *op);
+static int mtd_spi_nor_erase_async(mtd_dev_t *mtd, mtd_async_t *op);
+#endif
 
 const mtd_desc_t mtd_spi_nor_driver = {
     .init = mtd_spi_nor_init,
@@ -65,6 +72,10 @@ const mtd_desc_t mtd_spi_nor_driver = {
     .write = mtd_spi_nor_write,
     .erase = mtd_spi_nor_erase,
     .power = mtd_spi_nor_power,
+#if MODULE_MTD_ASYNC
+    .write_async = mtd_spi_nor_write_async,
+    .erase_async = mtd_spi_nor_erase_async,
+#endif
 };
 
 /**
@@ -74,15 +85,17 @@ const mtd_desc_t mtd_spi_nor_driver = {
  * @param[in]  dev    pointer to device descriptor
  * @param[in]  opcode command opcode
  * @param[in]  addr   address (big endian)
+ * @param[in]  dummy  number of dummy bytes to send after the address
  * @param[out] dest   read buffer
  * @param[in]  count  number of bytes to read after the address has been sent
  */
 static void mtd_spi_cmd_addr_read(const mtd_spi_nor_t *dev, uint8_t opcode,
-                                  be_uint32_t addr, void *dest, uint32_t count)
+                                  be_uint32_t addr, uint8_t dummy,
+                                  void *dest, uint32_t count)
 {
-    TRACE("mtd_spi_cmd_addr_read: %p, %02x, (%02x %02x %02x %02x), %p, %" PRIu32 "\n",
+    TRACE("mtd_spi_cmd_addr_read: %p, %02x, (%02x %02x %02x %02x), %u, %p, %" PRIu32 "\n",
           (void *)dev, (unsigned int)opcode, addr.u8[0], addr.u8[1], addr.u8[2],
-          addr.u8[3], dest, count);
+          addr.u8[3], (unsigned int)dummy, dest, count);
 
     uint8_t *addr_buf = &addr.u8[4 - dev->addr_width];
     if (ENABLE_TRACE) {
@@ -97,6 +110,9 @@ static void mtd_spi_cmd_addr_read(const mtd_spi_nor_t *dev, uint8_t opcode,
         /* Send opcode followed by address */
         spi_transfer_byte(dev->spi, dev->cs, true, opcode);
         spi_transfer_bytes(dev->spi, dev->cs, true, (char *)addr_buf, NULL, dev->addr_width);
+        while (dummy--) {
+            spi_transfer_byte(dev->spi, dev->cs, true, 0);
+        }
 
         /* Read data */
         spi_transfer_bytes(dev->spi, dev->cs, false, NULL, dest, count);
@@ -256,18 +272,37 @@ static int mtd_spi_read_jedec_id(const mtd_spi_nor_t *dev, mtd_jedec_id_t *out)
     return status;
 }
 
-static inline void wait_for_write_complete(const mtd_spi_nor_t *dev)
+/**
+ * @internal
+ * @brief Wait until the device finished a program or erase operation
+ *
+ * @param[in]  dev    pointer to device descriptor
+ * @param[in]  us     typical duration of the operation
+ */
+static void wait_for_write_complete(const mtd_spi_nor_t *dev, uint32_t us)
 {
+#if MODULE_XTIMER
+    /* the device is busy for about the typical duration, after that poll
+     * in steps of an eighth of it */
+    xtimer_usleep(us);
+    us /= 8;
+    if (us < MTD_SPI_NOR_WAIT_MIN_US) {
+        us = MTD_SPI_NOR_WAIT_MIN_US;
+    }
+#else
+    (void)us;
+#endif
+
     do {
         uint8_t status;
         mtd_spi_cmd_read(dev, dev->opcode->rdsr, &status, sizeof(status));
 
         TRACE("mtd_spi_nor: wait device status = 0x%02x\n", (unsigned int)status);
-        if ((status & 1) == 0) { /* TODO magic number */
+        if ((status & SPI_NOR_STATUS_WIP) == 0) {
             break;
         }
 #if MODULE_XTIMER
-        xtimer_usleep(MTD_SPI_NOR_WRITE_WAIT_US);
+        xtimer_usleep(us);
 #else
         thread_yield();
 #endif
@@ -359,39 +394,38 @@ static int mtd_spi_nor_read(mtd_dev_t *mtd, void *dest, uint32_t addr, uint32_t
     if (addr > chipsize) {
         return -EOVERFLOW;
     }
-    if (size > mtd->page_size) {
-        size = mtd->page_size;
-    }
     if ((addr + size) > chipsize) {
         size = chipsize - addr;
     }
-    uint32_t page_addr_mask = dev->page_addr_mask;
-    if ((addr & page_addr_mask) != ((addr + size - 1) & page_addr_mask)) {
-        /* Reads across page boundaries must be split */
-        size = mtd->page_size - (addr & ~(page_addr_mask));
-    }
     if (size == 0) {
         return 0;
     }
+#if MODULE_MTD_ASYNC
+    if (dev->async) {
+        return -EBUSY;
+    }
+#endif
     be_uint32_t addr_be = byteorder_htonl(addr);
 
+    /* the address counter wraps only at the end of the chip, so the whole
+     * range is read in a single transaction */
     spi_acquire(dev->spi, dev->cs, dev->mode, dev->clk);
-    mtd_spi_cmd_addr_read(dev, dev->opcode->read, addr_be, dest, size);
+    if (dev->flag & SPI_NOR_F_FAST_READ) {
+        mtd_spi_cmd_addr_read(dev, dev->opcode->read_fast, addr_be, 1, dest, size);
+    }
+    else {
+        mtd_spi_cmd_addr_read(dev, dev->opcode->read, addr_be, 0, dest, size);
+    }
     spi_release(dev->spi);
 
     return size;
 }
 
-static int mtd_spi_nor_write(mtd_dev_t *mtd, const void *src, uint32_t addr, uint32_t size)
+static int _check_write(const mtd_spi_nor_t *dev, uint32_t addr, uint32_t size)
 {
+    const mtd_dev_t *mtd = &dev->base;
     uint32_t total_size = mtd->page_size * mtd->pages_per_sector * mtd->sector_count;
 
-    DEBUG("mtd_spi_nor_write: %p, %p, 0x%" PRIx32 ", 0x%" PRIx32 "\n",
-          (void *)mtd, src, addr, size);
-    if (size == 0) {
-        return 0;
-    }
-    const mtd_spi_nor_t *dev = (mtd_spi_nor_t *)mtd;
     if (size > mtd->page_size) {
         DEBUG("mtd_spi_nor_write: ERR: page program >1 page (%" PRIu32 ")!\n", mtd->page_size);
         return -EOVERFLOW;
@@ -404,27 +438,13 @@ static int mtd_spi_nor_write(mtd_dev_t *mtd, const void *src, uint32_t addr, uin
     if (addr + size > total_size) {
         return -EOVERFLOW;
     }
-    be_uint32_t addr_be = byteorder_htonl(addr);
 
-    spi_acquire(dev->spi, dev->cs, dev->mode, dev->clk);
-    /* write enable */
-    mtd_spi_cmd(dev, dev->opcode->wren);
-
-    /* Page program */
-    mtd_spi_cmd_addr_write(dev, dev->opcode->page_program, addr_be, src, size);
-
-    /* waiting for the command to complete before returning */
-    wait_for_write_complete(dev);
-
-    spi_release(dev->spi);
-    return size;
+    return 0;
 }
 
-static int mtd_spi_nor_erase(mtd_dev_t *mtd, uint32_t addr, uint32_t size)
+static int _check_erase(const mtd_spi_nor_t *dev, uint32_t addr, uint32_t size)
 {
-    DEBUG("mtd_spi_nor_erase: %p, 0x%" PRIx32 ", 0x%" PRIx32 "\n",
-          (void *)mtd, addr, size);
-    mtd_spi_nor_t *dev = (mtd_spi_nor_t *)mtd;
+    const mtd_dev_t *mtd = &dev->base;
     uint32_t sector_size = mtd->page_size * mtd->pages_per_sector;
     uint32_t total_size = sector_size * mtd->sector_count;
 
@@ -444,48 +464,270 @@ static int mtd_spi_nor_erase(mtd_dev_t *mtd, uint32_t addr, uint32_t size)
         return -EOVERFLOW;
     }
 
+    return 0;
+}
+
+/**
+ * @internal
+ * @brief Start programming a page, the bus must be acquired
+ *
+ * @return typical duration of the operation
+ */
+static uint32_t _start_program(const mtd_spi_nor_t *dev, const void *src,
+                               uint32_t addr, uint32_t size)
+{
+    be_uint32_t addr_be = byteorder_htonl(addr);
+
+    /* write enable */
+    mtd_spi_cmd(dev, dev->opcode->wren);
+
+    /* Page program */
+    mtd_spi_cmd_addr_write(dev, dev->opcode->page_program, addr_be, src, size);
+
+    return MTD_SPI_NOR_WAIT_PAGE_PROGRAM_US;
+}
+
+/**
+ * @internal
+ * @brief Start erasing the largest unit at @p addr, the bus must be acquired
+ *
+ * @param[in]     dev   pointer to device descriptor
+ * @param[in,out] addr  start address, advanced by the erased unit
+ * @param[in,out] size  bytes left to erase, reduced by the erased unit
+ *
+ * @return typical duration of the operation
+ */
+static uint32_t _start_erase(const mtd_spi_nor_t *dev, uint32_t *addr, uint32_t *size)
+{
+    const mtd_dev_t *mtd = &dev->base;
+    uint32_t sector_size = mtd->page_size * mtd->pages_per_sector;
+    uint32_t total_size = sector_size * mtd->sector_count;
+    be_uint32_t addr_be = byteorder_htonl(*addr);
+
+    /* write enable */
+    mtd_spi_cmd(dev, dev->opcode->wren);
+
+    if (*size == total_size) {
+        mtd_spi_cmd(dev, dev->opcode->chip_erase);
+        *size -= total_size;
+        return MTD_SPI_NOR_WAIT_CHIP_ERASE_US;
+    }
+    else if ((dev->flag & SPI_NOR_F_SECT_32K) && (*size >= MTD_32K) &&
+             ((*addr & MTD_32K_ADDR_MASK) == 0)) {
+        /* 32 KiB blocks can be erased with block erase command */
+        mtd_spi_cmd_addr_write(dev, dev->opcode->block_erase_32k, addr_be, NULL, 0);
+        *addr += MTD_32K;
+        *size -= MTD_32K;
+        return MTD_SPI_NOR_WAIT_32K_ERASE_US;
+    }
+    else if ((dev->flag & SPI_NOR_F_SECT_4K) && (*size >= MTD_4K) &&
+             ((*addr & MTD_4K_ADDR_MASK) == 0)) {
+        /* 4 KiB sectors can be erased with sector erase command */
+        mtd_spi_cmd_addr_write(dev, dev->opcode->sector_erase, addr_be, NULL, 0);
+        *addr += MTD_4K;
+        *size -= MTD_4K;
+        return MTD_SPI_NOR_WAIT_4K_ERASE_US;
+    }
+    else {
+        mtd_spi_cmd_addr_write(dev, dev->opcode->block_erase, addr_be, NULL, 0);
+        *addr += sector_size;
+        *size -= sector_size;
+        return MTD_SPI_NOR_WAIT_BLOCK_ERASE_US;
+    }
+}
+
+static int mtd_spi_nor_write(mtd_dev_t *mtd, const void *src, uint32_t addr, uint32_t size)
+{
+    DEBUG("mtd_spi_nor_write: %p, %p, 0x%" PRIx32 ", 0x%" PRIx32 "\n",
+          (void *)mtd, src, addr, size);
+    if (size == 0) {
+        return 0;
+    }
+    const mtd_spi_nor_t *dev = (mtd_spi_nor_t *)mtd;
+    int res = _check_write(dev, addr, size);
+    if (res < 0) {
+        return res;
+    }
+#if MODULE_MTD_ASYNC
+    if (dev->async) {
+        return -EBUSY;
+    }
+#endif
+
     spi_acquire(dev->spi, dev->cs, dev->mode, dev->clk);
-    while (size) {
-        be_uint32_t addr_be = byteorder_htonl(addr);
-        /* write enable */
-        mtd_spi_cmd(dev, dev->opcode->wren);
+    uint32_t us = _start_program(dev, src, addr, size);
 
-        if (size == total_size) {
-            mtd_spi_cmd(dev, dev->opcode->chip_erase);
-            size -= total_size;
-        }
-        else if ((dev->flag & SPI_NOR_F_SECT_32K) && (size >= MTD_32K) &&
-                 ((addr & MTD_32K_ADDR_MASK) == 0)) {
-            /* 32 KiB blocks can be erased with block erase command */
-            mtd_spi_cmd_addr_write(dev, dev->opcode->block_erase_32k, addr_be, NULL, 0);
-            addr += MTD_32K;
-            size -= MTD_32K;
-        }
-        else if ((dev->flag & SPI_NOR_F_SECT_4K) && (size >= MTD_4K) &&
-                 ((addr & MTD_4K_ADDR_MASK) == 0)) {
-            /* 4 KiB sectors can be erased with sector erase command */
-            mtd_spi_cmd_addr_write(dev, dev->opcode->sector_erase, addr_be, NULL, 0);
-            addr += MTD_4K;
-            size -= MTD_4K;
-        }
-        else {
-            mtd_spi_cmd_addr_write(dev, dev->opcode->block_erase, addr_be, NULL, 0);
-            addr += sector_size;
-            size -= sector_size;
-        }
+    /* waiting for the command to complete before returning */
+    wait_for_write_complete(dev, us);
+
+    spi_release(dev->spi);
+    return size;
+}
+
+static int mtd_spi_nor_erase(mtd_dev_t *mtd, uint32_t addr, uint32_t size)
+{
+    DEBUG("mtd_spi_nor_erase: %p, 0x%" PRIx32 ", 0x%" PRIx32 "\n",
+          (void *)mtd, addr, size);
+    mtd_spi_nor_t *dev = (mtd_spi_nor_t *)mtd;
+
+    int res = _check_erase(dev, addr, size);
+    if (res < 0) {
+        return res;
+    }
+#if MODULE_MTD_ASYNC
+    if (dev->async) {
+        return -EBUSY;
+    }
+#endif
+
+    spi_acquire(dev->spi, dev->cs, dev->mode, dev->clk);
+    while (size) {
+        uint32_t us = _start_erase(dev, &addr, &size);
 
         /* waiting for the command to complete before continuing */
-        wait_for_write_complete(dev);
+        wait_for_write_complete(dev, us);
     }
     spi_release(dev->spi);
 
     return 0;
 }
 
+#if MODULE_MTD_ASYNC
+/**
+ * @internal
+ * @brief Poll the device after the typical duration, then in intervals of an
+ *        eighth of it, see wait_for_write_complete()
+ */
+static void _async_wait(mtd_async_t *op, uint32_t us)
+{
+    op->wait = us / 8;
+    if (op->wait < MTD_SPI_NOR_WAIT_MIN_US) {
+        op->wait = MTD_SPI_NOR_WAIT_MIN_US;
+    }
+    event_timeout_set(&op->timeout, us);
+}
+
+/**
+ * @internal
+ * @brief Claim the device for an asynchronous operation
+ *
+ * Operations may be started from several threads, so testing and setting
+ * mtd_spi_nor_t::async must not be interrupted.
+ */
+static int _async_claim(mtd_spi_nor_t *dev, mtd_async_t *op)
+{
+    int res = 0;
+    unsigned state = irq_disable();
+
+    if (dev->async) {
+        res = -EBUSY;
+    }
+    else {
+        dev->async = op;
+    }
+    irq_restore(state);
+
+    return res;
+}
+
+/**
+ * @internal
+ * @brief Poll the device and continue or finish an asynchronous operation
+ */
+static void _async_handler(event_t *event)
+{
+    mtd_async_t *op = container_of(event, mtd_async_t, event);
+    mtd_spi_nor_t *dev = (mtd_spi_nor_t *)op->mtd;
+    uint8_t status;
+
+    spi_acquire(dev->spi, dev->cs, dev->mode, dev->clk);
+    mtd_spi_cmd_read(dev, dev->opcode->rdsr, &status, sizeof(status));
+    if (status & SPI_NOR_STATUS_WIP) {
+        spi_release(dev->spi);
+        event_timeout_set(&op->timeout, op->wait);
+        return;
+    }
+    if (op->pos < op->size) {
+        /* erase the next unit */
+        uint32_t addr = op->addr + op->pos;
+        uint32_t left = op->size - op->pos;
+        uint32_t us = _start_erase(dev, &addr, &left);
+        spi_release(dev->spi);
+        op->pos = op->size - left;
+        _async_wait(op, us);
+        return;
+    }
+    spi_release(dev->spi);
+
+    dev->async = NULL;
+    mtd_async_done(op, (op->buf) ? (int)op->size : 0);
+}
+
+static int mtd_spi_nor_write_async(mtd_dev_t *mtd, mtd_async_t *op)
+{
+    DEBUG("mtd_spi_nor_write_async: %p, %p, 0x%" PRIx32 ", 0x%" PRIx32 "\n",
+          (void *)mtd, op->buf, op->addr, op->size);
+    mtd_spi_nor_t *dev = (mtd_spi_nor_t *)mtd;
+
+    int res = _check_write(dev, op->addr, op->size);
+    if (res < 0) {
+        return res;
+    }
+    res = _async_claim(dev, op);
+    if (res < 0) {
+        return res;
+    }
+    op->event.handler = _async_handler;
+
+    if (op->size == 0) {
+        event_post(op->queue, &op->event);
+        return 0;
+    }
+
+    spi_acquire(dev->spi, dev->cs, dev->mode, dev->clk);
+    uint32_t us = _start_program(dev, op->buf, op->addr, op->size);
+    spi_release(dev->spi);
+    op->pos = op->size;
+    _async_wait(op, us);
+
+    return 0;
+}
+
+static int mtd_spi_nor_erase_async(mtd_dev_t *mtd, mtd_async_t *op)
+{
+    DEBUG("mtd_spi_nor_erase_async: %p, 0x%" PRIx32 ", 0x%" PRIx32 "\n",
+          (void *)mtd, op->addr, op->size);
+    mtd_spi_nor_t *dev = (mtd_spi_nor_t *)mtd;
+
+    int res = _check_erase(dev, op->addr, op->size);
+    if (res < 0) {
+        return res;
+    }
+    res = _async_claim(dev, op);
+    if (res < 0) {
+        return res;
+    }
+    op->event.handler = _async_handler;
+    op->buf = NULL;
+    op->pos = 0;
+
+    /* the first unit is started by the handler on the idle device */
+    event_post(op->queue, &op->event);
+
+    return 0;
+}
+#endif
+
 static int mtd_spi_nor_power(mtd_dev_t *mtd, enum mtd_power_state power)
 {
     mtd_spi_nor_t *dev = (mtd_spi_nor_t *)mtd;
 
+#if MODULE_MTD_ASYNC
+    if (dev->async) {
+        return -EBUSY;
+    }
+#endif
+
     spi_acquire(dev->spi, dev->cs, dev->mode, dev->clk);
     switch (power) {
         case MTD_POWER_UP:
@@ -21,13 +21,17 @@ PSEUDOMODULES += gnrc_ipv6_nib_6lbr
 PSEUDOMODULES += gnrc_ipv6_nib_6ln
 PSEUDOMODULES += gnrc_ipv6_nib_6lr
 PSEUDOMODULES += gnrc_ipv6_nib_dns
+PSEUDOMODULES += gnrc_ipv6_nib_ft_trie
 PSEUDOMODULES += gnrc_ipv6_nib_router
 PSEUDOMODULES += gnrc_netdev_default
 PSEUDOMODULES += gnrc_neterr
 PSEUDOMODULES += gnrc_netapi_callbacks
 PSEUDOMODULES += gnrc_netapi_mbox
+PSEUDOMODULES += gnrc_netreg_hash
 PSEUDOMODULES += gnrc_pktbuf_cmd
+PSEUDOMODULES += gnrc_pktbuf_ext
 PSEUDOMODULES += gnrc_netif_cmd_%
+PSEUDOMODULES += gnrc_netif_coalesce
 PSEUDOMODULES += gnrc_netif_dedup
 PSEUDOMODULES += gnrc_sixloenc
 PSEUDOMODULES += gnrc_sixlowpan_border_router_default
@@ -38,6 +42,7 @@ PSEUDOMODULES += gnrc_sixlowpan_iphc_nhc
 PSEUDOMODULES += gnrc_sixlowpan_nd_border_router
 PSEUDOMODULES += gnrc_sixlowpan_router
 PSEUDOMODULES += gnrc_sixlowpan_router_default
+PSEUDOMODULES += gnrc_sock_async
 PSEUDOMODULES += gnrc_sock_check_reuse
 PSEUDOMODULES += gnrc_txtsnd
 PSEUDOMODULES += i2c_scan
@@ -53,6 +58,7 @@ PSEUDOMODULES += lora
 PSEUDOMODULES += mpu_stack_guard
 PSEUDOMODULES += nanocoap_%
 PSEUDOMODULES += netdev_default
+PSEUDOMODULES += netdev_tap_batch
 PSEUDOMODULES += netstats
 PSEUDOMODULES += netstats_l2
 PSEUDOMODULES += netstats_ipv6
@@ -64,6 +70,7 @@ PSEUDOMODULES += newlib_nano
 PSEUDOMODULES += openthread
 PSEUDOMODULES += pktqueue
 PSEUDOMODULES += posix_headers
+PSEUDOMODULES += posix_select
 PSEUDOMODULES += printf_float
 PSEUDOMODULES += prng
 PSEUDOMODULES += prng_%
@@ -76,6 +83,7 @@ PSEUDOMODULES += scanf_float
 PSEUDOMODULES += sched_cb
 PSEUDOMODULES += semtech_loramac_rx
 PSEUDOMODULES += sock
+PSEUDOMODULES += sock_async
 PSEUDOMODULES += sock_ip
 PSEUDOMODULES += sock_tcp
 PSEUDOMODULES += sock_udp
@@ -88,6 +96,9 @@ PSEUDOMODULES += suit_%
 # handle suit_v4 being a distinct module
 NO_PSEUDOMODULES += suit_v4
 
+# timer wheel backend of xtimer
+PSEUDOMODULES += xtimer_wheel
+
 # print ascii representation in function od_hex_dump()
 PSEUDOMODULES += od_string
 
@@ -181,5 +192,18 @@ PSEUDOMODULES += ds18_optimized
 PSEUDOMODULES += crypto_aes_precalculated
 # This pseudomodule causes a loop in AES to be unrolled (more flash, less CPU)
 PSEUDOMODULES += crypto_aes_unroll
+# Use AES-NI instructions for AES encryption on x86 CPUs supporting them
+PSEUDOMODULES += crypto_aes_ni
+
+# Unroll the SHA-256 round loop (more flash, less CPU)
+PSEUDOMODULES += hashes_sha256_unroll
+# Use the SHA extensions for SHA-256 on x86 CPUs supporting them
+PSEUDOMODULES += hashes_sha256_ni
+
+# Enable the asynchronous MTD API
+PSEUDOMODULES += mtd_async
+
+# Cache path lookups of VFS file system drivers
+PSEUDOMODULES += vfs_dcache
 
 # Packages may also add modules to PSEUDOMODULES in their `Makefile.include`.
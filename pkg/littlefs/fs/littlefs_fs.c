@@ -122,9 +122,11 @@ static int _dev_erase(const struct lfs_config *c, lfs_block_t block)
 
 static int _dev_sync(const struct lfs_config *c)
 {
-    (void)c;
+    littlefs_desc_t *fs = c->context;
 
-    return 0;
+    DEBUG("lfs_sync: c=%p\n", (void *)c);
+
+    return mtd_flush(fs->dev);
 }
 
 static int prepare(littlefs_desc_t *fs)
@@ -211,10 +213,13 @@ static int _umount(vfs_mount_t *mountp)
 
     DEBUG("littlefs: umount: mountp=%p\n", (void *)mountp);
 
-    int ret = lfs_unmount(&fs->fs);
+    int ret = littlefs_err_to_errno(lfs_unmount(&fs->fs));
+    if (ret == 0) {
+        ret = mtd_flush(fs->dev);
+    }
     mutex_unlock(&fs->lock);
 
-    return littlefs_err_to_errno(ret);
+    return ret;
 }
 
 static int _unlink(vfs_mount_t *mountp, const char *name)
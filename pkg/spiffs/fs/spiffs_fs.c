@@ -152,6 +152,16 @@ static int prepare(spiffs_desc_t *fs_desc)
     return mtd_init(dev);
 }
 
+static int _flush(spiffs_desc_t *fs_desc)
+{
+#if SPIFFS_HAL_CALLBACK_EXTRA == 1
+    return mtd_flush(fs_desc->dev);
+#else
+    (void)fs_desc;
+    return mtd_flush(SPIFFS_MTD_DEV);
+#endif
+}
+
 static int _format(vfs_mount_t *mountp)
 {
     spiffs_desc_t *fs_desc = mountp->private_data;
@@ -217,7 +227,7 @@ static int _umount(vfs_mount_t *mountp)
 
     SPIFFS_unmount(&fs_desc->fs);
 
-    return 0;
+    return _flush(fs_desc);
 }
 
 static int _unlink(vfs_mount_t *mountp, const char *name)
@@ -311,7 +321,12 @@ static int _close(vfs_file_t *filp)
 {
     spiffs_desc_t *fs_desc = filp->mp->private_data;
 
-    return spiffs_err_to_errno(SPIFFS_close(&fs_desc->fs, filp->private_data.value));
+    int res = spiffs_err_to_errno(SPIFFS_close(&fs_desc->fs, filp->private_data.value));
+    if (res < 0) {
+        return res;
+    }
+
+    return _flush(fs_desc);
 }
 
 static ssize_t _write(vfs_file_t *filp, const void *src, size_t nbytes)
@@ -96,6 +96,10 @@
 #include "schedstatistics.h"
 #endif
 
+#ifdef MODULE_KTRACE
+#include "ktrace.h"
+#endif
+
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
@@ -112,6 +116,10 @@ void auto_init(void)
 #ifdef MODULE_SCHEDSTATISTICS
     init_schedstatistics();
 #endif
+#ifdef MODULE_KTRACE
+    DEBUG("Auto init ktrace module.\n");
+    ktrace_init();
+#endif
 #ifdef MODULE_MCI
     DEBUG("Auto init mci module.\n");
     mci_initialize();
@@ -298,6 +306,11 @@ void auto_init(void)
     auto_init_socket_zep();
 #endif
 
+#ifdef MODULE_SHM_RADIO
+    extern void auto_init_shm_radio(void);
+    auto_init_shm_radio();
+#endif
+
 #ifdef MODULE_NORDIC_SOFTDEVICE_BLE
     extern void gnrc_nordic_ble_6lowpan_init(void);
     gnrc_nordic_ble_6lowpan_init();
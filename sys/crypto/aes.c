@@ -48,7 +48,8 @@ static const cipher_interface_t aes_interface = {
     AES_KEY_SIZE,
     aes_init,
     aes_encrypt,
-    aes_decrypt
+    aes_decrypt,
+    aes_encrypt_blocks
 };
 const cipher_id_t CIPHER_AES_128 = &aes_interface;
 
@@ -1023,25 +1024,107 @@ static int aes_set_decrypt_key(const unsigned char *userKey, const int bits,
     return 0;
 }
 
+#ifdef MODULE_CRYPTO_AES_NI
+#if !defined(__i386__) && !defined(__x86_64__)
+#error "crypto_aes_ni is only available on x86"
+#endif
+
+#include <wmmintrin.h>
+
+/* compile the AES-NI functions for CPUs with AES-NI only, whether they are
+ * used is decided at runtime, and make sure the stack is aligned for SSE */
+#define AES_NI_FUNC     __attribute__((target("aes,sse2"), \
+                                       force_align_arg_pointer))
+
+/* number of blocks encrypted in parallel to hide the latency of AESENC */
+#define AES_NI_INTERLEAVE   (4U)
+
+#define AES_NI_EXPAND(rk, i, rcon) \
+    rk[i] = aes_ni_expand_step(rk[i - 1], \
+                               _mm_aeskeygenassist_si128(rk[i - 1], rcon))
+
+static int aes_ni_available(void)
+{
+    static int available = -1;
+
+    if (available < 0) {
+        __builtin_cpu_init();
+        available = __builtin_cpu_supports("aes");
+    }
+    return available;
+}
+
+AES_NI_FUNC
+static inline __m128i aes_ni_expand_step(__m128i key, __m128i assist)
+{
+    assist = _mm_shuffle_epi32(assist, 0xff);
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, assist);
+}
+
+AES_NI_FUNC
+static void aes_ni_encrypt_blocks(const uint8_t *userKey, const uint8_t *in,
+                                  uint8_t *out, size_t nblocks)
+{
+    __m128i rk[11];
+
+    rk[0] = _mm_loadu_si128((const __m128i *)userKey);
+    AES_NI_EXPAND(rk, 1, 0x01);
+    AES_NI_EXPAND(rk, 2, 0x02);
+    AES_NI_EXPAND(rk, 3, 0x04);
+    AES_NI_EXPAND(rk, 4, 0x08);
+    AES_NI_EXPAND(rk, 5, 0x10);
+    AES_NI_EXPAND(rk, 6, 0x20);
+    AES_NI_EXPAND(rk, 7, 0x40);
+    AES_NI_EXPAND(rk, 8, 0x80);
+    AES_NI_EXPAND(rk, 9, 0x1b);
+    AES_NI_EXPAND(rk, 10, 0x36);
+
+    for (; nblocks >= AES_NI_INTERLEAVE; nblocks -= AES_NI_INTERLEAVE) {
+        __m128i b[AES_NI_INTERLEAVE];
+
+        for (unsigned i = 0; i < AES_NI_INTERLEAVE; i++) {
+            b[i] = _mm_loadu_si128((const __m128i *)in + i);
+            b[i] = _mm_xor_si128(b[i], rk[0]);
+        }
+        for (unsigned r = 1; r < 10; r++) {
+            for (unsigned i = 0; i < AES_NI_INTERLEAVE; i++) {
+                b[i] = _mm_aesenc_si128(b[i], rk[r]);
+            }
+        }
+        for (unsigned i = 0; i < AES_NI_INTERLEAVE; i++) {
+            b[i] = _mm_aesenclast_si128(b[i], rk[10]);
+            _mm_storeu_si128((__m128i *)out + i, b[i]);
+        }
+        in += AES_NI_INTERLEAVE * AES_BLOCK_SIZE;
+        out += AES_NI_INTERLEAVE * AES_BLOCK_SIZE;
+    }
+
+    for (; nblocks > 0; nblocks--) {
+        __m128i b = _mm_loadu_si128((const __m128i *)in);
+
+        b = _mm_xor_si128(b, rk[0]);
+        for (unsigned r = 1; r < 10; r++) {
+            b = _mm_aesenc_si128(b, rk[r]);
+        }
+        b = _mm_aesenclast_si128(b, rk[10]);
+        _mm_storeu_si128((__m128i *)out, b);
+        in += AES_BLOCK_SIZE;
+        out += AES_BLOCK_SIZE;
+    }
+}
+#endif /* MODULE_CRYPTO_AES_NI */
+
 #ifndef AES_ASM
 /*
- * Encrypt a single block
+ * Encrypt a single block with an expanded key
  * in and out can overlap
  */
-int aes_encrypt(const cipher_context_t *context, const uint8_t *plainBlock,
-                uint8_t *cipherBlock)
+static void aes_encrypt_block(const AES_KEY *key, const uint8_t *plainBlock,
+                              uint8_t *cipherBlock)
 {
-    /* setup AES_KEY */
-    int res;
-    AES_KEY aeskey;
-    const AES_KEY *key = &aeskey;
-
-    res = aes_set_encrypt_key((unsigned char *)context->context,
-                              AES_KEY_SIZE * 8, &aeskey);
-    if (res < 0) {
-        return res;
-    }
-
     const u32 *rk;
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
 #ifndef MODULE_CRYPTO_AES_UNROLL
@@ -1289,6 +1372,65 @@ int aes_encrypt(const cipher_context_t *context, const uint8_t *plainBlock,
         (Te4((t2) & 0xff)       & 0x000000ff) ^
         rk[3];
     PUTU32(cipherBlock + 12, s3);
+}
+
+/*
+ * Encrypt a single block
+ * in and out can overlap
+ */
+int aes_encrypt(const cipher_context_t *context, const uint8_t *plainBlock,
+                uint8_t *cipherBlock)
+{
+#ifdef MODULE_CRYPTO_AES_NI
+    if (aes_ni_available()) {
+        aes_ni_encrypt_blocks(context->context, plainBlock, cipherBlock, 1);
+        return 1;
+    }
+#endif
+
+    /* setup AES_KEY */
+    int res;
+    AES_KEY aeskey;
+
+    res = aes_set_encrypt_key((unsigned char *)context->context,
+                              AES_KEY_SIZE * 8, &aeskey);
+    if (res < 0) {
+        return res;
+    }
+
+    aes_encrypt_block(&aeskey, plainBlock, cipherBlock);
+    return 1;
+}
+
+/*
+ * Encrypt consecutive blocks, expanding the key only once
+ * in and out can overlap
+ */
+int aes_encrypt_blocks(const cipher_context_t *context, const uint8_t *input,
+                       uint8_t *output, size_t nblocks)
+{
+#ifdef MODULE_CRYPTO_AES_NI
+    if (aes_ni_available()) {
+        aes_ni_encrypt_blocks(context->context, input, output, nblocks);
+        return 1;
+    }
+#endif
+
+    /* setup AES_KEY */
+    int res;
+    AES_KEY aeskey;
+
+    res = aes_set_encrypt_key((unsigned char *)context->context,
+                              AES_KEY_SIZE * 8, &aeskey);
+    if (res < 0) {
+        return res;
+    }
+
+    while (nblocks--) {
+        aes_encrypt_block(&aeskey, input, output);
+        input += AES_BLOCK_SIZE;
+        output += AES_BLOCK_SIZE;
+    }
     return 1;
 }
 
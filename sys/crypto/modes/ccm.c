@@ -18,10 +18,10 @@
  * @}
  */
 
+#include <stdbool.h>
 #include <string.h>
 #include "debug.h"
 #include "crypto/helper.h"
-#include "crypto/modes/ctr.h"
 #include "crypto/modes/ccm.h"
 
 static inline int min(int a, int b)
@@ -37,7 +37,8 @@ static inline int min(int a, int b)
 int ccm_compute_cbc_mac(cipher_t *cipher, const uint8_t iv[16],
                         const uint8_t *input, size_t length, uint8_t *mac)
 {
-    uint8_t offset, block_size, mac_enc[16] = { 0 };
+    size_t offset;
+    uint8_t block_size, mac_enc[16] = { 0 };
 
     block_size = cipher_get_block_size(cipher);
     memmove(mac, iv, 16);
@@ -83,7 +84,7 @@ int ccm_create_mac_iv(cipher_t *cipher, uint8_t auth_data_len, uint8_t M,
     memcpy(&X1[1], nonce, min(nonce_len, 15 - L));
 
     /* write plaintext_len to B[15..16-L] */
-    for (uint8_t i = 15; i > 16 - L; --i) {
+    for (uint8_t i = 15; i >= 16 - L; --i) {
         X1[i] = plaintext_len & 0xff;
         plaintext_len >>= 8;
     }
@@ -147,6 +148,67 @@ static inline int _fits_in_nbytes(size_t value, uint8_t num_bytes)
 }
 
 
+/*
+ * En- or decrypts the message in counter mode and computes its CBC-MAC in the
+ * same pass. Block i of the key stream does not depend on the MAC, so it is
+ * encrypted together with the MAC of the preceding message block using a
+ * single call to cipher_encrypt_blocks().
+ */
+static int _ccm_crypt(cipher_t *cipher, uint8_t mac[16],
+                      uint8_t nonce_counter[16], uint8_t nonce_len,
+                      const uint8_t *input, size_t length, uint8_t *output,
+                      bool decrypt)
+{
+    /* blocks[0..15]: MAC, blocks[16..31]: counter and key stream */
+    uint8_t blocks[32], block_size;
+    size_t offset = 0;
+    /* like ccm_compute_cbc_mac(), an empty message adds one block to the MAC */
+    bool mac_pending = (length == 0);
+
+    block_size = cipher_get_block_size(cipher);
+    while ((offset < length) || mac_pending) {
+        uint8_t *first = &blocks[16];
+        size_t nblocks = 0;
+
+        if (mac_pending) {
+            memcpy(blocks, mac, block_size);
+            first = blocks;
+            nblocks++;
+        }
+        if (offset < length) {
+            memcpy(&blocks[16], nonce_counter, block_size);
+            crypto_block_inc_ctr(nonce_counter, block_size - nonce_len);
+            nblocks++;
+        }
+
+        if (cipher_encrypt_blocks(cipher, first, first, nblocks) != 1) {
+            return CIPHER_ERR_ENC_FAILED;
+        }
+
+        if (mac_pending) {
+            memcpy(mac, blocks, block_size);
+            mac_pending = false;
+        }
+        if (offset < length) {
+            size_t block_size_input = min(length - offset, block_size);
+
+            /* CBC-MAC is computed over the plaintext, read it before it is
+             * overwritten if input and output are the same */
+            for (size_t i = 0; i < block_size_input; ++i) {
+                uint8_t out = input[offset + i] ^ blocks[16 + i];
+
+                mac[i] ^= decrypt ? out : input[offset + i];
+                output[offset + i] = out;
+            }
+            offset += block_size_input;
+            mac_pending = true;
+        }
+    }
+
+    return offset;
+}
+
+
 int cipher_encrypt_ccm(cipher_t *cipher,
                        const uint8_t *auth_data, uint32_t auth_data_len,
                        uint8_t mac_length, uint8_t length_encoding,
@@ -156,7 +218,7 @@ int cipher_encrypt_ccm(cipher_t *cipher,
 {
     int len = -1;
     uint8_t nonce_counter[16] = { 0 }, mac_iv[16] = { 0 }, mac[16] = { 0 },
-            stream_block[16] = { 0 }, zero_block[16] = { 0 }, block_size;
+            stream_block[16] = { 0 }, block_size;
 
     if (mac_length % 2 != 0  || mac_length < 4 || mac_length > 16) {
         return CCM_ERR_INVALID_MAC_LENGTH;
@@ -174,30 +236,25 @@ int cipher_encrypt_ccm(cipher_t *cipher,
         return CCM_ERR_INVALID_DATA_LENGTH;
     }
 
-    /* MAC calulation (T) with additional data and plaintext */
+    /* MAC calulation (T) with additional data */
     len = ccm_compute_adata_mac(cipher, auth_data, auth_data_len, mac_iv);
     if (len < 0) {
         return len;
     }
-    len = ccm_compute_cbc_mac(cipher, mac_iv, input, input_len, mac);
-    if (len < 0) {
-        return len;
-    }
 
     /* Compute first stream block */
     nonce_counter[0] = length_encoding - 1;
     memcpy(&nonce_counter[1], nonce,
            min(nonce_len, (size_t)15 - length_encoding));
-    len = cipher_encrypt_ctr(cipher, nonce_counter, block_size,
-                             zero_block, block_size, stream_block);
-    if (len < 0) {
-        return len;
+    if (cipher_encrypt(cipher, nonce_counter, stream_block) != 1) {
+        return CIPHER_ERR_ENC_FAILED;
     }
 
-    /* Encrypt message in counter mode  */
+    /* Encrypt message in counter mode and MAC it */
     crypto_block_inc_ctr(nonce_counter, block_size - nonce_len);
-    len = cipher_encrypt_ctr(cipher, nonce_counter, nonce_len, input,
-                             input_len, output);
+    memcpy(mac, mac_iv, block_size);
+    len = _ccm_crypt(cipher, mac, nonce_counter, nonce_len, input, input_len,
+                     output, false);
     if (len < 0) {
         return len;
     }
@@ -220,9 +277,8 @@ int cipher_decrypt_ccm(cipher_t *cipher,
 {
     int len = -1;
     uint8_t nonce_counter[16] = { 0 }, mac_iv[16] = { 0 }, mac[16] = { 0 },
-            mac_recv[16] = { 0 }, stream_block[16] = { 0 },
-            zero_block[16] = { 0 },
-            plain_len, block_size;
+            mac_recv[16] = { 0 }, stream_block[16] = { 0 }, block_size;
+    size_t plain_len;
 
     if (mac_length % 2 != 0  || mac_length < 4 || mac_length > 16) {
         return CCM_ERR_INVALID_MAC_LENGTH;
@@ -233,38 +289,33 @@ int cipher_decrypt_ccm(cipher_t *cipher,
         return CCM_ERR_INVALID_LENGTH_ENCODING;
     }
 
-    /* Compute first stream block */
-    nonce_counter[0] = length_encoding - 1;
-    block_size = cipher_get_block_size(cipher);
-    memcpy(&nonce_counter[1], nonce, min(nonce_len,
-                                         (size_t)15 - length_encoding));
-    len = cipher_encrypt_ctr(cipher, nonce_counter, block_size, zero_block,
-                             block_size, stream_block);
-    if (len < 0) {
-        return len;
-    }
-
-    /* Decrypt message in counter mode */
-    plain_len = input_len - mac_length;
-    crypto_block_inc_ctr(nonce_counter, block_size - nonce_len);
-    len = cipher_encrypt_ctr(cipher, nonce_counter, nonce_len, input,
-                             plain_len, plain);
-    if (len < 0) {
-        return len;
-    }
-
     /* Create B0, encrypt it (X1) and use it as mac_iv */
+    plain_len = input_len - mac_length;
+    block_size = cipher_get_block_size(cipher);
     if (ccm_create_mac_iv(cipher, auth_data_len, mac_length, length_encoding,
                           nonce, nonce_len, plain_len, mac_iv) < 0) {
         return CCM_ERR_INVALID_DATA_LENGTH;
     }
 
-    /* MAC calulation (T) with additional data and plaintext */
+    /* MAC calulation (T) with additional data */
     len = ccm_compute_adata_mac(cipher, auth_data, auth_data_len, mac_iv);
     if (len < 0) {
         return len;
     }
-    len = ccm_compute_cbc_mac(cipher, mac_iv, plain, plain_len, mac);
+
+    /* Compute first stream block */
+    nonce_counter[0] = length_encoding - 1;
+    memcpy(&nonce_counter[1], nonce, min(nonce_len,
+                                         (size_t)15 - length_encoding));
+    if (cipher_encrypt(cipher, nonce_counter, stream_block) != 1) {
+        return CIPHER_ERR_ENC_FAILED;
+    }
+
+    /* Decrypt message in counter mode and MAC the plaintext */
+    crypto_block_inc_ctr(nonce_counter, block_size - nonce_len);
+    memcpy(mac, mac_iv, block_size);
+    len = _ccm_crypt(cipher, mac, nonce_counter, nonce_len, input, plain_len,
+                     plain, true);
     if (len < 0) {
         return len;
     }
@@ -92,6 +92,18 @@ const vfs_file_system_t constfs_file_system = {
  */
 static void _constfs_write_stat(const constfs_file_t *fp, struct stat *restrict buf);
 
+/**
+ * @internal
+ * @brief Find the file @p name on the file system mounted at @p mountp
+ *
+ * @param[in]  mountp mount point of the file system
+ * @param[in]  name   file name relative to the mount point
+ *
+ * @return the file
+ * @return NULL if there is no file @p name
+ */
+static const constfs_file_t *_constfs_find(vfs_mount_t *mountp, const char *name);
+
 static int constfs_mount(vfs_mount_t *mountp)
 {
     /* perform any extra initialization here */
@@ -122,18 +134,15 @@ static int constfs_stat(vfs_mount_t *mountp, const char *restrict name, struct s
         return -EFAULT;
     }
     constfs_t *fs = mountp->private_data;
-    /* linear search through the files array */
-    for (size_t i = 0; i < fs->nfiles; ++i) {
-        DEBUG("constfs_stat ? \"%s\"\n", fs->files[i].path);
-        if (strcmp(fs->files[i].path, name) == 0) {
-            DEBUG("constfs_stat: Found :)\n");
-            _constfs_write_stat(&fs->files[i], buf);
-            buf->st_ino = i;
-            return 0;
-        }
+    const constfs_file_t *fp = _constfs_find(mountp, name);
+    if (fp == NULL) {
+        DEBUG("constfs_stat: Not found :(\n");
+        return -ENOENT;
     }
-    DEBUG("constfs_stat: Not found :(\n");
-    return -ENOENT;
+    DEBUG("constfs_stat: Found :)\n");
+    _constfs_write_stat(fp, buf);
+    buf->st_ino = fp - fs->files;
+    return 0;
 }
 
 static int constfs_statvfs(vfs_mount_t *mountp, const char *restrict path, struct statvfs *restrict buf)
@@ -209,23 +218,19 @@ static int constfs_open(vfs_file_t *filp, const char *name, int flags, mode_t mo
 {
     (void) mode;
     (void) abs_path;
-    constfs_t *fs = filp->mp->private_data;
     DEBUG("constfs_open: %p, \"%s\", 0x%x, 0%03lo, \"%s\"\n", (void *)filp, name, flags, (unsigned long)mode, abs_path);
     /* We only support read access */
     if ((flags & O_ACCMODE) != O_RDONLY) {
         return -EROFS;
     }
-    /* linear search through the files array */
-    for (size_t i = 0; i < fs->nfiles; ++i) {
-        DEBUG("constfs_open ? \"%s\"\n", fs->files[i].path);
-        if (strcmp(fs->files[i].path, name) == 0) {
-            DEBUG("constfs_open: Found :)\n");
-            filp->private_data.ptr = (void *)&fs->files[i];
-            return 0;
-        }
+    const constfs_file_t *fp = _constfs_find(filp->mp, name);
+    if (fp == NULL) {
+        DEBUG("constfs_open: Not found :(\n");
+        return -ENOENT;
     }
-    DEBUG("constfs_open: Not found :(\n");
-    return -ENOENT;
+    DEBUG("constfs_open: Found :)\n");
+    filp->private_data.ptr = (void *)fp;
+    return 0;
 }
 
 static ssize_t constfs_read(vfs_file_t *filp, void *dest, size_t nbytes)
@@ -317,3 +322,21 @@ static void _constfs_write_stat(const constfs_file_t *fp, struct stat *restrict
     buf->st_blocks = fp->size;
     buf->st_blksize = sizeof(uint8_t);
 }
+
+static const constfs_file_t *_constfs_find(vfs_mount_t *mountp, const char *name)
+{
+    const constfs_file_t *fp = vfs_dcache_lookup(mountp, name);
+    if (fp != NULL) {
+        return fp;
+    }
+    constfs_t *fs = mountp->private_data;
+    /* linear search through the files array */
+    for (size_t i = 0; i < fs->nfiles; ++i) {
+        DEBUG("constfs_find ? \"%s\"\n", fs->files[i].path);
+        if (strcmp(fs->files[i].path, name) == 0) {
+            vfs_dcache_add(mountp, name, (void *)&fs->files[i]);
+            return &fs->files[i];
+        }
+    }
+    return NULL;
+}
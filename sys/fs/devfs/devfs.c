@@ -75,37 +75,54 @@ const vfs_file_system_t devfs_file_system = {
     .d_op = &devfs_dir_ops,
 };
 
-static int devfs_open(vfs_file_t *filp, const char *name, int flags, mode_t mode, const char *abs_path)
+/**
+ * @internal
+ * @brief Find the device registered at @p name, _devfs_mutex must be locked
+ */
+static devfs_t *_devfs_find(const char *name)
 {
-    DEBUG("devfs_open: %p, \"%s\", 0x%x, 0%03lo, \"%s\"\n", (void *)filp, name, flags, (unsigned long)mode, abs_path);
     /* linear search through the device list */
-    mutex_lock(&_devfs_mutex);
     clist_node_t *it = _devfs_list.next;
     if (it == NULL) {
         /* list empty */
-        mutex_unlock(&_devfs_mutex);
-        return -ENOENT;
+        return NULL;
     }
     do {
         it = it->next;
         devfs_t *devp = container_of(it, devfs_t, list_entry);
         if (strcmp(devp->path, name) == 0) {
-            mutex_unlock(&_devfs_mutex);
-            DEBUG("devfs_open: Found :)\n");
-            /* Add private data from DevFS node */
-            filp->private_data.ptr = devp->private_data;
-            /* Replace f_op with the operations provided by the device driver */
-            filp->f_op = devp->f_op;
-            /* Chain the open() method for the specific device */
-            if (filp->f_op->open != NULL) {
-                return filp->f_op->open(filp, name, flags, mode, abs_path);
-            }
-            return 0;
+            return devp;
         }
     } while (it != _devfs_list.next);
+    return NULL;
+}
+
+static int devfs_open(vfs_file_t *filp, const char *name, int flags, mode_t mode, const char *abs_path)
+{
+    DEBUG("devfs_open: %p, \"%s\", 0x%x, 0%03lo, \"%s\"\n", (void *)filp, name, flags, (unsigned long)mode, abs_path);
+    mutex_lock(&_devfs_mutex);
+    devfs_t *devp = vfs_dcache_lookup(filp->mp, name);
+    if (devp == NULL) {
+        devp = _devfs_find(name);
+        if (devp != NULL) {
+            vfs_dcache_add(filp->mp, name, devp);
+        }
+    }
     mutex_unlock(&_devfs_mutex);
-    DEBUG("devfs_open: Not found :(\n");
-    return -ENOENT;
+    if (devp == NULL) {
+        DEBUG("devfs_open: Not found :(\n");
+        return -ENOENT;
+    }
+    DEBUG("devfs_open: Found :)\n");
+    /* Add private data from DevFS node */
+    filp->private_data.ptr = devp->private_data;
+    /* Replace f_op with the operations provided by the device driver */
+    filp->f_op = devp->f_op;
+    /* Chain the open() method for the specific device */
+    if (filp->f_op->open != NULL) {
+        return filp->f_op->open(filp, name, flags, mode, abs_path);
+    }
+    return 0;
 }
 
 static int devfs_fcntl(vfs_file_t *filp, int cmd, int arg)
@@ -232,6 +249,10 @@ int devfs_unregister(devfs_t *devp)
     mutex_lock(&_devfs_mutex);
     /* find devp in the list and remove it */
     clist_node_t *node = clist_remove(&_devfs_list, &devp->list_entry);
+    if (node != NULL) {
+        /* devfs may be mounted more than once, drop the path on all mounts */
+        vfs_dcache_invalidate(NULL, devp->path);
+    }
     mutex_unlock(&_devfs_mutex);
     if (node == NULL) {
         /* not found */
@@ -122,42 +122,165 @@ static const uint32_t K[64] = {
     0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
 };
 
+/* Message schedule, computed in place in a rolling window of 16 words */
+#define W_NEXT(W, i)    (W[(i) & 15] += s1(W[((i) - 2) & 15]) + \
+                                        W[((i) - 7) & 15] + \
+                                        s0(W[((i) - 15) & 15]))
+
+/* One round, the caller rotates the roles of the working variables */
+#define ROUND(a, b, c, d, e, f, g, h, w, k) \
+    do { \
+        uint32_t t0 = h + S1(e) + Ch(e, f, g) + (w) + (k); \
+        uint32_t t1 = S0(a) + Maj(a, b, c); \
+        d += t0; \
+        h = t0 + t1; \
+    } while (0)
+
 /*
  * SHA256 block compression function.  The 256-bit state is transformed via
- * the 512-bit input block to produce a new state.
+ * the 512-bit input blocks to produce a new state.
  */
-static void sha256_transform(uint32_t *state, const unsigned char block[64])
+static void sha256_transform_generic(uint32_t *state,
+                                     const unsigned char *block,
+                                     size_t nblocks)
 {
-    uint32_t W[64];
-    uint32_t S[8];
+    for (; nblocks > 0; nblocks--, block += 64) {
+        uint32_t W[16];
+
+        /* 1. Load the first 16 words of the message schedule W. */
+        be32dec_vect(W, block, 64);
+
+        /* 2. Initialize working variables. */
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+        /* 3. Mix, extending the message schedule on the fly. */
+#ifdef MODULE_HASHES_SHA256_UNROLL
+        for (unsigned i = 0; i < 64; i += 8) {
+            if (i >= 16) {
+                for (unsigned j = 0; j < 8; j++) {
+                    W_NEXT(W, i + j);
+                }
+            }
+            ROUND(a, b, c, d, e, f, g, h, W[(i + 0) & 15], K[i + 0]);
+            ROUND(h, a, b, c, d, e, f, g, W[(i + 1) & 15], K[i + 1]);
+            ROUND(g, h, a, b, c, d, e, f, W[(i + 2) & 15], K[i + 2]);
+            ROUND(f, g, h, a, b, c, d, e, W[(i + 3) & 15], K[i + 3]);
+            ROUND(e, f, g, h, a, b, c, d, W[(i + 4) & 15], K[i + 4]);
+            ROUND(d, e, f, g, h, a, b, c, W[(i + 5) & 15], K[i + 5]);
+            ROUND(c, d, e, f, g, h, a, b, W[(i + 6) & 15], K[i + 6]);
+            ROUND(b, c, d, e, f, g, h, a, W[(i + 7) & 15], K[i + 7]);
+        }
+#else /* !MODULE_HASHES_SHA256_UNROLL */
+        for (unsigned i = 0; i < 64; i++) {
+            uint32_t w = (i < 16) ? W[i] : W_NEXT(W, i);
+
+            ROUND(a, b, c, d, e, f, g, h, w, K[i]);
+            /* rotate roles: the new a was written to h, the new e to d */
+            uint32_t t = h;
+            h = g; g = f; f = e; e = d;
+            d = c; c = b; b = a; a = t;
+        }
+#endif /* ?MODULE_HASHES_SHA256_UNROLL */
 
-    /* 1. Prepare message schedule W. */
-    be32dec_vect(W, block, 64);
-    for (int i = 16; i < 64; i++) {
-        W[i] = s1(W[i - 2]) + W[i - 7] + s0(W[i - 15]) + W[i - 16];
+        /* 4. Mix local working variables into global state */
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
     }
+}
+
+#ifdef MODULE_HASHES_SHA256_NI
+#if !defined(__i386__) && !defined(__x86_64__)
+#error "hashes_sha256_ni is only available on x86"
+#endif
 
-    /* 2. Initialize working variables. */
-    memcpy(S, state, 32);
+#include <cpuid.h>
+#include <immintrin.h>
 
-    /* 3. Mix. */
-    for (int i = 0; i < 64; ++i) {
-        uint32_t e = S[(68 - i) % 8], f = S[(69 - i) % 8];
-        uint32_t g = S[(70 - i) % 8], h = S[(71 - i) % 8];
-        uint32_t t0 = h + S1(e) + Ch(e, f, g) + W[i] + K[i];
+/* compile the SHA-NI function for CPUs with SHA extensions only, whether it
+ * is used is decided at runtime, and make sure the stack is aligned for SSE */
+#define SHA_NI_FUNC     __attribute__((target("sha,sse4.1,ssse3"), \
+                                       force_align_arg_pointer))
 
-        uint32_t a = S[(64 - i) % 8], b = S[(65 - i) % 8];
-        uint32_t c = S[(66 - i) % 8], d = S[(67 - i) % 8];
-        uint32_t t1 = S0(a) + Maj(a, b, c);
+static int sha256_ni_available(void)
+{
+    static int available = -1;
 
-        S[(67 - i) % 8] = d + t0;
-        S[(71 - i) % 8] = t0 + t1;
+    if (available < 0) {
+        unsigned eax, ebx, ecx, edx;
+
+        /* CPUID leaf 7, EBX bit 29: SHA extensions */
+        available = __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) &&
+                    (ebx & (1U << 29));
     }
+    return available;
+}
+
+SHA_NI_FUNC
+static void sha256_transform_ni(uint32_t *state, const unsigned char *block,
+                                size_t nblocks)
+{
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL,
+                                         0x0405060700010203ULL);
+    __m128i abef, cdgh, tmp;
+
+    /* the SHA instructions keep the state as ABEF and CDGH */
+    tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[0]),
+                            0xb1);
+    cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[4]),
+                             0x1b);
+    abef = _mm_alignr_epi8(tmp, cdgh, 8);
+    cdgh = _mm_blend_epi16(cdgh, tmp, 0xf0);
+
+    for (; nblocks > 0; nblocks--, block += 64) {
+        __m128i abef_save = abef, cdgh_save = cdgh;
+        __m128i msg[4];
+
+        for (unsigned i = 0; i < 4; i++) {
+            msg[i] = _mm_loadu_si128((const __m128i *)block + i);
+            msg[i] = _mm_shuffle_epi8(msg[i], bswap);
+        }
 
-    /* 4. Mix local working variables into global state */
-    for (int i = 0; i < 8; i++) {
-        state[i] += S[i];
+        /* 16 groups of 4 rounds, msg[g & 3] holds W[4g..4g+3] */
+        for (unsigned g = 0; g < 16; g++) {
+            __m128i m = msg[g & 3];
+
+            tmp = _mm_add_epi32(m, _mm_loadu_si128((const __m128i *)&K[4 * g]));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, tmp);
+            tmp = _mm_shuffle_epi32(tmp, 0x0e);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, tmp);
+
+            if (g < 12) {
+                /* W[4g+16..4g+19] from W[4g..4g+15] */
+                tmp = _mm_sha256msg1_epu32(m, msg[(g + 1) & 3]);
+                tmp = _mm_add_epi32(tmp, _mm_alignr_epi8(msg[(g + 3) & 3],
+                                                         msg[(g + 2) & 3],
+                                                         4));
+                msg[g & 3] = _mm_sha256msg2_epu32(tmp, msg[(g + 3) & 3]);
+            }
+        }
+
+        abef = _mm_add_epi32(abef, abef_save);
+        cdgh = _mm_add_epi32(cdgh, cdgh_save);
+    }
+
+    tmp = _mm_shuffle_epi32(abef, 0x1b);
+    cdgh = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128((__m128i *)&state[0], _mm_blend_epi16(tmp, cdgh, 0xf0));
+    _mm_storeu_si128((__m128i *)&state[4], _mm_alignr_epi8(cdgh, tmp, 8));
+}
+#endif /* MODULE_HASHES_SHA256_NI */
+
+static void sha256_transform(uint32_t *state, const unsigned char *block,
+                             size_t nblocks)
+{
+#ifdef MODULE_HASHES_SHA256_NI
+    if (sha256_ni_available()) {
+        sha256_transform_ni(state, block, nblocks);
+        return;
     }
+#endif
+    sha256_transform_generic(state, block, nblocks);
 }
 
 static unsigned char PAD[64] = {
@@ -229,19 +352,21 @@ void sha256_update(sha256_context_t *ctx, const void *data, size_t len)
         return;
     }
 
-    /* Finish the current block */
     const unsigned char *src = data;
 
-    memcpy(&ctx->buf[r], src, 64 - r);
-    sha256_transform(ctx->state, ctx->buf);
-    src += 64 - r;
-    len -= 64 - r;
+    /* Finish the current block */
+    if (r > 0) {
+        memcpy(&ctx->buf[r], src, 64 - r);
+        sha256_transform(ctx->state, ctx->buf, 1);
+        src += 64 - r;
+        len -= 64 - r;
+    }
 
-    /* Perform complete blocks */
-    while (len >= 64) {
-        sha256_transform(ctx->state, src);
-        src += 64;
-        len -= 64;
+    /* Perform complete blocks directly from the input */
+    if (len >= 64) {
+        sha256_transform(ctx->state, src, len / 64);
+        src += len & ~(size_t)0x3f;
+        len &= 0x3f;
     }
 
     /* Copy left over data into buffer */
@@ -281,9 +406,11 @@ void *sha256(const void *data, size_t len, void *digest)
 }
 
 
-void hmac_sha256_init(hmac_context_t *ctx, const void *key, size_t key_length)
+void hmac_sha256_precompute(hmac_sha256_key_t *pkey, const void *key,
+                            size_t key_length)
 {
     unsigned char k[SHA256_INTERNAL_BLOCK_SIZE];
+    sha256_context_t c;
 
     memset((void *)k, 0x00, SHA256_INTERNAL_BLOCK_SIZE);
 
@@ -307,20 +434,49 @@ void hmac_sha256_init(hmac_context_t *ctx, const void *key, size_t key_length)
         i_key_pad[i] = 0x36 ^ k[i];
     }
 
+    /*
+     * The key pads fill exactly one block, so after absorbing them the
+     * whole hash state is the 256 bit chaining value
+     */
+    sha256_init(&c);
+    sha256_update(&c, i_key_pad, SHA256_INTERNAL_BLOCK_SIZE);
+    memcpy(pkey->state_in, c.state, sizeof(pkey->state_in));
+
+    sha256_init(&c);
+    sha256_update(&c, o_key_pad, SHA256_INTERNAL_BLOCK_SIZE);
+    memcpy(pkey->state_out, c.state, sizeof(pkey->state_out));
+}
+
+static void _init_after_block(sha256_context_t *ctx, const uint32_t *state)
+{
+    memcpy(ctx->state, state, sizeof(ctx->state));
+    /* one block (512 bit) processed */
+    ctx->count[0] = 0;
+    ctx->count[1] = SHA256_INTERNAL_BLOCK_SIZE * 8;
+}
+
+void hmac_sha256_init_precomputed(hmac_context_t *ctx,
+                                  const hmac_sha256_key_t *pkey)
+{
     /*
      * Initiate calculation of the inner hash
      * tmp = hash(i_key_pad CONCAT message)
      */
-    sha256_init(&ctx->c_in);
-    sha256_update(&ctx->c_in, i_key_pad, SHA256_INTERNAL_BLOCK_SIZE);
+    _init_after_block(&ctx->c_in, pkey->state_in);
 
     /*
      * Initiate calculation of the outer hash
      * result = hash(o_key_pad CONCAT tmp)
      */
-    sha256_init(&ctx->c_out);
-    sha256_update(&ctx->c_out, o_key_pad, SHA256_INTERNAL_BLOCK_SIZE);
+    _init_after_block(&ctx->c_out, pkey->state_out);
+}
+
+void hmac_sha256_init(hmac_context_t *ctx, const void *key, size_t key_length)
+{
+    hmac_sha256_key_t pkey;
 
+    hmac_sha256_precompute(&pkey, key, key_length);
+    hmac_sha256_init_precomputed(ctx, &pkey);
 }
 
 void hmac_sha256_update(hmac_context_t *ctx, const void *data, size_t len)
@@ -356,6 +512,19 @@ const void *hmac_sha256(const void *key, size_t key_length,
     return digest;
 }
 
+const void *hmac_sha256_precomputed(const hmac_sha256_key_t *pkey,
+                                    const void *data, size_t len,
+                                    void *digest)
+{
+    hmac_context_t ctx;
+
+    hmac_sha256_init_precomputed(&ctx, pkey);
+    hmac_sha256_update(&ctx, data, len);
+    hmac_sha256_final(&ctx, digest);
+
+    return digest;
+}
+
 /**
  * @brief helper to compute sha256 inplace for the given buffer
  *
@@ -22,6 +22,7 @@
 #ifndef CRYPTO_CIPHERS_H
 #define CRYPTO_CIPHERS_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -96,6 +97,10 @@ typedef struct cipher_interface_st {
     /** the decrypt function */
     int (*decrypt)(const cipher_context_t *ctx, const uint8_t *cipher_block,
                    uint8_t *plain_block);
+
+    /** the multi-block encrypt function, NULL if the cipher has none */
+    int (*encrypt_blocks)(const cipher_context_t *ctx, const uint8_t *input,
+                          uint8_t *output, size_t nblocks);
 } cipher_interface_t;
 
 
@@ -152,6 +157,28 @@ int cipher_encrypt(const cipher_t *cipher, const uint8_t *input,
                    uint8_t *output);
 
 
+/**
+ * @brief Encrypt @p nblocks consecutive blocks of BLOCK_SIZE length
+ *
+ * Ciphers providing a multi-block implementation set up the key schedule
+ * only once per call, so this should be preferred over calling
+ * cipher_encrypt() in a loop. The blocks are encrypted independently (as in
+ * ECB mode), chaining is up to the caller.
+ *
+ * @param cipher     Already initialized cipher struct
+ * @param input      pointer to @p nblocks blocks of input data to encrypt
+ * @param output     pointer to allocated memory for encrypted data. It has to
+ *                   be of size @p nblocks * BLOCK_SIZE and may be equal to
+ *                   @p input
+ * @param nblocks    number of blocks to encrypt
+ *
+ * @return           1 in case of success
+ * @return           A negative value for an error
+ */
+int cipher_encrypt_blocks(const cipher_t *cipher, const uint8_t *input,
+                          uint8_t *output, size_t nblocks);
+
+
 /**
  * @brief Decrypt data of BLOCK_SIZE length
  * *
@@ -26,6 +26,17 @@
 extern "C" {
 #endif
 
+/**
+ * @brief   Number of key stream blocks generated with one call to
+ *          cipher_encrypt_blocks()
+ *
+ * The key stream is buffered on the stack, which needs
+ * CIPHER_CTR_BATCH_BLOCKS * CIPHER_MAX_BLOCK_SIZE bytes.
+ */
+#ifndef CIPHER_CTR_BATCH_BLOCKS
+#define CIPHER_CTR_BATCH_BLOCKS     (4U)
+#endif
+
 /**
  * @brief Encrypt data of arbitrary length in counter mode.
  *
@@ -34,6 +34,13 @@
  * @defgroup    sys_hashes_sha256 SHA-256
  * @ingroup     sys_hashes_unkeyed
  * @brief       Implementation of the SHA-256 hashing function
+ *
+ * The block transformation can be tuned by pseudo-modules:
+ *  * hashes_sha256_unroll: unroll the round loop eight times. This improves
+ *       speed at the expense of increased program size.
+ *  * hashes_sha256_ni: use the SHA extensions on x86 CPUs supporting them
+ *       (checked at runtime), e.g. on `native`.
+ *
  * @{
  *
  * @file
@@ -87,6 +94,20 @@ typedef struct {
     sha256_context_t c_out;
 } hmac_context_t;
 
+/**
+ * @brief Precomputed HMAC-SHA256 key
+ *
+ * Holds the hash states after absorbing the inner and outer key pads. MACs
+ * using the same key can start from them, which saves two to three block
+ * transformations per MAC.
+ */
+typedef struct {
+    /** state after absorbing the inner key pad */
+    uint32_t state_in[8];
+    /** state after absorbing the outer key pad */
+    uint32_t state_out[8];
+} hmac_sha256_key_t;
+
 /**
  * @brief sha256-chain indexed element
  */
@@ -142,6 +163,27 @@ void *sha256(const void *data, size_t len, void *digest);
  */
 void hmac_sha256_init(hmac_context_t *ctx, const void *key, size_t key_length);
 
+/**
+ * @brief Precompute the inner and outer states of a HMAC SHA-256 key
+ *
+ * @param[out] pkey precomputed key to fill
+ * @param[in] key key used in the hmac-sha256 computation
+ * @param[in] key_length the size in bytes of the key
+ */
+void hmac_sha256_precompute(hmac_sha256_key_t *pkey, const void *key,
+                            size_t key_length);
+
+/**
+ * @brief Initiate calculation of a HMAC with a precomputed key
+ *
+ * Same as hmac_sha256_init(), but without hashing the key again.
+ *
+ * @param[in] ctx hmac_context_t handle to use
+ * @param[in] pkey key precomputed with hmac_sha256_precompute()
+ */
+void hmac_sha256_init_precomputed(hmac_context_t *ctx,
+                                  const hmac_sha256_key_t *pkey);
+
 /**
  * @brief hmac_sha256_update Add data bytes for HMAC calculation
  * @param[in] ctx hmac_context_t handle to use
@@ -175,6 +217,23 @@ void hmac_sha256_final(hmac_context_t *ctx, void *digest);
 const void *hmac_sha256(const void *key, size_t key_length,
                         const void *data, size_t len, void *digest);
 
+/**
+ * @brief function to compute a hmac-sha256 from a given message with a
+ *        precomputed key
+ *
+ * @param[in] pkey key precomputed with hmac_sha256_precompute()
+ * @param[in] data pointer to the buffer to generate the hmac-sha256
+ * @param[in] len the length of the message in bytes
+ * @param[out] digest the computed hmac-sha256,
+ *             length MUST be SHA256_DIGEST_LENGTH
+ *             if digest == NULL, a static buffer is used
+ * @returns pointer to the resulting digest.
+ *          if result == NULL the pointer points to the static buffer
+ */
+const void *hmac_sha256_precomputed(const hmac_sha256_key_t *pkey,
+                                    const void *data, size_t len,
+                                    void *digest);
+
 /**
  * @brief function to produce a hash chain starting with a given seed element.
  *        The chain is computed by taking the sha256 from the seed,
@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_ktrace Kernel event tracer
+ * @ingroup     sys
+ * @brief       Records kernel events into a binary ring buffer
+ *
+ * When this module is used, the kernel records context switches, sent and
+ * received messages and threads blocking on or being woken up by mutexes
+ * into a ring buffer of @ref KTRACE_BUF_SIZE entries. CPUs that support it
+ * (currently native) also record entry and exit of interrupt service
+ * routines. Applications add their own events with ktrace_marker(),
+ * ktrace_begin() and ktrace_end().
+ *
+ * Timestamps are taken from the cycle counter on Cortex-M3 and above, from
+ * the host's monotonic clock in nanoseconds on native and from xtimer in
+ * microseconds otherwise. The trace clock is 64 bit wide, entries store the
+ * lower 32 bit. Whenever the upper 32 bit change, a
+ * @ref KTRACE_EVENT_SYNC entry carrying them is recorded first, so long idle
+ * periods are reconstructed exactly. The cycle counter is extended to 64 bit
+ * in software when recording, a period longer than its wrap around time
+ * without any event is shortened by a multiple of that time.
+ *
+ * The buffer is dumped with the `ktrace dump` shell command as hex lines on
+ * stdio or, on native, into a file on the host. `dist/tools/ktrace/ktrace2json.py`
+ * converts either form into the Chrome trace event format, which can be
+ * viewed with Perfetto (https://ui.perfetto.dev) or chrome://tracing.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Kernel event tracer interface
+ */
+
+#ifndef KTRACE_H
+#define KTRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "kernel_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of entries in the trace buffer, must be a power of two
+ */
+#ifndef KTRACE_BUF_SIZE
+#define KTRACE_BUF_SIZE             (256U)
+#endif
+
+/**
+ * @brief   Magic number at the beginning of a dump, written in the byte
+ *          order of the node
+ */
+#define KTRACE_MAGIC                (0x4b545243U)
+
+/**
+ * @brief   Version of the dump format
+ */
+#define KTRACE_VERSION              (2U)
+
+/**
+ * @brief   Flag of an entry recorded in interrupt context
+ */
+#define KTRACE_FLAG_ISR             (0x01U)
+
+/**
+ * @brief   Traced events
+ */
+typedef enum {
+    KTRACE_EVENT_SWITCH = 0,    /**< Context switch, arg0: PID of the next thread */
+    KTRACE_EVENT_ISR_ENTER,     /**< ISR entered, arg0: IRQ number */
+    KTRACE_EVENT_ISR_EXIT,      /**< ISR left, arg0: IRQ number */
+    KTRACE_EVENT_MSG_SEND,      /**< Message sent, arg0: PID of the receiver,
+                                     arg1: message type */
+    KTRACE_EVENT_MSG_RECV,      /**< Message received, arg0: PID of the sender,
+                                     arg1: message type */
+    KTRACE_EVENT_MUTEX_BLOCK,   /**< Thread blocks on a mutex, arg0: mutex address */
+    KTRACE_EVENT_MUTEX_UNBLOCK, /**< Mutex handed over to a waiting thread,
+                                     arg0: mutex address, arg1: PID of the
+                                     woken thread */
+    KTRACE_EVENT_MARKER,        /**< User marker, arg0: ID, arg1: value */
+    KTRACE_EVENT_BEGIN,         /**< User span begins, arg0: ID */
+    KTRACE_EVENT_END,           /**< User span ends, arg0: ID */
+    KTRACE_EVENT_SYNC,          /**< Upper 32 bit of the trace clock changed,
+                                     arg0: upper 32 bit of the time of this
+                                     and the following entries, arg1: upper
+                                     32 bit of the time of the preceding
+                                     entries */
+} ktrace_event_t;
+
+/**
+ * @brief   Entry of the trace buffer
+ */
+typedef struct {
+    uint32_t time;              /**< Lower 32 bit of the timestamp in ticks of
+                                     the trace clock */
+    uint8_t event;              /**< Event, one of @ref ktrace_event_t */
+    uint8_t flags;              /**< KTRACE_FLAG_* */
+    kernel_pid_t pid;           /**< PID of the active thread */
+    uint32_t arg0;              /**< First event argument */
+    uint32_t arg1;              /**< Second event argument */
+} ktrace_entry_t;
+
+/**
+ * @brief   Header of a dump
+ *
+ * The header is followed by @p count entries, oldest first, and @p threads
+ * thread name records. A thread name record consists of the PID
+ * (@ref kernel_pid_t), the length of the name (uint8_t) and the name without
+ * terminating zero.
+ */
+typedef struct {
+    uint32_t magic;             /**< @ref KTRACE_MAGIC */
+    uint16_t version;           /**< @ref KTRACE_VERSION */
+    uint16_t entry_size;        /**< sizeof(ktrace_entry_t) */
+    uint32_t clock_hz;          /**< Frequency of the trace clock */
+    uint32_t count;             /**< Number of entries in the dump */
+    uint32_t lost;              /**< Number of entries that were overwritten */
+    uint16_t threads;           /**< Number of thread name records */
+    uint16_t reserved;          /**< Reserved, zero */
+} ktrace_hdr_t;
+
+/**
+ * @brief   Output function used to dump the trace buffer
+ *
+ * @param[in] arg       Argument passed to ktrace_dump()
+ * @param[in] data      Data to write
+ * @param[in] len       Length of @p data
+ *
+ * @return  0 on success
+ * @return  negative errno on error
+ */
+typedef int (*ktrace_write_t)(void *arg, const void *data, size_t len);
+
+/**
+ * @brief   Initializes the trace clock and starts recording
+ *
+ * Called by auto_init.
+ */
+void ktrace_init(void);
+
+/**
+ * @brief   Starts recording
+ */
+void ktrace_start(void);
+
+/**
+ * @brief   Stops recording
+ */
+void ktrace_stop(void);
+
+/**
+ * @brief   Discards all recorded entries
+ */
+void ktrace_clear(void);
+
+/**
+ * @brief   Records an event
+ *
+ * May be called from interrupt context.
+ *
+ * @param[in] event     Event to record
+ * @param[in] arg0      First event argument
+ * @param[in] arg1      Second event argument
+ */
+void ktrace_record(ktrace_event_t event, uint32_t arg0, uint32_t arg1);
+
+/**
+ * @brief   Records a user marker
+ *
+ * @param[in] id        Application defined ID of the marker
+ * @param[in] value     Application defined value
+ */
+static inline void ktrace_marker(uint32_t id, uint32_t value)
+{
+    ktrace_record(KTRACE_EVENT_MARKER, id, value);
+}
+
+/**
+ * @brief   Records the begin of a user span
+ *
+ * @param[in] id        Application defined ID of the span
+ */
+static inline void ktrace_begin(uint32_t id)
+{
+    ktrace_record(KTRACE_EVENT_BEGIN, id, 0);
+}
+
+/**
+ * @brief   Records the end of a user span
+ *
+ * @param[in] id        Application defined ID of the span
+ */
+static inline void ktrace_end(uint32_t id)
+{
+    ktrace_record(KTRACE_EVENT_END, id, 0);
+}
+
+/**
+ * @brief   Records the entry of an ISR
+ *
+ * To be called by the interrupt dispatcher of the CPU.
+ *
+ * @param[in] irq       IRQ number
+ */
+static inline void ktrace_isr_enter(unsigned irq)
+{
+    ktrace_record(KTRACE_EVENT_ISR_ENTER, irq, 0);
+}
+
+/**
+ * @brief   Records the exit of an ISR
+ *
+ * To be called by the interrupt dispatcher of the CPU.
+ *
+ * @param[in] irq       IRQ number
+ */
+static inline void ktrace_isr_exit(unsigned irq)
+{
+    ktrace_record(KTRACE_EVENT_ISR_EXIT, irq, 0);
+}
+
+/**
+ * @brief   Dumps the trace buffer
+ *
+ * Recording is paused while the buffer is dumped.
+ *
+ * @param[in] write     Output function
+ * @param[in] arg       Argument passed to @p write
+ *
+ * @return  0 on success
+ * @return  negative errno returned by @p write
+ */
+int ktrace_dump(ktrace_write_t write, void *arg);
+
+#if defined(CPU_NATIVE) || defined(DOXYGEN)
+/**
+ * @brief   Dumps the trace buffer into a file on the host
+ *
+ * @note    Only available on native.
+ *
+ * @param[in] path      Path of the file on the host, an existing file is
+ *                      overwritten
+ *
+ * @return  0 on success
+ * @return  negative errno on error
+ */
+int ktrace_dump_file(const char *path);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KTRACE_H */
+/** @} */
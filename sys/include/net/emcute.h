@@ -21,10 +21,15 @@
  * @ref net_sock_udp. The design is not intended to be used with any other
  * transport.
  *
- * The implementation is based on a 2-thread model: emCute needs one thread of
- * its own, in which receiving of packets and sending of ping messages are
- * handled. All 'user space functions' have to run from (a) different (i.e.
- * user) thread(s). emCute uses thread flags to synchronize between threads.
+ * The implementation is based on a 2-thread model: emCute needs one thread in
+ * which receiving of packets and sending of ping messages are handled. This
+ * can be a thread of emCute's own (see emcute_run()) or, if the network stack
+ * supports @ref net_sock_async (currently @ref net_gnrc "GNRC" only), the
+ * thread of an @ref sys_event "event queue" that is shared with other
+ * protocols (see emcute_init()), e.g. the one of @ref net_gcoap. All 'user
+ * space functions' have to run from (a) different (i.e. user) thread(s), as
+ * they block until the response was handled. emCute uses thread flags to
+ * synchronize between threads.
  *
  * Further know restrictions are:
  * - ASCII topic names only (no support for UTF8 names, yet)
@@ -90,6 +95,9 @@
 #include <stdbool.h>
 
 #include "net/sock/udp.h"
+#if defined(MODULE_SOCK_ASYNC_EVENT) || defined(DOXYGEN)
+#include "event.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -343,11 +351,32 @@ int emcute_willupd_topic(const char *topic, unsigned flags);
  */
 int emcute_willupd_msg(const void *data, size_t len);
 
+#if defined(MODULE_SOCK_ASYNC_EVENT) || defined(DOXYGEN)
+/**
+ * @brief   Initialize emCute on an event queue
+ *
+ * Receiving of packets and sending of ping messages are handled by the thread
+ * serving @p queue, which may be shared with other protocols. The user space
+ * functions of emCute must not be called from that thread.
+ *
+ * @note    Only available with `sock_async_event`, which is used automatically
+ *          with @ref net_gnrc "GNRC".
+ *
+ * @param[in] queue     event queue to handle emCute's events on
+ * @param[in] port      UDP port used for listening (default: 1883)
+ * @param[in] id        client ID (should be unique)
+ *
+ * @return  0 on success
+ * @return  -1 if the UDP sock could not be created
+ */
+int emcute_init(event_queue_t *queue, uint16_t port, const char *id);
+#endif
+
 /**
  * @brief   Run emCute, will 'occupy' the calling thread
  *
- * This function will run the emCute message receiver. It will block the thread
- * it is running in.
+ * This function will run the emCute message receiver. It will block the
+ * thread it is running in.
  *
  * @param[in] port      UDP port used for listening (default: 1883)
  * @param[in] id        client ID (should be unique)
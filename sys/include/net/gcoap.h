@@ -301,11 +301,18 @@
  *
  * ### Waiting for a response ###
  *
- * We take advantage of RIOT's asynchronous messaging by using an xtimer to wait
- * for a response, so the gcoap thread does not block while waiting. The user is
- * notified via the same callback, whether the message is received or the wait
- * times out. We track the response with an entry in the
- * `_coap_state.open_reqs` array.
+ * The gcoap thread serves an @ref sys_event "event queue". Incoming messages
+ * are posted to it by @ref net_sock_async_event and the wait for a response
+ * is limited by an @ref event_timeout_t on the same queue, so the gcoap thread
+ * never blocks while waiting. The user is notified via the same callback,
+ * whether the message is received or the wait times out. We track the
+ * response with an entry in the `_coap_state.open_reqs` array.
+ *
+ * ### Sharing the gcoap thread ###
+ *
+ * Other protocols can handle their socks on the event queue of the gcoap
+ * thread, see gcoap_get_event_queue(), instead of running a thread of their
+ * own.
  *
  * ## Implementation Status ##
  * gcoap includes server and client capability. Available features include:
@@ -342,6 +349,7 @@
 #include "net/ipv6/addr.h"
 #include "net/sock/udp.h"
 #include "net/nanocoap.h"
+#include "event/timeout.h"
 #include "xtimer.h"
 
 #ifdef __cplusplus
@@ -354,13 +362,6 @@ extern "C" {
  * @ingroup  config
  * @{
  */
-/**
- * @brief  Size for module message queue
- */
-#ifndef GCOAP_MSG_QUEUE_SIZE
-#define GCOAP_MSG_QUEUE_SIZE    (4)
-#endif
-
 /**
  * @brief   Server port; use RFC 7252 default if not defined
  */
@@ -454,14 +455,6 @@ extern "C" {
  */
 #define GCOAP_SEND_LIMIT_NON    (-1)
 
-/**
- * @ingroup net_gcoap_conf
- * @brief   Time in usec that the event loop waits for an incoming CoAP message
- */
-#ifndef GCOAP_RECV_TIMEOUT
-#define GCOAP_RECV_TIMEOUT      (1 * US_PER_SEC)
-#endif
-
 #ifdef DOXYGEN
 /**
  * @ingroup net_gcoap_conf
@@ -486,19 +479,6 @@ extern "C" {
 #define GCOAP_NON_TIMEOUT       (5000000U)
 #endif
 
-/**
- * @brief   Identifies waiting timed out for a response to a sent message
- */
-#define GCOAP_MSG_TYPE_TIMEOUT  (0x1501)
-
-/**
- * @brief   Identifies a request to interrupt listening for an incoming message
- *          on a sock
- *
- * Allows the event loop to process IPC messages.
- */
-#define GCOAP_MSG_TYPE_INTR     (0x1502)
-
 /**
  * @ingroup net_gcoap_conf
  * @brief   Maximum number of Observe clients
@@ -584,6 +564,25 @@ extern "C" {
 #define GCOAP_RESEND_BUFS_MAX      (1)
 #endif
 
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Number of resources in the path index; 0 disables the index
+ *
+ * The index keeps the resources of all registered listeners ordered by path,
+ * so a request is resolved by binary search instead of comparing its path
+ * with every resource. The default `/.well-known/core` resource takes one
+ * entry. If no resource matches both path and method exactly, or a listener
+ * did not fit into the index anymore, the listeners are searched as without
+ * the index, e.g. for @ref COAP_MATCH_SUBTREE resources.
+ *
+ * @note    With the index, a resource matching path and method exactly takes
+ *          precedence over a @ref COAP_MATCH_SUBTREE resource for a prefix of
+ *          the path.
+ */
+#ifndef GCOAP_RESOURCE_INDEX_SIZE
+#define GCOAP_RESOURCE_INDEX_SIZE  (0)
+#endif
+
 /**
  * @name Bitwise positional flags for encoding resource links
  * @{
@@ -659,8 +658,8 @@ typedef struct {
                                              supports resending message */
     sock_udp_ep_t remote_ep;            /**< Remote endpoint */
     gcoap_resp_handler_t resp_handler;  /**< Callback for the response */
-    xtimer_t response_timer;            /**< Limits wait for response */
-    msg_t timeout_msg;                  /**< For response timer */
+    event_timeout_t resp_evt_tmout;     /**< Limits wait for response */
+    event_t resp_tmout_evt;             /**< Posted when the wait timed out */
 } gcoap_request_memo_t;
 
 /**
@@ -684,6 +683,17 @@ typedef struct {
  */
 kernel_pid_t gcoap_init(void);
 
+/**
+ * @brief   Returns the event queue of the gcoap thread
+ *
+ * Other protocols may post their events to this queue, e.g. with
+ * @ref net_sock_async_event, to share the thread and its stack with gcoap.
+ * Their handlers must not block, as that delays the CoAP messaging.
+ *
+ * @return  The event queue of the gcoap thread
+ */
+event_queue_t *gcoap_get_event_queue(void);
+
 /**
  * @brief   Starts listening for resource paths
  *
@@ -76,6 +76,10 @@ extern "C" {
 #define GNRC_IPV6_NIB_CONF_DNS          (1)
 #endif
 
+#ifdef MODULE_GNRC_IPV6_NIB_FT_TRIE
+#define GNRC_IPV6_NIB_CONF_FT_TRIE      (1)
+#endif
+
 /**
  * @name    Compile flags
  * @brief   Compile flags to (de-)activate certain features for NIB
@@ -209,6 +213,18 @@ extern "C" {
 #ifndef GNRC_IPV6_NIB_CONF_MULTIHOP_DAD
 #define GNRC_IPV6_NIB_CONF_MULTIHOP_DAD (0)
 #endif
+
+/**
+ * @brief   Index the off-link entries in a compressed binary trie
+ *
+ * Route lookups walk at most @ref IPV6_ADDR_BIT_LEN bits of the destination
+ * instead of comparing it against every off-link entry. This pays off for
+ * routers with many routes (e.g. a 6LBR in RPL storing mode) at the cost of
+ * about `(2 * GNRC_IPV6_NIB_OFFL_NUMOF * 8)` bytes of additional RAM.
+ */
+#ifndef GNRC_IPV6_NIB_CONF_FT_TRIE
+#define GNRC_IPV6_NIB_CONF_FT_TRIE      (0)
+#endif
 /** @} */
 
 /**
@@ -114,6 +114,14 @@ typedef struct {
 #endif
 #if defined(MODULE_GNRC_SIXLOWPAN) || DOXYGEN
     gnrc_netif_6lo_t sixlo;                 /**< 6Lo component */
+#endif
+#if defined(MODULE_GNRC_NETIF_COALESCE) || DOXYGEN
+    /**
+     * @brief   Frames received during the current wake-up of the thread
+     *
+     * @note    Only available with module `gnrc_netif_coalesce`.
+     */
+    uint16_t rx_batch;
 #endif
     uint8_t cur_hl;                         /**< Current hop-limit for out-going packets */
     uint8_t device_type;                    /**< Device type */
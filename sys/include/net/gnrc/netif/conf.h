@@ -57,6 +57,21 @@ extern "C" {
 #define GNRC_NETIF_MSG_QUEUE_SIZE  (16U)
 #endif
 
+/**
+ * @brief   Maximum number of device events handled per wake-up of the
+ *          network interface thread
+ *
+ * With module `gnrc_netif_coalesce` the interrupt of a network device only
+ * sets a thread flag instead of sending a message, so interrupts can not get
+ * lost when the message queue is full. On wake-up the thread services the
+ * device repeatedly until it does not report a received frame anymore or
+ * this budget is exhausted. In the latter case pending @ref net_gnrc_netapi
+ * messages are handled before the device is serviced again.
+ */
+#ifndef GNRC_NETIF_RX_BUDGET
+#define GNRC_NETIF_RX_BUDGET        (8U)
+#endif
+
 /**
  * @brief   Number of multicast addresses needed for @ref net_gnrc_rpl "RPL".
  *
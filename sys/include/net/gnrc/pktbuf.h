@@ -58,6 +58,63 @@ extern "C" {
 #define GNRC_PKTBUF_SIZE    (6144)
 #endif  /* GNRC_PKTBUF_SIZE */
 
+/**
+ * @name    Size classes of the slab packet buffer
+ *
+ * The `gnrc_pktbuf_slab` implementation replaces the first-fit allocator of
+ * `gnrc_pktbuf_static` with segregated pools of fixed-size blocks (one pool
+ * for packet snips and three for data), so allocation and release are
+ * constant-time and the buffer can not fragment into unusable holes.
+ * An allocation is served from the smallest class its size fits into and
+ * spills over into the next larger class if that one is exhausted.
+ *
+ * The defaults split @ref GNRC_PKTBUF_SIZE bytes of data into
+ * 32 * 32 B + 16 * 128 B + 2 * 1536 B, i.e. small headers, 802.15.4 frames,
+ * and full-MTU IPv6 or Ethernet frames.
+ *
+ * @note    Data sizes must be multiples of `sizeof(void *)`.
+ * @note    Only used with module `gnrc_pktbuf_slab`.
+ * @{
+ */
+#ifndef GNRC_PKTBUF_SLAB_SNIP_NUMOF
+#define GNRC_PKTBUF_SLAB_SNIP_NUMOF     (48U)   /**< number of packet snips */
+#endif
+
+#ifndef GNRC_PKTBUF_SLAB_SMALL_SIZE
+#define GNRC_PKTBUF_SLAB_SMALL_SIZE     (32U)   /**< size of small data blocks */
+#endif
+
+#ifndef GNRC_PKTBUF_SLAB_SMALL_NUMOF
+#define GNRC_PKTBUF_SLAB_SMALL_NUMOF    (32U)   /**< number of small data blocks */
+#endif
+
+#ifndef GNRC_PKTBUF_SLAB_MEDIUM_SIZE
+#define GNRC_PKTBUF_SLAB_MEDIUM_SIZE    (128U)  /**< size of medium data blocks */
+#endif
+
+#ifndef GNRC_PKTBUF_SLAB_MEDIUM_NUMOF
+#define GNRC_PKTBUF_SLAB_MEDIUM_NUMOF   (16U)   /**< number of medium data blocks */
+#endif
+
+#ifndef GNRC_PKTBUF_SLAB_LARGE_SIZE
+#define GNRC_PKTBUF_SLAB_LARGE_SIZE     (1536U) /**< size of large data blocks */
+#endif
+
+#ifndef GNRC_PKTBUF_SLAB_LARGE_NUMOF
+#define GNRC_PKTBUF_SLAB_LARGE_NUMOF    (2U)    /**< number of large data blocks */
+#endif
+/** @} */
+
+/**
+ * @brief   Maximum number of packet snips referencing external data that can
+ *          exist at the same time
+ *
+ * @note    Only used with module `gnrc_pktbuf_ext`.
+ */
+#ifndef GNRC_PKTBUF_EXT_NUMOF
+#define GNRC_PKTBUF_EXT_NUMOF           (4U)
+#endif
+
 /**
  * @brief   Initializes packet buffer module.
  */
@@ -87,6 +144,65 @@ void gnrc_pktbuf_init(void);
 gnrc_pktsnip_t *gnrc_pktbuf_add(gnrc_pktsnip_t *next, const void *data, size_t size,
                                 gnrc_nettype_t type);
 
+#if defined(MODULE_GNRC_PKTBUF_EXT) || defined(DOXYGEN)
+/**
+ * @brief   Callback that notifies the owner of external data that the packet
+ *          buffer does not reference it anymore
+ *
+ * @note    The callback is called with the packet buffer locked, so it
+ *          **must not** call any `gnrc_pktbuf_*` function.
+ *
+ * @param[in] arg   Argument given to gnrc_pktbuf_add_ext().
+ */
+typedef void (*gnrc_pktbuf_ext_cb_t)(void *arg);
+
+/**
+ * @brief   Adds a new gnrc_pktsnip_t that references external data instead of
+ *          copying it into the packet buffer.
+ *
+ * The snip is released like any other snip. As soon as the last user releases
+ * it, @p cb is called and @p data may be reused by its owner; until then
+ * @p data **must not** be changed.
+ *
+ * @warning The snip **must not** be passed to gnrc_pktbuf_mark(),
+ *          gnrc_pktbuf_realloc_data(), or be the head of a packet passed to
+ *          gnrc_pktbuf_merge(). gnrc_pktbuf_start_write() copies the data into
+ *          the packet buffer and is safe to use.
+ *
+ * @note    Only available with module `gnrc_pktbuf_ext`.
+ *
+ * @param[in] next      Next gnrc_pktsnip_t in the packet. Leave NULL if you
+ *                      want to create a new packet.
+ * @param[in] data      External data of the new gnrc_pktsnip_t.
+ * @param[in] size      Length of @p data.
+ * @param[in] type      Protocol type of the gnrc_pktsnip_t.
+ * @param[in] cb        Callback called when the snip is removed from the
+ *                      packet buffer. Must not be NULL.
+ * @param[in] arg       Argument for @p cb.
+ *
+ * @return  Pointer to the packet part that represents the new gnrc_pktsnip_t.
+ * @return  NULL, if no space is left in the packet buffer or all
+ *          @ref GNRC_PKTBUF_EXT_NUMOF external snips are in use.
+ */
+gnrc_pktsnip_t *gnrc_pktbuf_add_ext(gnrc_pktsnip_t *next, const void *data,
+                                    size_t size, gnrc_nettype_t type,
+                                    gnrc_pktbuf_ext_cb_t cb, void *arg);
+
+/**
+ * @brief   Notifies the owner of @p pkt's data if it is external
+ *
+ * @internal    Called by the packet buffer implementations, with the packet
+ *              buffer locked, right before @p pkt is freed.
+ *
+ * @param[in] pkt   A packet snip whose last user released it.
+ *
+ * @return  true, if gnrc_pktsnip_t::data of @p pkt is external and must not
+ *          be freed.
+ * @return  false, otherwise.
+ */
+bool gnrc_pktbuf_ext_release(gnrc_pktsnip_t *pkt);
+#endif
+
 /**
  * @brief   Marks the first @p size bytes in a received packet with a new
  *          packet snip that is appended to the packet.
@@ -289,7 +405,10 @@ int gnrc_pktbuf_merge(gnrc_pktsnip_t *pkt);
  *
  * @note    Only available with DEVELHELP defined.
  *
- * @details Statistics include maximum number of reserved bytes.
+ * @details Statistics include maximum number of reserved bytes. With
+ *          `gnrc_pktbuf_slab` they list usage, high-water mark, spill-overs
+ *          into larger classes, failed allocations and the internal
+ *          fragmentation (bytes reserved but not requested) per size class.
  */
 void gnrc_pktbuf_stats(void);
 #endif
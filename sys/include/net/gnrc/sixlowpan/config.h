@@ -71,6 +71,20 @@ extern "C" {
 #define GNRC_SIXLOWPAN_FRAG_RBUF_SIZE       (4U)
 #endif
 
+/**
+ * @brief   Maximum size of a datagram the reassembly buffer can reassemble
+ *
+ * Received fragments are tracked in 8-byte units, so every reassembly buffer
+ * entry carries two bitmaps of `GNRC_SIXLOWPAN_FRAG_RBUF_DATAGRAM_MAX / 8`
+ * bits each. Fragments of larger datagrams are dropped.
+ *
+ * @note    Only applicable with
+ *          [gnrc_sixlowpan_frag_rb](@ref net_gnrc_sixlowpan_frag_rb) module
+ */
+#ifndef GNRC_SIXLOWPAN_FRAG_RBUF_DATAGRAM_MAX
+#define GNRC_SIXLOWPAN_FRAG_RBUF_DATAGRAM_MAX   (1280U)
+#endif
+
 /**
  * @brief   Timeout for reassembly buffer entries in microseconds
  *
@@ -121,10 +135,7 @@ extern "C" {
  * @see     https://tools.ietf.org/html/draft-ietf-lwig-6lowpan-virtual-reassembly-01
  *
  * @note    Only applicable with
- *          [gnrc_sixlowpan_frag_vrb](@ref net_gnrc_sixlowpan_frag_vrb) module,
- *          but has also a direct influence on the number of available
- *          gnrc_sixlowpan_frag_rb_int_t entries (even when
- *          `gnrc_sixlowpan_frag_vrb` is not compiled in).
+ *          [gnrc_sixlowpan_frag_vrb](@ref net_gnrc_sixlowpan_frag_vrb) module
  */
 #ifndef GNRC_SIXLOWPAN_FRAG_VRB_SIZE
 #if defined(MODULE_GNRC_SIXLOWPAN_FRAG_VRB) || defined(DOXYGEN)
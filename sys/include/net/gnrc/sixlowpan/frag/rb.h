@@ -23,6 +23,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "bitfield.h"
 #include "net/gnrc/netif/hdr.h"
 #include "net/gnrc/pkt.h"
 
@@ -37,23 +38,10 @@ extern "C" {
 #define GNRC_SIXLOWPAN_FRAG_RB_GC_MSG       (0x0226)
 
 /**
- * @brief   Fragment intervals to identify limits of fragments and duplicates.
- *
- * @note    Fragments MUST NOT overlap and overlapping fragments are to be
- *          discarded
- *
- * @see <a href="https://tools.ietf.org/html/rfc4944#section-5.3">
- *          RFC 4944, section 5.3
- *      </a>
+ * @brief   Number of 8-byte units a reassembly buffer entry can track
  */
-typedef struct gnrc_sixlowpan_frag_rb_int {
-    /**
-     * @brief   next element in fragment interval list
-     */
-    struct gnrc_sixlowpan_frag_rb_int *next;
-    uint16_t start;             /**< start byte of the fragment interval */
-    uint16_t end;               /**< end byte of the fragment interval */
-} gnrc_sixlowpan_frag_rb_int_t;
+#define GNRC_SIXLOWPAN_FRAG_RB_UNITS    \
+    ((GNRC_SIXLOWPAN_FRAG_RBUF_DATAGRAM_MAX + 7U) / 8U)
 
 /**
  * @brief   Base class for both reassembly buffer and virtual reassembly buffer
@@ -69,7 +57,21 @@ typedef struct gnrc_sixlowpan_frag_rb_int {
  * @see https://tools.ietf.org/html/draft-ietf-lwig-6lowpan-virtual-reassembly-01
  */
 typedef struct {
-    gnrc_sixlowpan_frag_rb_int_t *ints;         /**< intervals of already received fragments */
+    /**
+     * @brief   8-byte units of the datagram already received
+     *
+     * Fragments MUST NOT overlap and overlapping fragments are to be
+     * discarded, see
+     * [RFC 4944, section 5.3](https://tools.ietf.org/html/rfc4944#section-5.3)
+     */
+    BITFIELD(received, GNRC_SIXLOWPAN_FRAG_RB_UNITS);
+    /**
+     * @brief   8-byte units a received fragment starts at
+     *
+     * Together with gnrc_sixlowpan_frag_rb_base_t::received this identifies
+     * the limits of all received fragments and thus duplicates.
+     */
+    BITFIELD(starts, GNRC_SIXLOWPAN_FRAG_RB_UNITS);
     uint8_t src[IEEE802154_LONG_ADDRESS_LEN];   /**< source address */
     uint8_t dst[IEEE802154_LONG_ADDRESS_LEN];   /**< destination address */
     uint8_t src_len;                            /**< length of gnrc_sixlowpan_frag_rb_t::src */
@@ -229,7 +231,8 @@ int gnrc_sixlowpan_frag_rb_dispatch_when_complete(gnrc_sixlowpan_frag_rb_t *rbuf
  *
  * @pre `rbuf != NULL`
  *
- * This functions sets rbuf_t::super::pkt to NULL and removes all rbuf::ints.
+ * This functions sets rbuf_t::super::pkt to NULL and clears the received
+ * fragments of rbuf_t::super.
  *
  * @note    Does nothing if module `gnrc_sixlowpan_frag_rb` is not included.
  *
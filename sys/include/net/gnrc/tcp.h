@@ -122,6 +122,8 @@ int gnrc_tcp_open_passive(gnrc_tcp_tcb_t *tcb, uint8_t address_family,
  * @pre @p data must not be NULL.
  *
  * @note Blocks until up to @p len bytes were transmitted or an error occured.
+ *       Transmitted data is held in the retransmission queue until the peer
+ *       acknowledges it, the function does not wait for the acknowledgment.
  *
  * @param[in,out] tcb                        TCB holding the connection information.
  * @param[in]     data                       Pointer to the data that should be transmitted.
@@ -189,6 +191,79 @@ void gnrc_tcp_close(gnrc_tcp_tcb_t *tcb);
  */
 void gnrc_tcp_abort(gnrc_tcp_tcb_t *tcb);
 
+#if GNRC_TCP_TCB_POOL_SIZE || defined(DOXYGEN)
+/**
+ * @brief Starts listening for incomming connection requests.
+ *
+ * Unlike gnrc_tcp_open_passive(), any number of connections to @p local_port
+ * can be established concurrently. Each of them uses a TCB from a pool of
+ * GNRC_TCP_TCB_POOL_SIZE preallocated TCBs until it is accepted with
+ * gnrc_tcp_accept() and closed again.
+ *
+ * @pre GNRC_TCP_TCB_POOL_SIZE must be greater than zero.
+ * @pre @p listener must not be NULL and not listen already.
+ * @pre if local_addr is not NULL, local_addr must be assigned to a network interface.
+ * @pre @p local_port must not be zero.
+ * @pre @p backlog must not be zero.
+ *
+ * @param[out] listener         Listener to set up.
+ * @param[in]  address_family   Address family of @p local_addr.
+ *                              If local_addr == NULL, address_family is ignored.
+ * @param[in]  local_addr       If not NULL connections are bound to @p local_addr.
+ *                              If NULL a connection request to all local ip
+ *                              addresses is valied.
+ * @param[in]  local_port       Port number to listen on.
+ * @param[in]  backlog          Maximum number of connections that are established
+ *                              or being established without being accepted.
+ *                              Further connection requests are ignored.
+ *
+ * @returns   0 on success.
+ *            -EAFNOSUPPORT if local_addr != NULL and @p address_family is not supported.
+ *            -EINVAL if @p local_addr is invalid.
+ *            -EADDRINUSE if another listener uses @p local_port.
+ */
+int gnrc_tcp_listen(gnrc_tcp_listener_t *listener, uint8_t address_family,
+                    const char *local_addr, uint16_t local_port, uint8_t backlog);
+
+/**
+ * @brief Accepts an established connection of a listener.
+ *
+ * @pre gnrc_tcp_listen() must have been successfully called on @p listener.
+ * @pre @p tcb must not be NULL.
+ *
+ * @note The accepted TCB is used like a TCB opened by gnrc_tcp_open_passive().
+ *       It must be released by gnrc_tcp_close() or gnrc_tcp_abort(), which
+ *       return it to the pool.
+ *
+ * @param[in,out] listener                   Listener to accept a connection from.
+ * @param[out]    tcb                        TCB of the accepted connection.
+ * @param[in]     user_timeout_duration_us   Timeout for accept in microseconds.
+ *                                           If zero and no connection is established,
+ *                                           the function returns immediately. If not
+ *                                           zero the function blocks until a connection
+ *                                           is established or @p user_timeout_duration_us
+ *                                           microseconds passed.
+ *
+ * @returns   0 on success.
+ *            -EAGAIN if user_timeout_duration_us is zero and no connection is established.
+ *            -ETIMEDOUT if @p user_timeout_duration_us expired.
+ */
+int gnrc_tcp_accept(gnrc_tcp_listener_t *listener, gnrc_tcp_tcb_t **tcb,
+                    const uint32_t user_timeout_duration_us);
+
+/**
+ * @brief Stops listening for incomming connection requests.
+ *
+ * Connections that were not accepted yet are aborted. Accepted connections
+ * are not affected. @p listener is not referenced anymore after return.
+ *
+ * @pre gnrc_tcp_listen() must have been successfully called on @p listener.
+ *
+ * @param[in,out] listener   Listener to stop.
+ */
+void gnrc_tcp_stop_listen(gnrc_tcp_listener_t *listener);
+#endif
+
 /**
  * @brief Calculate and set checksum in TCP header.
  *
@@ -79,6 +79,57 @@ extern "C" {
 #define GNRC_TCP_RCV_BUF_SIZE (GNRC_TCP_DEFAULT_WINDOW)
 #endif
 
+/**
+ * @brief Number of data segments that may be in flight unacknowledged
+ *
+ * This is the size of the retransmission queue and thereby limits the send
+ * window to GNRC_TCP_RETRANSMIT_QUEUE_SIZE * MSS bytes. Each queued segment
+ * occupies packet buffer space until it is acknowledged.
+ */
+#ifndef GNRC_TCP_RETRANSMIT_QUEUE_SIZE
+#define GNRC_TCP_RETRANSMIT_QUEUE_SIZE (2U)
+#endif
+
+/**
+ * @brief Shift count announced in the window scale option (see RFC 7323)
+ *
+ * Must be set if GNRC_TCP_RCV_BUF_SIZE exceeds 65535 bytes, otherwise the
+ * announced receive window is truncated.
+ */
+#ifndef GNRC_TCP_WINDOW_SCALE
+#define GNRC_TCP_WINDOW_SCALE (0U)
+#endif
+
+/**
+ * @brief Number of out-of-order segments held for reassembly and reported
+ *        to the peer by selective acknowledgments (see RFC 2018)
+ *
+ * Zero disables SACK. At most 4 blocks fit into the TCP option space.
+ */
+#ifndef GNRC_TCP_SACK_BLOCKS
+#define GNRC_TCP_SACK_BLOCKS (3U)
+#endif
+
+/**
+ * @brief Number of buckets of the hash table used to look up the TCB of an
+ *        incoming segment
+ *
+ * Must be a power of two.
+ */
+#ifndef GNRC_TCP_TCB_TABLE_SIZE
+#define GNRC_TCP_TCB_TABLE_SIZE (8U)
+#endif
+
+/**
+ * @brief Number of preallocated TCBs for connections accepted by a listener
+ *
+ * Zero disables gnrc_tcp_listen() and gnrc_tcp_accept(). Every connection
+ * taken from the pool also needs one of the GNRC_TCP_RCV_BUFFERS.
+ */
+#ifndef GNRC_TCP_TCB_POOL_SIZE
+#define GNRC_TCP_TCB_POOL_SIZE (0U)
+#endif
+
 /**
  * @brief Lower bound for RTO = 1 sec (see RFC 6298)
  */
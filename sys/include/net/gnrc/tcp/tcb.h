@@ -43,6 +43,21 @@ extern "C" {
  */
 #define GNRC_TCP_TCB_MBOX_SIZE (8U)
 
+/**
+ * @brief Size of the listener mbox
+ */
+#define GNRC_TCP_LISTENER_MBOX_SIZE (4U)
+
+/**
+ * @brief Segment held in the retransmission or out-of-order queue of a TCB.
+ */
+typedef struct {
+    gnrc_pktsnip_t *pkt;   /**< Packet containing the segment */
+    uint32_t seq;          /**< Sequence number of the segment */
+    uint16_t len;          /**< Sequence space consumed by the segment */
+    uint8_t sacked;        /**< Flag: segment was selectively acknowledged */
+} gnrc_tcp_seg_t;
+
 /**
  * @brief Transmission control block of GNRC TCP.
  */
@@ -59,31 +74,63 @@ typedef struct _transmission_control_block {
     uint8_t status;        /**< A connections status flags */
     uint32_t snd_una;      /**< Send unacknowledged */
     uint32_t snd_nxt;      /**< Send next */
-    uint16_t snd_wnd;      /**< Send window */
+    uint32_t snd_wnd;      /**< Send window */
     uint32_t snd_wl1;      /**< SeqNo. from last window update */
     uint32_t snd_wl2;      /**< AckNo. from last window update */
     uint32_t rcv_nxt;      /**< Receive next */
-    uint16_t rcv_wnd;      /**< Receive window */
+    uint32_t rcv_wnd;      /**< Receive window */
+    uint8_t snd_wnd_shift; /**< Scale applied to windows announced by the peer */
+    uint8_t rcv_wnd_shift; /**< Scale applied to windows announced to the peer */
     uint32_t iss;          /**< Initial sequence sumber */
     uint32_t irs;          /**< Initial received sequence number */
     uint16_t mss;          /**< The peers MSS */
     uint32_t rtt_start;    /**< Timer value for rtt estimation */
+    uint32_t rtt_seq;      /**< Sequence number that ends rtt estimation */
     int32_t rtt_var;       /**< Round trip time variance */
     int32_t srtt;          /**< Smoothed round trip time */
     int32_t rto;           /**< Retransmission timeout duration */
     uint8_t retries;       /**< Number of retransmissions */
+    uint8_t dup_acks;      /**< Number of duplicate acknowledgments */
     xtimer_t tim_tout;     /**< Timer struct for timeouts */
     msg_t msg_tout;        /**< Message, sent on timeouts */
-    gnrc_pktsnip_t *pkt_retransmit;   /**< Pointer to packet in "retransmit queue" */
+    gnrc_tcp_seg_t rtx[GNRC_TCP_RETRANSMIT_QUEUE_SIZE + 1]; /**< Retransmit queue, one
+                                                             additional slot for SYN or FIN */
+    uint8_t rtx_len;       /**< Number of segments in retransmit queue */
+#if GNRC_TCP_SACK_BLOCKS
+    gnrc_tcp_seg_t ooo[GNRC_TCP_SACK_BLOCKS];   /**< Out-of-order received segments */
+    uint8_t ooo_len;       /**< Number of out-of-order received segments */
+#endif
     msg_t mbox_raw[GNRC_TCP_TCB_MBOX_SIZE];   /**< Msg queue for mbox */
     mbox_t mbox;             /**< TCB mbox for synchronization */
     uint8_t *rcv_buf_raw;    /**< Pointer to the receive buffer */
     ringbuffer_t rcv_buf;    /**< Receive buffer data structure */
     mutex_t fsm_lock;        /**< Mutex for FSM access synchronization */
     mutex_t function_lock;   /**< Mutex for function call synchronization */
+#if GNRC_TCP_TCB_POOL_SIZE
+    struct _gnrc_tcp_listener *listener;        /**< Listener the connection waits to be
+                                                     accepted by, NULL once accepted */
+#endif
     struct _transmission_control_block *next;   /**< Pointer next TCB */
 } gnrc_tcp_tcb_t;
 
+/**
+ * @brief Listener of GNRC TCP, accepting connections into TCBs taken from a
+ *        preallocated pool.
+ */
+typedef struct _gnrc_tcp_listener {
+    uint8_t address_family;                   /**< Address Family of local_addr */
+#ifdef MODULE_GNRC_IPV6
+    uint8_t local_addr[sizeof(ipv6_addr_t)];  /**< Local IP address, unspecified for any */
+#endif
+    uint16_t local_port;     /**< Port number to listen on */
+    uint8_t backlog;         /**< Maximum number of connections waiting to be accepted */
+    uint8_t pending;         /**< Number of connections waiting to be accepted */
+    msg_t mbox_raw[GNRC_TCP_LISTENER_MBOX_SIZE];  /**< Msg queue for mbox */
+    mbox_t mbox;             /**< Listener mbox for synchronization */
+    mutex_t function_lock;   /**< Mutex for function call synchronization */
+    struct _gnrc_tcp_listener *next;  /**< Pointer to next listener */
+} gnrc_tcp_listener_t;
+
 #ifdef __cplusplus
 }
 #endif
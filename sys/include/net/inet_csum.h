@@ -49,6 +49,26 @@ extern "C" {
  */
 uint16_t inet_csum_slice(uint16_t sum, const uint8_t *buf, uint16_t len, size_t accum_len);
 
+/**
+ * @brief   Copies @p src to @p dst and calculates the unnormalized Internet
+ *          Checksum of it in the same pass.
+ *
+ * @details Same as inet_csum_slice() on @p src, but saves a second pass over
+ *          the data when it is copied anyway, e.g. into a packet buffer.
+ *
+ * @param[in] sum       An initial value for the checksum.
+ * @param[out] dst      Destination buffer of at least @p len byte. Must not
+ *                      overlap with @p src.
+ * @param[in] src       A buffer.
+ * @param[in] len       Length of @p src in byte.
+ * @param[in] accum_len Accumulated length of checksum domain that has already
+ *                      been checksummed.
+ *
+ * @return  The unnormalized Internet Checksum of @p src.
+ */
+uint16_t inet_csum_slice_copy(uint16_t sum, uint8_t *dst, const uint8_t *src,
+                              uint16_t len, size_t accum_len);
+
 /**
  * @brief   Calculates the unnormalized Internet Checksum of @p buf, where the
  *          buffer provides a standalone domain for the checksum.
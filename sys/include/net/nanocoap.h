@@ -239,6 +239,10 @@ typedef struct {
 
 /**
  * @brief   Global CoAP resource list
+ *
+ * Must be ordered alphabetically by path. Requests are resolved by binary
+ * search, so a resource matching the path exactly takes precedence over a
+ * @ref COAP_MATCH_SUBTREE resource for a prefix of the path.
  */
 extern const coap_resource_t coap_resources[];
 
@@ -51,6 +51,11 @@ typedef struct {
     uint32_t tx_bytes;          /**< sent bytes */
     uint32_t rx_count;          /**< received (data) packets */
     uint32_t rx_bytes;          /**< received bytes */
+    uint32_t rx_wakeups;        /**< wake-ups to handle device events (only
+                                     counted by interfaces that coalesce
+                                     device interrupts) */
+    uint32_t rx_batch_max;      /**< maximum number of packets received
+                                     within one wake-up */
 } netstats_t;
 
 #ifdef __cplusplus
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_sock_async  Asynchronous sock notifications
+ * @ingroup     net_sock
+ * @brief       Callbacks notifying a sock user about events on a sock
+ *
+ * With the `sock_async` module, a callback can be set on a sock that is
+ * called by the network stack when the state of the sock changes, e.g. when
+ * a message was received. The callback runs in the context of the network
+ * stack, so it must return quickly and must not call blocking sock functions.
+ * It is meant to wake up a thread that then calls the non-blocking functions
+ * of the sock (i.e. with a timeout of 0).
+ *
+ * A stack supporting this API defines `SOCK_HAS_ASYNC` in its `sock_types.h`.
+ * For @ref net_gnrc "GNRC" the implementation is `gnrc_sock_async`, which is
+ * pulled in by `sock_async`. No other stack implements it yet.
+ *
+ * Only raw IP and UDP socks are covered, there are no callbacks for TCP socks.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Asynchronous sock notification definitions
+ */
+#ifndef NET_SOCK_ASYNC_H
+#define NET_SOCK_ASYNC_H
+
+#include "net/sock/async/types.h"
+
+#ifdef MODULE_SOCK_IP
+#include "net/sock/ip.h"
+#endif
+#ifdef MODULE_SOCK_UDP
+#include "net/sock/udp.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(MODULE_SOCK_IP) || defined(DOXYGEN)
+/**
+ * @brief   Sets the event callback of a raw IPv4/IPv6 sock
+ *
+ * Creating the sock unsets the callback, so this is called after creation.
+ * The callback is kept when the sock is bound implicitly.
+ *
+ * @param[in] sock  A raw IPv4/IPv6 sock object
+ * @param[in] cb    An event callback, NULL to unset
+ * @param[in] arg   Argument for @p cb
+ */
+void sock_ip_set_cb(sock_ip_t *sock, sock_ip_cb_t cb, void *arg);
+#endif
+
+#if defined(MODULE_SOCK_UDP) || defined(DOXYGEN)
+/**
+ * @brief   Sets the event callback of a UDP sock
+ *
+ * Creating the sock unsets the callback, so this is called after creation.
+ * The callback is kept when the sock is bound implicitly.
+ *
+ * @param[in] sock  A UDP sock object
+ * @param[in] cb    An event callback, NULL to unset
+ * @param[in] arg   Argument for @p cb
+ */
+void sock_udp_set_cb(sock_udp_t *sock, sock_udp_cb_t cb, void *arg);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_SOCK_ASYNC_H */
+/** @} */
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_sock_async_event    Asynchronous sock with event API
+ * @ingroup     net_sock_async
+ * @brief       Handles the events of socks in the thread of an
+ *              @ref sys_event "event queue"
+ *
+ * With the `sock_async_event` module, the callbacks of
+ * @ref net_sock_async are not called by the network stack, but posted as
+ * events to an event queue. The handler of a sock then runs in the thread
+ * serving the queue and can call any sock function, so several protocols
+ * (e.g. CoAP, MQTT-SN and DNS) can share a single thread and stack instead
+ * of blocking on a sock each in a thread of their own.
+ *
+ * The network stack must implement @ref net_sock_async (`SOCK_HAS_ASYNC`),
+ * currently only @ref net_gnrc "GNRC" does.
+ *
+ * Like @ref event_timeout_t, the event object is provided by the caller.
+ * Events happening on the sock while its event is queued are combined, so
+ * the handler must read until the sock has no more data (i.e. with a
+ * timeout of 0 until `-EAGAIN` is returned).
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~ {.c}
+ * static sock_udp_t sock;
+ * static sock_event_t sock_event;
+ * static event_queue_t queue;
+ *
+ * static void handler(sock_udp_t *sock, sock_async_flags_t flags, void *arg)
+ * {
+ *     if (flags & SOCK_ASYNC_MSG_RECV) {
+ *         uint8_t buf[64];
+ *         ssize_t res;
+ *
+ *         while ((res = sock_udp_recv(sock, buf, sizeof(buf), 0, NULL)) != -EAGAIN) {
+ *             ...
+ *         }
+ *     }
+ * }
+ *
+ * int main(void)
+ * {
+ *     sock_udp_ep_t local = { .family = AF_INET6, .port = 5683 };
+ *
+ *     event_queue_init(&queue);
+ *     sock_udp_create(&sock, &local, NULL, 0);
+ *     sock_udp_event_init(&sock, &sock_event, &queue, handler, NULL);
+ *     event_loop(&queue);
+ *     return 0;
+ * }
+ * ~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * @{
+ *
+ * @file
+ * @brief       Asynchronous sock using the event API definitions
+ */
+#ifndef NET_SOCK_ASYNC_EVENT_H
+#define NET_SOCK_ASYNC_EVENT_H
+
+/* "event.h" would resolve to this file */
+#include <event.h>
+#include "net/sock/async.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Event of a sock
+ *
+ * The members are private, the event is set up by one of the
+ * `sock_*_event_init()` functions.
+ */
+typedef struct {
+    event_t super;                  /**< event structure that gets posted */
+    event_queue_t *queue;           /**< queue the event is posted to */
+    void *sock;                     /**< the sock */
+    /**
+     * @brief   Handler of the sock
+     */
+    union {
+        sock_ip_cb_t ip;            /**< for raw IP socks */
+        sock_udp_cb_t udp;          /**< for UDP socks */
+    } handler;
+    void *handler_arg;              /**< argument of the handler */
+    unsigned flags;                 /**< events not yet handled */
+} sock_event_t;
+
+#if defined(MODULE_SOCK_IP) || defined(DOXYGEN)
+/**
+ * @brief   Makes a raw IPv4/IPv6 sock able to handle events on an event queue
+ *
+ * @param[in] sock          A raw IPv4/IPv6 sock object
+ * @param[out] event        The event of @p sock, must stay valid while the
+ *                          sock is in use
+ * @param[in] queue         The queue to post the events of @p sock to
+ * @param[in] handler       Handler for the events of @p sock, called in the
+ *                          thread of @p queue
+ * @param[in] handler_arg   Argument for @p handler
+ */
+void sock_ip_event_init(sock_ip_t *sock, sock_event_t *event,
+                        event_queue_t *queue, sock_ip_cb_t handler,
+                        void *handler_arg);
+#endif
+
+#if defined(MODULE_SOCK_UDP) || defined(DOXYGEN)
+/**
+ * @brief   Makes a UDP sock able to handle events on an event queue
+ *
+ * @param[in] sock          A UDP sock object
+ * @param[out] event        The event of @p sock, must stay valid while the
+ *                          sock is in use
+ * @param[in] queue         The queue to post the events of @p sock to
+ * @param[in] handler       Handler for the events of @p sock, called in the
+ *                          thread of @p queue
+ * @param[in] handler_arg   Argument for @p handler
+ */
+void sock_udp_event_init(sock_udp_t *sock, sock_event_t *event,
+                         event_queue_t *queue, sock_udp_cb_t handler,
+                         void *handler_arg);
+#endif
+
+/**
+ * @brief   Removes a pending event of a sock from its queue
+ *
+ * Must be called from the thread of the queue after the sock was closed,
+ * before @p event is reused.
+ *
+ * @param[in] event The event of a closed sock
+ */
+void sock_event_cancel(sock_event_t *event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_SOCK_ASYNC_EVENT_H */
+/** @} */
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @addtogroup  net_sock_async
+ * @{
+ *
+ * @file
+ * @brief       Types of the asynchronous sock notifications
+ *
+ * Separate from @ref net/sock/async.h so that a stack's `sock_types.h` can
+ * use them, the sock types are only referred to by their struct tags.
+ */
+#ifndef NET_SOCK_ASYNC_TYPES_H
+#define NET_SOCK_ASYNC_TYPES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Event flags passed to the callbacks
+ *
+ * Several flags may be set in a single call.
+ */
+typedef enum {
+    SOCK_ASYNC_CONN_RDY  = 0x0001,  /**< connection established */
+    SOCK_ASYNC_CONN_FIN  = 0x0002,  /**< connection closed by the peer */
+    SOCK_ASYNC_CONN_RECV = 0x0004,  /**< listener received a connection */
+    SOCK_ASYNC_MSG_RECV  = 0x0010,  /**< message or data received */
+    SOCK_ASYNC_MSG_SENT  = 0x0020,  /**< message or data sent */
+} sock_async_flags_t;
+
+struct sock_ip;
+struct sock_udp;
+
+/**
+ * @brief   Event callback for @ref sock_ip_t
+ *
+ * @param[in] sock  The sock the event happened on
+ * @param[in] flags The events that happened
+ * @param[in] arg   Argument given to sock_ip_set_cb()
+ */
+typedef void (*sock_ip_cb_t)(struct sock_ip *sock, sock_async_flags_t flags,
+                             void *arg);
+
+/**
+ * @brief   Event callback for @ref sock_udp_t
+ *
+ * @param[in] sock  The sock the event happened on
+ * @param[in] flags The events that happened
+ * @param[in] arg   Argument given to sock_udp_set_cb()
+ */
+typedef void (*sock_udp_cb_t)(struct sock_udp *sock, sock_async_flags_t flags,
+                              void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_SOCK_ASYNC_TYPES_H */
+/** @} */
@@ -273,6 +273,7 @@
 #include <stdlib.h>
 #include <sys/types.h>
 
+#include "iolist.h"
 #include "net/sock.h"
 
 #ifdef __cplusplus
@@ -438,6 +439,39 @@ ssize_t sock_udp_recv(sock_udp_t *sock, void *data, size_t max_len,
 ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
                       const sock_udp_ep_t *remote);
 
+/**
+ * @brief   Sends a UDP message, gathered from a list of buffers, to remote
+ *          end point
+ *
+ * The payload of the datagram is the concatenation of all buffers in
+ * @p snips. Implementations may reference the buffers directly instead of
+ * copying them (e.g. GNRC with module `gnrc_pktbuf_ext`), but the buffers
+ * are free to be reused by the caller once this function returns. To
+ * guarantee this, such implementations block until the network stack
+ * released the buffers, so this function must not be called from a thread
+ * the stack hands the packet to itself.
+ *
+ * @pre `((sock != NULL || remote != NULL))`
+ *
+ * @param[in] sock      A raw IPv4/IPv6 sock object. May be `NULL`.
+ *                      A sensible local end point should be selected by the
+ *                      implementation in that case.
+ * @param[in] snips     List of buffers that make up the payload. May be
+ *                      `NULL` for an empty datagram.
+ * @param[in] remote    Remote end point for the sent data.
+ *                      May be `NULL`, if @p sock has a remote end point.
+ *                      sock_udp_ep_t::family may be AF_UNSPEC, if local
+ *                      end point of @p sock provides this information.
+ *                      sock_udp_ep_t::port may not be 0.
+ *
+ * @return  The number of bytes sent on success.
+ * @return  The same error codes as sock_udp_send() on failure.
+ *
+ * @note    Currently only provided by the GNRC implementation.
+ */
+ssize_t sock_udp_sendv(sock_udp_t *sock, const iolist_t *snips,
+                       const sock_udp_ep_t *remote);
+
 #include "sock_types.h"
 
 #ifdef __cplusplus
@@ -15,6 +15,14 @@
  * @note        This ringbuffer implementation can be used without locking if
  *              there's only one producer and one consumer.
  *
+ * Besides copying data in and out with @ref tsrb_add() and @ref tsrb_get(),
+ * the producer can write to the buffer in place: @ref tsrb_get_write_span()
+ * returns the largest contiguous free region, which is made visible to the
+ * consumer by @ref tsrb_commit_write(). Likewise, the consumer can process
+ * data in place using @ref tsrb_get_read_span() and @ref tsrb_commit_read().
+ * As the buffer may wrap around, it can take two spans to cover all free
+ * space or all available data.
+ *
  * @attention   Buffer size must be a power of two!
  *
  * @file
@@ -154,6 +162,46 @@ int tsrb_add_one(tsrb_t *rb, uint8_t c);
  */
 int tsrb_add(tsrb_t *rb, const uint8_t *src, size_t n);
 
+/**
+ * @brief       Get the largest contiguous region of data available for reading
+ *
+ * The data stays in the ringbuffer until it is released with
+ * @ref tsrb_commit_read(). Must only be called by the consumer.
+ *
+ * @param[in]   rb      Ringbuffer to operate on
+ * @param[out]  data    start of the readable region
+ * @return      nr of bytes readable at @p data, 0 if @p rb is empty
+ */
+unsigned tsrb_get_read_span(const tsrb_t *rb, uint8_t **data);
+
+/**
+ * @brief       Release bytes obtained via @ref tsrb_get_read_span()
+ * @param[in]   rb  Ringbuffer to operate on
+ * @param[in]   n   nr of bytes to release, must not exceed the length of
+ *                  the span
+ */
+void tsrb_commit_read(tsrb_t *rb, unsigned n);
+
+/**
+ * @brief       Get the largest contiguous region of free space
+ *
+ * Data written to the region becomes visible to the consumer only after
+ * @ref tsrb_commit_write(). Must only be called by the producer.
+ *
+ * @param[in]   rb      Ringbuffer to operate on
+ * @param[out]  data    start of the writable region
+ * @return      nr of bytes writable at @p data, 0 if @p rb is full
+ */
+unsigned tsrb_get_write_span(const tsrb_t *rb, uint8_t **data);
+
+/**
+ * @brief       Add bytes written to a region obtained via
+ *              @ref tsrb_get_write_span()
+ * @param[in]   rb  Ringbuffer to operate on
+ * @param[in]   n   nr of bytes to add, must not exceed the length of the span
+ */
+void tsrb_commit_write(tsrb_t *rb, unsigned n);
+
 #ifdef __cplusplus
 }
 #endif
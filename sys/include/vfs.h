@@ -41,6 +41,12 @@
  * driver knows how to use, which can be used to keep driver parameters in order
  * to allow dynamic handling of multiple devices.
  *
+ * File system drivers resolving paths by a search through their own data
+ * structures can keep the results in a small cache shared by all mounts, see
+ * vfs_dcache_lookup() (module `vfs_dcache`). The VFS layer drops cached
+ * entries when files are removed or renamed and when a file system is
+ * unmounted.
+ *
  * @todo VFS layer reference counting and locking for open files and
  *       simultaneous access.
  *
@@ -153,6 +159,21 @@ extern "C" {
 #define VFS_NAME_MAX (31)
 #endif
 
+#ifndef VFS_DCACHE_SIZE
+/**
+ * @brief Number of entries in the path lookup cache (module `vfs_dcache`)
+ */
+#define VFS_DCACHE_SIZE (8)
+#endif
+
+#ifndef VFS_DCACHE_PATH_MAX
+/**
+ * @brief Maximum length of a path in the path lookup cache (not including
+ * terminating null), longer paths are not cached
+ */
+#define VFS_DCACHE_PATH_MAX (23)
+#endif
+
 /**
  * @brief Used with vfs_bind to bind to any available fd number
  */
@@ -873,7 +894,9 @@ int vfs_normalize_path(char *buf, const char *path, size_t buflen);
  * @attention Not thread safe! Do not mix calls to this function with other
  * calls which modify the mount table, such as vfs_mount() and vfs_umount()
  *
- * Set @p cur to @c NULL to start from the beginning
+ * Set @p cur to @c NULL to start from the beginning. File systems are listed
+ * in order of decreasing mount point length, in mount order for equal
+ * lengths.
  *
  * @see @c sc_vfs.c (@c df command) for a usage example
  *
@@ -884,6 +907,68 @@ int vfs_normalize_path(char *buf, const char *path, size_t buflen);
  */
 const vfs_mount_t *vfs_iterate_mounts(const vfs_mount_t *cur);
 
+#if defined(MODULE_VFS_DCACHE) || defined(DOXYGEN)
+/**
+ * @brief Look up a path in the path lookup cache
+ *
+ * For use by file system drivers, @p path is the path relative to the mount
+ * point as passed to the driver.
+ *
+ * @param[in]  mountp   mount point the path belongs to
+ * @param[in]  path     path to look up
+ *
+ * @return     node added for @p path with vfs_dcache_add()
+ * @return     NULL if @p path is not cached
+ */
+void *vfs_dcache_lookup(const vfs_mount_t *mountp, const char *path);
+
+/**
+ * @brief Add a path to the path lookup cache
+ *
+ * The least recently used entry is replaced, an existing entry of @p path
+ * is updated. Paths longer than @ref VFS_DCACHE_PATH_MAX are not cached.
+ *
+ * @param[in]  mountp   mount point the path belongs to
+ * @param[in]  path     path relative to the mount point
+ * @param[in]  node     driver specific object @p path resolves to
+ */
+void vfs_dcache_add(const vfs_mount_t *mountp, const char *path, void *node);
+
+/**
+ * @brief Drop entries from the path lookup cache
+ *
+ * Called by the VFS layer when files are removed or renamed and when a file
+ * system is unmounted. Drivers call it when the node of a cached path becomes
+ * invalid otherwise.
+ *
+ * @param[in]  mountp   mount point to drop entries of, NULL for all
+ * @param[in]  path     path to drop, NULL for all paths
+ */
+void vfs_dcache_invalidate(const vfs_mount_t *mountp, const char *path);
+#else
+static inline void *vfs_dcache_lookup(const vfs_mount_t *mountp, const char *path)
+{
+    (void)mountp;
+    (void)path;
+    return NULL;
+}
+
+static inline void vfs_dcache_add(const vfs_mount_t *mountp, const char *path,
+                                  void *node)
+{
+    (void)mountp;
+    (void)path;
+    (void)node;
+}
+
+static inline void vfs_dcache_invalidate(const vfs_mount_t *mountp,
+                                         const char *path)
+{
+    (void)mountp;
+    (void)path;
+}
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -69,6 +69,13 @@ typedef void (*xtimer_callback_t)(void*);
  */
 typedef struct xtimer {
     struct xtimer *next;         /**< reference to next timer in timer lists */
+#if defined(MODULE_XTIMER_WHEEL) || defined(DOXYGEN)
+    struct xtimer **prev;        /**< reference to the pointer to this timer,
+                                     only with the `xtimer_wheel` module */
+    uintptr_t check;             /**< xtimer_t::prev XOR the address of
+                                     the timer, tells a set timer from
+                                     uninitialized memory */
+#endif
     uint32_t target;             /**< lower 32bit absolute target time */
     uint32_t long_target;        /**< upper 32bit absolute target time */
     xtimer_callback_t callback;  /**< callback function to call when timer
@@ -539,6 +546,41 @@ void xtimer_set_timeout_flag(xtimer_t *t, uint32_t timeout);
 #define XTIMER_PERIODIC_RELATIVE (512)
 #endif
 
+#ifndef XTIMER_WHEEL_SLOT_SHIFT
+/**
+ * @brief   Width of a slot of the finest timer wheel level, as power of two
+ *          hardware ticks
+ *
+ * Only used with the `xtimer_wheel` module. Timers due within the current slot
+ * are kept in a sorted list, so this should be in the order of the typical
+ * shortest timeout.
+ */
+#define XTIMER_WHEEL_SLOT_SHIFT (8)
+#endif
+
+#ifndef XTIMER_WHEEL_BITS
+/**
+ * @brief   Number of slots per timer wheel level, as power of two
+ *
+ * Only used with the `xtimer_wheel` module. The slots of a level are tracked
+ * in a bitmap of type `unsigned`, so this must be at most 4 on 16-bit
+ * platforms.
+ */
+#define XTIMER_WHEEL_BITS (4)
+#endif
+
+#ifndef XTIMER_WHEEL_LEVELS
+/**
+ * @brief   Number of timer wheel levels
+ *
+ * Only used with the `xtimer_wheel` module. Timers further than
+ * 2^(@ref XTIMER_WHEEL_SLOT_SHIFT + @ref XTIMER_WHEEL_BITS *
+ * @ref XTIMER_WHEEL_LEVELS) ticks in the future are kept in an unsorted list
+ * that is revisited each time the wheel completes a full turn.
+ */
+#define XTIMER_WHEEL_LEVELS (6)
+#endif
+
 /*
  * Default xtimer configuration
  */
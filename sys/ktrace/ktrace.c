@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_ktrace
+ * @{
+ *
+ * @file
+ * @brief       Kernel event tracer implementation
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "cpu.h"
+#include "irq.h"
+#include "ktrace.h"
+#include "sched.h"
+#include "thread.h"
+
+#if defined(CPU_NATIVE)
+/* provided by native_ktrace */
+uint64_t native_ktrace_clock(void);
+#define KTRACE_CLOCK_HZ     (1000000000LU)
+#elif defined(DWT_CTRL_CYCCNTENA_Msk)
+#include "periph_conf.h"
+#define KTRACE_CLOCK_HZ     (CLOCK_CORECLOCK)
+#else
+#include "xtimer.h"
+#define KTRACE_CLOCK_HZ     (US_PER_SEC)
+#endif
+
+#if (KTRACE_BUF_SIZE & (KTRACE_BUF_SIZE - 1)) != 0
+#error "KTRACE_BUF_SIZE must be a power of two"
+#endif
+
+static ktrace_entry_t _buf[KTRACE_BUF_SIZE];
+static uint32_t _head;
+static uint8_t _enabled;
+static uint64_t _last;      /* time of the last entry */
+
+static inline uint64_t _clock(void)
+{
+#if defined(CPU_NATIVE)
+    return native_ktrace_clock();
+#elif defined(DWT_CTRL_CYCCNTENA_Msk)
+    /* only a wrap since the last entry can be seen */
+    uint32_t now = DWT->CYCCNT;
+    uint64_t time = (_last & ~(uint64_t)UINT32_MAX) | now;
+    if (now < (uint32_t)_last) {
+        time += (uint64_t)UINT32_MAX + 1;
+    }
+    return time;
+#else
+    return xtimer_now_usec64();
+#endif
+}
+
+static void _put(uint32_t time, ktrace_event_t event, uint32_t arg0,
+                 uint32_t arg1)
+{
+    ktrace_entry_t *entry = &_buf[_head++ & (KTRACE_BUF_SIZE - 1)];
+
+    entry->time = time;
+    entry->event = event;
+    entry->flags = irq_is_in() ? KTRACE_FLAG_ISR : 0;
+    entry->pid = sched_active_pid;
+    entry->arg0 = arg0;
+    entry->arg1 = arg1;
+}
+
+void ktrace_init(void)
+{
+#if !defined(CPU_NATIVE) && defined(DWT_CTRL_CYCCNTENA_Msk)
+    /* enable the cycle counter of the DWT unit */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    ktrace_clear();
+    ktrace_start();
+}
+
+void ktrace_start(void)
+{
+    _enabled = 1;
+}
+
+void ktrace_stop(void)
+{
+    _enabled = 0;
+}
+
+void ktrace_clear(void)
+{
+    unsigned state = irq_disable();
+    _head = 0;
+    _last = 0;
+    irq_restore(state);
+}
+
+void ktrace_record(ktrace_event_t event, uint32_t arg0, uint32_t arg1)
+{
+    unsigned state = irq_disable();
+
+    if (_enabled) {
+        uint64_t now = _clock();
+        uint32_t high = now >> 32;
+
+        /* lets the decoder place the entry however long the gap was */
+        if (high != (uint32_t)(_last >> 32)) {
+            _put((uint32_t)now, KTRACE_EVENT_SYNC, high, _last >> 32);
+        }
+        _last = now;
+        _put((uint32_t)now, event, arg0, arg1);
+    }
+    irq_restore(state);
+}
+
+int ktrace_dump(ktrace_write_t write, void *arg)
+{
+    ktrace_hdr_t hdr;
+    int res = 0;
+    uint8_t enabled = _enabled;
+
+    /* pause recording, the buffer must not change while it is written */
+    _enabled = 0;
+
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = KTRACE_MAGIC;
+    hdr.version = KTRACE_VERSION;
+    hdr.entry_size = sizeof(ktrace_entry_t);
+    hdr.clock_hz = KTRACE_CLOCK_HZ;
+    hdr.count = (_head < KTRACE_BUF_SIZE) ? _head : KTRACE_BUF_SIZE;
+    hdr.lost = _head - hdr.count;
+    for (kernel_pid_t pid = KERNEL_PID_FIRST; pid <= KERNEL_PID_LAST; pid++) {
+        if (thread_getname(pid) != NULL) {
+            hdr.threads++;
+        }
+    }
+
+    if ((res = write(arg, &hdr, sizeof(hdr))) < 0) {
+        goto out;
+    }
+
+    /* write the oldest entries first, the buffer wraps at most once */
+    unsigned start = (_head - hdr.count) & (KTRACE_BUF_SIZE - 1);
+    unsigned first = KTRACE_BUF_SIZE - start;
+    if (first > hdr.count) {
+        first = hdr.count;
+    }
+    if ((res = write(arg, &_buf[start], first * sizeof(ktrace_entry_t))) < 0) {
+        goto out;
+    }
+    if ((hdr.count > first) &&
+        (res = write(arg, &_buf[0], (hdr.count - first) * sizeof(ktrace_entry_t))) < 0) {
+        goto out;
+    }
+
+    /* threads started meanwhile are skipped, the decoder copes with fewer records */
+    unsigned threads = 0;
+    for (kernel_pid_t pid = KERNEL_PID_FIRST;
+         (pid <= KERNEL_PID_LAST) && (threads < hdr.threads); pid++) {
+        const char *name = thread_getname(pid);
+        if (name == NULL) {
+            continue;
+        }
+        threads++;
+        uint8_t len = strnlen(name, UINT8_MAX);
+        if (((res = write(arg, &pid, sizeof(pid))) < 0) ||
+            ((res = write(arg, &len, sizeof(len))) < 0) ||
+            ((res = write(arg, name, len)) < 0)) {
+            goto out;
+        }
+    }
+    res = 0;
+
+out:
+    _enabled = enabled;
+    return res;
+}
@@ -31,6 +31,11 @@
 #include "net/mqttsn.h"
 #include "emcute_internal.h"
 
+#ifdef MODULE_SOCK_ASYNC_EVENT
+#include "event/timeout.h"
+#include "net/sock/async/event.h"
+#endif
+
 #define ENABLE_DEBUG        (0)
 #include "debug.h"
 
@@ -48,6 +53,12 @@ static const char *cli_id;
 static sock_udp_t sock;
 static sock_udp_ep_t gateway;
 
+#ifdef MODULE_SOCK_ASYNC_EVENT
+static sock_event_t sock_event;
+static event_timeout_t ping_timeout;
+static event_t ping_event;
+#endif
+
 static uint8_t rbuf[EMCUTE_BUFSIZE];
 static uint8_t tbuf[EMCUTE_BUFSIZE];
 
@@ -490,13 +501,48 @@ int emcute_willupd_msg(const void *data, size_t len)
     return syncsend(WILLMSGRESP, len, true);
 }
 
-void emcute_run(uint16_t port, const char *id)
+static void on_pkt(ssize_t len, sock_udp_ep_t *remote)
+{
+    uint16_t pkt_len;
+    /* catch invalid length field */
+    if ((len == 2) && (rbuf[0] == 0x01)) {
+        return;
+    }
+    /* parse length field */
+    size_t pos = get_len(rbuf, &pkt_len);
+    /* verify length to prevent overflows */
+    if (((size_t)pkt_len > (size_t)len) || (pos >= (size_t)len)) {
+        return;
+    }
+    /* get packet type */
+    uint8_t type = rbuf[pos];
+
+    switch (type) {
+        case CONNACK:       on_ack(type, 0, 2, 0);              break;
+        case WILLTOPICREQ:  on_ack(type, 0, 0, 0);              break;
+        case WILLMSGREQ:    on_ack(type, 0, 0, 0);              break;
+        case REGACK:        on_ack(type, 4, 6, 2);              break;
+        case PUBLISH:       on_publish((size_t)pkt_len, pos);   break;
+        case PUBACK:        on_ack(type, 4, 6, 0);              break;
+        case SUBACK:        on_ack(type, 5, 7, 3);              break;
+        case UNSUBACK:      on_ack(type, 2, 0, 0);              break;
+        case PINGREQ:       on_pingreq(remote);                 break;
+        case PINGRESP:      on_pingresp();                      break;
+        case DISCONNECT:    on_disconnect();                    break;
+        case WILLTOPICRESP: on_ack(type, 0, 0, 0);              break;
+        case WILLMSGRESP:   on_ack(type, 0, 0, 0);              break;
+        default:
+            LOG_DEBUG("[emcute] received unexpected type [%s]\n",
+                      emcute_type_str(type));
+    }
+}
+
+static int sock_open(uint16_t port, const char *id)
 {
     assert(strlen(id) >= MQTTSN_CLI_ID_MINLEN &&
            strlen(id) <= MQTTSN_CLI_ID_MAXLEN);
 
     sock_udp_ep_t local = SOCK_IPV6_EP_ANY;
-    sock_udp_ep_t remote;
     local.port = port;
     cli_id = id;
     timer.callback = time_evt;
@@ -505,6 +551,70 @@ void emcute_run(uint16_t port, const char *id)
 
     if (sock_udp_create(&sock, &local, NULL, 0) < 0) {
         LOG_ERROR("[emcute] unable to open UDP socket on port %i\n", (int)port);
+        return -1;
+    }
+    return 0;
+}
+
+#ifdef MODULE_SOCK_ASYNC_EVENT
+static void on_ping_evt(event_t *event)
+{
+    (void)event;
+    send_ping();
+    event_timeout_set(&ping_timeout, (EMCUTE_KEEPALIVE * US_PER_SEC));
+}
+
+static void on_sock_evt(sock_udp_t *s, sock_async_flags_t type, void *arg)
+{
+    (void)arg;
+
+    if (type & SOCK_ASYNC_MSG_RECV) {
+        sock_udp_ep_t remote;
+        ssize_t len;
+
+        /* read everything that was received while the event was queued */
+        while ((len = sock_udp_recv(s, rbuf, sizeof(rbuf), 0, &remote))
+               != -EAGAIN) {
+            if (len < 0) {
+                LOG_ERROR("[emcute] error while receiving UDP packet\n");
+                continue;
+            }
+            if (len >= 2) {
+                on_pkt(len, &remote);
+            }
+        }
+    }
+}
+
+int emcute_init(event_queue_t *queue, uint16_t port, const char *id)
+{
+    if (sock_open(port, id) < 0) {
+        return -1;
+    }
+    sock_udp_event_init(&sock, &sock_event, queue, on_sock_evt, NULL);
+
+    ping_event.handler = on_ping_evt;
+    event_timeout_init(&ping_timeout, queue, &ping_event);
+    event_timeout_set(&ping_timeout, (EMCUTE_KEEPALIVE * US_PER_SEC));
+    return 0;
+}
+
+void emcute_run(uint16_t port, const char *id)
+{
+    event_queue_t queue;
+
+    event_queue_init(&queue);
+    if (emcute_init(&queue, port, id) < 0) {
+        return;
+    }
+    event_loop(&queue);
+}
+#else
+void emcute_run(uint16_t port, const char *id)
+{
+    sock_udp_ep_t remote;
+
+    if (sock_open(port, id) < 0) {
         return;
     }
 
@@ -520,39 +630,7 @@ void emcute_run(uint16_t port, const char *id)
         }
 
         if (len >= 2) {
-            /* handle the packet */
-            uint16_t pkt_len;
-            /* catch invalid length field */
-            if ((len == 2) && (rbuf[0] == 0x01)) {
-                continue;
-            }
-            /* parse length field */
-            size_t pos = get_len(rbuf, &pkt_len);
-            /* verify length to prevent overflows */
-            if (((size_t)pkt_len > (size_t)len) || (pos >= (size_t)len)) {
-                continue;
-            }
-            /* get packet type */
-            uint8_t type = rbuf[pos];
-
-            switch (type) {
-                case CONNACK:       on_ack(type, 0, 2, 0);              break;
-                case WILLTOPICREQ:  on_ack(type, 0, 0, 0);              break;
-                case WILLMSGREQ:    on_ack(type, 0, 0, 0);              break;
-                case REGACK:        on_ack(type, 4, 6, 2);              break;
-                case PUBLISH:       on_publish((size_t)pkt_len, pos);   break;
-                case PUBACK:        on_ack(type, 4, 6, 0);              break;
-                case SUBACK:        on_ack(type, 5, 7, 3);              break;
-                case UNSUBACK:      on_ack(type, 2, 0, 0);              break;
-                case PINGREQ:       on_pingreq(&remote);                break;
-                case PINGRESP:      on_pingresp();                      break;
-                case DISCONNECT:    on_disconnect();                    break;
-                case WILLTOPICRESP: on_ack(type, 0, 0, 0);              break;
-                case WILLMSGRESP:   on_ack(type, 0, 0, 0);              break;
-                default:
-                    LOG_DEBUG("[emcute] received unexpected type [%s]\n",
-                              emcute_type_str(type));
-            }
+            on_pkt(len, &remote);
         }
 
         uint32_t now = xtimer_now_usec();
@@ -566,3 +644,4 @@ void emcute_run(uint16_t port, const char *id)
         }
     }
 }
+#endif
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2015-2017 Ken Bannister. All rights reserved.
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @addtogroup  net_gcoap
+ * @internal
+ * @{
+ *
+ * @file
+ * @brief       Internal definitions
+ */
+#ifndef PRIV_GCOAP_INTERNAL_H
+#define PRIV_GCOAP_INTERNAL_H
+
+#include "net/gcoap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @name    Return values of _gcoap_find_resource()
+ * @{
+ */
+#define GCOAP_RESOURCE_FOUND        (0)     /**< resource found */
+#define GCOAP_RESOURCE_WRONG_METHOD (-1)    /**< resource found, but the
+                                             *   method does not match */
+#define GCOAP_RESOURCE_NO_PATH      (-2)    /**< no resource for the path */
+/** @} */
+
+/**
+ * @brief   Searches listener registrations for the resource matching the path
+ *          and method of a request
+ *
+ * @param[in] pdu           Request to find the resource for
+ * @param[out] resource_ptr The resource, if found
+ * @param[out] listener_ptr The listener of the resource, if found
+ *
+ * @return  GCOAP_RESOURCE_FOUND if the resource was found
+ * @return  GCOAP_RESOURCE_WRONG_METHOD if a resource was found for the path,
+ *          but none for the method of @p pdu
+ * @return  GCOAP_RESOURCE_NO_PATH if no resource was found for the path
+ */
+int _gcoap_find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr,
+                         gcoap_listener_t **listener_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PRIV_GCOAP_INTERNAL_H */
+/** @} */
@@ -19,12 +19,15 @@
  */
 
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdatomic.h>
 #include <string.h>
 
 #include "assert.h"
 #include "net/gcoap.h"
+#include "_gcoap-internal.h"
+#include "net/sock/async/event.h"
 #include "net/sock/util.h"
 #include "mutex.h"
 #include "random.h"
@@ -33,22 +36,24 @@
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
-/* Return values used by the _find_resource function. */
-#define GCOAP_RESOURCE_FOUND 0
-#define GCOAP_RESOURCE_WRONG_METHOD -1
-#define GCOAP_RESOURCE_NO_PATH -2
-
 /* Internal functions */
 static void *_event_loop(void *arg);
-static void _listen(sock_udp_t *sock);
+static void _on_sock_evt(sock_udp_t *sock, sock_async_flags_t type, void *arg);
+static void _on_resp_timeout(event_t *event);
+static void _process_coap_pdu(sock_udp_t *sock, sock_udp_ep_t *remote,
+                              uint8_t *buf, size_t len);
 static ssize_t _well_known_core_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx);
 static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
                                                          sock_udp_ep_t *remote);
 static void _expire_request(gcoap_request_memo_t *memo);
 static void _find_req_memo(gcoap_request_memo_t **memo_ptr, coap_pkt_t *pdu,
                            const sock_udp_ep_t *remote);
-static int _find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr,
-                                            gcoap_listener_t **listener_ptr);
+#if GCOAP_RESOURCE_INDEX_SIZE
+static void _index_add(gcoap_listener_t *listener);
+static int _index_find(const char *uri, coap_method_flags_t method_flag,
+                       const coap_resource_t **resource_ptr,
+                       gcoap_listener_t **listener_ptr);
+#endif
 static int _find_observer(sock_udp_ep_t **observer, sock_udp_ep_t *remote);
 static int _find_obs_memo(gcoap_observe_memo_t **memo, sock_udp_ep_t *remote,
                                                        coap_pkt_t *pdu);
@@ -67,6 +72,21 @@ static gcoap_listener_t _default_listener = {
     NULL
 };
 
+#if GCOAP_RESOURCE_INDEX_SIZE
+/* Entry of the resource path index */
+typedef struct {
+    const coap_resource_t *resource;
+    gcoap_listener_t *listener;
+} _index_entry_t;
+
+/* Resources of all indexed listeners ordered by path; resources with equal
+ * paths in order of registration */
+static _index_entry_t _index[GCOAP_RESOURCE_INDEX_SIZE];
+static unsigned _index_numof = 0;
+static bool _index_full = false;
+static mutex_t _index_lock = MUTEX_INIT;
+#endif
+
 /* Container for the state of gcoap itself */
 typedef struct {
     mutex_t lock;                       /* Shares state attributes safely */
@@ -93,17 +113,17 @@ static gcoap_state_t _coap_state = {
 
 static kernel_pid_t _pid = KERNEL_PID_UNDEF;
 static char _msg_stack[GCOAP_STACK_SIZE];
-static msg_t _msg_queue[GCOAP_MSG_QUEUE_SIZE];
+static event_queue_t _queue;
 static sock_udp_t _sock;
+static sock_event_t _sock_event;
 
 
-/* Event/Message loop for gcoap _pid thread. */
+/* Event loop for gcoap _pid thread. */
 static void *_event_loop(void *arg)
 {
-    msg_t msg_rcvd;
     (void)arg;
 
-    msg_init_queue(_msg_queue, GCOAP_MSG_QUEUE_SIZE);
+    event_queue_claim(&_queue);
 
     sock_udp_ep_t local;
     memset(&local, 0, sizeof(sock_udp_ep_t));
@@ -117,85 +137,162 @@ static void *_event_loop(void *arg)
         return 0;
     }
 
-    while(1) {
-        res = msg_try_receive(&msg_rcvd);
+    sock_udp_event_init(&_sock, &_sock_event, &_queue, _on_sock_evt, NULL);
+    event_loop(&_queue);
 
-        if (res > 0) {
-            switch (msg_rcvd.type) {
-            case GCOAP_MSG_TYPE_TIMEOUT: {
-                gcoap_request_memo_t *memo = (gcoap_request_memo_t *)msg_rcvd.content.ptr;
+    return 0;
+}
 
-                /* no retries remaining */
-                if ((memo->send_limit == GCOAP_SEND_LIMIT_NON)
-                        || (memo->send_limit == 0)) {
-                    _expire_request(memo);
-                }
-                /* reduce retries remaining, double timeout and resend */
-                else {
-                    memo->send_limit--;
+/* Handles the events of the sock. */
+static void _on_sock_evt(sock_udp_t *sock, sock_async_flags_t type, void *arg)
+{
+    (void)arg;
+
+    if (type & SOCK_ASYNC_MSG_RECV) {
+        uint8_t buf[GCOAP_PDU_BUF_SIZE];
+        sock_udp_ep_t remote;
+        ssize_t res;
+
+        /* messages received while the event was queued only posted it once */
+        while ((res = sock_udp_recv(sock, buf, sizeof(buf), 0, &remote))
+               != -EAGAIN) {
+            if (res <= 0) {
+                /* the message was dropped, e.g. it did not fit into buf */
+                DEBUG("gcoap: udp recv failure: %d\n", (int)res);
+                continue;
+            }
+            _process_coap_pdu(sock, &remote, buf, res);
+        }
+    }
+}
+
+/* Handles the timeout of waiting for a response. */
+static void _on_resp_timeout(event_t *event)
+{
+    gcoap_request_memo_t *memo = container_of(event, gcoap_request_memo_t,
+                                              resp_tmout_evt);
+
+    /* no retries remaining */
+    if ((memo->send_limit == GCOAP_SEND_LIMIT_NON)
+            || (memo->send_limit == 0)) {
+        _expire_request(memo);
+    }
+    /* reduce retries remaining, double timeout and resend */
+    else {
+        memo->send_limit--;
 #ifdef GCOAP_NO_RETRANS_BACKOFF
-                    unsigned i        = 0;
+        unsigned i        = 0;
 #else
-                    unsigned i        = COAP_MAX_RETRANSMIT - memo->send_limit;
+        unsigned i        = COAP_MAX_RETRANSMIT - memo->send_limit;
 #endif
-                    uint32_t timeout  = ((uint32_t)COAP_ACK_TIMEOUT << i) * US_PER_SEC;
+        uint32_t timeout  = ((uint32_t)COAP_ACK_TIMEOUT << i) * US_PER_SEC;
 #if COAP_ACK_VARIANCE > 0
-                    uint32_t variance = ((uint32_t)COAP_ACK_VARIANCE << i) * US_PER_SEC;
-                    timeout = random_uint32_range(timeout, timeout + variance);
+        uint32_t variance = ((uint32_t)COAP_ACK_VARIANCE << i) * US_PER_SEC;
+        timeout = random_uint32_range(timeout, timeout + variance);
 #endif
 
-                    ssize_t bytes = sock_udp_send(&_sock, memo->msg.data.pdu_buf,
-                                                  memo->msg.data.pdu_len,
-                                                  &memo->remote_ep);
-                    if (bytes > 0) {
-                        xtimer_set_msg(&memo->response_timer, timeout,
-                                       &memo->timeout_msg, _pid);
-                    }
-                    else {
-                        DEBUG("gcoap: sock resend failed: %d\n", (int)bytes);
-                        _expire_request(memo);
-                    }
-                }
-                break;
-            }
-            default:
-                break;
-            }
+        ssize_t bytes = sock_udp_send(&_sock, memo->msg.data.pdu_buf,
+                                      memo->msg.data.pdu_len,
+                                      &memo->remote_ep);
+        if (bytes > 0) {
+            event_timeout_set(&memo->resp_evt_tmout, timeout);
+        }
+        else {
+            DEBUG("gcoap: sock resend failed: %d\n", (int)bytes);
+            _expire_request(memo);
+        }
+    }
+}
+
+#if GCOAP_RESOURCE_INDEX_SIZE
+/*
+ * Returns the position of the first index entry with a path greater than
+ * (or, if `inclusive`, equal to) `path`.
+ */
+static unsigned _index_bound(const char *path, bool inclusive)
+{
+    unsigned lo = 0, hi = _index_numof;
+
+    while (lo < hi) {
+        unsigned mid = lo + ((hi - lo) / 2);
+        int res = strcmp(_index[mid].resource->path, path);
+
+        if ((res < 0) || ((res == 0) && !inclusive)) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
         }
+    }
+    return lo;
+}
 
-        _listen(&_sock);
+/*
+ * Adds all resources of a listener to the path index, or none if they do not
+ * fit anymore. Once a listener did not fit, no further listeners are added so
+ * resources of earlier listeners still take precedence.
+ */
+static void _index_add(gcoap_listener_t *listener)
+{
+    mutex_lock(&_index_lock);
+    if (_index_full ||
+        ((_index_numof + listener->resources_len) > GCOAP_RESOURCE_INDEX_SIZE)) {
+        DEBUG("gcoap: resource index full, listener %p not indexed\n",
+              (void *)listener);
+        _index_full = true;
+        mutex_unlock(&_index_lock);
+        return;
     }
+    for (size_t i = 0; i < listener->resources_len; i++) {
+        const coap_resource_t *resource = &listener->resources[i];
+        /* after resources with equal path to keep registration order */
+        unsigned pos = _index_bound(resource->path, false);
+
+        memmove(&_index[pos + 1], &_index[pos],
+                (_index_numof - pos) * sizeof(_index[0]));
+        _index[pos].resource = resource;
+        _index[pos].listener = listener;
+        _index_numof++;
+    }
+    mutex_unlock(&_index_lock);
+}
 
-    return 0;
+/*
+ * Looks up a resource with exactly the given path in the path index.
+ *
+ * return same as _gcoap_find_resource()
+ */
+static int _index_find(const char *uri, coap_method_flags_t method_flag,
+                       const coap_resource_t **resource_ptr,
+                       gcoap_listener_t **listener_ptr)
+{
+    int ret = GCOAP_RESOURCE_NO_PATH;
+
+    mutex_lock(&_index_lock);
+    for (unsigned i = _index_bound(uri, true);
+         (i < _index_numof) && (strcmp(_index[i].resource->path, uri) == 0);
+         i++) {
+        if (_index[i].resource->methods & method_flag) {
+            *resource_ptr = _index[i].resource;
+            *listener_ptr = _index[i].listener;
+            ret = GCOAP_RESOURCE_FOUND;
+            break;
+        }
+        ret = GCOAP_RESOURCE_WRONG_METHOD;
+    }
+    mutex_unlock(&_index_lock);
+    return ret;
 }
+#endif
 
-/* Listen for an incoming CoAP message. */
-static void _listen(sock_udp_t *sock)
+/* Processes an incoming CoAP message. */
+static void _process_coap_pdu(sock_udp_t *sock, sock_udp_ep_t *remote,
+                              uint8_t *buf, size_t len)
 {
     coap_pkt_t pdu;
-    uint8_t buf[GCOAP_PDU_BUF_SIZE];
-    sock_udp_ep_t remote;
     gcoap_request_memo_t *memo = NULL;
-    uint8_t open_reqs = gcoap_op_state();
-
-    /* We expect a -EINTR response here when unlimited waiting (SOCK_NO_TIMEOUT)
-     * is interrupted when sending a message in gcoap_req_send(). While a
-     * request is outstanding, sock_udp_recv() is called here with limited
-     * waiting so the request's timeout can be handled in a timely manner in
-     * _event_loop(). */
-    ssize_t res = sock_udp_recv(sock, buf, sizeof(buf),
-                                open_reqs > 0 ? GCOAP_RECV_TIMEOUT : SOCK_NO_TIMEOUT,
-                                &remote);
-    if (res <= 0) {
-#if ENABLE_DEBUG
-        if (res < 0 && res != -ETIMEDOUT) {
-            DEBUG("gcoap: udp recv failure: %d\n", res);
-        }
-#endif
-        return;
-    }
 
-    res = coap_parse(&pdu, buf, res);
+    ssize_t res = coap_parse(&pdu, buf, len);
     if (res < 0) {
         DEBUG("gcoap: parse failure: %d\n", (int)res);
         /* If a response, can't clear memo, but it will timeout later. */
@@ -213,9 +310,9 @@ static void _listen(sock_udp_t *sock)
     case COAP_CLASS_REQ:
         if (coap_get_type(&pdu) == COAP_TYPE_NON
                 || coap_get_type(&pdu) == COAP_TYPE_CON) {
-            size_t pdu_len = _handle_req(&pdu, buf, sizeof(buf), &remote);
+            size_t pdu_len = _handle_req(&pdu, buf, GCOAP_PDU_BUF_SIZE, remote);
             if (pdu_len > 0) {
-                ssize_t bytes = sock_udp_send(sock, buf, pdu_len, &remote);
+                ssize_t bytes = sock_udp_send(sock, buf, pdu_len, remote);
                 if (bytes <= 0) {
                     DEBUG("gcoap: send response failed: %d\n", (int)bytes);
                 }
@@ -230,15 +327,17 @@ static void _listen(sock_udp_t *sock)
     case COAP_CLASS_SUCCESS:
     case COAP_CLASS_CLIENT_FAILURE:
     case COAP_CLASS_SERVER_FAILURE:
-        _find_req_memo(&memo, &pdu, &remote);
+        _find_req_memo(&memo, &pdu, remote);
         if (memo) {
             switch (coap_get_type(&pdu)) {
             case COAP_TYPE_NON:
             case COAP_TYPE_ACK:
-                xtimer_remove(&memo->response_timer);
+                event_timeout_clear(&memo->resp_evt_tmout);
+                /* the timeout may have been posted already */
+                event_cancel(&_queue, &memo->resp_tmout_evt);
                 memo->state = GCOAP_MEMO_RESP;
                 if (memo->resp_handler) {
-                    memo->resp_handler(memo->state, &pdu, &remote);
+                    memo->resp_handler(memo->state, &pdu, remote);
                 }
 
                 if (memo->send_limit >= 0) {        /* if confirmable */
@@ -279,7 +378,7 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
     gcoap_observe_memo_t *memo          = NULL;
     gcoap_observe_memo_t *resource_memo = NULL;
 
-    switch (_find_resource(pdu, &resource, &listener)) {
+    switch (_gcoap_find_resource(pdu, &resource, &listener)) {
         case GCOAP_RESOURCE_WRONG_METHOD:
             return gcoap_response(pdu, buf, len, COAP_CODE_METHOD_NOT_ALLOWED);
         case GCOAP_RESOURCE_NO_PATH:
@@ -375,18 +474,8 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
     return pdu_len;
 }
 
-/*
- * Searches listener registrations for the resource matching the path in a PDU.
- *
- * param[out] resource_ptr -- found resource
- * param[out] listener_ptr -- listener for found resource
- * return `GCOAP_RESOURCE_FOUND` if the resource was found,
- *        `GCOAP_RESOURCE_WRONG_METHOD` if a resource was found but the method
- *        code didn't match and `GCOAP_RESOURCE_NO_PATH` if no matching
- *        resource was found.
- */
-static int _find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr,
-                                            gcoap_listener_t **listener_ptr)
+int _gcoap_find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr,
+                         gcoap_listener_t **listener_ptr)
 {
     int ret = GCOAP_RESOURCE_NO_PATH;
     coap_method_flags_t method_flag = coap_method2flag(coap_get_code_detail(pdu));
@@ -399,6 +488,15 @@ static int _find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr,
         return GCOAP_RESOURCE_NO_PATH;
     }
 
+#if GCOAP_RESOURCE_INDEX_SIZE
+    ret = _index_find((char *)uri, method_flag, resource_ptr, listener_ptr);
+    if (ret == GCOAP_RESOURCE_FOUND) {
+        return ret;
+    }
+    /* on GCOAP_RESOURCE_WRONG_METHOD, a COAP_MATCH_SUBTREE resource for a
+     * prefix of the path may still accept the method */
+#endif
+
     while (listener) {
         const coap_resource_t *resource = listener->resources;
         for (size_t i = 0; i < listener->resources_len; i++) {
@@ -616,6 +714,8 @@ kernel_pid_t gcoap_init(void)
     if (_pid != KERNEL_PID_UNDEF) {
         return -EEXIST;
     }
+    /* claimed by the thread, requests may be sent before it runs */
+    event_queue_init_detached(&_queue);
     _pid = thread_create(_msg_stack, sizeof(_msg_stack), THREAD_PRIORITY_MAIN - 1,
                             THREAD_CREATE_STACKTEST, _event_loop, NULL, "coap");
 
@@ -625,12 +725,20 @@ kernel_pid_t gcoap_init(void)
     memset(&_coap_state.observers[0], 0, sizeof(_coap_state.observers));
     memset(&_coap_state.observe_memos[0], 0, sizeof(_coap_state.observe_memos));
     memset(&_coap_state.resend_bufs[0], 0, sizeof(_coap_state.resend_bufs));
+#if GCOAP_RESOURCE_INDEX_SIZE
+    _index_add(&_default_listener);
+#endif
     /* randomize initial value */
     atomic_init(&_coap_state.next_message_id, (unsigned)random_uint32());
 
     return _pid;
 }
 
+event_queue_t *gcoap_get_event_queue(void)
+{
+    return &_queue;
+}
+
 void gcoap_register_listener(gcoap_listener_t *listener)
 {
     /* Add the listener to the end of the linked list. */
@@ -643,6 +751,9 @@ void gcoap_register_listener(gcoap_listener_t *listener)
     if (!listener->link_encoder) {
         listener->link_encoder = gcoap_encode_link;
     }
+#if GCOAP_RESOURCE_INDEX_SIZE
+    _index_add(listener);
+#endif
     _last->next = listener;
 }
 
@@ -790,35 +901,23 @@ size_t gcoap_req_send(const uint8_t *buf, size_t len,
         }
     }
 
-    /* Memos complete; send msg and start timer */
+    /* Memos complete; start timer and send msg. The timer is started first,
+     * as the response may be handled on the gcoap thread before
+     * sock_udp_send() returns. Timeout may be zero for non-confirmable. */
+    if ((memo != NULL) && (timeout > 0)) {
+        memo->resp_tmout_evt.handler = _on_resp_timeout;
+        event_timeout_init(&memo->resp_evt_tmout, &_queue,
+                           &memo->resp_tmout_evt);
+        event_timeout_set(&memo->resp_evt_tmout, timeout);
+    }
     ssize_t res = sock_udp_send(&_sock, buf, len, remote);
 
-    /* timeout may be zero for non-confirmable */
-    if ((memo != NULL) && (res > 0) && (timeout > 0)) {
-        /* We assume gcoap_req_send() is called on some thread other than
-         * gcoap's. First, put a message in the mbox for the sock udp object,
-         * which will interrupt listening on the gcoap thread. (When there are
-         * no outstanding requests, gcoap blocks indefinitely in _listen() at
-         * sock_udp_recv().) While the message sent here is outstanding, the
-         * sock_udp_recv() call will be set to a short timeout so the request
-         * timer below, also on the gcoap thread, is processed in a timely
-         * manner. */
-        msg_t mbox_msg;
-        mbox_msg.type          = GCOAP_MSG_TYPE_INTR;
-        mbox_msg.content.value = 0;
-        if (mbox_try_put(&_sock.reg.mbox, &mbox_msg)) {
-            /* start response wait timer on the gcoap thread */
-            memo->timeout_msg.type        = GCOAP_MSG_TYPE_TIMEOUT;
-            memo->timeout_msg.content.ptr = (char *)memo;
-            xtimer_set_msg(&memo->response_timer, timeout, &memo->timeout_msg, _pid);
-        }
-        else {
-            res = 0;
-            DEBUG("gcoap: can't wake up mbox; no timeout for msg\n");
-        }
-    }
     if (res <= 0) {
         if (memo != NULL) {
+            if (timeout > 0) {
+                event_timeout_clear(&memo->resp_evt_tmout);
+                event_cancel(&_queue, &memo->resp_tmout_evt);
+            }
             if (msg_type == COAP_TYPE_CON) {
                 *memo->msg.data.pdu_buf = 0;    /* clear resend buffer */
             }
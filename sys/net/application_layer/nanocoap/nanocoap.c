@@ -365,6 +365,34 @@ int coap_get_blockopt(coap_pkt_t *pkt, uint16_t option, uint32_t *blknum, unsign
     return (blkopt & 0x8) ? 1 : 0;
 }
 
+/*
+ * Finds the first resource with exactly the path of uri and a matching method.
+ * As coap_resources is ordered alphabetically, uses binary search.
+ */
+static const coap_resource_t *_find_exact(const uint8_t *uri,
+                                          coap_method_flags_t method_flag)
+{
+    unsigned lo = 0, hi = coap_resources_numof;
+
+    while (lo < hi) {
+        unsigned mid = lo + ((hi - lo) / 2);
+
+        if (strcmp(coap_resources[mid].path, (char *)uri) < 0) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    for (; (lo < coap_resources_numof) &&
+           (strcmp(coap_resources[lo].path, (char *)uri) == 0); lo++) {
+        if (coap_resources[lo].methods & method_flag) {
+            return &coap_resources[lo];
+        }
+    }
+    return NULL;
+}
+
 ssize_t coap_handle_req(coap_pkt_t *pkt, uint8_t *resp_buf, unsigned resp_buf_len)
 {
     if (coap_get_code_class(pkt) != COAP_REQ) {
@@ -384,6 +412,12 @@ ssize_t coap_handle_req(coap_pkt_t *pkt, uint8_t *resp_buf, unsigned resp_buf_le
     }
     DEBUG("nanocoap: URI path: \"%s\"\n", uri);
 
+    const coap_resource_t *resource = _find_exact(uri, method_flag);
+    if (resource) {
+        return resource->handler(pkt, resp_buf, resp_buf_len, resource->context);
+    }
+
+    /* no exact match, e.g. for COAP_MATCH_SUBTREE */
     for (unsigned i = 0; i < coap_resources_numof; i++) {
         const coap_resource_t *resource = &coap_resources[i];
         if (!(resource->methods & method_flag)) {
@@ -14,13 +14,142 @@
 
 #include <inttypes.h>
 #include <stdio.h>
+#include <string.h>
+
+#include "byteorder.h"
 #include "od.h"
 #include "net/inet_csum.h"
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
-uint16_t inet_csum_slice(uint16_t sum, const uint8_t *buf, uint16_t len, size_t accum_len)
+/* widest word loaded at once, accumulated in a 64-bit sum */
+#if (UINTPTR_MAX > UINT32_MAX)
+typedef uint64_t _word_t;
+#else
+typedef uint32_t _word_t;
+#endif
+
+static inline uint64_t _add(uint64_t acc, _word_t word)
+{
+#if (UINTPTR_MAX > UINT32_MAX)
+    /* end-around carry; 2^64 - 1 is a multiple of 0xffff */
+    acc += word;
+    return acc + (acc < word);
+#else
+    /* can't overflow: len is limited to 16 bit */
+    return acc + word;
+#endif
+}
+
+/* copies n bytes from *src to *dst (if not NULL) via word and advances both */
+static inline void _load(void *word, const uint8_t **src, uint8_t **dst,
+                         size_t n)
+{
+    memcpy(word, *src, n);
+    *src += n;
+    if (*dst != NULL) {
+        memcpy(*dst, word, n);
+        *dst += n;
+    }
+}
+
+/**
+ * @brief   Sums @p src as 16-bit words in network byte order, starting at an
+ *          even position of the checksum domain, and copies it to @p dst on
+ *          the way if @p dst is not NULL.
+ *
+ * The buffer is summed in host byte order in words as wide as possible. Since
+ * the one's complement sum is independent of byte order, only the folded
+ * result needs to be swapped. If @p src is not aligned to 16 bit, the first
+ * byte is summed as the second half of a word, so all following words are
+ * shifted by one byte, which is fixed by another swap.
+ */
+static inline __attribute__((always_inline))
+uint16_t _sum(uint8_t *dst, const uint8_t *src, size_t len)
+{
+    uint64_t acc = 0;
+    unsigned odd = (uintptr_t)src & 1;
+    uint16_t res;
+
+    if (odd && (len > 0)) {
+        uint8_t tmp[2] = { 0, 0 };
+        uint16_t half;
+
+        _load(&tmp[1], &src, &dst, 1);
+        memcpy(&half, tmp, sizeof(half));
+        acc = half;
+        len--;
+    }
+    if (((uintptr_t)src & 2) && (len >= 2)) {
+        uint16_t half;
+
+        _load(&half, &src, &dst, sizeof(half));
+        acc += half;
+        len -= sizeof(half);
+    }
+#if (UINTPTR_MAX > UINT32_MAX)
+    if (((uintptr_t)src & 4) && (len >= 4)) {
+        uint32_t word;
+
+        _load(&word, &src, &dst, sizeof(word));
+        acc += word;
+        len -= sizeof(word);
+    }
+#endif
+    /* src is now aligned to _word_t */
+    while (len >= (4 * sizeof(_word_t))) {
+        _word_t words[4];
+
+        _load(words, &src, &dst, sizeof(words));
+        acc = _add(acc, words[0]);
+        acc = _add(acc, words[1]);
+        acc = _add(acc, words[2]);
+        acc = _add(acc, words[3]);
+        len -= sizeof(words);
+    }
+    while (len >= sizeof(_word_t)) {
+        _word_t word;
+
+        _load(&word, &src, &dst, sizeof(word));
+        acc = _add(acc, word);
+        len -= sizeof(word);
+    }
+#if (UINTPTR_MAX > UINT32_MAX)
+    if (len >= 4) {
+        uint32_t word;
+
+        _load(&word, &src, &dst, sizeof(word));
+        acc = _add(acc, word);
+        len -= sizeof(word);
+    }
+#endif
+    if (len >= 2) {
+        uint16_t half;
+
+        _load(&half, &src, &dst, sizeof(half));
+        acc = _add(acc, half);
+        len -= sizeof(half);
+    }
+    if (len > 0) {
+        /* pad last byte with zero */
+        uint8_t tmp[2] = { 0, 0 };
+        uint16_t half;
+
+        _load(&tmp[0], &src, &dst, 1);
+        memcpy(&half, tmp, sizeof(half));
+        acc = _add(acc, half);
+    }
+    while (acc >> 16) {
+        acc = (acc & 0xffff) + (acc >> 16);
+    }
+    res = ntohs((uint16_t)acc);
+    return (odd) ? byteorder_swaps(res) : res;
+}
+
+static inline __attribute__((always_inline))
+uint16_t _csum_slice(uint16_t sum, uint8_t *dst, const uint8_t *src,
+                     uint16_t len, size_t accum_len)
 {
     uint32_t csum = sum;
 
@@ -28,7 +157,7 @@ uint16_t inet_csum_slice(uint16_t sum, const uint8_t *buf, uint16_t len, size_t
 #if ENABLE_DEBUG
 #ifdef MODULE_OD
     DEBUG(", buf:\n");
-    od_hex_dump(buf, len, OD_WIDTH_DEFAULT);
+    od_hex_dump(src, len, OD_WIDTH_DEFAULT);
 #else
     DEBUG(", buf output only with od module\n");
 #endif
@@ -38,19 +167,16 @@ uint16_t inet_csum_slice(uint16_t sum, const uint8_t *buf, uint16_t len, size_t
         return csum;
 
     if (accum_len & 1) {      /* if accumulated length is odd */
-        csum += *buf;         /* add first byte as bottom half of 16-byte word */
-        buf++;
+        csum += *src;         /* add first byte as bottom half of 16-byte word */
+        if (dst != NULL) {
+            *(dst++) = *src;
+        }
+        src++;
         len--;
-        accum_len++;
     }
 
-    for (unsigned i = 0; i < (len >> 1); buf += 2, i++) {
-        csum += (uint16_t)(*buf << 8) + *(buf + 1); /* group bytes by 16-byte words */
-                                                    /* and add them */
-    }
-
-    if ((accum_len + len) & 1)          /* if accumulated length is odd */
-        csum += (uint16_t)(*buf << 8);  /* add last byte as top half of 16-byte word */
+    /* a trailing odd byte is added as top half of 16-byte word */
+    csum += _sum(dst, src, len);
 
     while (csum >> 16) {
         uint16_t carry = csum >> 16;
@@ -62,4 +188,15 @@ uint16_t inet_csum_slice(uint16_t sum, const uint8_t *buf, uint16_t len, size_t
     return csum;
 }
 
+uint16_t inet_csum_slice(uint16_t sum, const uint8_t *buf, uint16_t len, size_t accum_len)
+{
+    return _csum_slice(sum, NULL, buf, len, accum_len);
+}
+
+uint16_t inet_csum_slice_copy(uint16_t sum, uint8_t *dst, const uint8_t *src,
+                              uint16_t len, size_t accum_len)
+{
+    return _csum_slice(sum, dst, src, len, accum_len);
+}
+
 /** @} */
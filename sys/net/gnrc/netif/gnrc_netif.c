@@ -31,6 +31,9 @@
 #include "fmt.h"
 #include "log.h"
 #include "sched.h"
+#ifdef MODULE_GNRC_NETIF_COALESCE
+#include "thread_flags.h"
+#endif
 #include "xtimer.h"
 
 #include "net/gnrc/netif.h"
@@ -39,6 +42,12 @@
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
+#ifdef MODULE_GNRC_NETIF_COALESCE
+/* set by the device's interrupt, taken from the top next to the flags
+ * reserved by core, as drivers and users allocate theirs from bit 0 */
+#define _THREAD_FLAG_DEV_ISR    (1U << 13)
+#endif
+
 static gnrc_netif_t _netifs[GNRC_NETIF_NUMOF];
 
 static void _update_l2addr_from_dev(gnrc_netif_t *netif);
@@ -1317,6 +1326,57 @@ static void _test_options(gnrc_netif_t *netif)
 }
 #endif /* DEVELHELP */
 
+#ifdef MODULE_GNRC_NETIF_COALESCE
+static void _service_dev(gnrc_netif_t *netif)
+{
+    netdev_t *dev = netif->dev;
+    unsigned budget = GNRC_NETIF_RX_BUDGET;
+
+    netif->rx_batch = 0;
+    while (1) {
+        uint16_t rx_before = netif->rx_batch;
+
+        dev->driver->isr(dev);
+        if (netif->rx_batch == rx_before) {
+            /* device has nothing more for us */
+            break;
+        }
+        if (--budget == 0) {
+            /* there might be more frames pending: come back after the
+             * messages that queued up in the meantime were handled */
+            DEBUG("gnrc_netif: RX budget exhausted\n");
+            thread_flags_set((thread_t *)sched_active_thread,
+                             _THREAD_FLAG_DEV_ISR);
+            break;
+        }
+    }
+#ifdef MODULE_NETSTATS_L2
+    netif->stats.rx_wakeups++;
+    if (netif->rx_batch > netif->stats.rx_batch_max) {
+        netif->stats.rx_batch_max = netif->rx_batch;
+    }
+#endif
+}
+
+static void _wait_for_msg(gnrc_netif_t *netif, msg_t *msg)
+{
+    /* check for device events before every message, so a steady stream of
+     * messages can not starve the device */
+    thread_flags_t flags = thread_flags_clear(_THREAD_FLAG_DEV_ISR);
+
+    while (1) {
+        if (flags & _THREAD_FLAG_DEV_ISR) {
+            _service_dev(netif);
+        }
+        if (msg_try_receive(msg) > 0) {
+            return;
+        }
+        flags = thread_flags_wait_any(THREAD_FLAG_MSG_WAITING |
+                                      _THREAD_FLAG_DEV_ISR);
+    }
+}
+#endif
+
 static void *_gnrc_netif_thread(void *args)
 {
     gnrc_netapi_opt_t *opt;
@@ -1371,7 +1431,11 @@ static void *_gnrc_netif_thread(void *args)
 
     while (1) {
         DEBUG("gnrc_netif: waiting for incoming messages\n");
+#ifdef MODULE_GNRC_NETIF_COALESCE
+        _wait_for_msg(netif, &msg);
+#else
         msg_receive(&msg);
+#endif
         /* dispatch netdev, MAC and gnrc_netapi messages */
         switch (msg.type) {
             case NETDEV_MSG_TYPE_EVENT:
@@ -1460,12 +1524,17 @@ static void _event_cb(netdev_t *dev, netdev_event_t event)
     gnrc_netif_t *netif = (gnrc_netif_t *) dev->context;
 
     if (event == NETDEV_EVENT_ISR) {
+#ifdef MODULE_GNRC_NETIF_COALESCE
+        thread_flags_set((thread_t *)thread_get(netif->pid),
+                         _THREAD_FLAG_DEV_ISR);
+#else
         msg_t msg = { .type = NETDEV_MSG_TYPE_EVENT,
                       .content = { .ptr = netif } };
 
         if (msg_send(&msg, netif->pid) <= 0) {
             puts("gnrc_netif: possibly lost interrupt.");
         }
+#endif
     }
     else {
         DEBUG("gnrc_netif: event triggered -> %i\n", event);
@@ -1474,6 +1543,11 @@ static void _event_cb(netdev_t *dev, netdev_event_t event)
             case NETDEV_EVENT_RX_COMPLETE:
                 pkt = netif->ops->recv(netif);
                 if (pkt) {
+#ifdef MODULE_GNRC_NETIF_COALESCE
+                    /* some drivers signal RX_COMPLETE without a frame, only
+                     * count what was read so _service_dev() terminates */
+                    netif->rx_batch++;
+#endif
                     _pass_on_packet(pkt);
                 }
                 break;
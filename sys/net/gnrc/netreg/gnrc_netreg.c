@@ -13,6 +13,7 @@
  */
 
 #include <errno.h>
+#include <stdbool.h>
 #include <string.h>
 
 #include "assert.h"
@@ -28,13 +29,51 @@
 
 #define _INVALID_TYPE(type) (((type) < GNRC_NETTYPE_UNDEF) || ((type) >= GNRC_NETTYPE_NUMOF))
 
-/* The registry as lookup table by gnrc_nettype_t */
-static gnrc_netreg_entry_t *netreg[GNRC_NETTYPE_NUMOF];
+#ifdef MODULE_GNRC_NETREG_HASH
+#if (GNRC_NETREG_HASH_SIZE & (GNRC_NETREG_HASH_SIZE - 1)) != 0
+#error "gnrc_netreg: GNRC_NETREG_HASH_SIZE must be a power of two"
+#endif
+
+#define _NETREG_NUMOF   (GNRC_NETREG_HASH_SIZE)
+
+/* ports and protocol numbers differ in their low bits, the upper half mixes
+ * in GNRC_NETREG_DEMUX_CTX_ALL */
+static inline unsigned _bucket(gnrc_nettype_t type, uint32_t demux_ctx)
+{
+    return (demux_ctx ^ (demux_ctx >> 16) ^ ((unsigned)type * 7U)) &
+           (GNRC_NETREG_HASH_SIZE - 1);
+}
+
+static inline bool _match(const gnrc_netreg_entry_t *entry,
+                          gnrc_nettype_t type, uint32_t demux_ctx)
+{
+    return (entry->demux_ctx == demux_ctx) && (entry->nettype == type);
+}
+#else
+#define _NETREG_NUMOF   (GNRC_NETTYPE_NUMOF)
+
+static inline unsigned _bucket(gnrc_nettype_t type, uint32_t demux_ctx)
+{
+    (void)demux_ctx;
+    return type;
+}
+
+static inline bool _match(const gnrc_netreg_entry_t *entry,
+                          gnrc_nettype_t type, uint32_t demux_ctx)
+{
+    (void)type;
+    return (entry->demux_ctx == demux_ctx);
+}
+#endif
+
+/* The registry as lookup table by gnrc_nettype_t, or by hash of
+ * gnrc_nettype_t and demux context with gnrc_netreg_hash */
+static gnrc_netreg_entry_t *netreg[_NETREG_NUMOF];
 
 void gnrc_netreg_init(void)
 {
     /* set all pointers in registry to NULL */
-    memset(netreg, 0, GNRC_NETTYPE_NUMOF * sizeof(gnrc_netreg_entry_t *));
+    memset(netreg, 0, _NETREG_NUMOF * sizeof(gnrc_netreg_entry_t *));
 }
 
 int gnrc_netreg_register(gnrc_nettype_t type, gnrc_netreg_entry_t *entry)
@@ -59,7 +98,10 @@ int gnrc_netreg_register(gnrc_nettype_t type, gnrc_netreg_entry_t *entry)
         return -EINVAL;
     }
 
-    LL_PREPEND(netreg[type], entry);
+#ifdef MODULE_GNRC_NETREG_HASH
+    entry->nettype = type;
+#endif
+    LL_PREPEND(netreg[_bucket(type, entry->demux_ctx)], entry);
 
     return 0;
 }
@@ -70,7 +112,7 @@ void gnrc_netreg_unregister(gnrc_nettype_t type, gnrc_netreg_entry_t *entry)
         return;
     }
 
-    LL_DELETE(netreg[type], entry);
+    LL_DELETE(netreg[_bucket(type, entry->demux_ctx)], entry);
 }
 
 /**
@@ -89,11 +131,23 @@ static gnrc_netreg_entry_t *_netreg_lookup(gnrc_netreg_entry_t *from,
                                            gnrc_nettype_t type,
                                            uint32_t demux_ctx)
 {
-    gnrc_netreg_entry_t *res = NULL;
+    gnrc_netreg_entry_t *res;
+
+    if (from) {
+        res = from->next;
+#ifdef MODULE_GNRC_NETREG_HASH
+        type = from->nettype;
+#endif
+    }
+    else if (!_INVALID_TYPE(type)) {
+        res = netreg[_bucket(type, demux_ctx)];
+    }
+    else {
+        return NULL;
+    }
 
-    if (from || !_INVALID_TYPE(type)) {
-        gnrc_netreg_entry_t *head = (from) ? from->next : netreg[type];
-        LL_SEARCH_SCALAR(head, res, demux_ctx, demux_ctx);
+    while (res && !_match(res, type, demux_ctx)) {
+        res = res->next;
     }
 
     return res;
@@ -17,6 +17,7 @@
 #include <stdbool.h>
 #include <string.h>
 
+#include "assert.h"
 #include "net/gnrc/icmpv6/error.h"
 #include "net/gnrc/ipv6.h"
 #include "net/gnrc/ipv6/nib/conf.h"
@@ -42,6 +43,25 @@ static _nib_dr_entry_t _def_routers[GNRC_IPV6_NIB_DEFAULT_ROUTER_NUMOF];
 #if GNRC_IPV6_NIB_CONF_MULTIHOP_P6C
 static _nib_abr_entry_t _abrs[GNRC_IPV6_NIB_ABR_NUMOF];
 #endif  /* GNRC_IPV6_NIB_CONF_MULTIHOP_P6C */
+#if GNRC_IPV6_NIB_CONF_FT_TRIE
+/**
+ * @brief   Node of the compressed binary trie over the off-link entries
+ *
+ * Nodes that do not refer to an off-link entry are branch nodes and always
+ * have two children. All references are indexes + 1, 0 meaning "none".
+ */
+typedef struct {
+    uint16_t child[2];  /**< children, selected by the bit at position `len` */
+    uint16_t dst;       /**< first entry in _dsts with this prefix */
+    uint8_t len;        /**< prefix length of the node */
+} _ft_trie_node_t;
+
+/* a trie with n leaves has at most n - 1 branch nodes */
+static _ft_trie_node_t _ft_trie[2 * GNRC_IPV6_NIB_OFFL_NUMOF];
+/* next entry in _dsts with the same prefix, ordered by index */
+static uint16_t _ft_trie_dup[GNRC_IPV6_NIB_OFFL_NUMOF];
+static uint16_t _ft_trie_root;
+#endif  /* GNRC_IPV6_NIB_CONF_FT_TRIE */
 static rmutex_t _nib_mutex = RMUTEX_INIT;
 
 static char addr_str[IPV6_ADDR_MAX_STR_LEN];
@@ -51,6 +71,10 @@ evtimer_msg_t _nib_evtimer;
 static void _override_node(const ipv6_addr_t *addr, unsigned iface,
                            _nib_onl_entry_t *node);
 static inline bool _node_unreachable(_nib_onl_entry_t *node);
+#if GNRC_IPV6_NIB_CONF_FT_TRIE
+static void _ft_trie_add(unsigned idx);
+static void _ft_trie_rm(unsigned idx);
+#endif  /* GNRC_IPV6_NIB_CONF_FT_TRIE */
 
 void _nib_init(void)
 {
@@ -63,6 +87,11 @@ void _nib_init(void)
 #if GNRC_IPV6_NIB_CONF_MULTIHOP_P6C
     memset(_abrs, 0, sizeof(_abrs));
 #endif  /* GNRC_IPV6_NIB_CONF_MULTIHOP_P6C */
+#if GNRC_IPV6_NIB_CONF_FT_TRIE
+    memset(_ft_trie, 0, sizeof(_ft_trie));
+    memset(_ft_trie_dup, 0, sizeof(_ft_trie_dup));
+    _ft_trie_root = 0;
+#endif  /* GNRC_IPV6_NIB_CONF_FT_TRIE */
 #endif  /* TEST_SUITES */
     evtimer_init_msg(&_nib_evtimer);
     /* TODO: load ABR information from persistent memory */
@@ -512,6 +541,9 @@ _nib_offl_entry_t *_nib_offl_alloc(const ipv6_addr_t *next_hop, unsigned iface,
         dst->next_hop->mode |= _DST;
         ipv6_addr_init_prefix(&dst->pfx, pfx, pfx_len);
         dst->pfx_len = pfx_len;
+#if GNRC_IPV6_NIB_CONF_FT_TRIE
+        _ft_trie_add(dst - _dsts);
+#endif  /* GNRC_IPV6_NIB_CONF_FT_TRIE */
     }
     return dst;
 }
@@ -543,6 +575,9 @@ void _nib_offl_clear(_nib_offl_entry_t *dst)
             dst->next_hop->mode &= ~(_DST);
             _nib_onl_clear(dst->next_hop);
         }
+#if GNRC_IPV6_NIB_CONF_FT_TRIE
+        _ft_trie_rm(dst - _dsts);
+#endif  /* GNRC_IPV6_NIB_CONF_FT_TRIE */
         memset(dst, 0, sizeof(_nib_offl_entry_t));
     }
 }
@@ -566,10 +601,169 @@ bool _nib_offl_is_entry(const _nib_offl_entry_t *entry)
     return (entry >= _dsts) && _in_dsts(entry);
 }
 
+#if GNRC_IPV6_NIB_CONF_FT_TRIE
+static inline unsigned _addr_bit(const ipv6_addr_t *addr, unsigned pos)
+{
+    return (addr->u8[pos >> 3] >> (7 - (pos & 0x7))) & 0x1;
+}
+
+static uint16_t _ft_trie_node_alloc(uint8_t len, uint16_t dst)
+{
+    for (unsigned i = 0; i < (2 * GNRC_IPV6_NIB_OFFL_NUMOF); i++) {
+        _ft_trie_node_t *node = &_ft_trie[i];
+
+        if ((node->dst == 0) && (node->child[0] == 0) &&
+            (node->child[1] == 0)) {
+            node->len = len;
+            node->dst = dst;
+            return i + 1;
+        }
+    }
+    /* the trie is dimensioned so that this never happens */
+    assert(false);
+    return 0;
+}
+
+static inline void _ft_trie_node_free(uint16_t node)
+{
+    memset(&_ft_trie[node - 1], 0, sizeof(_ft_trie_node_t));
+}
+
+/* any entry below node shares its first node->len bits */
+static const ipv6_addr_t *_ft_trie_key(const _ft_trie_node_t *node)
+{
+    while (node->dst == 0) {
+        node = &_ft_trie[node->child[0] - 1];
+    }
+    return &_dsts[node->dst - 1].pfx;
+}
+
+static void _ft_trie_add(unsigned idx)
+{
+    const _nib_offl_entry_t *dst = &_dsts[idx];
+    uint16_t *link = &_ft_trie_root;
+
+    while (*link != 0) {
+        _ft_trie_node_t *node = &_ft_trie[*link - 1];
+        const ipv6_addr_t *key = _ft_trie_key(node);
+        unsigned common = ipv6_addr_match_prefix(&dst->pfx, key);
+
+        if (common > dst->pfx_len) {
+            common = dst->pfx_len;
+        }
+        if (common < node->len) {
+            /* prefix diverges from node (or is shorter): split the edge */
+            uint16_t old = *link;
+            uint16_t leaf = _ft_trie_node_alloc(dst->pfx_len, idx + 1);
+
+            if (common == dst->pfx_len) {
+                _ft_trie[leaf - 1].child[_addr_bit(key, common)] = old;
+                *link = leaf;
+            }
+            else {
+                uint16_t branch = _ft_trie_node_alloc(common, 0);
+
+                _ft_trie[branch - 1].child[_addr_bit(&dst->pfx, common)] = leaf;
+                _ft_trie[branch - 1].child[_addr_bit(key, common)] = old;
+                *link = branch;
+            }
+            return;
+        }
+        if (node->len == dst->pfx_len) {
+            /* keep entries with the same prefix ordered by index so lookups
+             * resolve ties the same way as the linear search */
+            uint16_t *next = &node->dst;
+
+            while ((*next != 0) && (*next < (idx + 1))) {
+                next = &_ft_trie_dup[*next - 1];
+            }
+            _ft_trie_dup[idx] = *next;
+            *next = idx + 1;
+            return;
+        }
+        link = &node->child[_addr_bit(&dst->pfx, node->len)];
+    }
+    *link = _ft_trie_node_alloc(dst->pfx_len, idx + 1);
+}
+
+static void _ft_trie_rm(unsigned idx)
+{
+    const _nib_offl_entry_t *dst = &_dsts[idx];
+    uint16_t *parent = NULL, *link = &_ft_trie_root;
+    _ft_trie_node_t *node = NULL;
+    uint16_t *next, child;
+
+    while (*link != 0) {
+        node = &_ft_trie[*link - 1];
+        if (node->len >= dst->pfx_len) {
+            break;
+        }
+        parent = link;
+        link = &node->child[_addr_bit(&dst->pfx, node->len)];
+    }
+    if ((*link == 0) || (node->len != dst->pfx_len)) {
+        return;
+    }
+    for (next = &node->dst; (*next != 0) && (*next != (idx + 1));
+         next = &_ft_trie_dup[*next - 1]) {}
+    if (*next == 0) {
+        return;
+    }
+    *next = _ft_trie_dup[idx];
+    _ft_trie_dup[idx] = 0;
+    if ((node->dst != 0) || ((node->child[0] != 0) && (node->child[1] != 0))) {
+        /* node still holds entries or remains as branch node */
+        return;
+    }
+    child = node->child[0] | node->child[1];
+    _ft_trie_node_free(*link);
+    *link = child;
+    if ((child == 0) && (parent != NULL) && (_ft_trie[*parent - 1].dst == 0)) {
+        /* parent branch node has only one child left => merge */
+        const _ft_trie_node_t *branch = &_ft_trie[*parent - 1];
+
+        child = branch->child[0] | branch->child[1];
+        _ft_trie_node_free(*parent);
+        *parent = child;
+    }
+}
+
+static _nib_offl_entry_t *_nib_offl_get_match(const ipv6_addr_t *dst)
+{
+    _nib_offl_entry_t *res = NULL;
+    uint16_t cur = _ft_trie_root;
+
+    DEBUG("nib: get match for destination %s from NIB trie\n",
+          ipv6_addr_to_str(addr_str, dst, sizeof(addr_str)));
+    while (cur != 0) {
+        const _ft_trie_node_t *node = &_ft_trie[cur - 1];
+
+        if (node->dst != 0) {
+            /* branch nodes are skipped without comparison: if dst diverged
+             * at one of them it will not match the next entry either */
+            if (ipv6_addr_match_prefix(&_dsts[node->dst - 1].pfx,
+                                       dst) < node->len) {
+                break;
+            }
+            for (uint16_t i = node->dst; i != 0; i = _ft_trie_dup[i - 1]) {
+                if (_dsts[i - 1].mode != _EMPTY) {
+                    DEBUG("nib: best match so far (%u bits)\n", node->len);
+                    res = &_dsts[i - 1];
+                    break;
+                }
+            }
+        }
+        if (node->len >= IPV6_ADDR_BIT_LEN) {
+            break;
+        }
+        cur = node->child[_addr_bit(dst, node->len)];
+    }
+    return res;
+}
+#else   /* GNRC_IPV6_NIB_CONF_FT_TRIE */
 static _nib_offl_entry_t *_nib_offl_get_match(const ipv6_addr_t *dst)
 {
     _nib_offl_entry_t *res = NULL;
-    uint8_t best_match = 0;
 
     DEBUG("nib: get match for destination %s from NIB\n",
           ipv6_addr_to_str(addr_str, dst, sizeof(addr_str)));
@@ -585,15 +779,17 @@ static _nib_offl_entry_t *_nib_offl_get_match(const ipv6_addr_t *dst)
                   ipv6_addr_to_str(addr_str, &entry->next_hop->ipv6,
                                    sizeof(addr_str)),
                   _nib_onl_get_if(entry->next_hop), match);
-            if ((match > best_match) && (match >= entry->pfx_len)) {
-                DEBUG("nib: best match (%u bits)\n", match);
+            /* a longer prefix wins, not more matching bits of a shorter one */
+            if ((match >= entry->pfx_len) &&
+                ((res == NULL) || (entry->pfx_len > res->pfx_len))) {
+                DEBUG("nib: best match (%u bits)\n", entry->pfx_len);
                 res = entry;
-                best_match = match;
             }
         }
     }
     return res;
 }
+#endif  /* GNRC_IPV6_NIB_CONF_FT_TRIE */
 
 void _nib_ft_get(const _nib_offl_entry_t *dst, gnrc_ipv6_nib_ft_t *fte)
 {
@@ -34,24 +34,23 @@
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
-/* estimated fragment payload size to determinate RBUF_INT_SIZE, default to
- * MAC payload size - fragment header. */
-#ifndef GNRC_SIXLOWPAN_FRAG_SIZE
-/* assuming 64-bit source/destination address, source PAN ID omitted */
-#define GNRC_SIXLOWPAN_FRAG_SIZE (104 - 5)
+/* entries are chained by index + 1 in the hash buckets, 0 ends a chain */
+#if GNRC_SIXLOWPAN_FRAG_RBUF_SIZE > UINT8_MAX
+#error "GNRC_SIXLOWPAN_FRAG_RBUF_SIZE must not exceed 255"
 #endif
 
-#ifndef RBUF_INT_SIZE
-/* same as ((int) ceil((double) N / D)) */
-#define DIV_CEIL(N, D) (((N) + (D) - 1) / (D))
-#define RBUF_INT_SIZE (DIV_CEIL(IPV6_MIN_MTU, GNRC_SIXLOWPAN_FRAG_SIZE) * \
-                       GNRC_SIXLOWPAN_FRAG_RBUF_SIZE)
-#endif
-
-static gnrc_sixlowpan_frag_rb_int_t rbuf_int[RBUF_INT_SIZE];
+#define RBUF_BUCKETS    (GNRC_SIXLOWPAN_FRAG_RBUF_SIZE)
+#define RBUF_NONE       (0U)
 
 static gnrc_sixlowpan_frag_rb_t rbuf[GNRC_SIXLOWPAN_FRAG_RBUF_SIZE];
 
+/* head of the chain of each hash bucket */
+static uint8_t _rbuf_bucket[RBUF_BUCKETS];
+/* next entry in the chain of each entry */
+static uint8_t _rbuf_next[GNRC_SIXLOWPAN_FRAG_RBUF_SIZE];
+/* bucket each entry is chained in */
+static uint8_t _rbuf_hash[GNRC_SIXLOWPAN_FRAG_RBUF_SIZE];
+
 static char l2addr_str[3 * IEEE802154_LONG_ADDRESS_LEN];
 
 static xtimer_t _gc_timer;
@@ -60,13 +59,21 @@ static msg_t _gc_timer_msg = { .type = GNRC_SIXLOWPAN_FRAG_RB_GC_MSG };
 /* ------------------------------------
  * internal function definitions
  * ------------------------------------*/
-/* checks whether start and end overlaps, but not identical to, given interval i */
-static inline bool _rbuf_int_overlap_partially(gnrc_sixlowpan_frag_rb_int_t *i,
-                                               uint16_t start, uint16_t end);
-/* gets a free entry from interval buffer */
-static gnrc_sixlowpan_frag_rb_int_t *_rbuf_int_get_free(void);
-/* update interval buffer of entry */
-static bool _rbuf_update_ints(gnrc_sixlowpan_frag_rb_base_t *entry,
+/* hashes the link-layer information and tag of a datagram to its bucket */
+static unsigned _rbuf_bucket_of(const uint8_t *src, size_t src_len,
+                                const uint8_t *dst, size_t dst_len,
+                                uint16_t tag);
+/* gets an entry only by link-layer information and tag from the hash
+ * buckets, datagram size is only compared if size is not 0 */
+static gnrc_sixlowpan_frag_rb_t *_rbuf_lookup(const uint8_t *src,
+                                              size_t src_len,
+                                              const uint8_t *dst,
+                                              size_t dst_len,
+                                              size_t size, uint16_t tag);
+/* moves entry into the given hash bucket */
+static void _rbuf_rehash(gnrc_sixlowpan_frag_rb_t *entry, unsigned bucket);
+/* mark fragment as received in entry */
+static void _rbuf_update_ints(gnrc_sixlowpan_frag_rb_base_t *entry,
                               uint16_t offset, size_t frag_size);
 /* gets an entry identified by its tuple */
 static int _rbuf_get(const void *src, size_t src_len,
@@ -100,27 +107,45 @@ gnrc_sixlowpan_frag_stats_t *gnrc_sixlowpan_frag_stats_get(void)
 static int _check_fragments(gnrc_sixlowpan_frag_rb_base_t *entry,
                             size_t frag_size, size_t offset)
 {
-    gnrc_sixlowpan_frag_rb_int_t *ptr = entry->ints;
-
-    /* If the fragment overlaps another fragment and differs in either the size
-     * or the offset of the overlapped fragment, discards the datagram
-     * https://tools.ietf.org/html/rfc4944#section-5.3 */
-    while (ptr != NULL) {
-        if (_rbuf_int_overlap_partially(ptr, offset, offset + frag_size - 1)) {
-
-            /* "A fresh reassembly may be commenced with the most recently
-             * received link fragment"
-             * https://tools.ietf.org/html/rfc4944#section-5.3 */
-            return RBUF_ADD_REPEAT;
+    const unsigned first = offset / 8U;
+    const unsigned last = (offset + frag_size - 1) / 8U;
+    const unsigned units = (entry->datagram_size + 7U) / 8U;
+    bool received = false;
+
+    for (unsigned i = first; i <= last; i++) {
+        if (bf_isset(entry->received, i)) {
+            received = true;
+            break;
         }
-        /* End was already checked in overlap check */
-        if (ptr->start == offset) {
+    }
+    if (!received) {
+        return RBUF_ADD_SUCCESS;
+    }
+    /* Received fragments never overlap, so a received fragment reaches from
+     * its start up to the next start or the next unit not received. If the
+     * fragment is identical to that it is a duplicate. */
+    if (bf_isset(entry->starts, first)) {
+        bool identical = ((last + 1) >= units) ||
+                         !bf_isset(entry->received, last + 1) ||
+                         bf_isset(entry->starts, last + 1);
+
+        for (unsigned i = first + 1; identical && (i <= last); i++) {
+            identical = bf_isset(entry->received, i) &&
+                        !bf_isset(entry->starts, i);
+        }
+        if (identical) {
             DEBUG("6lo rbuf: fragment already in reassembly buffer");
             return RBUF_ADD_DUPLICATE;
         }
-        ptr = ptr->next;
     }
-    return RBUF_ADD_SUCCESS;
+    /* If the fragment overlaps another fragment and differs in either the size
+     * or the offset of the overlapped fragment, discards the datagram
+     * https://tools.ietf.org/html/rfc4944#section-5.3
+     *
+     * "A fresh reassembly may be commenced with the most recently
+     * received link fragment"
+     * https://tools.ietf.org/html/rfc4944#section-5.3 */
+    return RBUF_ADD_REPEAT;
 }
 
 gnrc_sixlowpan_frag_rb_t *gnrc_sixlowpan_frag_rb_add(gnrc_netif_hdr_t *netif_hdr,
@@ -163,15 +188,45 @@ static gnrc_sixlowpan_frag_rb_t *_rbuf_get_by_tag(const gnrc_netif_hdr_t *netif_
                                                   uint16_t tag)
 {
     assert(netif_hdr != NULL);
-    const uint8_t *src = gnrc_netif_hdr_get_src_addr(netif_hdr);
-    const uint8_t *dst = gnrc_netif_hdr_get_dst_addr(netif_hdr);
-    const uint8_t src_len = netif_hdr->src_l2addr_len;
-    const uint8_t dst_len = netif_hdr->dst_l2addr_len;
+    return _rbuf_lookup(gnrc_netif_hdr_get_src_addr(netif_hdr),
+                        netif_hdr->src_l2addr_len,
+                        gnrc_netif_hdr_get_dst_addr(netif_hdr),
+                        netif_hdr->dst_l2addr_len, 0, tag);
+}
+
+static unsigned _rbuf_bucket_of(const uint8_t *src, size_t src_len,
+                                const uint8_t *dst, size_t dst_len,
+                                uint16_t tag)
+{
+    /* FNV-1a over the tag and the addresses */
+    uint32_t hash = 2166136261U;
 
-    for (unsigned i = 0; i < GNRC_SIXLOWPAN_FRAG_RBUF_SIZE; i++) {
-        gnrc_sixlowpan_frag_rb_t *e = &rbuf[i];
+    hash = (hash ^ (tag & 0xff)) * 16777619U;
+    hash = (hash ^ (tag >> 8)) * 16777619U;
+    for (unsigned i = 0; i < src_len; i++) {
+        hash = (hash ^ src[i]) * 16777619U;
+    }
+    for (unsigned i = 0; i < dst_len; i++) {
+        hash = (hash ^ dst[i]) * 16777619U;
+    }
+    return hash % RBUF_BUCKETS;
+}
 
+static gnrc_sixlowpan_frag_rb_t *_rbuf_lookup(const uint8_t *src,
+                                              size_t src_len,
+                                              const uint8_t *dst,
+                                              size_t dst_len,
+                                              size_t size, uint16_t tag)
+{
+    unsigned bucket = _rbuf_bucket_of(src, src_len, dst, dst_len, tag);
+
+    for (unsigned i = _rbuf_bucket[bucket]; i != RBUF_NONE;
+         i = _rbuf_next[i - 1]) {
+        gnrc_sixlowpan_frag_rb_t *e = &rbuf[i - 1];
+
+        /* removed entries stay chained until they are reused */
         if ((e->pkt != NULL) && (e->super.tag == tag) &&
+            ((size == 0) || (e->super.datagram_size == size)) &&
             (e->super.src_len == src_len) &&
             (e->super.dst_len == dst_len) &&
             (memcmp(e->super.src, src, src_len) == 0) &&
@@ -182,6 +237,24 @@ static gnrc_sixlowpan_frag_rb_t *_rbuf_get_by_tag(const gnrc_netif_hdr_t *netif_
     return NULL;
 }
 
+static void _rbuf_rehash(gnrc_sixlowpan_frag_rb_t *entry, unsigned bucket)
+{
+    const unsigned idx = entry - &rbuf[0];
+    uint8_t *ptr = &_rbuf_bucket[_rbuf_hash[idx]];
+
+    /* unchain from old bucket */
+    while (*ptr != RBUF_NONE) {
+        if (*ptr == (idx + 1)) {
+            *ptr = _rbuf_next[idx];
+            break;
+        }
+        ptr = &_rbuf_next[*ptr - 1];
+    }
+    _rbuf_hash[idx] = bucket;
+    _rbuf_next[idx] = _rbuf_bucket[bucket];
+    _rbuf_bucket[bucket] = idx + 1;
+}
+
 #ifndef NDEBUG
 static bool _valid_offset(gnrc_pktsnip_t *pkt, size_t offset)
 {
@@ -236,7 +309,6 @@ static int _rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
     datagram_size = sixlowpan_frag_datagram_size(pkt->data);
     datagram_tag = sixlowpan_frag_datagram_tag(pkt->data);
 
-    gnrc_sixlowpan_frag_rb_gc();
     res = _rbuf_get(gnrc_netif_hdr_get_src_addr(netif_hdr), netif_hdr->src_l2addr_len,
                     gnrc_netif_hdr_get_dst_addr(netif_hdr), netif_hdr->dst_l2addr_len,
                     datagram_size, datagram_tag, page);
@@ -254,6 +326,11 @@ static int _rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
         gnrc_sixlowpan_frag_rb_remove(entry);
         return RBUF_ADD_ERROR;
     }
+    if (frag_size == 0) {
+        DEBUG("6lo rfrag: empty fragment\n");
+        gnrc_pktbuf_release(pkt);
+        return res;
+    }
 
     switch (_check_fragments(&entry->super, frag_size, offset)) {
         case RBUF_ADD_REPEAT:
@@ -268,96 +345,65 @@ static int _rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
             break;
     }
 
-    if (_rbuf_update_ints(&entry->super, offset, frag_size)) {
-        DEBUG("6lo rbuf: add fragment data\n");
-        entry->super.current_size += (uint16_t)frag_size;
-        if (offset == 0) {
+    _rbuf_update_ints(&entry->super, offset, frag_size);
+    DEBUG("6lo rbuf: add fragment data\n");
+    entry->super.current_size += (uint16_t)frag_size;
+    if (offset == 0) {
 #ifdef MODULE_GNRC_SIXLOWPAN_IPHC
-            if (sixlowpan_iphc_is(data)) {
-                DEBUG("6lo rbuf: detected IPHC header.\n");
-                gnrc_pktsnip_t *frag_hdr = gnrc_pktbuf_mark(pkt,
-                        sizeof(sixlowpan_frag_t), GNRC_NETTYPE_SIXLOWPAN);
-                if (frag_hdr == NULL) {
-                    DEBUG("6lo rbuf: unable to mark fragment header. "
-                          "aborting reassembly.\n");
-                    gnrc_pktbuf_release(entry->pkt);
-                    gnrc_pktbuf_release(pkt);
-                    gnrc_sixlowpan_frag_rb_remove(entry);
-                    return RBUF_ADD_ERROR;
-                }
-                else {
-                    DEBUG("6lo rbuf: handing over to IPHC reception.\n");
-                    /* `pkt` released in IPHC */
-                    gnrc_sixlowpan_iphc_recv(pkt, entry, 0);
-                    /* check if entry was deleted in IPHC (error case) */
-                    if (gnrc_sixlowpan_frag_rb_entry_empty(entry)) {
-                        res = RBUF_ADD_ERROR;
-                    }
-                    return res;
+        if (sixlowpan_iphc_is(data)) {
+            DEBUG("6lo rbuf: detected IPHC header.\n");
+            gnrc_pktsnip_t *frag_hdr = gnrc_pktbuf_mark(pkt,
+                    sizeof(sixlowpan_frag_t), GNRC_NETTYPE_SIXLOWPAN);
+            if (frag_hdr == NULL) {
+                DEBUG("6lo rbuf: unable to mark fragment header. "
+                      "aborting reassembly.\n");
+                gnrc_pktbuf_release(entry->pkt);
+                gnrc_pktbuf_release(pkt);
+                gnrc_sixlowpan_frag_rb_remove(entry);
+                return RBUF_ADD_ERROR;
+            }
+            else {
+                DEBUG("6lo rbuf: handing over to IPHC reception.\n");
+                /* `pkt` released in IPHC */
+                gnrc_sixlowpan_iphc_recv(pkt, entry, 0);
+                /* check if entry was deleted in IPHC (error case) */
+                if (gnrc_sixlowpan_frag_rb_entry_empty(entry)) {
+                    res = RBUF_ADD_ERROR;
                 }
+                return res;
             }
-            else
+        }
+        else
 #endif
-            if (data[0] == SIXLOWPAN_UNCOMP) {
-                DEBUG("6lo rbuf: detected uncompressed datagram\n");
-                data++;
-            }
+        if (data[0] == SIXLOWPAN_UNCOMP) {
+            DEBUG("6lo rbuf: detected uncompressed datagram\n");
+            data++;
         }
-        memcpy(((uint8_t *)entry->pkt->data) + offset, data,
-               frag_size);
     }
+    memcpy(((uint8_t *)entry->pkt->data) + offset, data,
+           frag_size);
     /* no errors and not consumed => release packet */
     gnrc_pktbuf_release(pkt);
     return res;
 }
 
-static inline bool _rbuf_int_overlap_partially(gnrc_sixlowpan_frag_rb_int_t *i,
-                                               uint16_t start, uint16_t end)
-{
-    /* start and ends are both inclusive, so using <= for both */
-    return ((i->start <= end) && (start <= i->end)) && /* overlaps */
-        ((start != i->start) || (end != i->end)); /* not identical */
-}
-
-static gnrc_sixlowpan_frag_rb_int_t *_rbuf_int_get_free(void)
-{
-    for (unsigned int i = 0; i < RBUF_INT_SIZE; i++) {
-        if (rbuf_int[i].end == 0) { /* start must be smaller than end anyways*/
-            return rbuf_int + i;
-        }
-    }
-
-    return NULL;
-}
-
-static bool _rbuf_update_ints(gnrc_sixlowpan_frag_rb_base_t *entry,
+static void _rbuf_update_ints(gnrc_sixlowpan_frag_rb_base_t *entry,
                               uint16_t offset, size_t frag_size)
 {
-    gnrc_sixlowpan_frag_rb_int_t *new;
-    uint16_t end = (uint16_t)(offset + frag_size - 1);
-
-    new = _rbuf_int_get_free();
+    const unsigned last = (offset + frag_size - 1) / 8U;
 
-    if (new == NULL) {
-        DEBUG("6lo rfrag: no space left in rbuf interval buffer.\n");
-        return false;
+    bf_set(entry->starts, offset / 8U);
+    for (unsigned i = offset / 8U; i <= last; i++) {
+        bf_set(entry->received, i);
     }
 
-    new->start = offset;
-    new->end = end;
-
-    DEBUG("6lo rfrag: add interval (%" PRIu16 ", %" PRIu16 ") to entry (%s, ",
-          new->start, new->end, gnrc_netif_addr_to_str(entry->src,
-                                                       entry->src_len,
-                                                       l2addr_str));
+    DEBUG("6lo rfrag: add interval (%" PRIu16 ", %u) to entry (%s, ",
+          offset, (unsigned)(offset + frag_size - 1),
+          gnrc_netif_addr_to_str(entry->src, entry->src_len, l2addr_str));
     DEBUG("%s, %u, %u)\n", gnrc_netif_addr_to_str(entry->dst,
                                                   entry->dst_len,
                                                   l2addr_str),
           entry->datagram_size, entry->tag);
-
-    LL_PREPEND(entry->ints, new);
-
-    return true;
 }
 
 void gnrc_sixlowpan_frag_rb_gc(void)
@@ -402,31 +448,43 @@ static int _rbuf_get(const void *src, size_t src_len,
 {
     gnrc_sixlowpan_frag_rb_t *res = NULL, *oldest = NULL;
     uint32_t now_usec = xtimer_now_usec();
+    unsigned bucket = _rbuf_bucket_of(src, src_len, dst, dst_len, tag);
+
+    /* check first if entry already available */
+    res = _rbuf_lookup(src, src_len, dst, dst_len, size, tag);
+    if ((res != NULL) &&
+        ((now_usec - res->super.arrival) > GNRC_SIXLOWPAN_FRAG_RBUF_TIMEOUT_US)) {
+        DEBUG("6lo rfrag: entry %p timed out\n", (void *)res);
+        gnrc_pktbuf_release(res->pkt);
+        gnrc_sixlowpan_frag_rb_remove(res);
+        res = NULL;
+    }
+    if (res != NULL) {
+        DEBUG("6lo rfrag: entry %p (%s, ", (void *)res,
+              gnrc_netif_addr_to_str(res->super.src,
+                                     res->super.src_len,
+                                     l2addr_str));
+        DEBUG("%s, %u, %u) found\n",
+              gnrc_netif_addr_to_str(res->super.dst,
+                                     res->super.dst_len,
+                                     l2addr_str),
+              (unsigned)res->super.datagram_size, res->super.tag);
+        res->super.arrival = now_usec;
+        _set_rbuf_timeout();
+        return res - &(rbuf[0]);
+    }
+    if (size > GNRC_SIXLOWPAN_FRAG_RBUF_DATAGRAM_MAX) {
+        DEBUG("6lo rfrag: datagram too big for reassembly buffer\n");
+        return -1;
+    }
 
+    /* new datagram: since pkt occupies pktbuf, aggressivly collect garbage */
+    gnrc_sixlowpan_frag_rb_gc();
     for (unsigned int i = 0; i < GNRC_SIXLOWPAN_FRAG_RBUF_SIZE; i++) {
-        /* check first if entry already available */
-        if ((rbuf[i].pkt != NULL) && (rbuf[i].super.datagram_size == size) &&
-            (rbuf[i].super.tag == tag) && (rbuf[i].super.src_len == src_len) &&
-            (rbuf[i].super.dst_len == dst_len) &&
-            (memcmp(rbuf[i].super.src, src, src_len) == 0) &&
-            (memcmp(rbuf[i].super.dst, dst, dst_len) == 0)) {
-            DEBUG("6lo rfrag: entry %p (%s, ", (void *)(&rbuf[i]),
-                  gnrc_netif_addr_to_str(rbuf[i].super.src,
-                                         rbuf[i].super.src_len,
-                                         l2addr_str));
-            DEBUG("%s, %u, %u) found\n",
-                  gnrc_netif_addr_to_str(rbuf[i].super.dst,
-                                         rbuf[i].super.dst_len,
-                                         l2addr_str),
-                  (unsigned)rbuf[i].super.datagram_size, rbuf[i].super.tag);
-            rbuf[i].super.arrival = now_usec;
-            _set_rbuf_timeout();
-            return i;
-        }
-
-        /* if there is a free spot: remember it */
-        if ((res == NULL) && gnrc_sixlowpan_frag_rb_entry_empty(&rbuf[i])) {
+        /* if there is a free spot: take it */
+        if (gnrc_sixlowpan_frag_rb_entry_empty(&rbuf[i])) {
             res = &(rbuf[i]);
+            break;
         }
 
         /* remember oldest slot */
@@ -492,6 +550,7 @@ static int _rbuf_get(const void *src, size_t src_len,
     res->super.dst_len = dst_len;
     res->super.tag = tag;
     res->super.current_size = 0;
+    _rbuf_rehash(res, bucket);
 
     DEBUG("6lo rfrag: entry %p (%s, ", (void *)res,
           gnrc_netif_addr_to_str(res->super.src, res->super.src_len,
@@ -510,7 +569,9 @@ static int _rbuf_get(const void *src, size_t src_len,
 void gnrc_sixlowpan_frag_rb_reset(void)
 {
     xtimer_remove(&_gc_timer);
-    memset(rbuf_int, 0, sizeof(rbuf_int));
+    memset(_rbuf_bucket, 0, sizeof(_rbuf_bucket));
+    memset(_rbuf_next, 0, sizeof(_rbuf_next));
+    memset(_rbuf_hash, 0, sizeof(_rbuf_hash));
     for (unsigned int i = 0; i < GNRC_SIXLOWPAN_FRAG_RBUF_SIZE; i++) {
         if ((rbuf[i].pkt != NULL) &&
             (rbuf[i].pkt->users > 0)) {
@@ -528,14 +589,8 @@ const gnrc_sixlowpan_frag_rb_t *gnrc_sixlowpan_frag_rb_array(void)
 
 void gnrc_sixlowpan_frag_rb_base_rm(gnrc_sixlowpan_frag_rb_base_t *entry)
 {
-    while (entry->ints != NULL) {
-        gnrc_sixlowpan_frag_rb_int_t *next = entry->ints->next;
-
-        entry->ints->start = 0;
-        entry->ints->end = 0;
-        entry->ints->next = NULL;
-        entry->ints = next;
-    }
+    memset(entry->received, 0, sizeof(entry->received));
+    memset(entry->starts, 0, sizeof(entry->starts));
     entry->datagram_size = 0;
 }
 
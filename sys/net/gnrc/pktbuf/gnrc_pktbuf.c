@@ -13,8 +13,85 @@
  * @author  Martine Lenders <m.lenders@fu-berlin.de>
  */
 
+#include <assert.h>
+
 #include "net/gnrc/pktbuf.h"
 
+#ifdef MODULE_GNRC_PKTBUF_EXT
+#include "mutex.h"
+
+/**
+ * @brief   Bookkeeping of a snip that references external data
+ */
+typedef struct {
+    gnrc_pktsnip_t *snip;       /**< the snip, NULL while being set up */
+    gnrc_pktbuf_ext_cb_t cb;    /**< owner callback, NULL if entry is free */
+    void *arg;                  /**< argument for _ext_t::cb */
+} _ext_t;
+
+static mutex_t _ext_mutex = MUTEX_INIT;
+static _ext_t _ext[GNRC_PKTBUF_EXT_NUMOF];
+
+gnrc_pktsnip_t *gnrc_pktbuf_add_ext(gnrc_pktsnip_t *next, const void *data,
+                                    size_t size, gnrc_nettype_t type,
+                                    gnrc_pktbuf_ext_cb_t cb, void *arg)
+{
+    _ext_t *ext = NULL;
+    gnrc_pktsnip_t *pkt;
+
+    assert(cb != NULL);
+    mutex_lock(&_ext_mutex);
+    for (unsigned i = 0; i < GNRC_PKTBUF_EXT_NUMOF; i++) {
+        if (_ext[i].cb == NULL) {
+            ext = &_ext[i];
+            /* reserve entry */
+            ext->cb = cb;
+            ext->arg = arg;
+            break;
+        }
+    }
+    mutex_unlock(&_ext_mutex);
+    if (ext == NULL) {
+        return NULL;
+    }
+    /* the backend locks the packet buffer and calls gnrc_pktbuf_ext_release()
+     * with it held, so _ext_mutex must not be held here */
+    pkt = gnrc_pktbuf_add(next, NULL, 0, type);
+    mutex_lock(&_ext_mutex);
+    if (pkt == NULL) {
+        ext->cb = NULL;
+    }
+    else {
+        pkt->data = (void *)data;
+        pkt->size = size;
+        ext->snip = pkt;
+    }
+    mutex_unlock(&_ext_mutex);
+    return pkt;
+}
+
+bool gnrc_pktbuf_ext_release(gnrc_pktsnip_t *pkt)
+{
+    bool res = false;
+
+    if (pkt->data == NULL) {
+        return false;
+    }
+    mutex_lock(&_ext_mutex);
+    for (unsigned i = 0; i < GNRC_PKTBUF_EXT_NUMOF; i++) {
+        if ((_ext[i].cb != NULL) && (_ext[i].snip == pkt)) {
+            _ext[i].cb(_ext[i].arg);
+            _ext[i].snip = NULL;
+            _ext[i].cb = NULL;
+            res = true;
+            break;
+        }
+    }
+    mutex_unlock(&_ext_mutex);
+    return res;
+}
+#endif /* MODULE_GNRC_PKTBUF_EXT */
+
 gnrc_pktsnip_t *gnrc_pktbuf_remove_snip(gnrc_pktsnip_t *pkt,
                                         gnrc_pktsnip_t *snip)
 {
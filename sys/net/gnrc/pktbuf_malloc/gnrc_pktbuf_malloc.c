@@ -210,7 +210,13 @@ static void _release_error_locked(gnrc_pktsnip_t *pkt, uint32_t err)
         tmp = pkt->next;
         if (pkt->users == 1) {
             pkt->users = 0; /* not necessary but to be on the safe side */
+#ifdef MODULE_GNRC_PKTBUF_EXT
+            if (!gnrc_pktbuf_ext_release(pkt)) {
+                _free(pkt->data);
+            }
+#else
             _free(pkt->data);
+#endif
             _free(pkt);
         }
         else {
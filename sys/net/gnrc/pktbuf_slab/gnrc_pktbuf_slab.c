@@ -0,0 +1,507 @@
+/*
+ * Copyright (C) 2019 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup net_gnrc_pktbuf
+ * @{
+ *
+ * @file
+ * @brief   Packet buffer built on segregated size classes of fixed-size
+ *          blocks
+ *
+ * Every size class is a @ref sys_memarray pool, so allocating and releasing
+ * a snip or its data is a free-list push or pop. The class of a data pointer
+ * (and the block it lies in) is derived from its address, which allows
+ * @ref gnrc_pktbuf_mark() to leave the remainder of a snip in place and only
+ * copy the (usually small) marked header into a block of its own.
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "memarray.h"
+#include "mutex.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/nettype.h"
+#include "net/gnrc/pkt.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#define _CLASS_NUMOF    (3U)
+
+/**
+ * @brief   A size class of the packet buffer
+ */
+typedef struct {
+    memarray_t pool;        /**< free list of the blocks */
+    uint8_t *start;         /**< first block of the class */
+    uint16_t block_size;    /**< size of a block */
+    uint16_t numof;         /**< number of blocks */
+    uint16_t used;          /**< number of blocks in use */
+#ifdef DEVELHELP
+    uint16_t max_used;      /**< maximum number of blocks in use */
+    uint32_t requested;     /**< bytes requested from the blocks in use */
+    uint32_t spills;        /**< allocations served for a smaller class */
+    uint32_t fails;         /**< allocations that failed in this class */
+#endif
+} _slab_t;
+
+static mutex_t _mutex = MUTEX_INIT;
+
+static gnrc_pktsnip_t _snip_mem[GNRC_PKTBUF_SLAB_SNIP_NUMOF];
+static uint8_t _small_mem[GNRC_PKTBUF_SLAB_SMALL_NUMOF *
+                          GNRC_PKTBUF_SLAB_SMALL_SIZE]
+    __attribute__((aligned(sizeof(void *))));
+static uint8_t _medium_mem[GNRC_PKTBUF_SLAB_MEDIUM_NUMOF *
+                           GNRC_PKTBUF_SLAB_MEDIUM_SIZE]
+    __attribute__((aligned(sizeof(void *))));
+static uint8_t _large_mem[GNRC_PKTBUF_SLAB_LARGE_NUMOF *
+                          GNRC_PKTBUF_SLAB_LARGE_SIZE]
+    __attribute__((aligned(sizeof(void *))));
+
+static _slab_t _snips;
+/* ordered by block size, so the first class that fits is the best fit */
+static _slab_t _classes[_CLASS_NUMOF];
+
+/* internal gnrc_pktbuf functions */
+static gnrc_pktsnip_t *_create_snip(gnrc_pktsnip_t *next, const void *data, size_t size,
+                                    gnrc_nettype_t type);
+static void *_data_alloc(size_t size);
+static void _data_free(void *data, size_t size);
+
+static inline void _set_pktsnip(gnrc_pktsnip_t *pkt, gnrc_pktsnip_t *next,
+                                void *data, size_t size, gnrc_nettype_t type)
+{
+    pkt->next = next;
+    pkt->data = data;
+    pkt->size = size;
+    pkt->type = type;
+    pkt->users = 1;
+#ifdef MODULE_GNRC_NETERR
+    pkt->err_sub = KERNEL_PID_UNDEF;
+#endif
+}
+
+static void _slab_init(_slab_t *slab, void *mem, size_t block_size,
+                       size_t numof)
+{
+    assert((block_size % sizeof(void *)) == 0);
+    memset(slab, 0, sizeof(_slab_t));
+    memarray_init(&slab->pool, mem, block_size, numof);
+    slab->start = mem;
+    slab->block_size = block_size;
+    slab->numof = numof;
+}
+
+static inline bool _slab_contains(const _slab_t *slab, const void *ptr)
+{
+    return ((uintptr_t)ptr - (uintptr_t)slab->start) <
+           ((uintptr_t)slab->block_size * slab->numof);
+}
+
+static inline uint8_t *_slab_block(const _slab_t *slab, const void *ptr)
+{
+    size_t offset = (const uint8_t *)ptr - slab->start;
+
+    return slab->start + (offset - (offset % slab->block_size));
+}
+
+/* bytes from ptr to the end of its block */
+static inline size_t _slab_capacity(const _slab_t *slab, const void *ptr)
+{
+    return (_slab_block(slab, ptr) + slab->block_size) - (const uint8_t *)ptr;
+}
+
+static _slab_t *_slab_of(const void *ptr)
+{
+    for (unsigned i = 0; i < _CLASS_NUMOF; i++) {
+        if (_slab_contains(&_classes[i], ptr)) {
+            return &_classes[i];
+        }
+    }
+    return NULL;
+}
+
+static inline void _slab_account(_slab_t *slab, int32_t requested)
+{
+#ifdef DEVELHELP
+    slab->requested += requested;
+#else
+    (void)slab;
+    (void)requested;
+#endif
+}
+
+static void *_slab_alloc(_slab_t *slab)
+{
+    void *block = memarray_alloc(&slab->pool);
+
+    if (block != NULL) {
+        slab->used++;
+#ifdef DEVELHELP
+        if (slab->used > slab->max_used) {
+            slab->max_used = slab->used;
+        }
+#endif
+    }
+    return block;
+}
+
+static inline void _slab_free(_slab_t *slab, void *block)
+{
+    assert(slab->used > 0);
+    memarray_free(&slab->pool, block);
+    slab->used--;
+}
+
+void gnrc_pktbuf_init(void)
+{
+    mutex_lock(&_mutex);
+    _slab_init(&_snips, _snip_mem, sizeof(gnrc_pktsnip_t),
+               GNRC_PKTBUF_SLAB_SNIP_NUMOF);
+    _slab_init(&_classes[0], _small_mem, GNRC_PKTBUF_SLAB_SMALL_SIZE,
+               GNRC_PKTBUF_SLAB_SMALL_NUMOF);
+    _slab_init(&_classes[1], _medium_mem, GNRC_PKTBUF_SLAB_MEDIUM_SIZE,
+               GNRC_PKTBUF_SLAB_MEDIUM_NUMOF);
+    _slab_init(&_classes[2], _large_mem, GNRC_PKTBUF_SLAB_LARGE_SIZE,
+               GNRC_PKTBUF_SLAB_LARGE_NUMOF);
+    mutex_unlock(&_mutex);
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_add(gnrc_pktsnip_t *next, const void *data, size_t size,
+                                gnrc_nettype_t type)
+{
+    gnrc_pktsnip_t *pkt;
+
+    if (size > GNRC_PKTBUF_SLAB_LARGE_SIZE) {
+        DEBUG("pktbuf: size (%u) > GNRC_PKTBUF_SLAB_LARGE_SIZE (%u)\n",
+              (unsigned)size, GNRC_PKTBUF_SLAB_LARGE_SIZE);
+        return NULL;
+    }
+    mutex_lock(&_mutex);
+    pkt = _create_snip(next, data, size, type);
+    mutex_unlock(&_mutex);
+    return pkt;
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_mark(gnrc_pktsnip_t *pkt, size_t size, gnrc_nettype_t type)
+{
+    gnrc_pktsnip_t *marked_snip;
+    void *new_data_marked;
+
+    mutex_lock(&_mutex);
+    if ((size == 0) || (pkt == NULL) || (size > pkt->size) || (pkt->data == NULL)) {
+        DEBUG("pktbuf: size == 0 (was %u) or pkt == NULL (was %p) or "
+              "size > pkt->size (was %u) or pkt->data == NULL (was %p)\n",
+              (unsigned)size, (void *)pkt, (pkt ? (unsigned)pkt->size : 0),
+              (pkt ? pkt->data : NULL));
+        mutex_unlock(&_mutex);
+        return NULL;
+    }
+    /* create new snip descriptor for marked data */
+    marked_snip = _slab_alloc(&_snips);
+    if (marked_snip == NULL) {
+        DEBUG("pktbuf: could not reallocate marked section.\n");
+        mutex_unlock(&_mutex);
+        return NULL;
+    }
+    if (pkt->size == size) {
+        new_data_marked = pkt->data;
+        pkt->data = NULL;
+    }
+    else {
+        _slab_t *slab = _slab_of(pkt->data);
+
+        /* a block has exactly one owner: the remainder stays in the block of
+         * pkt, the marked section is copied to a new one */
+        new_data_marked = _data_alloc(size);
+        if (new_data_marked == NULL) {
+            DEBUG("pktbuf: could not reallocate marked section.\n");
+            _slab_free(&_snips, marked_snip);
+            mutex_unlock(&_mutex);
+            return NULL;
+        }
+        memcpy(new_data_marked, pkt->data, size);
+        if (slab != NULL) {
+            _slab_account(slab, -(int32_t)size);
+        }
+        pkt->data = ((uint8_t *)pkt->data) + size;
+    }
+    pkt->size -= size;
+    _set_pktsnip(marked_snip, pkt->next, new_data_marked, size, type);
+    pkt->next = marked_snip;
+    mutex_unlock(&_mutex);
+    return marked_snip;
+}
+
+int gnrc_pktbuf_realloc_data(gnrc_pktsnip_t *pkt, size_t size)
+{
+    _slab_t *slab;
+
+    mutex_lock(&_mutex);
+    assert(pkt != NULL);
+    assert(((pkt->size == 0) && (pkt->data == NULL)) ||
+           ((pkt->size > 0) && (pkt->data != NULL) && _slab_of(pkt->data)));
+    /* new size and old size are equal */
+    if (size == pkt->size) {
+        /* nothing to do */
+        mutex_unlock(&_mutex);
+        return 0;
+    }
+    /* new size is 0 and data pointer isn't already NULL */
+    if ((size == 0) && (pkt->data != NULL)) {
+        /* set data pointer to NULL */
+        _data_free(pkt->data, pkt->size);
+        pkt->data = NULL;
+    }
+    else if (((slab = _slab_of(pkt->data)) != NULL) &&
+             (size <= _slab_capacity(slab, pkt->data))) {
+        /* fits into the block of pkt->data => nothing to move */
+        _slab_account(slab, (int32_t)size - (int32_t)pkt->size);
+    }
+    else {
+        void *new_data = _data_alloc(size);
+
+        if (new_data == NULL) {
+            DEBUG("pktbuf: error allocating new data section\n");
+            mutex_unlock(&_mutex);
+            return ENOMEM;
+        }
+        if (pkt->data != NULL) {            /* if old data exist */
+            memcpy(new_data, pkt->data, pkt->size);
+        }
+        _data_free(pkt->data, pkt->size);
+        pkt->data = new_data;
+    }
+    pkt->size = size;
+    mutex_unlock(&_mutex);
+    return 0;
+}
+
+void gnrc_pktbuf_hold(gnrc_pktsnip_t *pkt, unsigned int num)
+{
+    mutex_lock(&_mutex);
+    while (pkt) {
+        pkt->users += num;
+        pkt = pkt->next;
+    }
+    mutex_unlock(&_mutex);
+}
+
+static void _release_error_locked(gnrc_pktsnip_t *pkt, uint32_t err)
+{
+    while (pkt) {
+        gnrc_pktsnip_t *tmp;
+        assert(_slab_contains(&_snips, pkt));
+        assert(pkt->users > 0);
+        tmp = pkt->next;
+        if (pkt->users == 1) {
+            pkt->users = 0; /* not necessary but to be on the safe side */
+#ifdef MODULE_GNRC_PKTBUF_EXT
+            if (_slab_of(pkt->data) == NULL) {
+                /* external data is ignored by _data_free() */
+                gnrc_pktbuf_ext_release(pkt);
+            }
+#endif
+            _data_free(pkt->data, pkt->size);
+            _slab_free(&_snips, pkt);
+        }
+        else {
+            pkt->users--;
+        }
+        DEBUG("pktbuf: report status code %" PRIu32 "\n", err);
+        gnrc_neterr_report(pkt, err);
+        pkt = tmp;
+    }
+}
+
+void gnrc_pktbuf_release_error(gnrc_pktsnip_t *pkt, uint32_t err)
+{
+    mutex_lock(&_mutex);
+    _release_error_locked(pkt, err);
+    mutex_unlock(&_mutex);
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_start_write(gnrc_pktsnip_t *pkt)
+{
+    mutex_lock(&_mutex);
+    if (pkt == NULL) {
+        mutex_unlock(&_mutex);
+        return NULL;
+    }
+    if (pkt->users > 1) {
+        gnrc_pktsnip_t *new;
+        new = _create_snip(pkt->next, pkt->data, pkt->size, pkt->type);
+        if (new != NULL) {
+            pkt->users--;
+        }
+        mutex_unlock(&_mutex);
+        return new;
+    }
+    mutex_unlock(&_mutex);
+    return pkt;
+}
+
+#ifdef DEVELHELP
+static void _print_slab(const char *name, const _slab_t *slab)
+{
+    /* snips are always used as a whole */
+    size_t unused = (slab == &_snips) ? 0 :
+                    ((size_t)slab->used * slab->block_size) - slab->requested;
+
+    printf("%-6s %5u %5u/%-5u %5u %7" PRIu32 " %7" PRIu32 " %6u\n",
+           name, slab->block_size, slab->used, slab->numof, slab->max_used,
+           slab->spills, slab->fails,
+           (unsigned)unused);
+}
+
+void gnrc_pktbuf_stats(void)
+{
+    static const char *names[] = { "small", "medium", "large" };
+    uint32_t reserved = 0, requested = 0;
+
+    mutex_lock(&_mutex);
+    printf("packet buffer: %u snips, %u bytes of data in %u classes\n",
+           GNRC_PKTBUF_SLAB_SNIP_NUMOF,
+           (unsigned)(sizeof(_small_mem) + sizeof(_medium_mem) +
+                      sizeof(_large_mem)), _CLASS_NUMOF);
+    puts("class   size  used/num    max  spills   fails  frag.");
+    _print_slab("snips", &_snips);
+    for (unsigned i = 0; i < _CLASS_NUMOF; i++) {
+        _print_slab(names[i], &_classes[i]);
+        reserved += (uint32_t)_classes[i].used * _classes[i].block_size;
+        requested += _classes[i].requested;
+    }
+    printf("  internal fragmentation: %" PRIu32 " of %" PRIu32
+           " reserved bytes unused\n", reserved - requested, reserved);
+    mutex_unlock(&_mutex);
+}
+#endif
+
+#ifdef TEST_SUITES
+bool gnrc_pktbuf_is_empty(void)
+{
+    if (_snips.used > 0) {
+        return false;
+    }
+    for (unsigned i = 0; i < _CLASS_NUMOF; i++) {
+        if (_classes[i].used > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool _slab_is_sane(const _slab_t *slab)
+{
+    unsigned free_blocks = 0;
+
+    /* Invariants of this implementation:
+     *  - forall ptr in free list: ptr is the start of a block of the class
+     *  - length of free list == numof - used
+     */
+    for (void *ptr = slab->pool.free_data; ptr != NULL; ptr = *((void **)ptr)) {
+        if (!_slab_contains(slab, ptr) || (_slab_block(slab, ptr) != ptr) ||
+            (++free_blocks > slab->numof)) {
+            return false;
+        }
+    }
+    return (free_blocks + slab->used) == slab->numof;
+}
+
+bool gnrc_pktbuf_is_sane(void)
+{
+    if (!_slab_is_sane(&_snips)) {
+        return false;
+    }
+    for (unsigned i = 0; i < _CLASS_NUMOF; i++) {
+        if (!_slab_is_sane(&_classes[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+static gnrc_pktsnip_t *_create_snip(gnrc_pktsnip_t *next, const void *data, size_t size,
+                                    gnrc_nettype_t type)
+{
+    gnrc_pktsnip_t *pkt = _slab_alloc(&_snips);
+    void *_data = NULL;
+
+    if (pkt == NULL) {
+        DEBUG("pktbuf: error allocating new packet snip\n");
+        return NULL;
+    }
+    if (size > 0) {
+        _data = _data_alloc(size);
+        if (_data == NULL) {
+            DEBUG("pktbuf: error allocating data for new packet snip\n");
+            _slab_free(&_snips, pkt);
+            return NULL;
+        }
+        if (data != NULL) {
+            memcpy(_data, data, size);
+        }
+    }
+    _set_pktsnip(pkt, next, _data, size, type);
+    return pkt;
+}
+
+/* allocates from the best fitting class, or the next larger one if exhausted */
+static void *_data_alloc(size_t size)
+{
+    _slab_t *best_fit = NULL;
+
+    for (_slab_t *slab = &_classes[0]; slab < &_classes[_CLASS_NUMOF]; slab++) {
+        void *block;
+
+        if (size > slab->block_size) {
+            continue;
+        }
+        if (best_fit == NULL) {
+            best_fit = slab;
+        }
+        if ((block = _slab_alloc(slab)) != NULL) {
+            _slab_account(slab, size);
+#ifdef DEVELHELP
+            if (slab != best_fit) {
+                slab->spills++;
+            }
+#endif
+            return block;
+        }
+    }
+#ifdef DEVELHELP
+    if (best_fit != NULL) {
+        best_fit->fails++;
+    }
+#endif
+    DEBUG("pktbuf: no block of %u bytes left in packet buffer\n",
+          (unsigned)size);
+    return NULL;
+}
+
+static void _data_free(void *data, size_t size)
+{
+    _slab_t *slab = _slab_of(data);
+
+    if (slab == NULL) {
+        return;
+    }
+    _slab_account(slab, -(int32_t)size);
+    _slab_free(slab, _slab_block(slab, data));
+}
+
+/** @} */
@@ -227,6 +227,12 @@ static void _release_error_locked(gnrc_pktsnip_t *pkt, uint32_t err)
         tmp = pkt->next;
         if (pkt->users == 1) {
             pkt->users = 0; /* not necessary but to be on the safe side */
+#ifdef MODULE_GNRC_PKTBUF_EXT
+            if (!_pktbuf_contains(pkt->data)) {
+                /* external data is ignored by _pktbuf_free() */
+                gnrc_pktbuf_ext_release(pkt);
+            }
+#endif
             _pktbuf_free(pkt->data, pkt->size);
             _pktbuf_free(pkt, sizeof(gnrc_pktsnip_t));
         }
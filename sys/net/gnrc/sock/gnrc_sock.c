@@ -44,10 +44,34 @@ static void _callback_put(void *arg)
 }
 #endif
 
+#ifdef SOCK_HAS_ASYNC
+static void _netapi_cb(uint16_t cmd, gnrc_pktsnip_t *pkt, void *ctx)
+{
+    gnrc_sock_reg_t *reg = ctx;
+    msg_t msg = { .type = cmd, .content = { .ptr = pkt } };
+
+    if (mbox_try_put(&reg->mbox, &msg) < 1) {
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+    if ((cmd == GNRC_NETAPI_MSG_TYPE_RCV) && (reg->async_cb.generic != NULL)) {
+        /* sock_ip_t and sock_udp_t start with their gnrc_sock_reg_t */
+        reg->async_cb.generic(reg, SOCK_ASYNC_MSG_RECV, reg->async_cb_arg);
+    }
+}
+#endif
+
 void gnrc_sock_create(gnrc_sock_reg_t *reg, gnrc_nettype_t type, uint32_t demux_ctx)
 {
     mbox_init(&reg->mbox, reg->mbox_queue, SOCK_MBOX_SIZE);
+#ifdef SOCK_HAS_ASYNC
+    /* the callback puts into the mbox like the mbox entry and notifies */
+    reg->netreg_cb.cb = _netapi_cb;
+    reg->netreg_cb.ctx = reg;
+    gnrc_netreg_entry_init_cb(&reg->entry, demux_ctx, &reg->netreg_cb);
+#else
     gnrc_netreg_entry_init_mbox(&reg->entry, demux_ctx, &reg->mbox);
+#endif
     gnrc_netreg_register(type, &reg->entry);
 }
 
@@ -78,7 +102,9 @@ ssize_t gnrc_sock_recv(gnrc_sock_reg_t *reg, gnrc_pktsnip_t **pkt_out,
         }
     }
 #ifdef MODULE_XTIMER
-    xtimer_remove(&timeout_timer);
+    if ((timeout != SOCK_NO_TIMEOUT) && (timeout != 0)) {
+        xtimer_remove(&timeout_timer);
+    }
 #endif
     switch (msg.type) {
         case GNRC_NETAPI_MSG_TYPE_RCV:
@@ -31,27 +31,64 @@
 #include "net/gnrc/netreg.h"
 #include "net/sock/ip.h"
 #include "net/sock/udp.h"
+#ifdef MODULE_GNRC_SOCK_ASYNC
+#include "net/sock/async/types.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#if defined(MODULE_GNRC_SOCK_ASYNC) || defined(DOXYGEN)
+/**
+ * @brief   The stack supports @ref net_sock_async
+ */
+#define SOCK_HAS_ASYNC
+#endif
+
 #ifndef SOCK_MBOX_SIZE
 #define SOCK_MBOX_SIZE      (8)         /**< Size for gnrc_sock_reg_t::mbox_queue */
 #endif
 
+typedef struct gnrc_sock_reg gnrc_sock_reg_t;
+
+#if defined(SOCK_HAS_ASYNC) || defined(DOXYGEN)
+/**
+ * @brief   Event callback for gnrc_sock_reg_t
+ * @internal
+ */
+typedef void (*gnrc_sock_reg_cb_t)(gnrc_sock_reg_t *sock,
+                                   sock_async_flags_t flags, void *arg);
+#endif
+
 /**
  * @brief   sock @ref net_gnrc_netreg info
  * @internal
  */
-typedef struct gnrc_sock_reg {
+struct gnrc_sock_reg {
 #ifdef MODULE_GNRC_SOCK_CHECK_REUSE
     struct gnrc_sock_reg *next;         /**< list-like for internal storage */
 #endif
     gnrc_netreg_entry_t entry;          /**< @ref net_gnrc_netreg entry for mbox */
     mbox_t mbox;                        /**< @ref core_mbox target for the sock */
     msg_t mbox_queue[SOCK_MBOX_SIZE];   /**< queue for gnrc_sock_reg_t::mbox */
-} gnrc_sock_reg_t;
+#if defined(SOCK_HAS_ASYNC) || defined(DOXYGEN)
+    /**
+     * @brief   @ref net_gnrc_netreg callback putting packets into
+     *          gnrc_sock_reg_t::mbox
+     */
+    gnrc_netreg_entry_cbd_t netreg_cb;
+    /**
+     * @brief   Event callback of the sock
+     */
+    union {
+        gnrc_sock_reg_cb_t generic;     /**< for gnrc_sock.c */
+        sock_ip_cb_t ip;                /**< for raw IP socks */
+        sock_udp_cb_t udp;              /**< for UDP socks */
+    } async_cb;
+    void *async_cb_arg;                 /**< argument of the event callback */
+#endif
+};
 
 /**
  * @brief   Raw IP sock type
@@ -22,6 +22,7 @@
 #include "net/af.h"
 #include "net/protnum.h"
 #include "net/gnrc/ipv6.h"
+#include "net/sock/async.h"
 #include "net/sock/ip.h"
 #include "random.h"
 
@@ -37,6 +38,9 @@ int sock_ip_create(sock_ip_t *sock, const sock_ip_ep_t *local,
         (local->netif != remote->netif)) {
         return -EINVAL;
     }
+#ifdef SOCK_HAS_ASYNC
+    sock->reg.async_cb.generic = NULL;
+#endif
     memset(&sock->local, 0, sizeof(sock_ip_ep_t));
     if (local != NULL) {
         if (gnrc_af_not_supported(local->family)) {
@@ -195,7 +199,21 @@ ssize_t sock_ip_send(sock_ip_t *sock, const void *data, size_t len,
     if (res <= 0) {
         return res;
     }
+#ifdef SOCK_HAS_ASYNC
+    if ((sock != NULL) && (sock->reg.async_cb.generic != NULL)) {
+        sock->reg.async_cb.ip(sock, SOCK_ASYNC_MSG_SENT,
+                              sock->reg.async_cb_arg);
+    }
+#endif
     return res;
 }
 
+#ifdef SOCK_HAS_ASYNC
+void sock_ip_set_cb(sock_ip_t *sock, sock_ip_cb_t cb, void *arg)
+{
+    sock->reg.async_cb.ip = cb;
+    sock->reg.async_cb_arg = arg;
+}
+#endif
+
 /** @} */
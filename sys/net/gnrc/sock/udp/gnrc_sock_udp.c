@@ -19,10 +19,12 @@
 #include <string.h>
 
 #include "byteorder.h"
+#include "mutex.h"
 #include "net/af.h"
 #include "net/protnum.h"
 #include "net/gnrc/ipv6.h"
 #include "net/gnrc/udp.h"
+#include "net/sock/async.h"
 #include "net/sock/udp.h"
 #include "net/udp.h"
 
@@ -95,6 +97,9 @@ int sock_udp_create(sock_udp_t *sock, const sock_udp_ep_t *local,
         (local->netif != remote->netif)) {
         return -EINVAL;
     }
+#ifdef SOCK_HAS_ASYNC
+    sock->reg.async_cb.generic = NULL;
+#endif
     memset(&sock->local, 0, sizeof(sock_udp_ep_t));
     if (local != NULL) {
         uint16_t port = local->port;
@@ -220,38 +225,43 @@ ssize_t sock_udp_recv(sock_udp_t *sock, void *data, size_t max_len,
     return res;
 }
 
-ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
-                      const sock_udp_ep_t *remote)
+/**
+ * @brief   Sends @p payload to @p remote, releasing it on error
+ */
+static ssize_t _send(sock_udp_t *sock, gnrc_pktsnip_t *payload,
+                     const sock_udp_ep_t *remote)
 {
     int res;
-    gnrc_pktsnip_t *payload, *pkt;
+    gnrc_pktsnip_t *pkt;
     uint16_t src_port = 0, dst_port;
     sock_ip_ep_t local;
     sock_udp_ep_t remote_cpy;
     sock_ip_ep_t *rem;
 
-    assert((sock != NULL) || (remote != NULL));
-    assert((len == 0) || (data != NULL)); /* (len != 0) => (data != NULL) */
-
     if (remote != NULL) {
         if (remote->port == 0) {
-            return -EINVAL;
+            res = -EINVAL;
+            goto error;
         }
         else if (gnrc_ep_addr_any((const sock_ip_ep_t *)remote)) {
-            return -EINVAL;
+            res = -EINVAL;
+            goto error;
         }
         else if (gnrc_af_not_supported(remote->family)) {
-            return -EAFNOSUPPORT;
+            res = -EAFNOSUPPORT;
+            goto error;
         }
         else if ((sock != NULL) &&
                  (sock->local.netif != SOCK_ADDR_ANY_NETIF) &&
                  (remote->netif != SOCK_ADDR_ANY_NETIF) &&
                  (sock->local.netif != remote->netif)) {
-            return -EINVAL;
+            res = -EINVAL;
+            goto error;
         }
     }
     else if (sock->remote.family == AF_UNSPEC) {
-        return -ENOTCONN;
+        res = -ENOTCONN;
+        goto error;
     }
     /* cppcheck-suppress nullPointerRedundantCheck
      * (reason: compiler evaluates lazily so this isn't a redundundant check and
@@ -260,7 +270,8 @@ ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
         /* no sock or sock currently unbound */
         memset(&local, 0, sizeof(local));
         if ((src_port = _get_dyn_port(sock)) == GNRC_SOCK_DYN_PORTRANGE_ERR) {
-            return -EADDRINUSE;
+            res = -EADDRINUSE;
+            goto error;
         }
         /* cppcheck-suppress nullPointer
          * (reason: sock *can* be NULL at this place, cppcheck is weird here as
@@ -301,23 +312,131 @@ ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
         local.family = rem->family;
     }
     else if (local.family != rem->family) {
-        return -EINVAL;
-    }
-    /* generate payload and header snips */
-    payload = gnrc_pktbuf_add(NULL, (void *)data, len, GNRC_NETTYPE_UNDEF);
-    if (payload == NULL) {
-        return -ENOMEM;
+        res = -EINVAL;
+        goto error;
     }
+    /* generate header snip */
     pkt = gnrc_udp_hdr_build(payload, src_port, dst_port);
     if (pkt == NULL) {
-        gnrc_pktbuf_release(payload);
-        return -ENOMEM;
+        res = -ENOMEM;
+        goto error;
     }
     res = gnrc_sock_send(pkt, &local, rem, PROTNUM_UDP);
     if (res > 0) {
         res -= sizeof(udp_hdr_t);
+#ifdef SOCK_HAS_ASYNC
+        if ((sock != NULL) && (sock->reg.async_cb.generic != NULL)) {
+            sock->reg.async_cb.udp(sock, SOCK_ASYNC_MSG_SENT,
+                                  sock->reg.async_cb_arg);
+        }
+#endif
     }
     return res;
+error:
+    gnrc_pktbuf_release(payload);
+    return res;
+}
+
+ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
+                      const sock_udp_ep_t *remote)
+{
+    gnrc_pktsnip_t *payload;
+
+    assert((sock != NULL) || (remote != NULL));
+    assert((len == 0) || (data != NULL)); /* (len != 0) => (data != NULL) */
+
+    /* generate payload snip */
+    payload = gnrc_pktbuf_add(NULL, (void *)data, len, GNRC_NETTYPE_UNDEF);
+    if (payload == NULL) {
+        return -ENOMEM;
+    }
+    return _send(sock, payload, remote);
 }
 
+#ifdef MODULE_GNRC_PKTBUF_EXT
+/**
+ * @brief   Context of a zero-copy sock_udp_sendv() call
+ */
+typedef struct {
+    mutex_t done;       /**< unlocked when all external snips are released */
+    unsigned pending;   /**< number of unreleased external snips */
+} _sendv_ctx_t;
+
+static void _sendv_released(void *arg)
+{
+    _sendv_ctx_t *ctx = arg;
+
+    /* external snips are only released with the packet buffer locked, so
+     * this is serialized */
+    if (--ctx->pending == 0) {
+        mutex_unlock(&ctx->done);
+    }
+}
+#endif
+
+ssize_t sock_udp_sendv(sock_udp_t *sock, const iolist_t *snips,
+                       const sock_udp_ep_t *remote)
+{
+    gnrc_pktsnip_t *payload = NULL, **tail = &payload;
+    ssize_t res;
+#ifdef MODULE_GNRC_PKTBUF_EXT
+    _sendv_ctx_t ctx = { .done = MUTEX_INIT_LOCKED, .pending = 0 };
+    unsigned ext = 0;
+#endif
+
+    assert((sock != NULL) || (remote != NULL));
+
+    /* build payload in iolist order */
+    for (const iolist_t *iol = snips; iol != NULL; iol = iol->iol_next) {
+        gnrc_pktsnip_t *snip = NULL;
+
+        if (iol->iol_len == 0) {
+            continue;
+        }
+#ifdef MODULE_GNRC_PKTBUF_EXT
+        /* reference caller memory; copy if all external snips are in use */
+        snip = gnrc_pktbuf_add_ext(NULL, iol->iol_base, iol->iol_len,
+                                   GNRC_NETTYPE_UNDEF, _sendv_released, &ctx);
+        if (snip != NULL) {
+            ctx.pending++;
+            ext++;
+        }
+#endif
+        if (snip == NULL) {
+            snip = gnrc_pktbuf_add(NULL, iol->iol_base, iol->iol_len,
+                                   GNRC_NETTYPE_UNDEF);
+        }
+        if (snip == NULL) {
+            gnrc_pktbuf_release(payload);
+            res = -ENOMEM;
+            goto out;
+        }
+        *tail = snip;
+        tail = &snip->next;
+    }
+    if (payload == NULL) {
+        payload = gnrc_pktbuf_add(NULL, NULL, 0, GNRC_NETTYPE_UNDEF);
+        if (payload == NULL) {
+            return -ENOMEM;
+        }
+    }
+    res = _send(sock, payload, remote);
+out:
+#ifdef MODULE_GNRC_PKTBUF_EXT
+    /* caller memory may only be reused after the stack released it */
+    if (ext > 0) {
+        mutex_lock(&ctx.done);
+    }
+#endif
+    return res;
+}
+
+#ifdef SOCK_HAS_ASYNC
+void sock_udp_set_cb(sock_udp_t *sock, sock_udp_cb_t cb, void *arg)
+{
+    sock->reg.async_cb.udp = cb;
+    sock->reg.async_cb_arg = arg;
+}
+#endif
+
 /** @} */
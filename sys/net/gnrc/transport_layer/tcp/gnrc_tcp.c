@@ -30,6 +30,7 @@
 #include "internal/option.h"
 #include "internal/eventloop.h"
 #include "internal/rcvbuf.h"
+#include "internal/tcb_table.h"
 
 #ifdef MODULE_GNRC_IPV6
 #include "net/gnrc/ipv6.h"
@@ -53,12 +54,7 @@ static char _stack[TCP_EVENTLOOP_STACK_SIZE];
 kernel_pid_t gnrc_tcp_pid = KERNEL_PID_UNDEF;
 
 /**
- * @brief Head of liked TCB list.
- */
-gnrc_tcp_tcb_t *_list_tcb_head;
-
-/**
- * @brief Mutex for TCB list synchronization.
+ * @brief Mutex for TCB table synchronization.
  */
 mutex_t _list_tcb_lock;
 
@@ -98,6 +94,22 @@ static void _setup_timeout(xtimer_t *timer, const uint32_t duration, const xtime
     xtimer_set(timer, duration);
 }
 
+#if GNRC_TCP_TCB_POOL_SIZE
+/**
+ * @brief Returns the TCB of an accepted connection to the pool.
+ *
+ * @param[in,out] tcb   TCB that was closed by the user.
+ */
+static void _release_pooled(gnrc_tcp_tcb_t *tcb)
+{
+    if (tcb->status & STATUS_POOLED) {
+        mutex_lock(&_list_tcb_lock);
+        _tcb_table_pool_release(tcb);
+        mutex_unlock(&_list_tcb_lock);
+    }
+}
+#endif
+
 /**
  * @brief   Establishes a new TCP connection
  *
@@ -255,11 +267,11 @@ int gnrc_tcp_init(void)
         return -1;
     }
 
-    /* Initialize mutex for TCB list synchronization */
+    /* Initialize mutex for TCB table synchronization */
     mutex_init(&(_list_tcb_lock));
 
-    /* Initialize TCB list */
-    _list_tcb_head = NULL;
+    /* Initialize TCB table */
+    _tcb_table_init();
     _rcvbuf_init();
 
     /* Start TCP processing thread */
@@ -375,8 +387,9 @@ ssize_t gnrc_tcp_send(gnrc_tcp_tcb_t *tcb, const void *data, const size_t len,
         _setup_timeout(&user_timeout, timeout_duration_us, _cb_mbox_put_msg, &user_timeout_arg);
     }
 
-    /* Loop until something was sent and acked */
-    while (ret == 0 || tcb->pkt_retransmit != NULL) {
+    /* Loop until data was queued for transmission or an error occurred. Queued data is
+     * retransmitted until it is acked, the call doesn't wait for the acknowledgment. */
+    while (ret == 0) {
         /* Check if the connections state is closed. If so, a reset was received */
         if (tcb->state == FSM_STATE_CLOSED) {
             ret = -ECONNRESET;
@@ -398,6 +411,11 @@ ssize_t gnrc_tcp_send(gnrc_tcp_tcb_t *tcb, const void *data, const size_t len,
         /* Try to send data in case there nothing has been sent and we are not probing */
         if (ret == 0 && !probing_mode) {
             ret = _fsm(tcb, FSM_EVENT_CALL_SEND, NULL, (void *) data, len);
+
+            /* Data was queued for transmission, it is retransmitted until acknowledged */
+            if (ret > 0) {
+                break;
+            }
         }
 
         /* Wait for responses */
@@ -411,7 +429,6 @@ ssize_t gnrc_tcp_send(gnrc_tcp_tcb_t *tcb, const void *data, const size_t len,
 
             case MSG_TYPE_USER_SPEC_TIMEOUT:
                 DEBUG("gnrc_tcp.c : gnrc_tcp_send() : USER_SPEC_TIMEOUT\n");
-                _fsm(tcb, FSM_EVENT_CLEAR_RETRANSMIT, NULL, NULL, 0);
                 ret = -ETIMEDOUT;
                 break;
 
@@ -528,7 +545,6 @@ ssize_t gnrc_tcp_recv(gnrc_tcp_tcb_t *tcb, void *data, const size_t max_len,
 
                 case MSG_TYPE_USER_SPEC_TIMEOUT:
                     DEBUG("gnrc_tcp.c : gnrc_tcp_recv() : USER_SPEC_TIMEOUT\n");
-                    _fsm(tcb, FSM_EVENT_CLEAR_RETRANSMIT, NULL, NULL, 0);
                     ret = -ETIMEDOUT;
                     break;
 
@@ -564,6 +580,9 @@ void gnrc_tcp_close(gnrc_tcp_tcb_t *tcb)
     /* Return if connection is closed */
     if (tcb->state == FSM_STATE_CLOSED) {
         mutex_unlock(&(tcb->function_lock));
+#if GNRC_TCP_TCB_POOL_SIZE
+        _release_pooled(tcb);
+#endif
         return;
     }
 
@@ -578,8 +597,9 @@ void gnrc_tcp_close(gnrc_tcp_tcb_t *tcb)
     _setup_timeout(&connection_timeout, GNRC_TCP_CONNECTION_TIMEOUT_DURATION,
                    _cb_mbox_put_msg, &connection_timeout_arg);
 
-    /* Start connection teardown sequence */
-    _fsm(tcb, FSM_EVENT_CALL_CLOSE, NULL, NULL, 0);
+    /* Start connection teardown sequence. If the retransmit queue is still full of
+     * unacknowledged data, the FIN is sent as soon as an ACK freed a slot. */
+    bool fin_queued = (_fsm(tcb, FSM_EVENT_CALL_CLOSE, NULL, NULL, 0) != -ENOMEM);
 
     /* Loop until the connection has been closed */
     while (tcb->state != FSM_STATE_CLOSED) {
@@ -592,6 +612,9 @@ void gnrc_tcp_close(gnrc_tcp_tcb_t *tcb)
 
             case MSG_TYPE_NOTIFY_USER:
                 DEBUG("gnrc_tcp.c : gnrc_tcp_close() : NOTIFY_USER\n");
+                if (!fin_queued && tcb->state != FSM_STATE_CLOSED) {
+                    fin_queued = (_fsm(tcb, FSM_EVENT_CALL_CLOSE, NULL, NULL, 0) != -ENOMEM);
+                }
                 break;
 
             default:
@@ -603,6 +626,9 @@ void gnrc_tcp_close(gnrc_tcp_tcb_t *tcb)
     xtimer_remove(&connection_timeout);
     tcb->status &= ~STATUS_WAIT_FOR_MSG;
     mutex_unlock(&(tcb->function_lock));
+#if GNRC_TCP_TCB_POOL_SIZE
+    _release_pooled(tcb);
+#endif
 }
 
 void gnrc_tcp_abort(gnrc_tcp_tcb_t *tcb)
@@ -616,8 +642,140 @@ void gnrc_tcp_abort(gnrc_tcp_tcb_t *tcb)
         _fsm(tcb, FSM_EVENT_CALL_ABORT, NULL, NULL, 0);
     }
     mutex_unlock(&(tcb->function_lock));
+#if GNRC_TCP_TCB_POOL_SIZE
+    _release_pooled(tcb);
+#endif
+}
+
+#if GNRC_TCP_TCB_POOL_SIZE
+int gnrc_tcp_listen(gnrc_tcp_listener_t *listener, uint8_t address_family,
+                    const char *local_addr, uint16_t local_port, uint8_t backlog)
+{
+    assert(listener != NULL);
+    assert(local_port != PORT_UNSPEC);
+    assert(backlog > 0);
+
+    int ret = 0;
+
+    memset(listener, 0, sizeof(gnrc_tcp_listener_t));
+#ifdef MODULE_GNRC_IPV6
+    listener->address_family = AF_INET6;
+
+    /* Check AF-Family support and parse local address if it was supplied */
+    if (local_addr != NULL) {
+        if (address_family != AF_INET6) {
+            return -EAFNOSUPPORT;
+        }
+        if (ipv6_addr_from_str((ipv6_addr_t *) listener->local_addr, local_addr) == NULL) {
+            DEBUG("gnrc_tcp.c : gnrc_tcp_listen() : Invalid local addr\n");
+            return -EINVAL;
+        }
+    }
+#else
+    (void) address_family;
+    (void) local_addr;
+    return -EAFNOSUPPORT;
+#endif
+    listener->local_port = local_port;
+    listener->backlog = backlog;
+    mbox_init(&(listener->mbox), listener->mbox_raw, GNRC_TCP_LISTENER_MBOX_SIZE);
+    mutex_init(&(listener->function_lock));
+
+    mutex_lock(&_list_tcb_lock);
+    ret = _tcb_table_listener_add(listener);
+    mutex_unlock(&_list_tcb_lock);
+    return ret;
 }
 
+int gnrc_tcp_accept(gnrc_tcp_listener_t *listener, gnrc_tcp_tcb_t **tcb,
+                    const uint32_t user_timeout_duration_us)
+{
+    assert(listener != NULL);
+    assert(tcb != NULL);
+
+    msg_t msg;
+    xtimer_t user_timeout;
+    cb_arg_t user_timeout_arg = {MSG_TYPE_USER_SPEC_TIMEOUT, &(listener->mbox)};
+    int ret = 0;
+
+    /* Lock the listener for this function call */
+    mutex_lock(&(listener->function_lock));
+
+    /* 'Flush' mbox */
+    while (mbox_try_get(&(listener->mbox), &msg) != 0) {
+    }
+
+    /* Setup user specified timeout if timeout_us is greater than zero */
+    if (user_timeout_duration_us > 0) {
+        _setup_timeout(&user_timeout, user_timeout_duration_us, _cb_mbox_put_msg,
+                       &user_timeout_arg);
+    }
+
+    /* Loop until an established connection was taken over */
+    while (1) {
+        mutex_lock(&_list_tcb_lock);
+        *tcb = _tcb_table_pool_accept(listener);
+        mutex_unlock(&_list_tcb_lock);
+        if (*tcb != NULL) {
+            break;
+        }
+
+        /* Return immediately if this call is non-blocking */
+        if (user_timeout_duration_us == 0) {
+            ret = -EAGAIN;
+            break;
+        }
+
+        /* Wait for the next established connection or until the timeout fires */
+        mbox_get(&(listener->mbox), &msg);
+        if (msg.type == MSG_TYPE_USER_SPEC_TIMEOUT) {
+            DEBUG("gnrc_tcp.c : gnrc_tcp_accept() : USER_SPEC_TIMEOUT\n");
+            ret = -ETIMEDOUT;
+            break;
+        }
+    }
+
+    /* Cleanup */
+    if (user_timeout_duration_us > 0) {
+        xtimer_remove(&user_timeout);
+    }
+    mutex_unlock(&(listener->function_lock));
+    return ret;
+}
+
+void gnrc_tcp_stop_listen(gnrc_tcp_listener_t *listener)
+{
+    assert(listener != NULL);
+
+    gnrc_tcp_tcb_t *tcb = NULL;
+
+    /* Lock the listener for this function call */
+    mutex_lock(&(listener->function_lock));
+
+    /* Stop spawning new connections */
+    mutex_lock(&_list_tcb_lock);
+    _tcb_table_listener_remove(listener);
+    mutex_unlock(&_list_tcb_lock);
+
+    /* Abort connections that were not accepted, their TCBs return to the pool */
+    while (1) {
+        mutex_lock(&_list_tcb_lock);
+        tcb = _tcb_table_pool_find_pending(listener);
+        if (tcb == NULL) {
+            /* The listener may be gone after return: The FSM drops the connections
+             * still in LISTEN once they lost it */
+            _tcb_table_pool_detach(listener);
+        }
+        mutex_unlock(&_list_tcb_lock);
+        if (tcb == NULL) {
+            break;
+        }
+        _fsm(tcb, FSM_EVENT_CALL_ABORT, NULL, NULL, 0);
+    }
+    mutex_unlock(&(listener->function_lock));
+}
+#endif
+
 int gnrc_tcp_calc_csum(const gnrc_pktsnip_t *hdr, const gnrc_pktsnip_t *pseudo_hdr)
 {
     uint16_t csum;
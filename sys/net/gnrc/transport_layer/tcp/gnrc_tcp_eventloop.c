@@ -25,6 +25,7 @@
 #include "internal/common.h"
 #include "internal/pkt.h"
 #include "internal/fsm.h"
+#include "internal/tcb_table.h"
 #include "internal/eventloop.h"
 
 #ifdef MODULE_GNRC_IPV6
@@ -95,6 +96,7 @@ static int _send(gnrc_pktsnip_t *pkt)
  *            -ENOMSG if paket couldn't be marked.
  *            -EINVAL if checksum was invalid.
  *            -ENOTCONN if no TCB is interested in @p pkt.
+ *            -ENOMEM if a listener could not take a new connection.
  */
 static int _receive(gnrc_pktsnip_t *pkt)
 {
@@ -180,39 +182,37 @@ static int _receive(gnrc_pktsnip_t *pkt)
 
     /* Find TCB to for this packet */
     mutex_lock(&_list_tcb_lock);
-    tcb = _list_tcb_head;
-    while (tcb) {
 #ifdef MODULE_GNRC_IPV6
-        /* Check if current TCB is fitting for the incomming packet */
-        if (ip->type == GNRC_NETTYPE_IPV6 && tcb->address_family == AF_INET6) {
-            /* If SYN is set, a connection is listening on that port ... */
-            ipv6_addr_t *tmp_addr = NULL;
-            if (syn && tcb->local_port == dst && tcb->state == FSM_STATE_LISTEN) {
-                /* ... and local addr is unspec or pre configured */
-                tmp_addr = &((ipv6_hdr_t *)ip->data)->dst;
-                if (ipv6_addr_equal((ipv6_addr_t *) tcb->local_addr, (ipv6_addr_t *) tmp_addr) ||
-                    ipv6_addr_is_unspecified((ipv6_addr_t *) tcb->local_addr)) {
-                    break;
-                }
-            }
+    if (ip->type == GNRC_NETTYPE_IPV6) {
+        uint8_t *src_addr = (uint8_t *) &((ipv6_hdr_t *)ip->data)->src;
+        uint8_t *dst_addr = (uint8_t *) &((ipv6_hdr_t *)ip->data)->dst;
+
+        /* Look up the connection by ports and peer address ... */
+        tcb = _tcb_table_find(dst, src, src_addr);
 
-            /* If SYN is not set and the ports match ... */
-            if (!syn && tcb->local_port == dst && tcb->peer_port == src) {
-                /* .. and the IPv6 addresses match */
-                tmp_addr = &((ipv6_hdr_t * )ip->data)->src;
-                if (ipv6_addr_equal((ipv6_addr_t *) tcb->peer_addr, (ipv6_addr_t *) tmp_addr)) {
-                    break;
-                }
+        /* ... if SYN is set and there is none, a connection is listening on that port ... */
+        if ((tcb == NULL) && syn) {
+            tcb = _tcb_table_find_listen(dst, dst_addr);
+        }
+#if GNRC_TCP_TCB_POOL_SIZE
+        /* ... or a listener spawns a new connection */
+        if ((tcb == NULL) && syn) {
+            if (_tcb_table_pool_alloc(&tcb, dst, dst_addr) == -ENOMEM) {
+                /* Don't reset, the peer retries once the backlog has room again */
+                mutex_unlock(&_list_tcb_lock);
+                DEBUG("gnrc_tcp_eventloop.c : _receive() : Listener can't take connection\n");
+                gnrc_pktbuf_release(pkt);
+                return -ENOMEM;
             }
         }
-#else
-        /* Supress compiler warnings if TCP is build without network layer */
-        (void) syn;
-        (void) src;
-        (void) dst;
 #endif
-        tcb = tcb->next;
     }
+#else
+    /* Supress compiler warnings if TCP is build without network layer */
+    (void) syn;
+    (void) src;
+    (void) dst;
+#endif
     mutex_unlock(&_list_tcb_lock);
 
     /* Call FSM with event RCVD_PKT if a fitting TCB was found */
@@ -17,15 +17,18 @@
  * @}
  */
 
+#include <string.h>
 #include <utlist.h>
 #include <errno.h>
 #include "random.h"
+#include "kernel_defines.h"
 #include "net/af.h"
 #include "net/gnrc.h"
 #include "internal/common.h"
 #include "internal/pkt.h"
 #include "internal/option.h"
 #include "internal/rcvbuf.h"
+#include "internal/tcb_table.h"
 #include "internal/fsm.h"
 
 #ifdef MODULE_GNRC_IPV6
@@ -35,31 +38,11 @@
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
-/**
- * @brief Helper macro for LL_SEARCH to compare TCBs
- */
-#define TCB_EQUAL(a,b)      ((a) != (b))
-
-/**
- * @brief Checks if a given port number is currently used by a TCB as local_port.
- *
- * @note Must be called from a context where the TCB list is locked.
- *
- * @param[in] port_number   Port number that should be checked.
- *
- * @returns   Zero if @p port_number is currently not used.
- *            1 if @p port_number is used by an active connection.
- */
-static int _is_local_port_in_use(const uint16_t port_number)
-{
-    gnrc_tcp_tcb_t *iter = NULL;
-    LL_SEARCH_SCALAR(_list_tcb_head, iter, local_port, port_number);
-    return (iter != NULL);
-}
-
 /**
  * @brief Generate random unused local port above the well-known ports (> 1024).
  *
+ * @note Must be called from a context where the TCB table is locked.
+ *
  * @returns   Generated port number.
  */
 static uint16_t _get_random_local_port(void)
@@ -70,7 +53,7 @@ static uint16_t _get_random_local_port(void)
         if (ret < 1024) {
             continue;
         }
-    } while(_is_local_port_in_use(ret));
+    } while(_tcb_table_port_in_use(ret));
     return ret;
 }
 
@@ -83,14 +66,129 @@ static uint16_t _get_random_local_port(void)
  */
 static int _clear_retransmit(gnrc_tcp_tcb_t *tcb)
 {
-    if (tcb->pkt_retransmit != NULL) {
-        gnrc_pktbuf_release(tcb->pkt_retransmit);
+    if (tcb->rtx_len > 0) {
+        for (uint8_t i = 0; i < tcb->rtx_len; ++i) {
+            gnrc_pktbuf_release(tcb->rtx[i].pkt);
+        }
         xtimer_remove(&(tcb->tim_tout));
-        tcb->pkt_retransmit = NULL;
+        tcb->rtx_len = 0;
     }
+    tcb->status &= ~STATUS_RTT_PENDING;
     return 0;
 }
 
+/**
+ * @brief Copies payload into the receive buffer.
+ *
+ * @param[in,out] tcb    TCB holding the receive buffer.
+ * @param[in]     snp    First payload snip of a segment.
+ * @param[in]     skip   Number of leading payload bytes that were already received.
+ *
+ * @return   Number of bytes copied into the receive buffer.
+ */
+static uint32_t _rcv_payload(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *snp, uint32_t skip)
+{
+    uint32_t added = 0;
+
+    while (snp && snp->type == GNRC_NETTYPE_UNDEF) {
+        if (skip < snp->size) {
+            size_t len = snp->size - skip;
+            size_t num = ringbuffer_add(&(tcb->rcv_buf), (char *) snp->data + skip, len);
+
+            added += num;
+            skip = 0;
+
+            /* Receive buffer is full */
+            if (num < len) {
+                break;
+            }
+        }
+        else {
+            skip -= snp->size;
+        }
+        snp = snp->next;
+    }
+    return added;
+}
+
+#if GNRC_TCP_SACK_BLOCKS
+/**
+ * @brief Holds an out-of-order received segment until the gap before it is filled.
+ *
+ * @param[in,out] tcb       TCB holding the out-of-order queue.
+ * @param[in]     pkt       Received packet.
+ * @param[in]     seg_seq   Sequence number of the segment.
+ * @param[in]     pay_len   Payload length of the segment.
+ */
+static void _ooo_insert(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *pkt, uint32_t seg_seq,
+                        uint32_t pay_len)
+{
+    uint8_t pos = 0;
+
+    /* Queue is ordered by sequence number, ignore segments that are already held */
+    while (pos < tcb->ooo_len && LEQ_32_BIT(tcb->ooo[pos].seq, seg_seq)) {
+        if (tcb->ooo[pos].seq == seg_seq && tcb->ooo[pos].len >= pay_len) {
+            return;
+        }
+        pos += 1;
+    }
+
+    /* Queue is full: Drop the segment most far away from rcv_nxt */
+    if (tcb->ooo_len == GNRC_TCP_SACK_BLOCKS) {
+        if (pos == GNRC_TCP_SACK_BLOCKS) {
+            return;
+        }
+        tcb->ooo_len -= 1;
+        gnrc_pktbuf_release(tcb->ooo[tcb->ooo_len].pkt);
+    }
+
+    memmove(tcb->ooo + pos + 1, tcb->ooo + pos, (tcb->ooo_len - pos) * sizeof(tcb->ooo[0]));
+    tcb->ooo[pos].pkt = pkt;
+    tcb->ooo[pos].seq = seg_seq;
+    tcb->ooo[pos].len = pay_len;
+    tcb->ooo_len += 1;
+    gnrc_pktbuf_hold(pkt, 1);
+}
+
+/**
+ * @brief Moves held segments that became in-order into the receive buffer.
+ *
+ * @param[in,out] tcb   TCB holding the out-of-order queue.
+ */
+static void _ooo_drain(gnrc_tcp_tcb_t *tcb)
+{
+    uint8_t done = 0;
+
+    while (done < tcb->ooo_len && LEQ_32_BIT(tcb->ooo[done].seq, tcb->rcv_nxt)) {
+        gnrc_tcp_seg_t *seg = &tcb->ooo[done];
+
+        if (LSS_32_BIT(tcb->rcv_nxt, seg->seq + seg->len)) {
+            gnrc_pktsnip_t *snp = NULL;
+
+            LL_SEARCH_SCALAR(seg->pkt, snp, type, GNRC_NETTYPE_UNDEF);
+            tcb->rcv_nxt += _rcv_payload(tcb, snp, tcb->rcv_nxt - seg->seq);
+        }
+        gnrc_pktbuf_release(seg->pkt);
+        done += 1;
+    }
+    tcb->ooo_len -= done;
+    memmove(tcb->ooo, tcb->ooo + done, tcb->ooo_len * sizeof(tcb->ooo[0]));
+}
+
+/**
+ * @brief Releases all held out-of-order segments.
+ *
+ * @param[in,out] tcb   TCB holding the out-of-order queue.
+ */
+static void _ooo_clear(gnrc_tcp_tcb_t *tcb)
+{
+    for (uint8_t i = 0; i < tcb->ooo_len; ++i) {
+        gnrc_pktbuf_release(tcb->ooo[i].pkt);
+    }
+    tcb->ooo_len = 0;
+}
+#endif
+
 /**
  * @brief Restarts timewait timer.
  *
@@ -119,16 +217,18 @@ static int _transition_to(gnrc_tcp_tcb_t *tcb, fsm_state_t state)
 {
     DEBUG("_transition_to: %d\n", state);
 
-    gnrc_tcp_tcb_t *iter = NULL;
-
     switch (state) {
         case FSM_STATE_CLOSED:
             /* Clear retransmit queue */
             _clear_retransmit(tcb);
+#if GNRC_TCP_SACK_BLOCKS
+            /* Drop out-of-order received segments */
+            _ooo_clear(tcb);
+#endif
 
             /* Remove connection from active connections */
             mutex_lock(&_list_tcb_lock);
-            LL_DELETE(_list_tcb_head, tcb);
+            _tcb_table_remove(tcb);
             mutex_unlock(&_list_tcb_lock);
 
             /* Free potencially allocated receive buffer */
@@ -137,6 +237,11 @@ static int _transition_to(gnrc_tcp_tcb_t *tcb, fsm_state_t state)
             break;
 
         case FSM_STATE_LISTEN:
+            /* Remove connection from the table while its address info changes */
+            mutex_lock(&_list_tcb_lock);
+            _tcb_table_remove(tcb);
+            mutex_unlock(&_list_tcb_lock);
+
             /* Clear address info */
 #ifdef MODULE_GNRC_IPV6
             if (tcb->address_family == AF_INET6) {
@@ -153,12 +258,9 @@ static int _transition_to(gnrc_tcp_tcb_t *tcb, fsm_state_t state)
                 return -ENOMEM;
             }
 
-            /* Add connection to active connections (if not already active) */
+            /* Add connection to listening connections */
             mutex_lock(&_list_tcb_lock);
-            LL_SEARCH(_list_tcb_head, iter, tcb, TCB_EQUAL);
-            if (iter == NULL) {
-                LL_PREPEND(_list_tcb_head, tcb);
-            }
+            _tcb_table_add_listen(tcb);
             mutex_unlock(&_list_tcb_lock);
             break;
 
@@ -168,33 +270,47 @@ static int _transition_to(gnrc_tcp_tcb_t *tcb, fsm_state_t state)
                 return -ENOMEM;
             }
 
-            /* Add connection to active connections (if not already active) */
+            /* Add connection to active connections, SYN_SENT is only entered from CLOSED */
             mutex_lock(&_list_tcb_lock);
-            LL_SEARCH(_list_tcb_head, iter, tcb, TCB_EQUAL);
-            /* If connection is not already active: Check port number, append TCB */
-            if (iter == NULL) {
-                /* Check if port number was specified */
-                if (tcb->local_port != PORT_UNSPEC) {
-                    /* Check if given port number is use: return error and release buffer */
-                    if (_is_local_port_in_use(tcb->local_port)) {
-                        mutex_unlock(&_list_tcb_lock);
-                        _rcvbuf_release_buffer(tcb);
-                        return -EADDRINUSE;
-                    }
+            /* Check if port number was specified */
+            if (tcb->local_port != PORT_UNSPEC) {
+                /* Check if given port number is use: return error and release buffer */
+                if (_tcb_table_port_in_use(tcb->local_port)) {
+                    mutex_unlock(&_list_tcb_lock);
+                    _rcvbuf_release_buffer(tcb);
+                    return -EADDRINUSE;
                 }
-                /* Pick random port */
-                else {
-                    tcb->local_port = _get_random_local_port();
-                }
-                LL_PREPEND(_list_tcb_head, tcb);
             }
+            /* Pick random port */
+            else {
+                tcb->local_port = _get_random_local_port();
+            }
+            _tcb_table_add(tcb);
             mutex_unlock(&_list_tcb_lock);
             break;
 
         case FSM_STATE_SYN_RCVD:
+            /* The peer is known now: (Re-)add connection to the hash table */
+            mutex_lock(&_list_tcb_lock);
+            _tcb_table_remove(tcb);
+            _tcb_table_add(tcb);
+            mutex_unlock(&_list_tcb_lock);
+            tcb->status |= STATUS_NOTIFY_USER;
+            break;
+
         case FSM_STATE_ESTABLISHED:
         case FSM_STATE_CLOSE_WAIT:
             tcb->status |= STATUS_NOTIFY_USER;
+#if GNRC_TCP_TCB_POOL_SIZE
+            /* Wake up a thread waiting to accept a connection of the listener */
+            mutex_lock(&_list_tcb_lock);
+            if (tcb->listener != NULL) {
+                msg_t msg;
+                msg.type = MSG_TYPE_NOTIFY_USER;
+                mbox_try_put(&(tcb->listener->mbox), &msg);
+            }
+            mutex_unlock(&_list_tcb_lock);
+#endif
             break;
 
         case FSM_STATE_TIME_WAIT:
@@ -267,24 +383,36 @@ static int _fsm_call_send(gnrc_tcp_tcb_t *tcb, void *buf, size_t len)
 {
     DEBUG("gnrc_tcp_fsm.c : _fsm_call_send()\n");
 
-    size_t payload = (tcb->snd_una + tcb->snd_wnd) - tcb->snd_nxt;
+    size_t sent = 0;
+    uint32_t wnd_end = tcb->snd_una + tcb->snd_wnd;
 
-    /* Check if window is open and all packets were transmitted */
-    if (payload > 0 && tcb->snd_wnd > 0 && tcb->pkt_retransmit == NULL) {
+    /* Send segments as long as the window is open and the retransmit queue can hold them */
+    while (sent < len && LSS_32_BIT(tcb->snd_nxt, wnd_end) &&
+           tcb->rtx_len < GNRC_TCP_RETRANSMIT_QUEUE_SIZE) {
         /* Calculate segment size */
+        size_t payload = wnd_end - tcb->snd_nxt;
         payload = (payload < GNRC_TCP_MSS) ? payload : GNRC_TCP_MSS;
         payload = (payload < tcb->mss) ? payload : tcb->mss;
-        payload = (payload < len) ? payload : len;
+        payload = (payload < len - sent) ? payload : len - sent;
+
+        /* Avoid silly window syndrome: Wait for outstanding ACKs, instead of sending a
+         * small segment into the remains of the window */
+        if (payload == 0 || (payload < len - sent && payload < tcb->mss && tcb->rtx_len > 0)) {
+            break;
+        }
 
-        /* Calculate payload size for this segment */
+        /* Build and send segment */
         gnrc_pktsnip_t *out_pkt = NULL;
         uint16_t seq_con = 0;
-        _pkt_build(tcb, &out_pkt, &seq_con, MSK_ACK | MSK_PSH, tcb->snd_nxt, tcb->rcv_nxt, buf, payload);
+        if (_pkt_build(tcb, &out_pkt, &seq_con, MSK_ACK | MSK_PSH, tcb->snd_nxt, tcb->rcv_nxt,
+                       (uint8_t *) buf + sent, payload) < 0) {
+            break;
+        }
         _pkt_setup_retransmit(tcb, out_pkt, false);
         _pkt_send(tcb, out_pkt, seq_con, false);
-        return payload;
+        sent += payload;
     }
-    return 0;
+    return sent;
 }
 
 /**
@@ -308,7 +436,7 @@ static int _fsm_call_recv(gnrc_tcp_tcb_t *tcb, void *buf, size_t len)
     size_t rcvd = ringbuffer_get(&(tcb->rcv_buf), buf, len);
 
     /* Reopen window if recv buffer can hold a MSS sized payload and FIN was not received. */
-    uint16_t buf_free = ringbuffer_get_free(&tcb->rcv_buf);
+    uint32_t buf_free = ringbuffer_get_free(&tcb->rcv_buf);
 
     if (buf_free >= GNRC_TCP_MSS && tcb->state != FSM_STATE_CLOSE_WAIT) {
         tcb->rcv_wnd = buf_free;
@@ -328,6 +456,7 @@ static int _fsm_call_recv(gnrc_tcp_tcb_t *tcb, void *buf, size_t len)
  * @param[in,out] tcb   TCB holding the connection information.
  *
  * @returns   Zero on success.
+ *            -ENOMEM if the retransmit queue can't hold the FIN yet.
  */
 static int _fsm_call_close(gnrc_tcp_tcb_t *tcb)
 {
@@ -336,10 +465,19 @@ static int _fsm_call_close(gnrc_tcp_tcb_t *tcb)
     if (tcb->state == FSM_STATE_SYN_RCVD || tcb->state == FSM_STATE_ESTABLISHED ||
         tcb->state == FSM_STATE_CLOSE_WAIT) {
 
+        /* The FIN must be retransmitted until it is acknowledged: Wait for queue space */
+        if (tcb->rtx_len >= ARRAY_SIZE(tcb->rtx)) {
+            DEBUG("gnrc_tcp_fsm.c : _fsm_call_close() : Retransmit queue is full\n");
+            return -ENOMEM;
+        }
+
         /* Send FIN packet */
         gnrc_pktsnip_t *out_pkt = NULL;
         uint16_t seq_con = 0;
-        _pkt_build(tcb, &out_pkt, &seq_con, MSK_FIN_ACK, tcb->snd_nxt, tcb->rcv_nxt, NULL, 0);
+        if (_pkt_build(tcb, &out_pkt, &seq_con, MSK_FIN_ACK, tcb->snd_nxt, tcb->rcv_nxt,
+                       NULL, 0) < 0) {
+            return -ENOMEM;
+        }
         _pkt_setup_retransmit(tcb, out_pkt, false);
         _pkt_send(tcb, out_pkt, seq_con, false);
     }
@@ -423,6 +561,11 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
     seg_ack = byteorder_ntohl(tcp_hdr->ack_num);
     seg_wnd = byteorder_ntohs(tcp_hdr->window);
 
+    /* Windows in SYN segments are never scaled (see RFC 7323) */
+    if (!(ctl & MSK_SYN)) {
+        seg_wnd <<= tcb->snd_wnd_shift;
+    }
+
     /* Extract network layer header */
 #ifdef MODULE_GNRC_IPV6
     LL_SEARCH_SCALAR(in_pkt, snp, type, GNRC_NETTYPE_IPV6);
@@ -451,24 +594,20 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
             uint16_t dst = byteorder_ntohs(tcp_hdr->dst_port);
 
             /* Check if SYN request is handled by another connection */
-            lst = _list_tcb_head;
-            while (lst) {
-                /* Compare port numbers and network layer adresses */
-                if (lst->local_port == dst && lst->peer_port == src) {
 #ifdef MODULE_GNRC_IPV6
-                    if (snp->type == GNRC_NETTYPE_IPV6 && lst->address_family == AF_INET6) {
-                        ipv6_addr_t *dst_addr = &((ipv6_hdr_t *)ip)->dst;
-                        ipv6_addr_t *src_addr = &((ipv6_hdr_t *)ip)->src;
-
-                        if (ipv6_addr_equal((ipv6_addr_t *)lst->local_addr, dst_addr) &&
-                            ipv6_addr_equal((ipv6_addr_t *)lst->peer_addr, src_addr)) {
-                            break;
-                        }
-                    }
-#endif
+            if (snp->type == GNRC_NETTYPE_IPV6) {
+                ipv6_addr_t *dst_addr = &((ipv6_hdr_t *)ip)->dst;
+                ipv6_addr_t *src_addr = &((ipv6_hdr_t *)ip)->src;
+
+                /* Compare port numbers and network layer adresses */
+                mutex_lock(&_list_tcb_lock);
+                lst = _tcb_table_find(dst, src, (uint8_t *)src_addr);
+                if (lst && !ipv6_addr_equal((ipv6_addr_t *)lst->local_addr, dst_addr)) {
+                    lst = NULL;
                 }
-                lst = lst->next;
+                mutex_unlock(&_list_tcb_lock);
             }
+#endif
             /* Return if connection is already handled (port and addresses match) */
             if (lst != NULL) {
                 DEBUG("gnrc_tcp_fsm.c : _fsm_rcvd_pkt() : Connection already handled\n");
@@ -635,7 +774,23 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
                 /* Acknowledge previously sent data */
                 if (LSS_32_BIT(tcb->snd_una, seg_ack) && LEQ_32_BIT(seg_ack, tcb->snd_nxt)) {
                     tcb->snd_una = seg_ack;
+                    tcb->dup_acks = 0;
                     _pkt_acknowledge(tcb, seg_ack);
+
+                    /* Signal user that the retransmit queue has room again */
+                    tcb->status |= STATUS_NOTIFY_USER;
+                }
+                /* Duplicate ACK: Retransmit first unacknowledged segment after the third */
+                else if (seg_ack == tcb->snd_una && pay_len == 0 && seg_wnd == tcb->snd_wnd &&
+                         !(ctl & MSK_FIN) && tcb->rtx_len > 0) {
+                    tcb->dup_acks += 1;
+                    if (tcb->dup_acks == DUP_ACK_THRESHOLD) {
+                        gnrc_pktsnip_t *rtx_pkt = _pkt_get_retransmit(tcb);
+
+                        DEBUG("gnrc_tcp_fsm.c : _fsm_rcvd_pkt() : Fast retransmit\n");
+                        gnrc_pktbuf_hold(rtx_pkt, 1);
+                        _pkt_send(tcb, rtx_pkt, 0, true);
+                    }
                 }
                 /* ACK received for something not yet sent: Reply with pure ACK */
                 else if (LSS_32_BIT(tcb->snd_nxt, seg_ack)) {
@@ -659,25 +814,25 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
                 /* Additional processing */
                 /* Check additionaly if previously sent FIN was acknowledged */
                 if (tcb->state == FSM_STATE_FIN_WAIT_1) {
-                    if (tcb->pkt_retransmit == NULL) {
+                    if (tcb->rtx_len == 0) {
                         _transition_to(tcb, FSM_STATE_FIN_WAIT_2);
                     }
                 }
                 /* If retransmission queue is empty, acknowledge close operation */
                 if (tcb->state == FSM_STATE_FIN_WAIT_2) {
-                    if (tcb->pkt_retransmit == NULL) {
+                    if (tcb->rtx_len == 0) {
                         /* Optional: Unblock user close operation */
                     }
                 }
                 /* If our FIN has been acknowledged: Transition to TIME_WAIT */
                 if (tcb->state == FSM_STATE_CLOSING) {
-                    if (tcb->pkt_retransmit == NULL) {
+                    if (tcb->rtx_len == 0) {
                         _transition_to(tcb, FSM_STATE_TIME_WAIT);
                     }
                 }
                 /* If our FIN was acknowledged and status is LAST_ACK: close connection */
                 if (tcb->state == FSM_STATE_LAST_ACK) {
-                    if (tcb->pkt_retransmit == NULL) {
+                    if (tcb->rtx_len == 0) {
                         _transition_to(tcb, FSM_STATE_CLOSED);
                         return 0;
                     }
@@ -695,29 +850,38 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
                 /* Search for begin of payload */
                 LL_SEARCH_SCALAR(in_pkt, snp, type, GNRC_NETTYPE_UNDEF);
 
-                /* Accept only data that is expected, to be received */
-                if (tcb->rcv_nxt == seg_seq) {
+                /* Accept data that is expected, skip the part that was already received */
+                if (LEQ_32_BIT(seg_seq, tcb->rcv_nxt) &&
+                    LSS_32_BIT(tcb->rcv_nxt, seg_seq + pay_len)) {
                     /* Copy contents into receive buffer */
-                    while (snp && snp->type == GNRC_NETTYPE_UNDEF) {
-                        tcb->rcv_nxt += ringbuffer_add(&(tcb->rcv_buf), snp->data, snp->size);
-                        snp = snp->next;
-                    }
+                    tcb->rcv_nxt += _rcv_payload(tcb, snp, tcb->rcv_nxt - seg_seq);
+#if GNRC_TCP_SACK_BLOCKS
+                    /* Append out-of-order received data that became in-order */
+                    _ooo_drain(tcb);
+#endif
                     /* Shrink receive window */
                     tcb->rcv_wnd = ringbuffer_get_free(&(tcb->rcv_buf));
                     /* Notify owner because new data is available */
                     tcb->status |= STATUS_NOTIFY_USER;
                 }
+#if GNRC_TCP_SACK_BLOCKS
+                /* Hold data behind a gap, the peer learns about it by SACK */
+                else if (LSS_32_BIT(tcb->rcv_nxt, seg_seq) && !(ctl & MSK_FIN) &&
+                         (tcb->status & STATUS_SACK)) {
+                    _ooo_insert(tcb, in_pkt, seg_seq, pay_len);
+                }
+#endif
                 /* Send ACK, if FIN processing sends ACK already */
                 /* NOTE: this is the place to add payload piggybagging in the future */
-                if (!(ctl & MSK_FIN)) {
+                if (!(ctl & MSK_FIN) || tcb->rcv_nxt != seg_seq + pay_len) {
                     _pkt_build(tcb, &out_pkt, &seq_con, MSK_ACK, tcb->snd_nxt, tcb->rcv_nxt,
                                NULL, 0);
                     _pkt_send(tcb, out_pkt, seq_con, false);
                 }
             }
         }
-        /* 7) Check FIN */
-        if (ctl & MSK_FIN) {
+        /* 7) Check FIN, it is only processed if all data in front of it was received */
+        if ((ctl & MSK_FIN) && tcb->rcv_nxt == seg_seq + pay_len) {
             if (tcb->state == FSM_STATE_CLOSED || tcb->state == FSM_STATE_LISTEN ||
                 tcb->state == FSM_STATE_SYN_SENT) {
                 return 0;
@@ -731,7 +895,7 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
                 _transition_to(tcb, FSM_STATE_CLOSE_WAIT);
             }
             else if (tcb->state == FSM_STATE_FIN_WAIT_1) {
-                if (tcb->pkt_retransmit == NULL) {
+                if (tcb->rtx_len == 0) {
                     _transition_to(tcb, FSM_STATE_TIME_WAIT);
                 }
                 else {
@@ -773,9 +937,24 @@ static int _fsm_timeout_timewait(gnrc_tcp_tcb_t *tcb)
 static int _fsm_timeout_retransmit(gnrc_tcp_tcb_t *tcb)
 {
     DEBUG("gnrc_tcp_fsm.c : _fsm_timeout_retransmit()\n");
-    if (tcb->pkt_retransmit != NULL) {
-        _pkt_setup_retransmit(tcb, tcb->pkt_retransmit, true);
-        _pkt_send(tcb, tcb->pkt_retransmit, 0, true);
+#if GNRC_TCP_TCB_POOL_SIZE
+    /* Nobody waits for the handshake of a connection spawned by a listener: Give up on it */
+    if ((tcb->listener != NULL) && (tcb->state == FSM_STATE_SYN_RCVD) &&
+        (tcb->retries >= SYN_ACK_MAX_RETRIES)) {
+        DEBUG("gnrc_tcp_fsm.c : _fsm_timeout_retransmit() : SYN+ACK not acknowledged\n");
+        _transition_to(tcb, FSM_STATE_CLOSED);
+        return 0;
+    }
+#endif
+    if (tcb->rtx_len > 0) {
+        /* The peer might have discarded SACKed data: Retransmit the oldest segment */
+        for (uint8_t i = 0; i < tcb->rtx_len; ++i) {
+            tcb->rtx[i].sacked = 0;
+        }
+        gnrc_pktsnip_t *rtx_pkt = tcb->rtx[0].pkt;
+
+        _pkt_setup_retransmit(tcb, rtx_pkt, true);
+        _pkt_send(tcb, rtx_pkt, 0, true);
     }
     else {
         DEBUG("gnrc_tcp_fsm.c : _fsm_timeout_retransmit() : Retransmit queue is empty\n");
@@ -894,6 +1073,20 @@ int _fsm(gnrc_tcp_tcb_t *tcb, fsm_event_t event, gnrc_pktsnip_t *in_pkt, void *b
     /* Lock FSM */
     mutex_lock(&(tcb->fsm_lock));
 
+#if GNRC_TCP_TCB_POOL_SIZE
+    /* Accepted connections are never in LISTEN or SYN_RCVD: The listener of this one
+     * stopped during the handshake. Drop it. */
+    if ((tcb->status & STATUS_POOLED) && (tcb->listener == NULL) &&
+        (tcb->state == FSM_STATE_LISTEN || tcb->state == FSM_STATE_SYN_RCVD)) {
+        _fsm_call_abort(tcb);
+        mutex_unlock(&(tcb->fsm_lock));
+        mutex_lock(&_list_tcb_lock);
+        _tcb_table_pool_release(tcb);
+        mutex_unlock(&_list_tcb_lock);
+        return -ENOTCONN;
+    }
+#endif
+
     /* Call FSM */
     tcb->status &= ~STATUS_NOTIFY_USER;
     int32_t result = _fsm_unprotected(tcb, event, in_pkt, buf, len);
@@ -906,5 +1099,18 @@ int _fsm(gnrc_tcp_tcb_t *tcb, fsm_event_t event, gnrc_pktsnip_t *in_pkt, void *b
     }
     /* Unlock FSM */
     mutex_unlock(&(tcb->fsm_lock));
+
+#if GNRC_TCP_TCB_POOL_SIZE
+    /* Connections of a listener, that were closed or never left LISTEN before they were
+     * accepted, return to the pool. Accepted ones return on gnrc_tcp_close/abort. */
+    if (tcb->listener != NULL) {
+        mutex_lock(&_list_tcb_lock);
+        if ((tcb->listener != NULL) &&
+            (tcb->state == FSM_STATE_CLOSED || tcb->state == FSM_STATE_LISTEN)) {
+            _tcb_table_pool_release(tcb);
+        }
+        mutex_unlock(&_list_tcb_lock);
+    }
+#endif
     return result;
 }
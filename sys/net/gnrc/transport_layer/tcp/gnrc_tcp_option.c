@@ -16,16 +16,27 @@
  * @author      Simon Brummer <simon.brummer@posteo.de>
  * @}
  */
+#include <string.h>
 #include "internal/common.h"
 #include "internal/option.h"
+#include "internal/pkt.h"
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
 int _option_parse(gnrc_tcp_tcb_t *tcb, tcp_hdr_t *hdr)
 {
+    uint16_t ctl = byteorder_ntohs(hdr->off_ctl);
+
+    /* Options negotiated on connection setup are disabled unless the SYN contains them */
+    if (ctl & MSK_SYN) {
+        tcb->status &= ~(STATUS_SACK | STATUS_WINDOW_SCALE);
+        tcb->snd_wnd_shift = 0;
+        tcb->rcv_wnd_shift = 0;
+    }
+
     /* Extract offset value. Return if no options are set */
-    uint8_t offset = GET_OFFSET(byteorder_ntohs(hdr->off_ctl));
+    uint8_t offset = GET_OFFSET(ctl);
     if (offset <= TCP_HDR_OFFSET_MIN) {
         return 0;
     }
@@ -62,6 +73,63 @@ int _option_parse(gnrc_tcp_tcb_t *tcb, tcp_hdr_t *hdr)
                       tcb->mss);
                 break;
 
+            case TCP_OPTION_KIND_WS:
+                if (opt_left < TCP_OPTION_LENGTH_MIN || option->length > opt_left ||
+                    option->length != TCP_OPTION_LENGTH_WS) {
+
+                    DEBUG("gnrc_tcp_option.c : _option_parse() : invalid WS Option length.\n");
+                    return -1;
+                }
+                /* Window scaling is only negotiated on SYN */
+                if (ctl & MSK_SYN) {
+                    tcb->status |= STATUS_WINDOW_SCALE;
+                    tcb->snd_wnd_shift = (option->value[0] < TCP_OPTION_WS_SHIFT_MAX) ?
+                                         option->value[0] : TCP_OPTION_WS_SHIFT_MAX;
+                    tcb->rcv_wnd_shift = GNRC_TCP_WINDOW_SCALE;
+                }
+                DEBUG("gnrc_tcp_option.c : _option_parse() : WS option found. SHIFT=%"PRIu8"\n",
+                      option->value[0]);
+                break;
+
+            case TCP_OPTION_KIND_SACK_PERM:
+                if (opt_left < TCP_OPTION_LENGTH_MIN || option->length > opt_left ||
+                    option->length != TCP_OPTION_LENGTH_SACK_PERM) {
+
+                    DEBUG("gnrc_tcp_option.c : _option_parse() : invalid SACK_PERM length.\n");
+                    return -1;
+                }
+                /* SACK is only negotiated on SYN and if we support it ourself */
+                if ((ctl & MSK_SYN) && GNRC_TCP_SACK_BLOCKS > 0) {
+                    tcb->status |= STATUS_SACK;
+                }
+                DEBUG("gnrc_tcp_option.c : _option_parse() : SACK_PERM option found.\n");
+                break;
+
+            case TCP_OPTION_KIND_SACK:
+                if (opt_left < TCP_OPTION_LENGTH_MIN || option->length > opt_left ||
+                    option->length < TCP_OPTION_LENGTH_MIN + TCP_OPTION_LENGTH_SACK_BLOCK ||
+                    (option->length - TCP_OPTION_LENGTH_MIN) % TCP_OPTION_LENGTH_SACK_BLOCK) {
+
+                    DEBUG("gnrc_tcp_option.c : _option_parse() : invalid SACK Option length.\n");
+                    return -1;
+                }
+                /* Mark selectively acknowledged segments in the retransmission queue */
+                if ((ctl & MSK_ACK) && (tcb->status & STATUS_SACK)) {
+                    for (uint8_t *blk = option->value; blk < opt_ptr + option->length;
+                         blk += TCP_OPTION_LENGTH_SACK_BLOCK) {
+                        network_uint32_t edges[2];
+
+                        memcpy(edges, blk, sizeof(edges));
+                        uint32_t left = byteorder_ntohl(edges[0]);
+                        uint32_t right = byteorder_ntohl(edges[1]);
+
+                        DEBUG("gnrc_tcp_option.c : _option_parse() : SACK block found.\
+                              LEFT=%"PRIu32", RIGHT=%"PRIu32"\n", left, right);
+                        _pkt_sack(tcb, left, right);
+                    }
+                }
+                break;
+
             default:
                 if (opt_left >= TCP_OPTION_LENGTH_MIN) {
                     DEBUG("gnrc_tcp_option.c : _option_parse() : Unsupported option found.\
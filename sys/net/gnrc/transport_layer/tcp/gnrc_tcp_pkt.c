@@ -20,6 +20,7 @@
 #include <utlist.h>
 #include <errno.h>
 #include "byteorder.h"
+#include "kernel_defines.h"
 #include "net/inet_csum.h"
 #include "net/gnrc.h"
 #include "internal/common.h"
@@ -46,6 +47,42 @@ static inline uint32_t _max(const uint32_t x, const uint32_t y)
   return (x > y) ? x : y;
 }
 
+#if GNRC_TCP_SACK_BLOCKS
+/**
+ * @brief Builds SACK blocks from the out-of-order queue of a TCB.
+ *
+ * @note Adjacent segments are merged. Blocks are reported in sequence number order.
+ *
+ * @param[in]  tcb      TCB holding the out-of-order queue.
+ * @param[out] blocks   Left and right edges of each block, in network byte order.
+ *
+ * @returns   Number of SACK blocks written into @p blocks.
+ */
+static uint8_t _sack_blocks(const gnrc_tcp_tcb_t *tcb, network_uint32_t *blocks)
+{
+    uint8_t num = 0;
+    uint32_t right = 0;
+
+    for (uint8_t i = 0; i < tcb->ooo_len; ++i) {
+        const gnrc_tcp_seg_t *seg = &tcb->ooo[i];
+
+        /* Extend previous block if this segment is contiguous or overlapping */
+        if (num > 0 && LEQ_32_BIT(seg->seq, right)) {
+            if (LSS_32_BIT(right, seg->seq + seg->len)) {
+                right = seg->seq + seg->len;
+                blocks[(num * 2) - 1] = byteorder_htonl(right);
+            }
+            continue;
+        }
+        right = seg->seq + seg->len;
+        blocks[num * 2] = byteorder_htonl(seg->seq);
+        blocks[(num * 2) + 1] = byteorder_htonl(right);
+        num += 1;
+    }
+    return num;
+}
+#endif
+
 int _pkt_build_reset_from_pkt(gnrc_pktsnip_t **out_pkt, gnrc_pktsnip_t *in_pkt)
 {
     tcp_hdr_t tcp_hdr_out;
@@ -147,6 +184,13 @@ int _pkt_build(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t **out_pkt, uint16_t *seq_con,
     gnrc_pktsnip_t *tcp_snp = NULL;
     tcp_hdr_t tcp_hdr;
     uint8_t offset = TCP_HDR_OFFSET_MIN;
+    uint32_t wnd = 0;
+    bool ws = false;
+    bool sack_perm = false;
+    uint8_t sack_blocks = 0;
+#if GNRC_TCP_SACK_BLOCKS
+    network_uint32_t sack[GNRC_TCP_SACK_BLOCKS * 2];
+#endif
 
     /* Add payload, if supplied */
     if (payload != NULL && payload_len > 0) {
@@ -164,14 +208,32 @@ int _pkt_build(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t **out_pkt, uint16_t *seq_con,
     tcp_hdr.checksum = byteorder_htons(0);
     tcp_hdr.seq_num = byteorder_htonl(seq_num);
     tcp_hdr.ack_num = byteorder_htonl(ack_num);
-    tcp_hdr.window = byteorder_htons(tcb->rcv_wnd);
     tcp_hdr.urgent_ptr = byteorder_htons(0);
 
+    /* Windows in SYN segments are never scaled (see RFC 7323) */
+    wnd = (ctl & MSK_SYN) ? tcb->rcv_wnd : (tcb->rcv_wnd >> tcb->rcv_wnd_shift);
+    tcp_hdr.window = byteorder_htons((wnd < UINT16_MAX) ? wnd : UINT16_MAX);
+
     /* Calculate option field size. */
-    /* Add MSS option if SYN is sent */
     if (ctl & MSK_SYN) {
+        /* Add MSS option if SYN is sent */
         offset += 1;
+
+        /* Add window scale and SACK permitted option, on SYN+ACK only if the peer sent them */
+        ws = !(ctl & MSK_ACK) || (tcb->status & STATUS_WINDOW_SCALE);
+        sack_perm = (GNRC_TCP_SACK_BLOCKS > 0) && (!(ctl & MSK_ACK) ||
+                                                   (tcb->status & STATUS_SACK));
+        offset += ws + sack_perm;
+    }
+#if GNRC_TCP_SACK_BLOCKS
+    /* Add SACK option if out-of-order segments were received */
+    else if ((ctl & MSK_ACK) && (tcb->status & STATUS_SACK)) {
+        sack_blocks = _sack_blocks(tcb, sack);
+        if (sack_blocks > 0) {
+            offset += 1 + (sack_blocks * TCP_OPTION_LENGTH_SACK_BLOCK) / sizeof(network_uint32_t);
+        }
     }
+#endif
     /* Set offset and control bit accordingly */
     tcp_hdr.off_ctl = byteorder_htons(_option_build_offset_control(offset, ctl));
 
@@ -203,8 +265,26 @@ int _pkt_build(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t **out_pkt, uint16_t *seq_con,
             if (ctl & MSK_SYN) {
                 network_uint32_t mss_option = byteorder_htonl(_option_build_mss(GNRC_TCP_MSS));
                 memcpy(opt_ptr, &mss_option, sizeof(mss_option));
+                opt_ptr += sizeof(mss_option);
+            }
+            if (ws) {
+                network_uint32_t ws_option = byteorder_htonl(_option_build_ws(GNRC_TCP_WINDOW_SCALE));
+                memcpy(opt_ptr, &ws_option, sizeof(ws_option));
+                opt_ptr += sizeof(ws_option);
+            }
+            if (sack_perm) {
+                network_uint32_t sack_perm_option = byteorder_htonl(_option_build_sack_perm());
+                memcpy(opt_ptr, &sack_perm_option, sizeof(sack_perm_option));
+                opt_ptr += sizeof(sack_perm_option);
             }
-            /* Increase opt_ptr and decrease opt_left, if other options are added */
+#if GNRC_TCP_SACK_BLOCKS
+            if (sack_blocks > 0) {
+                network_uint32_t sack_option = byteorder_htonl(_option_build_sack(sack_blocks));
+                memcpy(opt_ptr, &sack_option, sizeof(sack_option));
+                opt_ptr += sizeof(sack_option);
+                memcpy(opt_ptr, sack, sack_blocks * TCP_OPTION_LENGTH_SACK_BLOCK);
+            }
+#endif
             /* NOTE: Add additional options here */
         }
         *(out_pkt) = tcp_snp;
@@ -269,12 +349,20 @@ int _pkt_send(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *out_pkt, const uint16_t seq_c
 
     /* If this is no retransmission, advance sequence number and measure time */
     if (!retransmit) {
-        tcb->retries = 0;
         tcb->snd_nxt += seq_con;
-        tcb->rtt_start = xtimer_now().ticks32;
+
+        /* Time one segment per round trip */
+        if (seq_con > 0 && !(tcb->status & STATUS_RTT_PENDING)) {
+            tcb->status |= STATUS_RTT_PENDING;
+            tcb->rtt_start = xtimer_now().ticks32;
+            tcb->rtt_seq = tcb->snd_nxt;
+        }
     }
     else {
         tcb->retries += 1;
+
+        /* Retransmitted segments are ambiguous and can't be timed (Karns Algorithm) */
+        tcb->status &= ~STATUS_RTT_PENDING;
     }
 
     /* Pass packet down the network stack */
@@ -349,6 +437,43 @@ uint32_t _pkt_get_pay_len(gnrc_pktsnip_t *pkt)
     return seg_len;
 }
 
+/**
+ * @brief Calculates the retransmission timeout from the current RTT estimation.
+ *
+ * @param[in,out] tcb   TCB holding the connection information.
+ */
+static void _calc_rto(gnrc_tcp_tcb_t *tcb)
+{
+    /* If there was no measurement yet: rto is 1 sec (Lower Bound) */
+    if (tcb->srtt == RTO_UNINITIALIZED || tcb->rtt_var == RTO_UNINITIALIZED) {
+        tcb->rto = GNRC_TCP_RTO_LOWER_BOUND;
+    }
+    else {
+        tcb->rto = tcb->srtt + _max(GNRC_TCP_RTO_GRANULARITY,  GNRC_TCP_RTO_K * tcb->rtt_var);
+    }
+}
+
+/**
+ * @brief Performs boundry checks on the RTO and (re)starts the retransmission timer.
+ *
+ * @param[in,out] tcb   TCB holding the connection information.
+ */
+static void _start_retransmit_timer(gnrc_tcp_tcb_t *tcb)
+{
+    /* Perform boundry checks on current RTO before usage */
+    if (tcb->rto < (int32_t) GNRC_TCP_RTO_LOWER_BOUND) {
+        tcb->rto = GNRC_TCP_RTO_LOWER_BOUND;
+    }
+    else if (tcb->rto > (int32_t) GNRC_TCP_RTO_UPPER_BOUND) {
+        tcb->rto = GNRC_TCP_RTO_UPPER_BOUND;
+    }
+
+    /* Setup retransmission timer, msg to TCP thread with ptr to TCB */
+    tcb->msg_tout.type = MSG_TYPE_RETRANSMISSION;
+    tcb->msg_tout.content.ptr = (void *) tcb;
+    xtimer_set_msg(&tcb->tim_tout, tcb->rto, &tcb->msg_tout, gnrc_tcp_pid);
+}
+
 int _pkt_setup_retransmit(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *pkt, const bool retransmit)
 {
     gnrc_pktsnip_t *snp = NULL;
@@ -362,8 +487,8 @@ int _pkt_setup_retransmit(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *pkt, const bool r
     }
 
     /* Check if retransmit queue is full and pkt is not already in retransmit queue */
-    if (tcb->pkt_retransmit != NULL && tcb->pkt_retransmit != pkt) {
-        DEBUG("gnrc_tcp_pkt.c : _pkt_setup_retransmit() : Nothing to do\n");
+    if (!retransmit && tcb->rtx_len >= ARRAY_SIZE(tcb->rtx)) {
+        DEBUG("gnrc_tcp_pkt.c : _pkt_setup_retransmit() : Retransmit queue is full\n");
         return -ENOMEM;
     }
 
@@ -377,19 +502,23 @@ int _pkt_setup_retransmit(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *pkt, const bool r
         return 0;
     }
 
-    /* Assign pkt and increase users: every send attempt consumes a user */
-    tcb->pkt_retransmit = pkt;
+    /* Increase users: every send attempt consumes a user */
     gnrc_pktbuf_hold(pkt, 1);
 
     /* RTO adjustment */
     if (!retransmit) {
-        /* If this is the first transmission: rto is 1 sec (Lower Bound) */
-        if (tcb->srtt == RTO_UNINITIALIZED || tcb->rtt_var == RTO_UNINITIALIZED) {
-            tcb->rto = GNRC_TCP_RTO_LOWER_BOUND;
-        }
-        else {
-            tcb->rto = tcb->srtt + _max(GNRC_TCP_RTO_GRANULARITY,  GNRC_TCP_RTO_K * tcb->rtt_var);
+        /* Append pkt to the retransmit queue */
+        gnrc_tcp_seg_t *seg = &tcb->rtx[tcb->rtx_len++];
+        seg->pkt = pkt;
+        seg->seq = byteorder_ntohl(((tcp_hdr_t *) snp->data)->seq_num);
+        seg->len = _pkt_get_seg_len(pkt);
+        seg->sacked = 0;
+
+        /* The timer is already running if older segments are in flight */
+        if (tcb->rtx_len > 1) {
+            return 0;
         }
+        _calc_rto(tcb);
     }
     else {
         /* If this is a retransmission: Double the rto (Timer Backoff) */
@@ -403,50 +532,41 @@ int _pkt_setup_retransmit(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *pkt, const bool r
         }
     }
 
-    /* Perform boundry checks on current RTO before usage */
-    if (tcb->rto < (int32_t) GNRC_TCP_RTO_LOWER_BOUND) {
-        tcb->rto = GNRC_TCP_RTO_LOWER_BOUND;
-    }
-    else if (tcb->rto > (int32_t) GNRC_TCP_RTO_UPPER_BOUND) {
-        tcb->rto = GNRC_TCP_RTO_UPPER_BOUND;
-    }
-
-    /* Setup retransmission timer, msg to TCP thread with ptr to TCB */
-    tcb->msg_tout.type = MSG_TYPE_RETRANSMISSION;
-    tcb->msg_tout.content.ptr = (void *) tcb;
-    xtimer_set_msg(&tcb->tim_tout, tcb->rto, &tcb->msg_tout, gnrc_tcp_pid);
+    _start_retransmit_timer(tcb);
     return 0;
 }
 
 int _pkt_acknowledge(gnrc_tcp_tcb_t *tcb, const uint32_t ack)
 {
-    uint32_t seg = 0;
-    gnrc_pktsnip_t *snp = NULL;
-    tcp_hdr_t *hdr;
+    uint8_t acked = 0;
 
     /* Retransmission queue is empty. Nothing to ACK there */
-    if (tcb->pkt_retransmit == NULL) {
+    if (tcb->rtx_len == 0) {
         DEBUG("gnrc_tcp_pkt.c : _pkt_acknowledge() : There is no packet to ack\n");
         return -ENODATA;
     }
 
-    LL_SEARCH_SCALAR(tcb->pkt_retransmit, snp, type, GNRC_NETTYPE_TCP);
-    hdr = (tcp_hdr_t *) snp->data;
-
-    /* There must be a packet, waiting to be acknowledged. */
-    seg = byteorder_ntohl(hdr->seq_num) + _pkt_get_seg_len(tcb->pkt_retransmit) - 1;
-
-    /* If segment can be acknowledged -> stop timer, release packet from pktbuf and update rto. */
-    if (LSS_32_BIT(seg, ack)) {
-        xtimer_remove(&(tcb->tim_tout));
-        gnrc_pktbuf_release(tcb->pkt_retransmit);
-        tcb->pkt_retransmit = NULL;
+    /* Release all segments that are covered by ack, the queue is ordered by sequence number */
+    while (acked < tcb->rtx_len &&
+           LEQ_32_BIT(tcb->rtx[acked].seq + tcb->rtx[acked].len, ack)) {
+        gnrc_pktbuf_release(tcb->rtx[acked].pkt);
+        acked += 1;
+    }
+    if (acked == 0) {
+        return 0;
+    }
+    tcb->rtx_len -= acked;
+    memmove(tcb->rtx, tcb->rtx + acked, tcb->rtx_len * sizeof(tcb->rtx[0]));
+    tcb->retries = 0;
 
-        /* Measure round trip time */
+    /* Measure round trip time, if the timed segment was acknowledged */
+    if ((tcb->status & STATUS_RTT_PENDING) && LEQ_32_BIT(tcb->rtt_seq, ack)) {
         int32_t rtt = xtimer_now().ticks32 - tcb->rtt_start;
 
-        /* Use time only if ther was no timer overflow and no retransmission (Karns Alogrithm) */
-        if (tcb->retries == 0 && rtt > 0) {
+        tcb->status &= ~STATUS_RTT_PENDING;
+
+        /* Use time only if there was no timer overflow */
+        if (rtt > 0) {
             /* If this is the first sample taken */
             if (tcb->srtt == RTO_UNINITIALIZED && tcb->rtt_var == RTO_UNINITIALIZED) {
                 tcb->srtt = rtt;
@@ -459,11 +579,44 @@ int _pkt_acknowledge(gnrc_tcp_tcb_t *tcb, const uint32_t ack)
                 tcb->srtt = (tcb->srtt / GNRC_TCP_RTO_A_DIV) * (GNRC_TCP_RTO_A_DIV-1);
                 tcb->srtt += rtt / GNRC_TCP_RTO_A_DIV;
             }
+            _calc_rto(tcb);
         }
     }
+
+    /* Stop timer if everything was acknowledged, restart it for the remaining segments if not */
+    if (tcb->rtx_len == 0) {
+        xtimer_remove(&(tcb->tim_tout));
+    }
+    else {
+        _start_retransmit_timer(tcb);
+    }
     return 0;
 }
 
+void _pkt_sack(gnrc_tcp_tcb_t *tcb, const uint32_t left, const uint32_t right)
+{
+    for (uint8_t i = 0; i < tcb->rtx_len; ++i) {
+        gnrc_tcp_seg_t *seg = &tcb->rtx[i];
+
+        if (LEQ_32_BIT(left, seg->seq) && LEQ_32_BIT(seg->seq + seg->len, right)) {
+            seg->sacked = 1;
+        }
+    }
+}
+
+gnrc_pktsnip_t *_pkt_get_retransmit(gnrc_tcp_tcb_t *tcb)
+{
+    if (tcb->rtx_len == 0) {
+        return NULL;
+    }
+    for (uint8_t i = 0; i < tcb->rtx_len; ++i) {
+        if (!tcb->rtx[i].sacked) {
+            return tcb->rtx[i].pkt;
+        }
+    }
+    return tcb->rtx[0].pkt;
+}
+
 uint16_t _pkt_calc_csum(const gnrc_pktsnip_t *hdr, const gnrc_pktsnip_t *pseudo_hdr,
                         const gnrc_pktsnip_t *payload)
 {
@@ -0,0 +1,353 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gnrc
+ * @{
+ *
+ * @file
+ * @brief       Implementation of internal/tcb_table.h
+ * @}
+ */
+
+#include <errno.h>
+#include "net/af.h"
+#include "net/gnrc/tcp.h"
+#include "internal/common.h"
+#include "internal/fsm.h"
+#include "internal/rcvbuf.h"
+#include "internal/tcb_table.h"
+
+#ifdef MODULE_GNRC_IPV6
+#include "net/gnrc/ipv6.h"
+#endif
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#if (GNRC_TCP_TCB_TABLE_SIZE & (GNRC_TCP_TCB_TABLE_SIZE - 1)) != 0
+#error "GNRC_TCP_TCB_TABLE_SIZE must be a power of two"
+#endif
+
+/**
+ * @brief Head of the list of listening TCBs.
+ */
+static gnrc_tcp_tcb_t *_list_listen_head;
+
+/**
+ * @brief Hash table of all other active TCBs.
+ */
+static gnrc_tcp_tcb_t *_table[GNRC_TCP_TCB_TABLE_SIZE];
+
+#if GNRC_TCP_TCB_POOL_SIZE
+/**
+ * @brief Head of the list of listeners.
+ */
+static gnrc_tcp_listener_t *_list_listener_head;
+
+/**
+ * @brief TCBs for connections spawned by listeners.
+ */
+static gnrc_tcp_tcb_t _pool[GNRC_TCP_TCB_POOL_SIZE];
+#endif
+
+/**
+ * @brief Calculates the hash table bucket of a connection.
+ *
+ * @param[in] local_port   Local port number.
+ * @param[in] peer_port    Peer port number.
+ * @param[in] peer_addr    Peer address.
+ *
+ * @returns   Index of the bucket.
+ */
+static unsigned _hash(uint16_t local_port, uint16_t peer_port, const uint8_t *peer_addr)
+{
+    uint32_t hash = ((uint32_t)local_port << 16) | peer_port;
+
+#ifdef MODULE_GNRC_IPV6
+    /* Peers mostly differ in the interface identifier */
+    for (unsigned i = sizeof(ipv6_addr_t) / 2; i < sizeof(ipv6_addr_t); ++i) {
+        hash = (hash * 31) ^ peer_addr[i];
+    }
+#else
+    (void) peer_addr;
+#endif
+    hash ^= hash >> 16;
+    hash ^= hash >> 8;
+    return hash & (GNRC_TCP_TCB_TABLE_SIZE - 1);
+}
+
+/**
+ * @brief Removes a TCB from a singly linked list.
+ *
+ * @param[in,out] head   Head of the list.
+ * @param[in]     tcb    TCB to remove.
+ *
+ * @returns   1 if @p tcb was removed.
+ *            Zero if @p tcb was not part of the list.
+ */
+static int _list_remove(gnrc_tcp_tcb_t **head, gnrc_tcp_tcb_t *tcb)
+{
+    for (gnrc_tcp_tcb_t **iter = head; *iter != NULL; iter = &(*iter)->next) {
+        if (*iter == tcb) {
+            *iter = tcb->next;
+            tcb->next = NULL;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void _tcb_table_init(void)
+{
+    _list_listen_head = NULL;
+    for (unsigned i = 0; i < GNRC_TCP_TCB_TABLE_SIZE; ++i) {
+        _table[i] = NULL;
+    }
+#if GNRC_TCP_TCB_POOL_SIZE
+    _list_listener_head = NULL;
+    for (unsigned i = 0; i < GNRC_TCP_TCB_POOL_SIZE; ++i) {
+        _pool[i].status = 0;
+    }
+#endif
+}
+
+void _tcb_table_add_listen(gnrc_tcp_tcb_t *tcb)
+{
+    tcb->next = _list_listen_head;
+    _list_listen_head = tcb;
+}
+
+void _tcb_table_add(gnrc_tcp_tcb_t *tcb)
+{
+#ifdef MODULE_GNRC_IPV6
+    const uint8_t *peer_addr = tcb->peer_addr;
+#else
+    const uint8_t *peer_addr = NULL;
+#endif
+    unsigned bucket = _hash(tcb->local_port, tcb->peer_port, peer_addr);
+
+    tcb->next = _table[bucket];
+    _table[bucket] = tcb;
+}
+
+void _tcb_table_remove(gnrc_tcp_tcb_t *tcb)
+{
+#ifdef MODULE_GNRC_IPV6
+    const uint8_t *peer_addr = tcb->peer_addr;
+#else
+    const uint8_t *peer_addr = NULL;
+#endif
+
+    if (!_list_remove(&_list_listen_head, tcb)) {
+        _list_remove(&_table[_hash(tcb->local_port, tcb->peer_port, peer_addr)], tcb);
+    }
+}
+
+gnrc_tcp_tcb_t *_tcb_table_find(uint16_t local_port, uint16_t peer_port,
+                                const uint8_t *peer_addr)
+{
+    gnrc_tcp_tcb_t *tcb = _table[_hash(local_port, peer_port, peer_addr)];
+
+    while (tcb) {
+        if (tcb->local_port == local_port && tcb->peer_port == peer_port) {
+#ifdef MODULE_GNRC_IPV6
+            if (tcb->address_family == AF_INET6 &&
+                ipv6_addr_equal((ipv6_addr_t *) tcb->peer_addr, (ipv6_addr_t *) peer_addr)) {
+                break;
+            }
+#else
+            break;
+#endif
+        }
+        tcb = tcb->next;
+    }
+    return tcb;
+}
+
+gnrc_tcp_tcb_t *_tcb_table_find_listen(uint16_t local_port, const uint8_t *local_addr)
+{
+    gnrc_tcp_tcb_t *tcb = _list_listen_head;
+
+    while (tcb) {
+        if (tcb->local_port == local_port) {
+#ifdef MODULE_GNRC_IPV6
+            /* Local addr must be unspec or pre configured */
+            if (tcb->address_family == AF_INET6 &&
+                (ipv6_addr_equal((ipv6_addr_t *) tcb->local_addr, (ipv6_addr_t *) local_addr) ||
+                 ipv6_addr_is_unspecified((ipv6_addr_t *) tcb->local_addr))) {
+                break;
+            }
+#else
+            (void) local_addr;
+#endif
+        }
+        tcb = tcb->next;
+    }
+    return tcb;
+}
+
+int _tcb_table_port_in_use(uint16_t port_number)
+{
+    gnrc_tcp_tcb_t *tcb;
+
+    for (tcb = _list_listen_head; tcb; tcb = tcb->next) {
+        if (tcb->local_port == port_number) {
+            return 1;
+        }
+    }
+    for (unsigned i = 0; i < GNRC_TCP_TCB_TABLE_SIZE; ++i) {
+        for (tcb = _table[i]; tcb; tcb = tcb->next) {
+            if (tcb->local_port == port_number) {
+                return 1;
+            }
+        }
+    }
+#if GNRC_TCP_TCB_POOL_SIZE
+    for (gnrc_tcp_listener_t *iter = _list_listener_head; iter; iter = iter->next) {
+        if (iter->local_port == port_number) {
+            return 1;
+        }
+    }
+#endif
+    return 0;
+}
+
+#if GNRC_TCP_TCB_POOL_SIZE
+int _tcb_table_listener_add(gnrc_tcp_listener_t *listener)
+{
+    for (gnrc_tcp_listener_t *iter = _list_listener_head; iter; iter = iter->next) {
+        if (iter->local_port == listener->local_port) {
+            return -EADDRINUSE;
+        }
+    }
+    listener->next = _list_listener_head;
+    _list_listener_head = listener;
+    return 0;
+}
+
+void _tcb_table_listener_remove(gnrc_tcp_listener_t *listener)
+{
+    for (gnrc_tcp_listener_t **iter = &_list_listener_head; *iter; iter = &(*iter)->next) {
+        if (*iter == listener) {
+            *iter = listener->next;
+            listener->next = NULL;
+            return;
+        }
+    }
+}
+
+int _tcb_table_pool_alloc(gnrc_tcp_tcb_t **tcb_out, uint16_t local_port,
+                          const uint8_t *local_addr)
+{
+    gnrc_tcp_listener_t *listener = _list_listener_head;
+    gnrc_tcp_tcb_t *tcb = NULL;
+
+    /* Find the listener the request is directed to */
+    while (listener) {
+        if (listener->local_port == local_port) {
+#ifdef MODULE_GNRC_IPV6
+            if (ipv6_addr_equal((ipv6_addr_t *) listener->local_addr,
+                                (ipv6_addr_t *) local_addr) ||
+                ipv6_addr_is_unspecified((ipv6_addr_t *) listener->local_addr)) {
+                break;
+            }
+#else
+            (void) local_addr;
+            break;
+#endif
+        }
+        listener = listener->next;
+    }
+    if (listener == NULL) {
+        return -ENOENT;
+    }
+
+    /* Ignore the request if the backlog is full, the peer will retry */
+    if (listener->pending >= listener->backlog) {
+        DEBUG("gnrc_tcp_tcb_table.c : _tcb_table_pool_alloc() : Backlog is full\n");
+        return -ENOMEM;
+    }
+
+    for (unsigned i = 0; i < GNRC_TCP_TCB_POOL_SIZE; ++i) {
+        if (!(_pool[i].status & STATUS_POOLED)) {
+            tcb = &_pool[i];
+            break;
+        }
+    }
+    if (tcb == NULL) {
+        DEBUG("gnrc_tcp_tcb_table.c : _tcb_table_pool_alloc() : Pool is exhausted\n");
+        return -ENOMEM;
+    }
+
+    gnrc_tcp_tcb_init(tcb);
+    if (_rcvbuf_get_buffer(tcb) == -ENOMEM) {
+        DEBUG("gnrc_tcp_tcb_table.c : _tcb_table_pool_alloc() : Out of receive buffers\n");
+        return -ENOMEM;
+    }
+    tcb->status = STATUS_POOLED;
+    tcb->local_port = local_port;
+    tcb->rcv_wnd = GNRC_TCP_DEFAULT_WINDOW;
+    tcb->state = FSM_STATE_LISTEN;
+    tcb->listener = listener;
+    listener->pending++;
+    *tcb_out = tcb;
+    return 0;
+}
+
+void _tcb_table_pool_release(gnrc_tcp_tcb_t *tcb)
+{
+    if (tcb->listener != NULL) {
+        tcb->listener->pending--;
+        tcb->listener = NULL;
+    }
+    _rcvbuf_release_buffer(tcb);
+    tcb->status &= ~STATUS_POOLED;
+}
+
+gnrc_tcp_tcb_t *_tcb_table_pool_accept(gnrc_tcp_listener_t *listener)
+{
+    for (unsigned i = 0; i < GNRC_TCP_TCB_POOL_SIZE; ++i) {
+        gnrc_tcp_tcb_t *tcb = &_pool[i];
+
+        if ((tcb->status & STATUS_POOLED) && (tcb->listener == listener) &&
+            (tcb->state == FSM_STATE_ESTABLISHED || tcb->state == FSM_STATE_CLOSE_WAIT)) {
+            listener->pending--;
+            tcb->listener = NULL;
+            return tcb;
+        }
+    }
+    return NULL;
+}
+
+gnrc_tcp_tcb_t *_tcb_table_pool_find_pending(gnrc_tcp_listener_t *listener)
+{
+    for (unsigned i = 0; i < GNRC_TCP_TCB_POOL_SIZE; ++i) {
+        gnrc_tcp_tcb_t *tcb = &_pool[i];
+
+        /* TCBs in LISTEN are still being set up by the eventloop */
+        if ((tcb->status & STATUS_POOLED) && (tcb->listener == listener) &&
+            (tcb->state != FSM_STATE_LISTEN)) {
+            return tcb;
+        }
+    }
+    return NULL;
+}
+
+void _tcb_table_pool_detach(gnrc_tcp_listener_t *listener)
+{
+    for (unsigned i = 0; i < GNRC_TCP_TCB_POOL_SIZE; ++i) {
+        gnrc_tcp_tcb_t *tcb = &_pool[i];
+
+        if ((tcb->status & STATUS_POOLED) && (tcb->listener == listener)) {
+            listener->pending--;
+            tcb->listener = NULL;
+        }
+    }
+}
+#endif
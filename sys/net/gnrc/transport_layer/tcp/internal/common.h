@@ -47,6 +47,10 @@ extern "C" {
 #define STATUS_ALLOW_ANY_ADDR (1 << 1)
 #define STATUS_NOTIFY_USER    (1 << 2)
 #define STATUS_WAIT_FOR_MSG   (1 << 3)
+#define STATUS_RTT_PENDING    (1 << 4)
+#define STATUS_SACK           (1 << 5)
+#define STATUS_WINDOW_SCALE   (1 << 6)
+#define STATUS_POOLED         (1 << 7)
 /** @} */
 
 /**
@@ -89,6 +93,17 @@ extern "C" {
 #define MSG_TYPE_NOTIFY_USER        (GNRC_NETAPI_MSG_TYPE_ACK + 106)
 /** @} */
 
+/**
+ * @brief Number of duplicate acknowledgments triggering a fast retransmit (see RFC 5681).
+ */
+#define DUP_ACK_THRESHOLD (3U)
+
+/**
+ * @brief Number of SYN+ACK retransmissions after which a connection spawned by a
+ *        listener is given up.
+ */
+#define SYN_ACK_MAX_RETRIES (5U)
+
 /**
  * @brief Define for marking that time measurement is uninitialized.
  */
@@ -121,12 +136,7 @@ extern "C" {
 extern kernel_pid_t gnrc_tcp_pid;
 
 /**
- * @brief Head of linked TCB list.
- */
-extern gnrc_tcp_tcb_t *_list_tcb_head;
-
-/**
- * @brief Mutex to protect TCB list.
+ * @brief Mutex to protect the TCB table.
  */
 extern mutex_t _list_tcb_lock;
 
@@ -74,6 +74,7 @@ typedef enum {
  * @returns   Zero on success
  *            Positive Number, number of bytes sent from or copied into @p buf.
  *            -ENOSYS if event is not implemented
+ *            -ENOTCONN if the listener of a pooled TCB stopped during the handshake
  */
 int _fsm(gnrc_tcp_tcb_t *tcb, fsm_event_t event, gnrc_pktsnip_t *in_pkt, void *buf, size_t len);
 
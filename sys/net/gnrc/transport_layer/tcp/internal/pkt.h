@@ -129,6 +129,26 @@ int _pkt_setup_retransmit(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *pkt, const bool r
  */
 int _pkt_acknowledge(gnrc_tcp_tcb_t *tcb, const uint32_t ack);
 
+/**
+ * @brief Marks packets in the retransmission mechanism as selectively acknowledged.
+ *
+ * @param[in,out] tcb     TCB holding the connection information.
+ * @param[in]     left    Left edge of the SACK block.
+ * @param[in]     right   Right edge of the SACK block.
+ */
+void _pkt_sack(gnrc_tcp_tcb_t *tcb, const uint32_t left, const uint32_t right);
+
+/**
+ * @brief Get the packet to retransmit next.
+ *
+ * @param[in] tcb   TCB holding the connection information.
+ *
+ * @returns   Oldest packet in the retransmission mechanism that was not selectively
+ *            acknowledged by the peer. The oldest packet if all were acknowledged.
+ *            NULL if the retransmission queue is empty.
+ */
+gnrc_pktsnip_t *_pkt_get_retransmit(gnrc_tcp_tcb_t *tcb);
+
 /**
  * @brief Calculates checksum over payload, TCP header and network layer header.
  *
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gnrc_tcp
+ *
+ * @{
+ *
+ * @file
+ * @brief       Functions for looking up TCBs and managing listeners.
+ *
+ * Listening TCBs are kept in a list, all other active TCBs in a hash table
+ * keyed by the peer address and both port numbers. TCBs of connections
+ * spawned by a listener are taken from a preallocated pool.
+ *
+ * @note All functions must be called with _list_tcb_lock locked.
+ */
+
+#ifndef TCB_TABLE_H
+#define TCB_TABLE_H
+
+#include <stdint.h>
+#include "net/gnrc/tcp/config.h"
+#include "net/gnrc/tcp/tcb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initializes the TCB table.
+ */
+void _tcb_table_init(void);
+
+/**
+ * @brief Adds a TCB in state LISTEN to the list of listening TCBs.
+ *
+ * @param[in,out] tcb   TCB to add.
+ */
+void _tcb_table_add_listen(gnrc_tcp_tcb_t *tcb);
+
+/**
+ * @brief Adds a TCB to the hash table.
+ *
+ * @note The peer address and port numbers of @p tcb must not change while
+ *       it is in the table.
+ *
+ * @param[in,out] tcb   TCB to add.
+ */
+void _tcb_table_add(gnrc_tcp_tcb_t *tcb);
+
+/**
+ * @brief Removes a TCB from the table, if it is part of it.
+ *
+ * @param[in,out] tcb   TCB to remove.
+ */
+void _tcb_table_remove(gnrc_tcp_tcb_t *tcb);
+
+/**
+ * @brief Looks up the TCB of a connection.
+ *
+ * @param[in] local_port   Local port number.
+ * @param[in] peer_port    Peer port number.
+ * @param[in] peer_addr    Peer address.
+ *
+ * @returns   The TCB of the connection.
+ *            NULL if there is no such connection.
+ */
+gnrc_tcp_tcb_t *_tcb_table_find(uint16_t local_port, uint16_t peer_port,
+                                const uint8_t *peer_addr);
+
+/**
+ * @brief Looks up a TCB listening for a connection request.
+ *
+ * @param[in] local_port   Port number the request is directed to.
+ * @param[in] local_addr   Address the request is directed to.
+ *
+ * @returns   A TCB listening on @p local_port and @p local_addr.
+ *            NULL if no TCB is listening.
+ */
+gnrc_tcp_tcb_t *_tcb_table_find_listen(uint16_t local_port, const uint8_t *local_addr);
+
+/**
+ * @brief Checks if a given port number is used as local port.
+ *
+ * @param[in] port_number   Port number that should be checked.
+ *
+ * @returns   Zero if @p port_number is currently not used.
+ *            1 if @p port_number is used by a TCB or listener.
+ */
+int _tcb_table_port_in_use(uint16_t port_number);
+
+#if GNRC_TCP_TCB_POOL_SIZE
+/**
+ * @brief Adds a listener.
+ *
+ * @param[in,out] listener   Listener to add.
+ *
+ * @returns   Zero on success.
+ *            -EADDRINUSE if another listener uses the same port number.
+ */
+int _tcb_table_listener_add(gnrc_tcp_listener_t *listener);
+
+/**
+ * @brief Removes a listener.
+ *
+ * @param[in,out] listener   Listener to remove.
+ */
+void _tcb_table_listener_remove(gnrc_tcp_listener_t *listener);
+
+/**
+ * @brief Takes a TCB from the pool for a connection request to a listener.
+ *
+ * The TCB is initialized in state LISTEN with a receive buffer, but not
+ * added to the table.
+ *
+ * @param[out] tcb_out      The TCB for the connection.
+ * @param[in]  local_port   Port number the request is directed to.
+ * @param[in]  local_addr   Address the request is directed to.
+ *
+ * @returns   Zero on success.
+ *            -ENOENT if there is no listener for the request.
+ *            -ENOMEM if the backlog of the listener is full or no TCB or
+ *                    receive buffer is available.
+ */
+int _tcb_table_pool_alloc(gnrc_tcp_tcb_t **tcb_out, uint16_t local_port,
+                          const uint8_t *local_addr);
+
+/**
+ * @brief Returns a TCB to the pool.
+ *
+ * @param[in,out] tcb   TCB taken from the pool.
+ */
+void _tcb_table_pool_release(gnrc_tcp_tcb_t *tcb);
+
+/**
+ * @brief Hands an established connection over to the user of a listener.
+ *
+ * @param[in,out] listener   Listener accepting the connection.
+ *
+ * @returns   The TCB of the accepted connection.
+ *            NULL if no connection is waiting to be accepted.
+ */
+gnrc_tcp_tcb_t *_tcb_table_pool_accept(gnrc_tcp_listener_t *listener);
+
+/**
+ * @brief Finds a connection of a listener that was not accepted yet.
+ *
+ * @param[in] listener   Listener of the connection.
+ *
+ * @returns   TCB of a connection waiting to be accepted.
+ *            NULL if there is none.
+ */
+gnrc_tcp_tcb_t *_tcb_table_pool_find_pending(gnrc_tcp_listener_t *listener);
+
+/**
+ * @brief Detaches all connections from a listener that stops.
+ *
+ * Must be called after all connections of @p listener that left LISTEN were
+ * aborted. The remaining ones are being set up by the eventloop, _fsm()
+ * aborts them and returns them to the pool once they lost their listener.
+ *
+ * @param[in,out] listener   Listener of the connections.
+ */
+void _tcb_table_pool_detach(gnrc_tcp_listener_t *listener);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TCB_TABLE_H */
+/** @} */
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_sock_async_event
+ * @{
+ *
+ * @file
+ * @brief       Asynchronous sock using the event API implementation
+ * @}
+ */
+
+#include "irq.h"
+#include "net/sock/async/event.h"
+
+#ifndef SOCK_HAS_ASYNC
+#error "sock_async_event: the network stack does not implement sock_async"
+#endif
+
+/* called by the network stack */
+static void _post(sock_event_t *event, sock_async_flags_t flags)
+{
+    unsigned state = irq_disable();
+    event->flags |= flags;
+    irq_restore(state);
+    /* does nothing if the event is still queued */
+    event_post(event->queue, &event->super);
+}
+
+/* called in the thread of the queue */
+static sock_async_flags_t _take_flags(event_t *ev)
+{
+    sock_event_t *event = (sock_event_t *)ev;
+
+    unsigned state = irq_disable();
+    sock_async_flags_t flags = event->flags;
+    event->flags = 0;
+    irq_restore(state);
+    return flags;
+}
+
+static void _init(sock_event_t *event, void *sock, event_queue_t *queue,
+                  event_handler_t handler, void *handler_arg)
+{
+    event->super.list_node.next = NULL;
+    event->super.handler = handler;
+    event->queue = queue;
+    event->sock = sock;
+    event->handler_arg = handler_arg;
+    event->flags = 0;
+}
+
+void sock_event_cancel(sock_event_t *event)
+{
+    event_cancel(event->queue, &event->super);
+    event->flags = 0;
+}
+
+#ifdef MODULE_SOCK_IP
+static void _ip_cb(sock_ip_t *sock, sock_async_flags_t flags, void *arg)
+{
+    (void)sock;
+    _post(arg, flags);
+}
+
+static void _ip_handler(event_t *ev)
+{
+    sock_event_t *event = (sock_event_t *)ev;
+    sock_async_flags_t flags = _take_flags(ev);
+
+    if (flags) {
+        event->handler.ip(event->sock, flags, event->handler_arg);
+    }
+}
+
+void sock_ip_event_init(sock_ip_t *sock, sock_event_t *event,
+                        event_queue_t *queue, sock_ip_cb_t handler,
+                        void *handler_arg)
+{
+    _init(event, sock, queue, _ip_handler, handler_arg);
+    event->handler.ip = handler;
+    sock_ip_set_cb(sock, _ip_cb, event);
+}
+#endif
+
+#ifdef MODULE_SOCK_UDP
+static void _udp_cb(sock_udp_t *sock, sock_async_flags_t flags, void *arg)
+{
+    (void)sock;
+    _post(arg, flags);
+}
+
+static void _udp_handler(event_t *ev)
+{
+    sock_event_t *event = (sock_event_t *)ev;
+    sock_async_flags_t flags = _take_flags(ev);
+
+    if (flags) {
+        event->handler.udp(event->sock, flags, event->handler_arg);
+    }
+}
+
+void sock_udp_event_init(sock_udp_t *sock, sock_event_t *event,
+                         event_queue_t *queue, sock_udp_cb_t handler,
+                         void *handler_arg)
+{
+    _init(event, sock, queue, _udp_handler, handler_arg);
+    event->handler.udp = handler;
+    sock_udp_set_cb(sock, _udp_cb, event);
+}
+#endif
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    posix_select    POSIX poll() and select()
+ * @ingroup     posix
+ * @brief       Waiting for events on several @ref posix_sockets "sockets"
+ *
+ * With the `posix_select` module, a single thread can wait for any of several
+ * sockets to become readable with poll() or select(), instead of blocking in
+ * recv() on each of them in a thread of its own. The sockets are notified by
+ * the network stack via @ref net_sock_async, so the stack needs to support it
+ * (`SOCK_HAS_ASYNC`). Currently only @ref net_gnrc "GNRC" does, with lwIP the
+ * module fails to compile.
+ *
+ * Only datagram and raw socket file descriptors are supported. They are
+ * always writable. A socket is readable when a message was signaled by the
+ * stack and not yet read.
+ *
+ * @warning Stream (TCP) sockets are not supported, as @ref net_sock_async has
+ *          no TCP callbacks. poll() reports them as @ref POLLNVAL, select()
+ *          fails with `EBADF`. Use a thread per connection for them.
+ *
+ * Combine with O_NONBLOCK, @ref SOCK_NONBLOCK or @ref MSG_DONTWAIT to read
+ * from a readable socket until no data is left.
+ *
+ * @note    Only one thread can wait for a given socket at a time.
+ *
+ * @see <a href="http://pubs.opengroup.org/onlinepubs/9699919799/basedefs/poll.h.html">
+ *          The Open Group Base Specifications Issue 7, <poll.h>
+ *      </a>
+ *
+ * @{
+ *
+ * @file
+ * @brief       Definitions for poll()
+ */
+#ifndef POLL_H
+#define POLL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Thread flag poll() and select() wait for
+ */
+#ifndef POSIX_SELECT_THREAD_FLAG
+#define POSIX_SELECT_THREAD_FLAG    (1U << 3)
+#endif
+
+/**
+ * @name    Event flags for struct pollfd
+ * @{
+ */
+#define POLLIN      (0x0001)    /**< Data other than high-priority may be read */
+#define POLLPRI     (0x0002)    /**< High-priority data may be read */
+#define POLLOUT     (0x0004)    /**< Normal data may be written */
+#define POLLERR     (0x0008)    /**< An error has occurred (revents only) */
+#define POLLHUP     (0x0010)    /**< Device has been disconnected (revents only) */
+#define POLLNVAL    (0x0020)    /**< Invalid fd member (revents only) */
+#define POLLRDNORM  (0x0040)    /**< Normal data may be read */
+#define POLLRDBAND  (0x0080)    /**< Priority data may be read */
+#define POLLWRNORM  (0x0100)    /**< Equivalent to POLLOUT */
+#define POLLWRBAND  (0x0200)    /**< Priority data may be written */
+/** @} */
+
+/**
+ * @brief   Type for the number of file descriptors
+ */
+typedef unsigned int nfds_t;
+
+/**
+ * @brief   File descriptor and events to poll
+ */
+struct pollfd {
+    int fd;         /**< the file descriptor, ignored if negative */
+    short events;   /**< the requested events */
+    short revents;  /**< the returned events */
+};
+
+/**
+ * @brief   Waits for events on a set of file descriptors
+ *
+ * @see <a href="http://pubs.opengroup.org/onlinepubs/9699919799/functions/poll.html">
+ *          The Open Group Base Specification Issue 7, poll
+ *      </a>
+ *
+ * @param[in,out] fds   The file descriptors and the events to wait for,
+ *                      the events that occurred are returned in
+ *                      pollfd::revents.
+ * @param[in] nfds      Number of elements in @p fds.
+ * @param[in] timeout   Timeout in milliseconds, 0 to return immediately,
+ *                      -1 to wait indefinitely.
+ *
+ * @return  Number of file descriptors with returned events, 0 on timeout.
+ * @return  -1 on error, errno is set to indicate the error.
+ */
+int poll(struct pollfd *fds, nfds_t nfds, int timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POLL_H */
+/** @} */
@@ -92,6 +92,21 @@ extern "C" {
 #define SOCK_STREAM     (4)     /**< Stream socket */
 /** @} */
 
+/**
+ * @brief   Flag for the type argument of socket() to create the socket with
+ *          O_NONBLOCK set
+ */
+#define SOCK_NONBLOCK   (0x4000)
+
+/**
+ * @name    Message flags
+ * @brief   Flags for the flags argument of recv(), recvfrom(), send() and
+ *          sendto()
+ * @{
+ */
+#define MSG_DONTWAIT    (0x0040)    /**< Do not block, as with O_NONBLOCK */
+/** @} */
+
 #define SOL_SOCKET      (-1)    /**< Options to be accessed at socket level, not protocol level */
 
 /**
@@ -332,8 +347,8 @@ int listen(int socket, int backlog);
  *                          stored.
  * @param[in] length        Specifies the length in bytes of the buffer pointed
  *                          to by the buffer argument.
- * @param[in] flags         Specifies the type of message reception. Support
- *                          for values other than 0 is not implemented yet.
+ * @param[in] flags         Specifies the type of message reception. Only
+ *                          @ref MSG_DONTWAIT is supported.
  * @param[out] address      A null pointer, or points to a sockaddr structure
  *                          in which the sending address is to be stored. The
  *                          length and format of the address depend on the
@@ -369,8 +384,8 @@ ssize_t recvfrom(int socket, void *__restrict buffer, size_t length, int flags,
  * @param[out] buffer   Points to a buffer where the message should be stored.
  * @param[in] length    Specifies the length in bytes of the buffer pointed to
  *                      by the buffer argument.
- * @param[in] flags     Specifies the type of message reception. Support for
- *                      values other than 0 is not implemented yet.
+ * @param[in] flags     Specifies the type of message reception. Only
+ *                      @ref MSG_DONTWAIT is supported.
  *
  * @return  Upon successful completion, recv() shall return the length of the
  *          message in bytes. If no messages are available to be received and
@@ -400,8 +415,9 @@ static inline ssize_t recv(int socket, void *buffer, size_t length, int flags)
  * @param[in] socket        Specifies the socket file descriptor.
  * @param[in] buffer        Points to the buffer containing the message to send.
  * @param[in] length        Specifies the length of the message in bytes.
- * @param[in] flags         Specifies the type of message reception. Support
- *                          for values other than 0 is not implemented yet.
+ * @param[in] flags         Specifies the type of message transmission.
+ *                          @ref MSG_DONTWAIT is accepted, sending a datagram
+ *                          does not block.
  * @param[in] address       Points to a sockaddr structure containing the
  *                          destination address. The length and format of the
  *                          address depend on the address family of the socket.
@@ -440,8 +456,9 @@ ssize_t sendto(int socket, const void *buffer, size_t length, int flags,
  * @param[in] socket    Specifies the socket file descriptor.
  * @param[in] buffer    Points to the buffer containing the message to send.
  * @param[in] length    Specifies the length of the message in bytes.
- * @param[in] flags     Specifies the type of message reception. Support
- *                      for values other than 0 is not implemented yet.
+ * @param[in] flags     Specifies the type of message transmission.
+ *                      @ref MSG_DONTWAIT is accepted, sending a datagram
+ *                      does not block.
  *
  * @return  Upon successful completion, send() shall return the number of bytes
  *          sent. Otherwise, -1 shall be returned and errno set to indicate the
@@ -464,7 +481,8 @@ static inline ssize_t send(int socket, const void *buffer, size_t length,
  *                      and defined in @ref socket.h.
  * @param[in] type      Specifies the type of socket to be created. Valued
  *                      values are prefixed with ``SOCK_`` and defined in
- *                      @ref socket.h.
+ *                      @ref socket.h, optionally or'ed with
+ *                      @ref SOCK_NONBLOCK.
  * @param[in] protocol  Specifies a particular protocol to be used with the
  *                      socket. Specifying a protocol of 0 causes socket() to
  *                      use an unspecified default protocol appropriate for
@@ -24,6 +24,7 @@
 #include <string.h>
 
 #include "bitfield.h"
+#include "irq.h"
 #include "mutex.h"
 #include "net/ipv4/addr.h"
 #include "net/ipv6/addr.h"
@@ -37,6 +38,20 @@
 #include "net/sock/udp.h"
 #include "net/sock/tcp.h"
 
+#ifdef MODULE_POSIX_SELECT
+#include <poll.h>
+#include <sys/select.h>
+
+#include "net/sock/async.h"
+#include "thread.h"
+#include "thread_flags.h"
+#include "xtimer.h"
+
+#ifndef SOCK_HAS_ASYNC
+#error "posix_select: the network stack does not implement sock_async"
+#endif
+#endif
+
 /* enough to create sockets both with socket() and accept() */
 #define _ACTUAL_SOCKET_POOL_SIZE   (SOCKET_POOL_SIZE + \
                                     (SOCKET_POOL_SIZE * SOCKET_TCP_QUEUE_SIZE))
@@ -71,6 +86,11 @@ typedef struct {
     int type;
     int protocol;
     bool bound;
+    bool nonblocking;           /* O_NONBLOCK is set */
+#ifdef MODULE_POSIX_SELECT
+    unsigned available;         /* receive events not read yet */
+    thread_t *waiter;           /* thread waiting in poll() */
+#endif
 #ifdef POSIX_SETSOCKOPT
     uint32_t recv_timeout;
 #endif
@@ -138,6 +158,98 @@ static int _get_sock_idx(socket_sock_t *sock)
     return sock - &_sock_pool[0];
 }
 
+static inline uint32_t _recv_timeout(const socket_t *s, int flags)
+{
+    if (s->nonblocking || (flags & MSG_DONTWAIT)) {
+        return 0;
+    }
+#ifdef POSIX_SETSOCKOPT
+    return s->recv_timeout;
+#else
+    return SOCK_NO_TIMEOUT;
+#endif
+}
+
+#ifdef MODULE_POSIX_SELECT
+static void _async_notify(socket_t *s, sock_async_flags_t flags)
+{
+    if (!(flags & (SOCK_ASYNC_MSG_RECV | SOCK_ASYNC_CONN_RECV |
+                   SOCK_ASYNC_CONN_FIN))) {
+        return;
+    }
+    unsigned state = irq_disable();
+    thread_t *waiter = s->waiter;
+    s->available++;
+    irq_restore(state);
+    if (waiter != NULL) {
+        thread_flags_set(waiter, POSIX_SELECT_THREAD_FLAG);
+    }
+}
+
+#ifdef MODULE_SOCK_IP
+static void _ip_cb(sock_ip_t *sock, sock_async_flags_t flags, void *arg)
+{
+    (void)sock;
+    _async_notify(arg, flags);
+}
+#endif
+
+#ifdef MODULE_SOCK_UDP
+static void _udp_cb(sock_udp_t *sock, sock_async_flags_t flags, void *arg)
+{
+    (void)sock;
+    _async_notify(arg, flags);
+}
+#endif
+
+/* sets the callback for the sock just created for s, stream sockets can't be
+ * polled as sock_async has no TCP callbacks */
+static void _async_init(socket_t *s)
+{
+    s->available = 0;
+    switch (s->type) {
+#ifdef MODULE_SOCK_IP
+        case SOCK_RAW:
+            sock_ip_set_cb(&s->sock->raw, _ip_cb, s);
+            break;
+#endif
+#ifdef MODULE_SOCK_UDP
+        case SOCK_DGRAM:
+            sock_udp_set_cb(&s->sock->udp, _udp_cb, s);
+            break;
+#endif
+        default:
+            break;
+    }
+}
+
+/* accounts for a read from s that returned res, errors other than -EAGAIN
+ * and -ETIMEDOUT dequeued a datagram as well, e.g. -ENOBUFS for one
+ * exceeding the buffer or -EPROTO for one from the wrong peer */
+static void _async_read(socket_t *s, int res)
+{
+    unsigned state = irq_disable();
+    if (res == -EAGAIN) {
+        s->available = 0;
+    }
+    else if ((res != -ETIMEDOUT) && (s->available > 0)) {
+        s->available--;
+    }
+    irq_restore(state);
+}
+#else
+static inline void _async_init(socket_t *s)
+{
+    (void)s;
+}
+
+static inline void _async_read(socket_t *s, int res)
+{
+    (void)s;
+    (void)res;
+}
+#endif
+
 static inline int _choose_ipproto(int type, int protocol)
 {
     switch (type) {
@@ -309,6 +421,20 @@ static inline off_t socket_lseek(vfs_file_t *filp, off_t off, int whence)
     return -ESPIPE; /* see http://pubs.opengroup.org/onlinepubs/9699919799/functions/lseek.html */
 }
 
+static int socket_fcntl(vfs_file_t *filp, int cmd, int arg)
+{
+    socket_t *s = filp->private_data.ptr;
+
+    switch (cmd) {
+        case F_SETFL:
+            s->nonblocking = (arg & O_NONBLOCK);
+            filp->flags = (filp->flags & ~O_NONBLOCK) | (arg & O_NONBLOCK);
+            return 0;
+        default:
+            return -EINVAL;
+    }
+}
+
 static inline ssize_t socket_read(vfs_file_t *filp, void *buf, size_t n)
 {
     return socket_recvfrom(filp->private_data.ptr, buf, n, 0, NULL, NULL);
@@ -321,7 +447,7 @@ static inline ssize_t socket_write(vfs_file_t *filp, const void *buf, size_t n)
 
 static const vfs_file_ops_t socket_ops = {
     .close = socket_close,
-    .fcntl = NULL,          /* TODO: provide when needed */
+    .fcntl = socket_fcntl,
     .fstat = socket_fstat,
     .lseek = socket_lseek,
     .read = socket_read,
@@ -332,6 +458,9 @@ int socket(int domain, int type, int protocol)
 {
     int res = 0;
     socket_t *s;
+    bool nonblocking = (type & SOCK_NONBLOCK);
+
+    type &= ~SOCK_NONBLOCK;
 
     mutex_lock(&_socket_pool_mutex);
     s = _get_free_socket();
@@ -346,7 +475,9 @@ int socket(int domain, int type, int protocol)
         case AF_INET6:
 #endif
         {
-            int fd = vfs_bind(VFS_ANY_FD, O_RDWR, &socket_ops, s);
+            int fd = vfs_bind(VFS_ANY_FD,
+                              O_RDWR | (nonblocking ? O_NONBLOCK : 0),
+                              &socket_ops, s);
 
             if (fd < 0) {
                 errno = ENFILE;
@@ -363,6 +494,11 @@ int socket(int domain, int type, int protocol)
                 break;
             }
             s->bound = false;
+            s->nonblocking = nonblocking;
+#ifdef MODULE_POSIX_SELECT
+            s->available = 0;
+            s->waiter = NULL;
+#endif
             s->sock = NULL;
 #ifdef POSIX_SETSOCKOPT
             s->recv_timeout = SOCK_NO_TIMEOUT;
@@ -408,11 +544,7 @@ int accept(int socket, struct sockaddr *restrict address,
         return -1;
     }
 
-#ifdef POSIX_SETSOCKOPT
-    const uint32_t recv_timeout = s->recv_timeout;
-#else
-    const uint32_t recv_timeout = SOCK_NO_TIMEOUT;
-#endif
+    const uint32_t recv_timeout = _recv_timeout(s, 0);
 
     switch (s->type) {
         case SOCK_STREAM:
@@ -423,8 +555,8 @@ int accept(int socket, struct sockaddr *restrict address,
                 break;
             }
             sock = (sock_tcp_t *)new_s->sock;
-            if ((res = sock_tcp_accept(&s->sock->tcp.queue, &sock,
-                                       recv_timeout)) < 0) {
+            res = sock_tcp_accept(&s->sock->tcp.queue, &sock, recv_timeout);
+            if (res < 0) {
                 errno = -res;
                 res = -1;
                 break;
@@ -459,9 +591,14 @@ int accept(int socket, struct sockaddr *restrict address,
                 new_s->type = s->type;
                 new_s->protocol = s->protocol;
                 new_s->bound = true;
+                new_s->nonblocking = false;
                 new_s->queue_array = NULL;
                 new_s->queue_array_len = 0;
                 new_s->sock = (socket_sock_t *)sock;
+#ifdef MODULE_POSIX_SELECT
+                new_s->waiter = NULL;
+#endif
+                _async_init(new_s);
                 memset(&s->local, 0, sizeof(sock_tcp_ep_t));
             }
             break;
@@ -595,6 +732,7 @@ static int _bind_connect(socket_t *s, const struct sockaddr *address,
         return -1;
     }
     s->sock = sock;
+    _async_init(s);
     return 0;
 }
 
@@ -794,6 +932,7 @@ int listen(int socket, int backlog)
     }
     if (res == 0) {
         s->sock = sock;
+        _async_init(s);
     }
     else {
         errno = -res;
@@ -819,7 +958,6 @@ static ssize_t socket_recvfrom(socket_t *s, void *restrict buffer,
     int res = 0;
     struct _sock_tl_ep ep = { .port = 0 };
 
-    (void)flags;
     if (s == NULL) {
         return -ENOTSOCK;
     }
@@ -835,11 +973,7 @@ static ssize_t socket_recvfrom(socket_t *s, void *restrict buffer,
         }
     }
 
-#ifdef POSIX_SETSOCKOPT
-    const uint32_t recv_timeout = s->recv_timeout;
-#else
-    const uint32_t recv_timeout = SOCK_NO_TIMEOUT;
-#endif
+    const uint32_t recv_timeout = _recv_timeout(s, flags);
 
     switch (s->type) {
 #ifdef MODULE_SOCK_IP
@@ -867,6 +1001,7 @@ static ssize_t socket_recvfrom(socket_t *s, void *restrict buffer,
             res = -EOPNOTSUPP;
             break;
     }
+    _async_read(s, res);
     if ((res >= 0) && (address != NULL) && (address_len != NULL)) {
         switch (s->type) {
 #ifdef MODULE_SOCK_TCP
@@ -1000,6 +1135,184 @@ ssize_t sendto(int socket, const void *buffer, size_t length, int flags,
     return res;
 }
 
+#ifdef MODULE_POSIX_SELECT
+static socket_t *_get_open_socket(int fd)
+{
+    mutex_lock(&_socket_pool_mutex);
+    socket_t *s = _get_socket(fd);
+    mutex_unlock(&_socket_pool_mutex);
+    return ((s != NULL) && (s->domain != AF_UNSPEC)) ? s : NULL;
+}
+
+static short _revents(socket_t *s)
+{
+    if (s->type == SOCK_STREAM) {
+        /* the stack would never notify about events */
+        return POLLNVAL;
+    }
+    if ((s->sock == NULL) && s->bound) {
+        /* create the sock to receive with, as recvfrom() would */
+        if (_bind_connect(s, NULL, 0) < 0) {
+            return POLLERR;
+        }
+    }
+    if (s->sock == NULL) {
+        return POLLOUT | POLLWRNORM;
+    }
+
+    short revents = POLLOUT | POLLWRNORM;
+    if (s->available > 0) {
+        revents |= POLLIN | POLLRDNORM;
+    }
+    return revents;
+}
+
+static void _set_waiter(struct pollfd *fds, nfds_t nfds, thread_t *waiter)
+{
+    for (nfds_t i = 0; i < nfds; i++) {
+        socket_t *s = (fds[i].fd < 0) ? NULL : _get_open_socket(fds[i].fd);
+        if (s == NULL) {
+            continue;
+        }
+        unsigned state = irq_disable();
+        if ((waiter != NULL) || (s->waiter == sched_active_thread)) {
+            s->waiter = waiter;
+        }
+        irq_restore(state);
+    }
+}
+
+static int _poll_once(struct pollfd *fds, nfds_t nfds)
+{
+    int res = 0;
+
+    for (nfds_t i = 0; i < nfds; i++) {
+        fds[i].revents = 0;
+        if (fds[i].fd < 0) {
+            continue;
+        }
+        socket_t *s = _get_open_socket(fds[i].fd);
+        if (s == NULL) {
+            fds[i].revents = POLLNVAL;
+        }
+        else {
+            fds[i].revents = _revents(s) &
+                             (fds[i].events | POLLERR | POLLHUP | POLLNVAL);
+        }
+        if (fds[i].revents) {
+            res++;
+        }
+    }
+    return res;
+}
+
+/* timeout in microseconds or SOCK_NO_TIMEOUT */
+static int _poll(struct pollfd *fds, nfds_t nfds, uint32_t timeout)
+{
+    thread_t *me = (thread_t *)sched_active_thread;
+    xtimer_t timer;
+    bool timer_set = false;
+    int res;
+
+    thread_flags_clear(POSIX_SELECT_THREAD_FLAG | THREAD_FLAG_TIMEOUT);
+    /* set the waiter before checking, so no notification is missed */
+    _set_waiter(fds, nfds, me);
+    while (((res = _poll_once(fds, nfds)) == 0) && (timeout != 0)) {
+        if ((timeout != SOCK_NO_TIMEOUT) && !timer_set) {
+            xtimer_set_timeout_flag(&timer, timeout);
+            timer_set = true;
+        }
+        if (thread_flags_wait_any(POSIX_SELECT_THREAD_FLAG |
+                                  THREAD_FLAG_TIMEOUT) & THREAD_FLAG_TIMEOUT) {
+            res = _poll_once(fds, nfds);
+            break;
+        }
+    }
+    if (timer_set) {
+        xtimer_remove(&timer);
+    }
+    _set_waiter(fds, nfds, NULL);
+    return res;
+}
+
+int poll(struct pollfd *fds, nfds_t nfds, int timeout)
+{
+    uint32_t timeout_us = SOCK_NO_TIMEOUT;
+
+    if (timeout >= 0) {
+        timeout_us = ((uint32_t)timeout < (SOCK_NO_TIMEOUT / US_PER_MS))
+                   ? (uint32_t)timeout * US_PER_MS : (SOCK_NO_TIMEOUT - 1);
+    }
+    return _poll(fds, nfds, timeout_us);
+}
+
+int select(int nfds, fd_set *restrict readfds, fd_set *restrict writefds,
+           fd_set *restrict errorfds, struct timeval *restrict timeout)
+{
+    struct pollfd fds[_ACTUAL_SOCKET_POOL_SIZE];
+    nfds_t num = 0;
+    uint32_t timeout_us = SOCK_NO_TIMEOUT;
+
+    if ((nfds < 0) || (nfds > FD_SETSIZE)) {
+        errno = EINVAL;
+        return -1;
+    }
+    for (int fd = 0; fd < nfds; fd++) {
+        short events = 0;
+        if ((readfds != NULL) && FD_ISSET(fd, readfds)) {
+            events |= POLLIN;
+        }
+        if ((writefds != NULL) && FD_ISSET(fd, writefds)) {
+            events |= POLLOUT;
+        }
+        if (!events && ((errorfds == NULL) || !FD_ISSET(fd, errorfds))) {
+            continue;
+        }
+        /* there can't be more open sockets, stream sockets can't be polled */
+        socket_t *s = _get_open_socket(fd);
+        if ((num == ARRAY_SIZE(fds)) || (s == NULL) || (s->type == SOCK_STREAM)) {
+            errno = EBADF;
+            return -1;
+        }
+        fds[num].fd = fd;
+        fds[num].events = events;
+        num++;
+    }
+    if (timeout != NULL) {
+        if ((timeout->tv_sec < 0) || (timeout->tv_usec < 0)) {
+            errno = EINVAL;
+            return -1;
+        }
+        uint64_t us = (uint64_t)timeout->tv_sec * US_PER_SEC + timeout->tv_usec;
+        timeout_us = (us < SOCK_NO_TIMEOUT) ? us : (SOCK_NO_TIMEOUT - 1);
+    }
+
+    _poll(fds, num, timeout_us);
+
+    /* the sets only keep the descriptors that are ready */
+    for (nfds_t i = 0; i < num; i++) {
+        int fd = fds[i].fd;
+        if ((readfds != NULL) && !(fds[i].revents & (POLLIN | POLLHUP))) {
+            FD_CLR(fd, readfds);
+        }
+        if ((writefds != NULL) && !(fds[i].revents & POLLOUT)) {
+            FD_CLR(fd, writefds);
+        }
+        if ((errorfds != NULL) && !(fds[i].revents & POLLERR)) {
+            FD_CLR(fd, errorfds);
+        }
+    }
+    /* select() counts the bits set, not the descriptors */
+    int res = 0;
+    for (int fd = 0; fd < nfds; fd++) {
+        res += ((readfds != NULL) && FD_ISSET(fd, readfds)) +
+               ((writefds != NULL) && FD_ISSET(fd, writefds)) +
+               ((errorfds != NULL) && FD_ISSET(fd, errorfds));
+    }
+    return res;
+}
+#endif /* MODULE_POSIX_SELECT */
+
 /*
  * This is a partial implementation of setsockopt for changing the receive
  * timeout value of a socket.
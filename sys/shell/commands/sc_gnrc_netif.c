@@ -130,6 +130,13 @@ static int _netif_stats(kernel_pid_t iface, unsigned module, bool reset)
                (unsigned) stats->tx_bytes,
                (unsigned) stats->tx_success,
                (unsigned) stats->tx_failed);
+        if (stats->rx_wakeups > 0) {
+            printf("            RX wake-ups %u (packets per wake-up: "
+                   "avg %u max %u)\n",
+                   (unsigned) stats->rx_wakeups,
+                   (unsigned) (stats->rx_count / stats->rx_wakeups),
+                   (unsigned) stats->rx_batch_max);
+        }
         res = 0;
     }
     return res;
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_shell_commands
+ * @{
+ *
+ * @file
+ * @brief       Shell command for the kernel event tracer
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ktrace.h"
+
+/* bytes per line of a hex dump */
+#define LINE_LEN    (32U)
+
+static int _write_hex(void *arg, const void *data, size_t len)
+{
+    unsigned *col = arg;
+    const uint8_t *pos = data;
+
+    while (len--) {
+        printf("%02x", *pos++);
+        if (++(*col) == LINE_LEN) {
+            puts("");
+            *col = 0;
+        }
+    }
+    return 0;
+}
+
+static void _usage(const char *cmd)
+{
+    printf("usage: %s start|stop|clear|dump", cmd);
+#ifdef CPU_NATIVE
+    printf(" [<host file>]");
+#endif
+    puts("");
+}
+
+int _ktrace_handler(int argc, char **argv)
+{
+    if (argc < 2) {
+        _usage(argv[0]);
+        return 1;
+    }
+
+    if (strcmp(argv[1], "start") == 0) {
+        ktrace_start();
+    }
+    else if (strcmp(argv[1], "stop") == 0) {
+        ktrace_stop();
+    }
+    else if (strcmp(argv[1], "clear") == 0) {
+        ktrace_clear();
+    }
+    else if ((strcmp(argv[1], "dump") == 0) && (argc == 2)) {
+        unsigned col = 0;
+
+        puts("ktrace: begin");
+        ktrace_dump(_write_hex, &col);
+        if (col) {
+            puts("");
+        }
+        puts("ktrace: end");
+    }
+#ifdef CPU_NATIVE
+    else if ((strcmp(argv[1], "dump") == 0) && (argc == 3)) {
+        int res = ktrace_dump_file(argv[2]);
+        if (res < 0) {
+            printf("error: unable to write %s (%d)\n", argv[2], res);
+            return 1;
+        }
+    }
+#endif
+    else {
+        _usage(argv[0]);
+        return 1;
+    }
+    return 0;
+}
@@ -17,16 +17,27 @@
  * @}
  */
 
+#include <string.h>
+
 #include "tsrb.h"
 
+/* The data must be copied before the counter update makes it visible to the
+ * other side, so prevent the compiler from reordering across it */
+#define _BARRIER()      __asm__ volatile ("" : : : "memory")
+
 static void _push(tsrb_t *rb, uint8_t c)
 {
-    rb->buf[rb->writes++ & (rb->size - 1)] = c;
+    rb->buf[rb->writes & (rb->size - 1)] = c;
+    _BARRIER();
+    rb->writes++;
 }
 
 static uint8_t _pop(tsrb_t *rb)
 {
-    return rb->buf[rb->reads++ & (rb->size - 1)];
+    uint8_t c = rb->buf[rb->reads & (rb->size - 1)];
+    _BARRIER();
+    rb->reads++;
+    return c;
 }
 
 int tsrb_get_one(tsrb_t *rb)
@@ -41,22 +52,34 @@ int tsrb_get_one(tsrb_t *rb)
 
 int tsrb_get(tsrb_t *rb, uint8_t *dst, size_t n)
 {
-    size_t tmp = n;
-    while (tmp && !tsrb_empty(rb)) {
-        *dst++ = _pop(rb);
-        tmp--;
+    unsigned reads = rb->reads;
+    unsigned avail = rb->writes - reads;
+    unsigned pos = reads & (rb->size - 1);
+
+    if (n > avail) {
+        n = avail;
     }
-    return (n - tmp);
+    /* at most two copies: up to the end of the buffer and from its start */
+    size_t first = rb->size - pos;
+    if (first > n) {
+        first = n;
+    }
+    memcpy(dst, &rb->buf[pos], first);
+    memcpy(dst + first, rb->buf, n - first);
+    _BARRIER();
+    rb->reads = reads + n;
+    return n;
 }
 
 int tsrb_drop(tsrb_t *rb, size_t n)
 {
-    size_t tmp = n;
-    while (tmp && !tsrb_empty(rb)) {
-        _pop(rb);
-        tmp--;
+    unsigned avail = tsrb_avail(rb);
+
+    if (n > avail) {
+        n = avail;
     }
-    return (n - tmp);
+    rb->reads += n;
+    return n;
 }
 
 int tsrb_add_one(tsrb_t *rb, uint8_t c)
@@ -72,10 +95,56 @@ int tsrb_add_one(tsrb_t *rb, uint8_t c)
 
 int tsrb_add(tsrb_t *rb, const uint8_t *src, size_t n)
 {
-    size_t tmp = n;
-    while (tmp && !tsrb_full(rb)) {
-        _push(rb, *src++);
-        tmp--;
+    unsigned writes = rb->writes;
+    unsigned free = rb->size - (writes - rb->reads);
+    unsigned pos = writes & (rb->size - 1);
+
+    if (n > free) {
+        n = free;
     }
-    return (n - tmp);
+    size_t first = rb->size - pos;
+    if (first > n) {
+        first = n;
+    }
+    memcpy(&rb->buf[pos], src, first);
+    memcpy(rb->buf, src + first, n - first);
+    _BARRIER();
+    rb->writes = writes + n;
+    return n;
+}
+
+unsigned tsrb_get_read_span(const tsrb_t *rb, uint8_t **data)
+{
+    unsigned reads = rb->reads;
+    unsigned avail = rb->writes - reads;
+    unsigned pos = reads & (rb->size - 1);
+    unsigned len = rb->size - pos;
+
+    *data = &rb->buf[pos];
+    return (avail < len) ? avail : len;
+}
+
+void tsrb_commit_read(tsrb_t *rb, unsigned n)
+{
+    assert(n <= tsrb_avail(rb));
+    _BARRIER();
+    rb->reads += n;
+}
+
+unsigned tsrb_get_write_span(const tsrb_t *rb, uint8_t **data)
+{
+    unsigned writes = rb->writes;
+    unsigned free = rb->size - (writes - rb->reads);
+    unsigned pos = writes & (rb->size - 1);
+    unsigned len = rb->size - pos;
+
+    *data = &rb->buf[pos];
+    return (free < len) ? free : len;
+}
+
+void tsrb_commit_write(tsrb_t *rb, unsigned n)
+{
+    assert(n <= tsrb_free(rb));
+    _BARRIER();
+    rb->writes += n;
 }
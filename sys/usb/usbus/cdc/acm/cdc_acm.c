@@ -292,12 +292,11 @@ static void _handle_in(usbus_cdcacm_device_t *cdcacm,
         (cdcacm->state != USBUS_CDC_ACM_LINE_STATE_DTE)) {
         return;
     }
-    while (!tsrb_empty(&cdcacm->tsrb)) {
-        int c = tsrb_get_one(&cdcacm->tsrb);
-        ep->buf[cdcacm->occupied++] = (uint8_t)c;
-        if (cdcacm->occupied >= USBUS_CDC_ACM_BULK_EP_SIZE) {
-            break;
-        }
+    if (cdcacm->occupied < USBUS_CDC_ACM_BULK_EP_SIZE) {
+        cdcacm->occupied += tsrb_get(&cdcacm->tsrb,
+                                     &ep->buf[cdcacm->occupied],
+                                     USBUS_CDC_ACM_BULK_EP_SIZE -
+                                     cdcacm->occupied);
     }
     usbdev_ep_ready(ep, cdcacm->occupied);
 }
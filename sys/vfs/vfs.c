@@ -28,6 +28,7 @@
 #include "thread.h"
 #include "kernel_types.h"
 #include "clist.h"
+#include "bitarithm.h"
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
@@ -50,12 +51,27 @@
  */
 static vfs_file_t _vfs_open_files[VFS_MAX_OPEN_FILES];
 
+/**
+ * @internal
+ * @brief Number of fd numbers per word of _vfs_fd_used
+ */
+#define VFS_FD_WORD_BITS    (sizeof(unsigned) * 8)
+
+/**
+ * @internal
+ * @brief Bitmap of the used entries in _vfs_open_files
+ *
+ * Lets _allocate_fd find a free entry without scanning the whole table.
+ */
+static unsigned _vfs_fd_used[(VFS_MAX_OPEN_FILES + VFS_FD_WORD_BITS - 1) / VFS_FD_WORD_BITS];
+
 /**
  * @internal
  * @brief List handle for list of all currently mounted file systems
  *
  * This singly linked list is used to dispatch vfs calls to the appropriate file
- * system driver.
+ * system driver. It is sorted by decreasing mount point length, so the first
+ * mount point matching a path is its longest matching prefix.
  */
 static clist_node_t _vfs_mounts_list;
 
@@ -67,9 +83,8 @@ static clist_node_t _vfs_mounts_list;
  * corresponding slot in the open files table is already occupied, no iteration
  * is done to find another free number in this case.
  *
- * If the @p fd argument is negative, the algorithm will iterate through the
- * open files table until it find an unused slot and return the number of that
- * slot.
+ * If the @p fd argument is negative, the lowest unused slot is taken from the
+ * _vfs_fd_used bitmap and its number is returned.
  *
  * @param[in]  fd  Desired fd number, use VFS_ANY_FD for any free fd
  *
@@ -132,6 +147,38 @@ static inline int _fd_is_valid(int fd);
 static mutex_t _mount_mutex = MUTEX_INIT;
 static mutex_t _open_mutex = MUTEX_INIT;
 
+#ifdef MODULE_VFS_DCACHE
+/**
+ * @internal
+ * @brief Entry of the path lookup cache
+ */
+typedef struct {
+    const vfs_mount_t *mp;  /**< mount of the path, NULL if unused */
+    void *node;             /**< driver object the path resolves to */
+    uint32_t used;          /**< _dcache_stamp of the last use */
+    uint16_t hash;          /**< hash of path */
+    char path[VFS_DCACHE_PATH_MAX + 1]; /**< path relative to mp */
+} _dcache_entry_t;
+
+static _dcache_entry_t _dcache[VFS_DCACHE_SIZE];
+static uint32_t _dcache_stamp;
+
+/**
+ * @internal
+ * @brief Serializes modifications of _dcache
+ */
+static mutex_t _dcache_mutex = MUTEX_INIT;
+
+/**
+ * @internal
+ * @brief Modification counter of _dcache, odd while it is modified
+ *
+ * Lookups do not lock _dcache_mutex, they are discarded if the counter
+ * changed while they were running.
+ */
+static atomic_uint _dcache_seq;
+#endif
+
 int vfs_close(int fd)
 {
     DEBUG("vfs_close: %d\n", fd);
@@ -462,6 +509,18 @@ int vfs_format(vfs_mount_t *mountp)
     return -ENOTSUP;
 }
 
+/**
+ * @internal
+ * @brief Order mounts by decreasing mount point length for clist_sort
+ */
+static int _mount_cmp(clist_node_t *a, clist_node_t *b)
+{
+    size_t len_a = container_of(a, vfs_mount_t, list_entry)->mount_point_len;
+    size_t len_b = container_of(b, vfs_mount_t, list_entry)->mount_point_len;
+
+    return (len_a < len_b) ? 1 : (len_a > len_b) ? -1 : 0;
+}
+
 int vfs_mount(vfs_mount_t *mountp)
 {
     DEBUG("vfs_mount: %p\n", (void *)mountp);
@@ -481,8 +540,9 @@ int vfs_mount(vfs_mount_t *mountp)
             }
         }
     }
-    /* insert last in list */
+    /* insert last in list, then move before all shorter mount points */
     clist_rpush(&_vfs_mounts_list, &mountp->list_entry);
+    clist_sort(&_vfs_mounts_list, _mount_cmp);
     mutex_unlock(&_mount_mutex);
     DEBUG("vfs_mount: mount done\n");
     return 0;
@@ -530,6 +590,7 @@ int vfs_umount(vfs_mount_t *mountp)
         return -EINVAL;
     }
     mutex_unlock(&_mount_mutex);
+    vfs_dcache_invalidate(mountp, NULL);
     return 0;
 }
 
@@ -575,6 +636,8 @@ int vfs_rename(const char *from_path, const char *to_path)
         return -EXDEV;
     }
     res = mountp->fs->fs_op->rename(mountp, rel_from, rel_to);
+    /* cached paths below a renamed directory become invalid as well */
+    vfs_dcache_invalidate(mountp, NULL);
     DEBUG("vfs_rename: rename %p, \"%s\" -> \"%s\"", (void *)mountp, rel_from, rel_to);
     if (res < 0) {
         /* something went wrong during rename */
@@ -615,6 +678,7 @@ int vfs_unlink(const char *name)
         return -EPERM;
     }
     res = mountp->fs->fs_op->unlink(mountp, rel_path);
+    vfs_dcache_invalidate(mountp, rel_path);
     DEBUG("vfs_unlink: unlink %p, \"%s\"", (void *)mountp, rel_path);
     if (res < 0) {
         /* something went wrong during unlink */
@@ -689,6 +753,7 @@ int vfs_rmdir(const char *name)
         return -EPERM;
     }
     res = mountp->fs->fs_op->rmdir(mountp, rel_path);
+    vfs_dcache_invalidate(mountp, rel_path);
     DEBUG("vfs_rmdir: rmdir %p, \"%s\"", (void *)mountp, rel_path);
     if (res < 0) {
         /* something went wrong during rmdir */
@@ -864,18 +929,142 @@ const vfs_mount_t *vfs_iterate_mounts(const vfs_mount_t *cur)
     return container_of(node, vfs_mount_t, list_entry);
 }
 
+#ifdef MODULE_VFS_DCACHE
+/**
+ * @internal
+ * @brief Hash @p path for the path lookup cache
+ *
+ * @return hash of @p path
+ * @return -1 if @p path is too long to be cached
+ */
+static int _dcache_hash(const char *path)
+{
+    /* FNV-1a, folded to 16 bit */
+    uint32_t hash = 2166136261LU;
+    size_t len = 0;
+
+    for (; path[len] != '\0'; ++len) {
+        if (len >= VFS_DCACHE_PATH_MAX) {
+            return -1;
+        }
+        hash = (hash ^ (uint8_t)path[len]) * 16777619LU;
+    }
+    return (hash ^ (hash >> 16)) & 0xffff;
+}
+
+static void _dcache_modify_begin(void)
+{
+    mutex_lock(&_dcache_mutex);
+    atomic_store(&_dcache_seq, atomic_load(&_dcache_seq) + 1);
+}
+
+static void _dcache_modify_end(void)
+{
+    atomic_store(&_dcache_seq, atomic_load(&_dcache_seq) + 1);
+    mutex_unlock(&_dcache_mutex);
+}
+
+/**
+ * @internal
+ * @brief Find the entry of @p path
+ */
+static _dcache_entry_t *_dcache_find(const vfs_mount_t *mountp,
+                                     const char *path, int hash)
+{
+    for (unsigned i = 0; i < VFS_DCACHE_SIZE; ++i) {
+        _dcache_entry_t *e = &_dcache[i];
+        if ((e->mp == mountp) && (e->hash == hash) &&
+            (strcmp(e->path, path) == 0)) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+void *vfs_dcache_lookup(const vfs_mount_t *mountp, const char *path)
+{
+    int hash = _dcache_hash(path);
+    void *node = NULL;
+
+    if ((mountp == NULL) || (hash < 0)) {
+        return NULL;
+    }
+    unsigned seq = atomic_load(&_dcache_seq);
+    if (seq & 1) {
+        /* being modified */
+        return NULL;
+    }
+    _dcache_entry_t *e = _dcache_find(mountp, path, hash);
+    if (e != NULL) {
+        /* a lost update only makes the replacement order less exact */
+        e->used = ++_dcache_stamp;
+        node = e->node;
+    }
+    if (atomic_load(&_dcache_seq) != seq) {
+        /* modified while searching, the result may be inconsistent */
+        node = NULL;
+    }
+    DEBUG("vfs_dcache_lookup: %p, \"%s\" -> %p\n", (void *)mountp, path, node);
+    return node;
+}
+
+void vfs_dcache_add(const vfs_mount_t *mountp, const char *path, void *node)
+{
+    int hash = _dcache_hash(path);
+
+    if ((mountp == NULL) || (hash < 0)) {
+        return;
+    }
+    _dcache_modify_begin();
+    _dcache_entry_t *e = _dcache_find(mountp, path, hash);
+    if (e == NULL) {
+        /* replace the least recently used entry, unused entries first */
+        e = &_dcache[0];
+        for (unsigned i = 1; (e->mp != NULL) && (i < VFS_DCACHE_SIZE); ++i) {
+            if ((_dcache[i].mp == NULL) || (_dcache[i].used < e->used)) {
+                e = &_dcache[i];
+            }
+        }
+        e->mp = mountp;
+        e->hash = hash;
+        strcpy(e->path, path);
+    }
+    e->node = node;
+    e->used = ++_dcache_stamp;
+    _dcache_modify_end();
+}
+
+void vfs_dcache_invalidate(const vfs_mount_t *mountp, const char *path)
+{
+    _dcache_modify_begin();
+    for (unsigned i = 0; i < VFS_DCACHE_SIZE; ++i) {
+        _dcache_entry_t *e = &_dcache[i];
+        if ((e->mp != NULL) &&
+            ((mountp == NULL) || (e->mp == mountp)) &&
+            ((path == NULL) || (strcmp(e->path, path) == 0))) {
+            e->mp = NULL;
+        }
+    }
+    _dcache_modify_end();
+}
+#endif
+
 static inline int _allocate_fd(int fd)
 {
     if (fd < 0) {
-        for (fd = 0; fd < VFS_MAX_OPEN_FILES; ++fd) {
-            if ((fd == STDIN_FILENO) || (fd == STDOUT_FILENO) || (fd == STDERR_FILENO)) {
+        fd = VFS_MAX_OPEN_FILES;
+        for (unsigned i = 0; i < ARRAY_SIZE(_vfs_fd_used); ++i) {
+            unsigned free_fds = ~_vfs_fd_used[i];
+            if (i == 0) {
                 /* Do not auto-allocate the stdio file descriptor numbers to
                  * avoid conflicts between normal file system users and stdio
                  * drivers such as stdio_uart, stdio_rtt which need to be able
                  * to bind to these specific file descriptor numbers. */
-                continue;
+                free_fds &= ~((1U << STDIN_FILENO) | (1U << STDOUT_FILENO) |
+                              (1U << STDERR_FILENO));
             }
-            if (_vfs_open_files[fd].pid == KERNEL_PID_UNDEF) {
+            if (free_fds) {
+                fd = i * VFS_FD_WORD_BITS + bitarithm_lsb(free_fds);
                 break;
             }
         }
@@ -895,6 +1084,7 @@ static inline int _allocate_fd(int fd)
         pid = -1;
     }
     _vfs_open_files[fd].pid = pid;
+    _vfs_fd_used[fd / VFS_FD_WORD_BITS] |= 1U << (fd % VFS_FD_WORD_BITS);
     return fd;
 }
 
@@ -905,6 +1095,7 @@ static inline void _free_fd(int fd)
         atomic_fetch_sub(&_vfs_open_files[fd].mp->open_files, 1);
     }
     _vfs_open_files[fd].pid = KERNEL_PID_UNDEF;
+    _vfs_fd_used[fd / VFS_FD_WORD_BITS] &= ~(1U << (fd % VFS_FD_WORD_BITS));
 }
 
 static inline int _init_fd(int fd, const vfs_file_ops_t *f_op, vfs_mount_t *mountp, int flags, void *private_data)
@@ -939,10 +1130,6 @@ static inline int _find_mount(vfs_mount_t **mountpp, const char *name, const cha
         node = node->next;
         vfs_mount_t *it = container_of(node, vfs_mount_t, list_entry);
         size_t len = it->mount_point_len;
-        if (len < longest_match) {
-            /* Already found a longer prefix */
-            continue;
-        }
         if (len > name_len) {
             /* path name is shorter than the mount point name */
             continue;
@@ -957,7 +1144,9 @@ static inline int _find_mount(vfs_mount_t **mountpp, const char *name, const cha
             if (len > 1) {
                 longest_match = len;
             }
+            /* the list is sorted by length, this is the longest match */
             mountp = it;
+            break;
         }
     } while (node != _vfs_mounts_list.next);
     if (mountp == NULL) {
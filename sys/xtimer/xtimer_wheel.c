@@ -0,0 +1,494 @@
+/**
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup sys_xtimer
+ *
+ * @{
+ * @file
+ * @brief xtimer core functionality based on a hierarchical timer wheel
+ *
+ * Replaces xtimer_core.c when the `xtimer_wheel` module is used. Armed timers
+ * are hashed by their absolute 64 bit target into @ref XTIMER_WHEEL_LEVELS
+ * levels of 2^@ref XTIMER_WHEEL_BITS buckets, so setting and removing a timer
+ * takes constant time regardless of the number of armed timers. A bucket is
+ * cascaded to the next finer level once the wheel reaches its start; only
+ * timers due within the current slot are kept sorted.
+ * @}
+ */
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "bitarithm.h"
+#include "board.h"
+#include "periph/timer.h"
+#include "periph_conf.h"
+
+#include "xtimer.h"
+#include "irq.h"
+
+/* WARNING! enabling this will have side effects and can lead to timer underflows. */
+#define ENABLE_DEBUG 0
+#include "debug.h"
+
+#define SLOT_SHIFT      (XTIMER_WHEEL_SLOT_SHIFT)
+#define LEVEL_BITS      (XTIMER_WHEEL_BITS)
+#define LEVEL_SLOTS     (1U << LEVEL_BITS)
+#define LEVEL_MASK      (LEVEL_SLOTS - 1)
+#define RANGE_BITS      (LEVEL_BITS * XTIMER_WHEEL_LEVELS)
+#define NO_EVENT        (UINT64_MAX)
+
+static volatile int _in_handler = 0;
+
+static volatile uint32_t _long_cnt = 0;
+#if XTIMER_MASK
+volatile uint32_t _xtimer_high_cnt = 0;
+#endif
+
+/* bucket heads of all levels, level 0 has the finest granularity */
+static xtimer_t *_wheel[XTIMER_WHEEL_LEVELS][LEVEL_SLOTS];
+/* non-empty buckets of each level, bits of emptied buckets are cleared lazily */
+static unsigned _occupied[XTIMER_WHEEL_LEVELS];
+/* timers due within the current slot, sorted by target */
+static xtimer_t *_near = NULL;
+/* timers beyond the range of the wheel */
+static xtimer_t *_far = NULL;
+/* slot the wheel has been advanced to */
+static uint64_t _wheel_slot = 0;
+/* time of the event the low-level timer is currently set for */
+static uint64_t _armed = 0;
+/* low-level timer is set for the end of the current period */
+static int _armed_period_end = 0;
+
+static void _timer_callback(void);
+static void _periph_timer_callback(void *arg, int chan);
+
+static inline uint64_t _target(const xtimer_t *timer)
+{
+    return ((uint64_t)timer->long_target << 32) | timer->target;
+}
+
+/* xtimer_set() is commonly used on uninitialized timers on the stack, so prev
+ * may only be followed if the check word matches */
+static inline int _is_set(const xtimer_t *timer)
+{
+    return (timer->target || timer->long_target) &&
+           (timer->check == ((uintptr_t)timer->prev ^ (uintptr_t)timer)) &&
+           (*timer->prev == timer);
+}
+
+static inline void _set_prev(xtimer_t *timer, xtimer_t **prev)
+{
+    timer->prev = prev;
+    timer->check = (uintptr_t)prev ^ (uintptr_t)timer;
+}
+
+static inline void xtimer_spin_until(uint32_t target)
+{
+#if XTIMER_MASK
+    target = _xtimer_lltimer_mask(target);
+#endif
+    while (_xtimer_lltimer_now() > target) {}
+    while (_xtimer_lltimer_now() < target) {}
+}
+
+static inline void _lltimer_set(uint32_t target)
+{
+    if (_in_handler) {
+        return;
+    }
+    DEBUG("_lltimer_set(): setting %" PRIu32 "\n", _xtimer_lltimer_mask(target));
+    timer_set_absolute(XTIMER_DEV, XTIMER_CHAN, _xtimer_lltimer_mask(target));
+}
+
+static inline uint64_t _period_end(void)
+{
+    uint64_t base = (uint64_t)_long_cnt << 32;
+
+#if XTIMER_MASK
+    base |= _xtimer_high_cnt;
+#endif
+    return base + _xtimer_lltimer_mask(0xFFFFFFFF);
+}
+
+static void _link(xtimer_t **head, xtimer_t *timer)
+{
+    timer->next = *head;
+    _set_prev(timer, head);
+    if (*head) {
+        _set_prev(*head, &timer->next);
+    }
+    *head = timer;
+}
+
+static void _unlink(xtimer_t *timer)
+{
+    *timer->prev = timer->next;
+    if (timer->next) {
+        _set_prev(timer->next, timer->prev);
+    }
+    timer->check = 0;
+}
+
+/**
+ * @brief put a timer into the near list, the wheel or the far list, depending
+ *        on the distance of its target to the current wheel position
+ */
+static void _add(xtimer_t *timer)
+{
+    uint64_t slot = _target(timer) >> SLOT_SHIFT;
+    uint64_t diff = slot ^ _wheel_slot;
+
+    if (slot <= _wheel_slot) {
+        xtimer_t **pos = &_near;
+
+        while (*pos && (_target(*pos) <= _target(timer))) {
+            pos = &((*pos)->next);
+        }
+        _link(pos, timer);
+        return;
+    }
+    /* the highest bit in which the target differs from the current position
+     * selects the level, so the bucket is always ahead of the wheel */
+    for (unsigned level = 0; level < XTIMER_WHEEL_LEVELS; level++) {
+        diff >>= LEVEL_BITS;
+        if (!diff) {
+            unsigned idx = (slot >> (level * LEVEL_BITS)) & LEVEL_MASK;
+
+            _link(&_wheel[level][idx], timer);
+            _occupied[level] |= 1U << idx;
+            return;
+        }
+    }
+    _link(&_far, timer);
+}
+
+/**
+ * @brief get the first slot covered by the earliest non-empty bucket
+ *
+ * @param[out] list bucket head, &_far if the far list is due first
+ *
+ * @return  NO_EVENT if there are no timers on the wheel and in the far list
+ */
+static uint64_t _next_bucket(xtimer_t ***list)
+{
+    for (unsigned level = 0; level < XTIMER_WHEEL_LEVELS; level++) {
+        while (_occupied[level]) {
+            unsigned idx = bitarithm_lsb(_occupied[level]);
+            unsigned shift = level * LEVEL_BITS;
+
+            if (!_wheel[level][idx]) {
+                _occupied[level] &= ~(1U << idx);
+                continue;
+            }
+            *list = &_wheel[level][idx];
+            return ((_wheel_slot >> (shift + LEVEL_BITS)) << (shift + LEVEL_BITS)) |
+                   ((uint64_t)idx << shift);
+        }
+    }
+    if (_far) {
+        *list = &_far;
+        return ((_wheel_slot >> RANGE_BITS) + 1) << RANGE_BITS;
+    }
+    return NO_EVENT;
+}
+
+/**
+ * @brief advance the wheel to @p slot, cascading all buckets reached on the
+ *        way
+ */
+static void _advance(uint64_t slot)
+{
+    xtimer_t **bucket;
+    uint64_t next;
+
+    while ((next = _next_bucket(&bucket)) <= slot) {
+        xtimer_t *timer = *bucket;
+
+        *bucket = NULL;
+        _wheel_slot = next;
+        while (timer) {
+            xtimer_t *tmp = timer->next;
+
+            _add(timer);
+            timer = tmp;
+        }
+    }
+    if (slot > _wheel_slot) {
+        _wheel_slot = slot;
+    }
+}
+
+static uint64_t _next_event(void)
+{
+    xtimer_t **bucket;
+    uint64_t next;
+
+    if (_near) {
+        return _target(_near);
+    }
+    next = _next_bucket(&bucket);
+    return (next == NO_EVENT) ? NO_EVENT : (next << SLOT_SHIFT);
+}
+
+void xtimer_init(void)
+{
+    static_assert(LEVEL_SLOTS <= (8 * sizeof(unsigned)),
+                  "XTIMER_WHEEL_BITS too large for the bucket bitmap");
+    static_assert((SLOT_SHIFT + RANGE_BITS) < 64,
+                  "XTIMER_WHEEL_LEVELS too large");
+
+    /* initialize low-level timer */
+    timer_init(XTIMER_DEV, XTIMER_HZ, _periph_timer_callback, NULL);
+
+    /* register initial overflow tick */
+    _armed = _period_end();
+    _armed_period_end = 1;
+    _lltimer_set(0xFFFFFFFF);
+}
+
+static void _xtimer_now_internal(uint32_t *short_term, uint32_t *long_term)
+{
+    uint32_t before, after, long_value;
+
+    /* loop to cope with possible overflow of _xtimer_now() */
+    do {
+        before = _xtimer_now();
+        long_value = _long_cnt;
+        after = _xtimer_now();
+
+    } while (before > after);
+
+    *short_term = after;
+    *long_term = long_value;
+}
+
+uint64_t _xtimer_now64(void)
+{
+    uint32_t short_term, long_term;
+
+    _xtimer_now_internal(&short_term, &long_term);
+
+    return ((uint64_t)long_term << 32) + short_term;
+}
+
+static void _shoot(xtimer_t *timer)
+{
+    timer->callback(timer->arg);
+}
+
+/* needs interrupts to be disabled */
+static void _set(xtimer_t *timer, uint64_t target)
+{
+    if (_is_set(timer)) {
+        _unlink(timer);
+    }
+    timer->target = (uint32_t)target;
+    timer->long_target = (uint32_t)(target >> 32);
+    _add(timer);
+
+    /* the timer handler reprograms the low-level timer after running the
+     * callbacks anyway */
+    if (!_in_handler && (target < _armed)) {
+        DEBUG("_set(): timer is the next event. updating lltimer.\n");
+        _armed = target;
+        _armed_period_end = 0;
+        _lltimer_set((uint32_t)target - XTIMER_OVERHEAD);
+    }
+}
+
+void _xtimer_set64(xtimer_t *timer, uint32_t offset, uint32_t long_offset)
+{
+    DEBUG(" _xtimer_set64() offset=%" PRIu32 " long_offset=%" PRIu32 "\n", offset, long_offset);
+    if (!long_offset) {
+        /* timer fits into the short timer */
+        _xtimer_set(timer, (uint32_t)offset);
+    }
+    else {
+        int state = irq_disable();
+
+        _set(timer, _xtimer_now64() + (((uint64_t)long_offset << 32) | offset));
+        irq_restore(state);
+    }
+}
+
+void _xtimer_set(xtimer_t *timer, uint32_t offset)
+{
+    DEBUG("timer_set(): offset=%" PRIu32 " now=%" PRIu32 " (%" PRIu32 ")\n",
+          offset, xtimer_now().ticks32, _xtimer_lltimer_now());
+    if (!timer->callback) {
+        DEBUG("timer_set(): timer has no callback.\n");
+        return;
+    }
+
+    xtimer_remove(timer);
+
+    if (offset < XTIMER_BACKOFF) {
+        _xtimer_spin(offset);
+        _shoot(timer);
+    }
+    else {
+        uint32_t target = _xtimer_now() + offset;
+        _xtimer_set_absolute(timer, target);
+    }
+}
+
+static void _periph_timer_callback(void *arg, int chan)
+{
+    (void)arg;
+    (void)chan;
+    _timer_callback();
+}
+
+int _xtimer_set_absolute(xtimer_t *timer, uint32_t target)
+{
+    uint64_t now = _xtimer_now64();
+
+    /* see xtimer_core.c: the callers make sure target is not so close to now
+     * that it could have passed before the call above */
+    uint32_t offset = target - (uint32_t)now;
+
+    DEBUG("timer_set_absolute(): now=%" PRIu32 " target=%" PRIu32 " offset=%" PRIu32 "\n",
+          (uint32_t)now, target, offset);
+
+    if (offset <= XTIMER_BACKOFF) {
+        /* backoff */
+        xtimer_spin_until(target);
+        _shoot(timer);
+        return 0;
+    }
+
+    unsigned state = irq_disable();
+    _set(timer, now + offset);
+    irq_restore(state);
+
+    return 0;
+}
+
+void xtimer_remove(xtimer_t *timer)
+{
+    int state = irq_disable();
+
+    if (_is_set(timer)) {
+        _unlink(timer);
+        timer->target = 0;
+        timer->long_target = 0;
+    }
+    irq_restore(state);
+}
+
+/**
+ * @brief handle low-level timer overflow, advance to next short timer period
+ */
+static void _next_period(void)
+{
+#if XTIMER_MASK
+    /* advance <32bit mask register */
+    _xtimer_high_cnt += ~XTIMER_MASK + 1;
+    if (_xtimer_high_cnt == 0) {
+        /* high_cnt overflowed, so advance >32bit counter */
+        _long_cnt++;
+    }
+#else
+    /* advance >32bit counter */
+    _long_cnt++;
+#endif
+}
+
+/**
+ * @brief main xtimer callback function
+ */
+static void _timer_callback(void)
+{
+    uint32_t reference;
+    uint32_t next_target;
+
+    _in_handler = 1;
+
+    if (_armed_period_end) {
+        DEBUG("_timer_callback(): tick\n");
+        /* make sure the timer counter also arrived
+         * in the next timer period */
+        while (_xtimer_lltimer_now() == _xtimer_lltimer_mask(0xFFFFFFFF)) {}
+        _next_period();
+        reference = 0;
+    }
+    else {
+        reference = _xtimer_lltimer_now();
+    }
+
+    while (1) {
+        uint32_t now_ll = _xtimer_lltimer_now();
+
+        if (now_ll < reference) {
+            DEBUG("_timer_callback: overflowed while executing callbacks.\n");
+            _next_period();
+            reference = 0;
+        }
+        else if (_xtimer_lltimer_mask(now_ll + XTIMER_ISR_BACKOFF) < now_ll) {
+            /* the end of this period is very soon, spin until next period,
+             * then advance */
+            while (_xtimer_lltimer_now() >= now_ll) {}
+            _next_period();
+            reference = 0;
+        }
+
+        uint64_t end = _period_end();
+        uint64_t horizon = _xtimer_now64() + XTIMER_ISR_BACKOFF;
+
+        _advance(horizon >> SLOT_SHIFT);
+
+        /* fire timers that are close to expiring, those at or after the end
+         * of this period wait for the next iteration */
+        while (_near && (_target(_near) <= horizon) && (_target(_near) < end)) {
+            xtimer_t *timer = _near;
+            uint32_t target = _xtimer_lltimer_mask(timer->target);
+            uint32_t now;
+
+            _unlink(timer);
+
+            /* make sure we don't fire too early */
+            while (((now = _xtimer_lltimer_now()) >= reference) && (now < target)) {}
+
+            /* make sure timer is recognized as being already fired */
+            timer->target = 0;
+            timer->long_target = 0;
+
+            _shoot(timer);
+        }
+
+        uint64_t next = _next_event();
+
+        if (next >= end) {
+            /* there's no timer planned for this timer period,
+             * schedule callback on next overflow */
+            if (end < (_xtimer_now64() + XTIMER_ISR_BACKOFF)) {
+                continue;
+            }
+            _armed = end;
+            _armed_period_end = 1;
+            next_target = _xtimer_lltimer_mask(0xFFFFFFFF);
+        }
+        else {
+            /* make sure we're not setting a time in the past */
+            if ((next - XTIMER_OVERHEAD) < (_xtimer_now64() + XTIMER_ISR_BACKOFF)) {
+                continue;
+            }
+            _armed = next;
+            _armed_period_end = 0;
+            next_target = (uint32_t)next - XTIMER_OVERHEAD;
+        }
+        break;
+    }
+
+    _in_handler = 0;
+
+    /* set low level timer */
+    _lltimer_set(next_target);
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2019 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Measure runtime and fragmentation of the packet buffer
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "benchmark.h"
+#include "net/gnrc/pktbuf.h"
+
+#ifndef BENCH_RUNS
+#define BENCH_RUNS          (100UL * 1000UL)
+#endif
+
+/* number of packets kept alive during the mixed workload */
+#define HELD_NUMOF          (8U)
+#define MIXED_ROUNDS        (1000U)
+
+static const uint16_t _sizes[] = { 8, 40, 127, 20, 1280, 60, 102, 3 };
+
+static void _add_release(size_t size)
+{
+    gnrc_pktbuf_release(gnrc_pktbuf_add(NULL, NULL, size, GNRC_NETTYPE_UNDEF));
+}
+
+/* what a 6LoWPAN interface does for every received frame */
+static void _rx_frame(void)
+{
+    gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, NULL, 102, GNRC_NETTYPE_UNDEF);
+
+    if (pkt != NULL) {
+        gnrc_pktsnip_t *hdr = gnrc_pktbuf_add(NULL, NULL, 24,
+                                              GNRC_NETTYPE_NETIF);
+        LL_APPEND(pkt, hdr);
+        gnrc_pktbuf_mark(pkt, 40, GNRC_NETTYPE_UNDEF);
+        gnrc_pktbuf_mark(pkt, 8, GNRC_NETTYPE_UNDEF);
+        gnrc_pktbuf_release(pkt);
+    }
+}
+
+static unsigned _mixed_workload(void)
+{
+    gnrc_pktsnip_t *held[HELD_NUMOF] = { NULL };
+    unsigned fails = 0;
+
+    for (unsigned i = 0; i < MIXED_ROUNDS; i++) {
+        unsigned slot = (i * 5) % HELD_NUMOF;
+        size_t size = _sizes[i % (sizeof(_sizes) / sizeof(_sizes[0]))];
+
+        gnrc_pktbuf_release(held[slot]);
+        held[slot] = gnrc_pktbuf_add(NULL, NULL, size, GNRC_NETTYPE_UNDEF);
+        if (held[slot] == NULL) {
+            fails++;
+        }
+        /* short-living packet in between */
+        gnrc_pktsnip_t *tmp = gnrc_pktbuf_add(NULL, NULL, size / 2 + 1,
+                                              GNRC_NETTYPE_UNDEF);
+        if (tmp == NULL) {
+            fails++;
+        }
+        gnrc_pktbuf_release(tmp);
+    }
+    for (unsigned i = 0; i < HELD_NUMOF; i++) {
+        gnrc_pktbuf_release(held[i]);
+    }
+    return fails;
+}
+
+int main(void)
+{
+    puts("Runtime of gnrc_pktbuf operations\n");
+
+    BENCHMARK_FUNC("add/release 8 B", BENCH_RUNS, _add_release(8));
+    BENCHMARK_FUNC("add/release 127 B", BENCH_RUNS, _add_release(127));
+    BENCHMARK_FUNC("add/release 1280 B", BENCH_RUNS, _add_release(1280));
+    BENCHMARK_FUNC("rx frame", BENCH_RUNS, _rx_frame());
+    puts("");
+    printf("mixed workload: %u failed allocations in %u rounds\n",
+           _mixed_workload(), MIXED_ROUNDS);
+#ifdef DEVELHELP
+    gnrc_pktbuf_stats();
+#endif
+
+    puts("\n[SUCCESS]");
+    return 0;
+}
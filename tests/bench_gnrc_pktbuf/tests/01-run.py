@@ -0,0 +1,28 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2019 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+TIMEOUT = 30
+BENCHMARK_REGEXP = r"\s+{func}:\s+\d+us\s+---\s+\d*\.*\d+us per call\s+---\s+\d+ calls per sec"
+
+
+def testfunc(child):
+    child.expect_exact('Runtime of gnrc_pktbuf operations')
+    child.expect(BENCHMARK_REGEXP.format(func="add/release 8 B"), timeout=TIMEOUT)
+    child.expect(BENCHMARK_REGEXP.format(func="add/release 127 B"), timeout=TIMEOUT)
+    child.expect(BENCHMARK_REGEXP.format(func="add/release 1280 B"), timeout=TIMEOUT)
+    child.expect(BENCHMARK_REGEXP.format(func="rx frame"), timeout=TIMEOUT)
+    child.expect(r"mixed workload: \d+ failed allocations in \d+ rounds")
+    child.expect_exact('[SUCCESS]')
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc))
@@ -28,8 +28,14 @@
 #define TEST_DURATION       (1000000U)
 #endif
 
+#ifndef TEST_BULK_SIZE
+#define TEST_BULK_SIZE      (8U)    /* must be a power of two */
+#endif
+
 volatile unsigned _flag = 0;
 static char _stack[THREAD_STACKSIZE_MAIN];
+static char _stack_queue[THREAD_STACKSIZE_MAIN];
+static msg_t _queue[TEST_BULK_SIZE];
 
 static void _timer_callback(void*arg)
 {
@@ -50,6 +56,20 @@ static void *_second_thread(void *arg)
     return NULL;
 }
 
+static void *_queue_thread(void *arg)
+{
+    (void)arg;
+    msg_t test[TEST_BULK_SIZE];
+
+    msg_init_queue(_queue, TEST_BULK_SIZE);
+
+    while(1) {
+        msg_receive_bulk(test, TEST_BULK_SIZE);
+    }
+
+    return NULL;
+}
+
 int main(void)
 {
     printf("main starting\n");
@@ -77,5 +97,34 @@ int main(void)
 
     printf("{ \"result\" : %"PRIu32" }\n", n);
 
+    kernel_pid_t queued = thread_create(_stack_queue,
+                                        sizeof(_stack_queue),
+                                        (THREAD_PRIORITY_MAIN - 1),
+                                        THREAD_CREATE_STACKTEST,
+                                        _queue_thread,
+                                        NULL,
+                                        "queue_thread");
+
+    n = 0;
+    _flag = 0;
+    xtimer_set(&timer, TEST_DURATION);
+    while(!_flag) {
+        msg_send(&test, queued);
+        n++;
+    }
+
+    printf("{ \"result_queue\" : %"PRIu32" }\n", n);
+
+    msg_t bulk[TEST_BULK_SIZE];
+
+    n = 0;
+    _flag = 0;
+    xtimer_set(&timer, TEST_DURATION);
+    while(!_flag) {
+        n += msg_send_bulk(bulk, TEST_BULK_SIZE, queued);
+    }
+
+    printf("{ \"result_bulk\" : %"PRIu32" }\n", n);
+
     return 0;
 }
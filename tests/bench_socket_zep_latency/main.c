@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Round-trip latency benchmark for socket_zep
+ *
+ * Every frame received over the ZEP socket is sent back unmodified, the host
+ * side script measures the round-trip time.
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <stdio.h>
+
+#include "net/ieee802154.h"
+#include "socket_zep.h"
+#include "socket_zep_params.h"
+#include "thread.h"
+#include "thread_flags.h"
+
+#define FLAG_ISR        (0x1)
+
+static uint8_t _buf[IEEE802154_FRAME_LEN_MAX];
+static socket_zep_t _dev;
+static thread_t *_main_thread;
+
+static void _echo(netdev_t *dev)
+{
+    int len = dev->driver->recv(dev, _buf, sizeof(_buf), NULL);
+
+    if (len > 0) {
+        iolist_t iolist = { .iol_base = _buf, .iol_len = len };
+
+        dev->driver->send(dev, &iolist);
+    }
+}
+
+static void _event_cb(netdev_t *dev, netdev_event_t event)
+{
+    if (event == NETDEV_EVENT_ISR) {
+        /* thread flags coalesce the simulated TX interrupts, so they do not
+         * pile up in front of the next RX interrupt like messages would */
+        thread_flags_set(_main_thread, FLAG_ISR);
+    }
+    else if (event == NETDEV_EVENT_RX_COMPLETE) {
+        _echo(dev);
+    }
+}
+
+int main(void)
+{
+    netdev_t *netdev = (netdev_t *)&_dev;
+
+    _main_thread = (thread_t *)thread_get(thread_getpid());
+
+    socket_zep_setup(&_dev, &socket_zep_params[0]);
+    netdev->event_callback = _event_cb;
+    if (netdev->driver->init(netdev) < 0) {
+        puts("failed to initialize socket_zep");
+        return 1;
+    }
+
+    puts("Waiting for frames to echo (use `make test`)");
+    while (1) {
+        thread_flags_wait_any(FLAG_ISR);
+        netdev->driver->isr(netdev);
+    }
+
+    return 0;
+}
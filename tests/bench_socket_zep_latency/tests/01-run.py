@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2020 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import os
+import sys
+import time
+import socket
+from testrunner import run
+
+
+ROUNDS = 2000
+IEEE802154_FRAME_LEN_MAX = 127
+ZEP_DATA_HEADER_SIZE = 32
+FCS_LEN = 2
+RCVBUF_LEN = IEEE802154_FRAME_LEN_MAX + ZEP_DATA_HEADER_SIZE + FCS_LEN
+# ZEPv2 data header followed by a MAC header addressed to the node
+ZEP_HDR = (b"\x45\x58\x02\x01\x1a\x44\xe0\x01\xff\xdb\xde\xa6\x1a\x00\x8b" +
+           b"\xfd\xae\x60\xd3\x21\xf1\x00\x00\x00\x00\x00\x00\x00\x00\x00" +
+           b"\x00\x22\x41\xdc\x02\x23\x00\x38\x30\x00\x0a\x50\x45\x5a\x00" +
+           b"\x5b\x45\x00\x0a\x50\x45\x5a\x00")
+zep_params = {
+        "local_addr": "::",
+        "local_port": 12345,
+        "remote_addr": "::1",
+        "remote_port": 17754,
+    }
+s = None
+
+
+def roundtrip(seq):
+    payload = b"%011d" % seq
+    start = time.perf_counter()
+    s.sendto(ZEP_HDR + payload + b"\x00\x00",
+             ("::1", zep_params['local_port']))
+    while True:
+        data = s.recv(RCVBUF_LEN)
+        if data[-(len(payload) + FCS_LEN):-FCS_LEN] == payload:
+            return time.perf_counter() - start
+
+
+def testfunc(child):
+    child.expect_exact("Waiting for frames to echo (use `make test`)")
+    s.settimeout(1)
+    # warm up
+    for seq in range(10):
+        roundtrip(seq)
+    samples = sorted(roundtrip(seq) for seq in range(ROUNDS))
+    usec = [int(sample * 1000000) for sample in samples]
+    print("")
+    print("{ \"rounds\" : %d }" % ROUNDS)
+    print("{ \"latency_min_us\" : %d }" % usec[0])
+    print("{ \"latency_avg_us\" : %d }" % (sum(usec) // ROUNDS))
+    print("{ \"latency_p50_us\" : %d }" % usec[ROUNDS // 2])
+    print("{ \"latency_p99_us\" : %d }" % usec[(ROUNDS * 99) // 100])
+    print("{ \"latency_max_us\" : %d }" % usec[-1])
+
+
+if __name__ == "__main__":
+    os.environ['TERMFLAGS'] = "-z [%s]:%d,[%s]:%d" % (
+            zep_params['local_addr'], zep_params['local_port'],
+            zep_params['remote_addr'], zep_params['remote_port'])
+    s = socket.socket(family=socket.AF_INET6, type=socket.SOCK_DGRAM)
+    s.bind(("::", zep_params['remote_port']))
+    res = run(testfunc, timeout=1, echo=False, traceback=True)
+    s.close()
+    sys.exit(res)
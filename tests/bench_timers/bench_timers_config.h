@@ -241,6 +241,23 @@ extern "C" {
 /* estimate_cpu_overhead will loop for this many iterations to get a proper estimate */
 #define ESTIMATE_CPU_ITERATIONS 2048
 
+#if TEST_XTIMER
+/* Measure the xtimer set/remove cost and callback latency with up to this many
+ * timers armed in the background, 0 disables the measurement */
+#ifndef TEST_ARMED_MAX
+#define TEST_ARMED_MAX 1000
+#endif
+/* Background timers are rearmed with a random timeout of up to this many TUT
+ * ticks, probe timers use up to a thousandth of it */
+#ifndef TEST_ARMED_SPREAD
+#define TEST_ARMED_SPREAD (TIM_TEST_FREQ)
+#endif
+/* Number of probe timers per number of armed timers */
+#ifndef TEST_ARMED_ITERATIONS
+#define TEST_ARMED_ITERATIONS 256
+#endif
+#endif
+
 #if TEST_XTIMER
 #define READ_TUT() _xtimer_now()
 #else
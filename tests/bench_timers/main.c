@@ -511,6 +511,107 @@ static void run_test(test_ctx_t *ctx, uint32_t interval, unsigned int variant)
 }
 #endif /* TEST_XTIMER */
 
+#if TEST_XTIMER && TEST_ARMED_MAX
+/* Background timers, kept armed while measuring */
+static xtimer_t armed[TEST_ARMED_MAX];
+
+static void cb_armed(void *arg)
+{
+    /* rearm, so that the number of armed timers stays constant */
+    _xtimer_set(arg, XTIMER_BACKOFF + random_uint32_range(0, TEST_ARMED_SPREAD));
+}
+
+static void cb_latency(void *arg)
+{
+    *(unsigned int *)arg = timer_read(TIM_REF_DEV);
+    mutex_unlock(&mtx_cb);
+}
+
+static void print_armed_stats(const char *name, matstat_state_t *state)
+{
+    print_str(name);
+    print_str(": mean = ");
+    print_s32_dec(matstat_mean(state));
+    print_str(", max = ");
+    print_s32_dec(state->max);
+}
+
+/*
+ * Measure the cost of a set/remove pair and the callback latency of a probe
+ * timer while numof timers with random timeouts are armed and firing in the
+ * background. The worst case latency includes the time interrupts are disabled
+ * by xtimer while handling the background timers.
+ */
+static void bench_armed(unsigned int numof)
+{
+    matstat_state_t cost = MATSTAT_STATE_INIT;
+    matstat_state_t latency = MATSTAT_STATE_INIT;
+    unsigned int now_ref = 0;
+    xtimer_t xt = {
+        .target = 0,
+        .long_target = 0,
+        .callback = cb_latency,
+        .arg = &now_ref,
+    };
+
+    for (unsigned int k = 0; k < numof; ++k) {
+        armed[k] = (xtimer_t){ .callback = cb_armed, .arg = &armed[k] };
+        cb_armed(&armed[k]);
+    }
+    for (unsigned int k = 0; k < TEST_ARMED_ITERATIONS; ++k) {
+        /* the probe timer is removed again before it fires, so it can use
+         * the same range as the background timers */
+        uint32_t interval = XTIMER_BACKOFF +
+                            random_uint32_range(0, TEST_ARMED_SPREAD);
+
+        spin_random_delay();
+        unsigned int begin = timer_read(TIM_REF_DEV);
+        _xtimer_set(&xt, interval);
+        xtimer_remove(&xt);
+        matstat_add(&cost, timer_read(TIM_REF_DEV) - begin);
+
+        interval = XTIMER_BACKOFF +
+                   random_uint32_range(0, TEST_ARMED_SPREAD / 1000);
+        spin_random_delay();
+        unsigned int target_ref = timer_read(TIM_REF_DEV) +
+                                  TIM_TEST_TO_REF(interval);
+        _xtimer_set(&xt, interval);
+        mutex_lock(&mtx_cb);
+        matstat_add(&latency, now_ref - target_ref - overhead_target);
+    }
+    for (unsigned int k = 0; k < numof; ++k) {
+        xtimer_remove(&armed[k]);
+    }
+
+    print_str("armed = ");
+    print_u32_dec(numof);
+    print_str(", ");
+    print_armed_stats("set+remove", &cost);
+    print_str(", ");
+    print_armed_stats("latency", &latency);
+    print("\n", 1);
+}
+
+static void bench_armed_all(void)
+{
+    static const unsigned int numofs[] = { 10, 100, 1000 };
+
+    print_str("Measuring xtimer with armed background timers ");
+#if MODULE_XTIMER_WHEEL
+    print_str("(xtimer_wheel), ");
+#else
+    print_str("(sorted lists), ");
+#endif
+    print_str("results in reference timer ticks\n");
+    for (unsigned int k = 0; k < ARRAY_SIZE(numofs); ++k) {
+        if (numofs[k] > TEST_ARMED_MAX) {
+            break;
+        }
+        bench_armed(numofs[k]);
+    }
+}
+#endif /* TEST_XTIMER && TEST_ARMED_MAX */
+
 static int test_timer(void)
 {
     uint32_t time_last = timer_read(TIM_REF_DEV);
@@ -737,6 +838,9 @@ int main(void)
     print_u32_dec(spin_max);
     print("\n", 1);
     estimate_cpu_overhead();
+#if TEST_XTIMER && TEST_ARMED_MAX
+    bench_armed_all();
+#endif
 #ifdef MODULE_PERIPH_RTT
     rtt_begin = rtt_get_counter();
 #endif
@@ -14,6 +14,7 @@
  *
  * @author      Joakim Nohlgård <joakim.nohlgard@eistec.se>
  */
+#include <errno.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -137,6 +138,10 @@ static void test_devfs_mount_open(void)
     res = devfs_unregister(&_mock_devfs_node);
     TEST_ASSERT_EQUAL_INT(0, res);
 
+    /* not found after unregistering, even if the lookup was cached */
+    fd = vfs_open("/test/mock0", O_RDWR, 0);
+    TEST_ASSERT_EQUAL_INT(-ENOENT, fd);
+
     res = vfs_umount(&_test_devfs_mount);
     TEST_ASSERT_EQUAL_INT(0, res);
 }
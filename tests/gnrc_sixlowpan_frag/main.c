@@ -11,14 +11,19 @@
  * @{
  *
  * @file
- * @brief       Tests 6LoWPAN fragmentation handling of gnrc stack.
+ * @brief       Tests 6LoWPAN fragmentation handling of gnrc stack and
+ *              benchmarks the reassembly buffer.
  *
  * @author      Martine S. Lenders <m.lenders@fu-berlin.de>
  *
  * @}
  */
 
+#include <inttypes.h>
+#include <stdio.h>
+
 #include "embUnit.h"
+#include "kernel_defines.h"
 #include "net/gnrc/pktbuf.h"
 #include "net/gnrc/netreg.h"
 #include "net/gnrc/sixlowpan/frag.h"
@@ -35,6 +40,13 @@
 #define TEST_RECEIVE_TIMEOUT    (100U)
 #define TEST_GC_TIMEOUT         (GNRC_SIXLOWPAN_FRAG_RBUF_TIMEOUT_US + TEST_RECEIVE_TIMEOUT)
 
+/* the benchmark feeds all but the last fragment of BENCH_DATAGRAM_SIZE byte
+ * datagrams, so the datagrams stay in the reassembly buffer */
+#define BENCH_DATAGRAM_SIZE     (200U)
+#define BENCH_FRAG_PAYLOAD      (24U)
+#define BENCH_FRAGS_PER_DG      (BENCH_DATAGRAM_SIZE / BENCH_FRAG_PAYLOAD)
+#define BENCH_ROUNDS            (50U)
+
 /* test date taken from an experimental run (uncompressed ICMPv6 echo reply with
  * 300 byte payload)*/
 #define TEST_DATAGRAM_SIZE      (348U)
@@ -235,10 +247,14 @@ static void _test_entry(const gnrc_sixlowpan_frag_rb_t *entry,
                         "entry->super.dst != TEST_NETIF_HDR_DST");
     TEST_ASSERT_EQUAL_INT(TEST_TAG, entry->super.tag);
     TEST_ASSERT_EQUAL_INT(exp_current_size, entry->super.current_size);
-    TEST_ASSERT_NOT_NULL(entry->super.ints);
-    TEST_ASSERT_NULL(entry->super.ints->next);
-    TEST_ASSERT_EQUAL_INT(exp_int_start, entry->super.ints->start);
-    TEST_ASSERT_EQUAL_INT(exp_int_end, entry->super.ints->end);
+    /* exactly one fragment from exp_int_start to exp_int_end was received */
+    for (unsigned i = 0; i < GNRC_SIXLOWPAN_FRAG_RB_UNITS; i++) {
+        bool in_int = ((exp_int_start / 8U) <= i) && (i <= (exp_int_end / 8U));
+
+        TEST_ASSERT(in_int == bf_isset((uint8_t *)entry->super.received, i));
+        TEST_ASSERT((i == (exp_int_start / 8U)) ==
+                    bf_isset((uint8_t *)entry->super.starts, i));
+    }
 }
 
 static void _check_pktbuf(const gnrc_sixlowpan_frag_rb_t *entry)
@@ -625,6 +641,88 @@ static void run_unittests(void)
     TESTS_END();
 }
 
+static gnrc_pktsnip_t *_bench_fragment(uint16_t tag, unsigned idx)
+{
+    const size_t hdr_len = (idx == 0) ? sizeof(sixlowpan_frag_t)
+                                      : sizeof(sixlowpan_frag_n_t);
+    gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, NULL,
+                                          hdr_len + BENCH_FRAG_PAYLOAD,
+                                          GNRC_NETTYPE_SIXLOWPAN);
+    sixlowpan_frag_n_t *frag;
+
+    if (pkt == NULL) {
+        return NULL;
+    }
+    frag = pkt->data;
+    memset(frag, 0, pkt->size);
+    frag->disp_size = byteorder_htons(BENCH_DATAGRAM_SIZE);
+    frag->tag = byteorder_htons(tag);
+    if (idx == 0) {
+        frag->disp_size.u8[0] |= SIXLOWPAN_FRAG_1_DISP;
+    }
+    else {
+        frag->disp_size.u8[0] |= SIXLOWPAN_FRAG_N_DISP;
+        frag->offset = (idx * BENCH_FRAG_PAYLOAD) / 8;
+    }
+    return pkt;
+}
+
+static void run_benchmark(unsigned datagrams)
+{
+    uint32_t usec = 0;
+    unsigned frags = 0;
+
+    for (unsigned round = 0; round < BENCH_ROUNDS; round++) {
+        uint32_t start;
+
+        gnrc_sixlowpan_frag_rb_reset();
+        gnrc_pktbuf_init();
+        start = xtimer_now_usec();
+        /* interleave fragments of all datagrams like a border router
+         * terminating many nodes sees them */
+        for (unsigned f = 0; f < BENCH_FRAGS_PER_DG; f++) {
+            for (unsigned dg = 0; dg < datagrams; dg++) {
+                gnrc_pktsnip_t *pkt = _bench_fragment(TEST_TAG + dg, f);
+                uint8_t src[] = TEST_NETIF_HDR_SRC;
+
+                /* every datagram originates from another node */
+                src[sizeof(src) - 1] = dg;
+                gnrc_netif_hdr_set_src_addr(&_test_netif_hdr.hdr, src,
+                                            sizeof(src));
+                if ((pkt == NULL) ||
+                    (gnrc_sixlowpan_frag_rb_add(&_test_netif_hdr.hdr, pkt,
+                                                f * BENCH_FRAG_PAYLOAD,
+                                                TEST_PAGE) == NULL)) {
+                    printf("rbuf: unable to add fragment %u of datagram %u\n",
+                           f, dg);
+                    return;
+                }
+            }
+        }
+        usec += xtimer_now_usec() - start;
+        frags += BENCH_FRAGS_PER_DG * datagrams;
+    }
+    printf("rbuf: %3u datagrams: %" PRIu32 " fragments/s\n", datagrams,
+           (uint32_t)(((uint64_t)frags * US_PER_SEC) / usec));
+}
+
+static void run_benchmarks(void)
+{
+    static const unsigned datagrams[] = { 4, 16, 64 };
+
+    _set_up();
+    for (unsigned i = 0; i < ARRAY_SIZE(datagrams); i++) {
+        if (datagrams[i] > GNRC_SIXLOWPAN_FRAG_RBUF_SIZE) {
+            printf("rbuf: %3u datagrams: skipped (GNRC_SIXLOWPAN_FRAG_RBUF_SIZE=%u)\n",
+                   datagrams[i], (unsigned)GNRC_SIXLOWPAN_FRAG_RBUF_SIZE);
+            continue;
+        }
+        run_benchmark(datagrams[i]);
+    }
+    gnrc_sixlowpan_frag_rb_reset();
+    puts("benchmark done");
+}
+
 int main(void)
 {
     /* no auto-init, so xtimer needs to be initialized manually*/
@@ -632,5 +730,6 @@ int main(void)
     /* netreg requires queue, but queue size one should be enough for us */
     msg_init_queue(&_msg_queue, 1U);
     run_unittests();
+    run_benchmarks();
     return 0;
 }
@@ -12,6 +12,10 @@ from testrunner import run
 
 def testfunc(child):
     child.expect(r'OK \(\d+ tests\)')
+    for datagrams in (4, 16, 64):
+        child.expect(r'rbuf: +{} datagrams: '.format(datagrams) +
+                     r'(\d+ fragments/s|skipped)')
+    child.expect_exact('benchmark done')
 
 
 if __name__ == "__main__":
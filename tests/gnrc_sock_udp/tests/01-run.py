@@ -49,6 +49,8 @@ def testfunc(child):
     child.expect_exact(u"Calling test_sock_udp_send__unsocketed()")
     child.expect_exact(u"Calling test_sock_udp_send__no_sock_no_netif()")
     child.expect_exact(u"Calling test_sock_udp_send__no_sock()")
+    child.expect_exact(u"Calling test_sock_udp_sendv__EINVAL_port()")
+    child.expect_exact(u"Calling test_sock_udp_sendv__socketed()")
     child.expect_exact(u"ALL TESTS SUCCESSFUL")
 
 
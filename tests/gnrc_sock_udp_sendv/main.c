@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Test for the zero-copy sock_udp_sendv() of GNRC
+ *
+ * With `gnrc_pktbuf_ext` the payload references the buffers of the caller
+ * and sock_udp_sendv() blocks until the stack released them, so the datagrams
+ * are received by a thread of their own. All datagrams are sent to the IPv6
+ * loopback address, so no network interface is needed.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "embUnit.h"
+#include "iolist.h"
+#include "mutex.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/ipv6/addr.h"
+#include "net/sock/udp.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define TEST_PORT           (20000U)
+#define TEST_TIMEOUT        (1U * US_PER_SEC)
+/* one more buffer than there are external snips */
+#define TEST_BUFS           (GNRC_PKTBUF_EXT_NUMOF + 1)
+#define TEST_BUF_SIZE       (8U)
+
+static sock_udp_t _sock;
+static uint8_t _rcv_buf[TEST_BUFS * TEST_BUF_SIZE];
+static ssize_t _rcv_len;
+static mutex_t _received = MUTEX_INIT_LOCKED;
+static char _rcv_stack[THREAD_STACKSIZE_DEFAULT];
+
+static uint8_t _bufs[TEST_BUFS][TEST_BUF_SIZE];
+static iolist_t _iol[TEST_BUFS];
+static uint8_t _expected[TEST_BUFS * TEST_BUF_SIZE];
+
+static void *_rcv_thread(void *arg)
+{
+    (void)arg;
+    while (1) {
+        _rcv_len = sock_udp_recv(&_sock, _rcv_buf, sizeof(_rcv_buf),
+                                 SOCK_NO_TIMEOUT, NULL);
+        mutex_unlock(&_received);
+    }
+    return NULL;
+}
+
+static void _remote(sock_udp_ep_t *ep)
+{
+    memset(ep, 0, sizeof(*ep));
+    ep->family = AF_INET6;
+    ep->port = TEST_PORT;
+    ipv6_addr_set_loopback((ipv6_addr_t *)ep->addr.ipv6);
+}
+
+/* fills the first @p num buffers and chains them */
+static size_t _setup(unsigned num, uint8_t seed)
+{
+    for (unsigned i = 0; i < num; i++) {
+        for (unsigned j = 0; j < TEST_BUF_SIZE; j++) {
+            _bufs[i][j] = seed + (i * TEST_BUF_SIZE) + j;
+        }
+        memcpy(&_expected[i * TEST_BUF_SIZE], _bufs[i], TEST_BUF_SIZE);
+        _iol[i].iol_next = (i + 1 < num) ? &_iol[i + 1] : NULL;
+        _iol[i].iol_base = _bufs[i];
+        _iol[i].iol_len = TEST_BUF_SIZE;
+    }
+    return num * TEST_BUF_SIZE;
+}
+
+static void _check_received(size_t len)
+{
+    TEST_ASSERT_EQUAL_INT(0, xtimer_mutex_lock_timeout(&_received,
+                                                       TEST_TIMEOUT));
+    TEST_ASSERT_EQUAL_INT(len, _rcv_len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_expected, _rcv_buf, len));
+    /* the sent packet was released, the received one was read */
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void _sendv(unsigned num, uint8_t seed)
+{
+    sock_udp_ep_t remote;
+    size_t len = _setup(num, seed);
+
+    _remote(&remote);
+    TEST_ASSERT_EQUAL_INT(len, sock_udp_sendv(NULL, _iol, &remote));
+    /* the buffers are not referenced by the stack anymore */
+    memset(_bufs, 0, sizeof(_bufs));
+    _check_received(len);
+}
+
+static void set_up(void)
+{
+    /* drop a leftover notification of a failed test */
+    mutex_trylock(&_received);
+}
+
+static void test_sendv__single(void)
+{
+    _sendv(1, 0x10);
+}
+
+static void test_sendv__ext(void)
+{
+    _sendv(GNRC_PKTBUF_EXT_NUMOF, 0x20);
+}
+
+static void test_sendv__ext_exhausted(void)
+{
+    /* the last buffer is copied into the packet buffer */
+    _sendv(TEST_BUFS, 0x30);
+}
+
+static void test_sendv__repeated(void)
+{
+    /* external snips are reusable after each call */
+    for (unsigned i = 0; i < 3; i++) {
+        _sendv(GNRC_PKTBUF_EXT_NUMOF, 0x40 + i);
+    }
+}
+
+static Test *tests_sock_udp_sendv(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_sendv__single),
+        new_TestFixture(test_sendv__ext),
+        new_TestFixture(test_sendv__ext_exhausted),
+        new_TestFixture(test_sendv__repeated),
+    };
+
+    EMB_UNIT_TESTCALLER(tests, set_up, NULL, fixtures);
+    return (Test *)&tests;
+}
+
+int main(void)
+{
+    sock_udp_ep_t local = { .family = AF_INET6, .port = TEST_PORT };
+
+    if (sock_udp_create(&_sock, &local, NULL, 0) < 0) {
+        puts("error: unable to create sock");
+        return 1;
+    }
+    thread_create(_rcv_stack, sizeof(_rcv_stack), THREAD_PRIORITY_MAIN - 1,
+                  THREAD_CREATE_STACKTEST, _rcv_thread, NULL, "recv");
+
+    TESTS_START();
+    TESTS_RUN(tests_sock_udp_sendv());
+    TESTS_END();
+    return 0;
+}
+/** @} */
@@ -6,6 +6,7 @@
  * directory for more details.
  */
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -13,12 +14,14 @@
 #include "msg.h"
 #include "net/af.h"
 #include "net/gnrc/tcp.h"
+#include "xtimer.h"
 
 #define MAIN_QUEUE_SIZE (8)
 #define BUFFER_SIZE (2049)
 
 static msg_t main_msg_queue[MAIN_QUEUE_SIZE];
 static gnrc_tcp_tcb_t tcb;
+static gnrc_tcp_listener_t listener;
 static char buffer[BUFFER_SIZE];
 
 void dump_args(int argc, char **argv)
@@ -216,6 +219,34 @@ int gnrc_tcp_send_cmd(int argc, char **argv)
     return sent;
 }
 
+int gnrc_tcp_send_bulk_cmd(int argc, char **argv)
+{
+    dump_args(argc, argv);
+
+    int timeout = atol(argv[1]);
+    size_t to_send = atol(argv[2]);
+    size_t buf_len = strlen(buffer);
+    size_t sent = 0;
+
+    /* Send the internal buffer repeatedly, until to_send bytes are sent */
+    uint32_t start = xtimer_now_usec();
+    while (sent < to_send) {
+        size_t offset = sent % buf_len;
+        size_t chunk = (buf_len - offset < to_send - sent) ? buf_len - offset : to_send - sent;
+        int ret = gnrc_tcp_send(&tcb, buffer + offset, chunk, timeout);
+        if (ret < 0) {
+            printf("%s: returns %d\n", argv[0], ret);
+            return ret;
+        }
+        sent += ret;
+    }
+    uint32_t duration = xtimer_now_usec() - start;
+
+    printf("%s: sent %u in %" PRIu32 " us (%" PRIu32 " byte/s)\n", argv[0], (unsigned)sent,
+           duration, (uint32_t)(((uint64_t)sent * US_PER_SEC) / (duration ? duration : 1)));
+    return 0;
+}
+
 int gnrc_tcp_recv_cmd(int argc, char **argv)
 {
     dump_args(argc, argv);
@@ -269,6 +300,96 @@ int gnrc_tcp_abort_cmd(int argc, char **argv)
     return 0;
 }
 
+int gnrc_tcp_listen_cmd(int argc, char **argv)
+{
+    dump_args(argc, argv);
+    int af_family = get_af_family(argv[1]);
+    char *local_addr = NULL;
+    uint16_t local_port = 0;
+    uint8_t backlog = 0;
+
+    if (argc == 4) {
+        local_port = atol(argv[2]);
+        backlog = atol(argv[3]);
+    }
+    else if (argc == 5) {
+        local_addr = argv[2];
+        local_port = atol(argv[3]);
+        backlog = atol(argv[4]);
+    }
+
+    int err = gnrc_tcp_listen(&listener, af_family, local_addr, local_port, backlog);
+    switch (err) {
+        case -EAFNOSUPPORT:
+            printf("%s: returns -EAFNOSUPPORT\n", argv[0]);
+            break;
+
+        case -EINVAL:
+            printf("%s: returns -EINVAL\n", argv[0]);
+            break;
+
+        case -EADDRINUSE:
+            printf("%s: returns -EADDRINUSE\n", argv[0]);
+            break;
+
+        default:
+            printf("%s: returns %d\n", argv[0], err);
+    }
+    return err;
+}
+
+int gnrc_tcp_accept_bulk_cmd(int argc, char **argv)
+{
+    dump_args(argc, argv);
+
+    int timeout = atol(argv[1]);
+    unsigned conns = atol(argv[2]);
+    size_t to_receive = atol(argv[3]);
+    size_t total = 0;
+    gnrc_tcp_tcb_t *conn;
+
+    /* Accept conns connections, receive to_receive bytes on each and close it */
+    uint32_t start = xtimer_now_usec();
+    for (unsigned i = 0; i < conns; ++i) {
+        int err = gnrc_tcp_accept(&listener, &conn, timeout);
+        if (err < 0) {
+            printf("%s: accept returns %d\n", argv[0], err);
+            return err;
+        }
+
+        size_t rcvd = 0;
+        while (rcvd < to_receive) {
+            size_t chunk = to_receive - rcvd;
+            if (chunk > BUFFER_SIZE - 1) {
+                chunk = BUFFER_SIZE - 1;
+            }
+            int ret = gnrc_tcp_recv(conn, buffer, chunk, timeout);
+            if (ret < 0) {
+                printf("%s: recv returns %d\n", argv[0], ret);
+                gnrc_tcp_abort(conn);
+                return ret;
+            }
+            rcvd += ret;
+        }
+        gnrc_tcp_close(conn);
+        total += rcvd;
+    }
+    uint32_t duration = xtimer_now_usec() - start;
+    duration = duration ? duration : 1;
+
+    printf("%s: accepted %u in %" PRIu32 " us (%" PRIu32 " conn/s, %" PRIu32 " byte/s)\n",
+           argv[0], conns, duration, (uint32_t)(((uint64_t)conns * US_PER_SEC) / duration),
+           (uint32_t)(((uint64_t)total * US_PER_SEC) / duration));
+    return 0;
+}
+
+int gnrc_tcp_stop_listen_cmd(int argc, char **argv)
+{
+    dump_args(argc, argv);
+    gnrc_tcp_stop_listen(&listener);
+    return 0;
+}
+
 /* Exporting GNRC TCP Api to for shell usage */
 static const shell_command_t shell_commands[] = {
     { "gnrc_tcp_tcb_init", "gnrc_tcp: init tcb", gnrc_tcp_tcb_init_cmd },
@@ -278,12 +399,19 @@ static const shell_command_t shell_commands[] = {
       gnrc_tcp_open_passive_cmd },
     { "gnrc_tcp_send", "gnrc_tcp: send data to connected peer",
       gnrc_tcp_send_cmd },
+    { "gnrc_tcp_send_bulk", "gnrc_tcp: send internal buffer repeatedly and measure throughput",
+      gnrc_tcp_send_bulk_cmd },
     { "gnrc_tcp_recv", "gnrc_tcp: recv data from connected peer",
       gnrc_tcp_recv_cmd },
     { "gnrc_tcp_close", "gnrc_tcp: close connection gracefully",
       gnrc_tcp_close_cmd },
     { "gnrc_tcp_abort", "gnrc_tcp: close connection forcefully",
       gnrc_tcp_abort_cmd },
+    { "gnrc_tcp_listen", "gnrc_tcp: listen for multiple connections",
+      gnrc_tcp_listen_cmd },
+    { "gnrc_tcp_accept_bulk", "gnrc_tcp: accept, receive from and close connections, "
+      "measure connection rate and throughput", gnrc_tcp_accept_bulk_cmd },
+    { "gnrc_tcp_stop_listen", "gnrc_tcp: stop listening", gnrc_tcp_stop_listen_cmd },
     { "buffer_init", "init internal buffer", buffer_init_cmd },
     { "buffer_get_max_size", "get max size of internal buffer",
       buffer_get_max_size_cmd },
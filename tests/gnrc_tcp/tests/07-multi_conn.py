@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2020   Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import os
+import sys
+import socket
+import threading
+
+from testrunner import run
+from shared_func import generate_port_number, get_host_tap_device, get_riot_ll_addr, \
+                        verify_pktbuf_empty, sudo_guard
+
+
+def tcp_client(addr, port, data, rounds):
+    addr_info = socket.getaddrinfo(addr + '%' + get_host_tap_device(), port, type=socket.SOCK_STREAM)
+
+    # Open a new connection per round, send data and close it again
+    for _ in range(rounds):
+        sock = socket.socket(socket.AF_INET6, socket.SOCK_STREAM)
+        sock.connect(addr_info[0][-1])
+        sock.sendall(data.encode('utf-8'))
+        sock.close()
+
+
+def testfunc(child):
+    port = generate_port_number()
+
+    # Each client sends 4 KiB over 5 consecutive connections
+    clients = 4
+    rounds = 5
+    data = ('0123456789' * 410)[:4096]
+    conns = clients * rounds
+
+    # Setup RIOT Node to listen for incoming connections from host system
+    child.sendline('gnrc_tcp_listen AF_INET6 ' + str(port) + ' ' + str(clients))
+    child.expect_exact('gnrc_tcp_listen: returns 0')
+
+    riot_addr = get_riot_ll_addr(child)
+    client_handles = [threading.Thread(target=tcp_client, args=(riot_addr, port, data, rounds))
+                      for _ in range(clients)]
+
+    # Accept all connections and report the connection rate and throughput
+    child.sendline('gnrc_tcp_accept_bulk 3000000 {} {}'.format(conns, len(data)))
+    for handle in client_handles:
+        handle.start()
+    child.expect(r'gnrc_tcp_accept_bulk: accepted {} in (\d+) us '
+                 r'\((\d+) conn/s, (\d+) byte/s\)'.format(conns))
+    print('connection rate: {} conn/s'.format(child.match.group(2)))
+    print('throughput: {} byte/s'.format(child.match.group(3)))
+
+    for handle in client_handles:
+        handle.join()
+
+    # Stop listening and verify that pktbuf is cleared
+    child.sendline('gnrc_tcp_stop_listen')
+    verify_pktbuf_empty(child)
+
+    print(os.path.basename(sys.argv[0]) + ': success')
+
+
+if __name__ == '__main__':
+    sudo_guard()
+    sys.exit(run(testfunc, timeout=60, echo=False, traceback=True))
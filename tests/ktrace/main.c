@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief   Kernel event tracer test application
+ *
+ * Two threads exchange messages and a third one blocks on a mutex held by
+ * main. Recording is stopped afterwards, so the trace can be dumped with the
+ * `ktrace dump` shell command.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "ktrace.h"
+#include "mutex.h"
+#include "shell.h"
+#include "thread.h"
+
+#define ROUNDS          (5U)
+#define MARKER_ROUND    (1U)
+#define SPAN_ROUND      (2U)
+
+static char ping_stack[THREAD_STACKSIZE_DEFAULT];
+static char pong_stack[THREAD_STACKSIZE_DEFAULT];
+static char waiter_stack[THREAD_STACKSIZE_DEFAULT];
+static kernel_pid_t ping_pid;
+static kernel_pid_t pong_pid;
+static kernel_pid_t main_pid;
+static mutex_t lock = MUTEX_INIT_LOCKED;
+
+static void *_ping(void *arg)
+{
+    (void)arg;
+    msg_t msg;
+
+    for (unsigned i = 0; i < ROUNDS; i++) {
+        ktrace_marker(MARKER_ROUND, i);
+        ktrace_begin(SPAN_ROUND);
+        msg.type = i;
+        msg_send(&msg, pong_pid);
+        msg_receive(&msg);
+        ktrace_end(SPAN_ROUND);
+    }
+    /* wake up main, stay alive to keep the thread name in the dump */
+    msg_send(&msg, main_pid);
+    thread_sleep();
+    return NULL;
+}
+
+static void *_pong(void *arg)
+{
+    (void)arg;
+    msg_t msg;
+
+    while (1) {
+        msg_receive(&msg);
+        msg_send(&msg, ping_pid);
+    }
+    return NULL;
+}
+
+static void *_waiter(void *arg)
+{
+    (void)arg;
+
+    mutex_lock(&lock);
+    mutex_unlock(&lock);
+    thread_sleep();
+    return NULL;
+}
+
+int main(void)
+{
+    msg_t msg;
+
+    main_pid = thread_getpid();
+    pong_pid = thread_create(pong_stack, sizeof(pong_stack), THREAD_PRIORITY_MAIN - 1,
+                             THREAD_CREATE_STACKTEST, _pong, NULL, "pong");
+    ping_pid = thread_create(ping_stack, sizeof(ping_stack), THREAD_PRIORITY_MAIN - 1,
+                             THREAD_CREATE_STACKTEST, _ping, NULL, "ping");
+    msg_receive(&msg);
+
+    /* the waiter blocks on the mutex until main unlocks it */
+    thread_create(waiter_stack, sizeof(waiter_stack), THREAD_PRIORITY_MAIN - 1,
+                  THREAD_CREATE_STACKTEST, _waiter, NULL, "waiter");
+    mutex_unlock(&lock);
+
+    ktrace_stop();
+    puts("ktrace test done");
+
+    char line_buf[SHELL_DEFAULT_BUFSIZE];
+    shell_run(NULL, line_buf, SHELL_DEFAULT_BUFSIZE);
+    return 0;
+}
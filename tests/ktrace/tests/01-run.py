@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2020 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import os
+import sys
+from testrunner import run
+
+sys.path.append(os.path.join(os.environ['RIOTTOOLS'], 'ktrace'))
+from ktrace2json import extract_hex_dump, parse_dump, to_chrome_trace  # noqa: E402
+
+ROUNDS = 5
+MARKER_ROUND = 1
+SPAN_ROUND = 2
+
+
+def _count(events, name, **args):
+    return len([e for e in events if e['name'] == name and
+                all(e.get('args', {}).get(k) == v for k, v in args.items())])
+
+
+def testfunc(child):
+    child.expect_exact('ktrace test done')
+
+    child.sendline('ktrace dump')
+    child.expect_exact('ktrace: begin')
+    child.expect_exact('ktrace: end')
+    dump = extract_hex_dump('ktrace: begin\n' + child.before + 'ktrace: end')
+
+    clock_hz, lost, entries, names = parse_dump(dump)
+    assert clock_hz > 0
+    assert {'ping', 'pong', 'waiter'} <= set(names.values())
+    pids = {name: pid for pid, name in names.items()}
+
+    events = to_chrome_trace(clock_hz, lost, entries, names)['traceEvents']
+    assert _count(events, 'running') > 0
+    for i in range(ROUNDS):
+        assert _count(events, 'marker {}'.format(MARKER_ROUND), value=i) == 1
+        assert _count(events, 'msg_send', to=pids['pong'], type='0x{:04x}'.format(i)) == 1
+        assert _count(events, 'msg_receive', **{'from': pids['ping'],
+                                                'type': '0x{:04x}'.format(i)}) == 1
+    assert _count(events, 'span {}'.format(SPAN_ROUND)) == 2 * ROUNDS
+
+    blocked = [e for e in events if e['name'] == 'mutex_block' and e['tid'] == pids['waiter']]
+    assert len(blocked) == 1
+    assert _count(events, 'mutex_unblock', mutex=blocked[0]['args']['mutex'],
+                  woken=pids['waiter']) == 1
+
+    # the trace must be stable while recording is stopped
+    child.sendline('ktrace dump')
+    child.expect_exact('ktrace: begin')
+    child.expect_exact('ktrace: end')
+    assert extract_hex_dump('ktrace: begin\n' + child.before + 'ktrace: end') == dump
+
+    print('SUCCESS')
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc))
@@ -0,0 +1,345 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Test for message queues with several producers
+ *
+ * Built with `core_msg_mpsc` by default, see the Makefile. The main thread
+ * owns a message queue and is fed by ISRs and threads at the same time, by
+ * threads blocked on its full queue and by bulk transfers. msg_send_receive()
+ * and msg_reply() are tested against a server thread with a queue.
+ */
+#include <stdint.h>
+#include <stdio.h>
+
+#include "embUnit.h"
+#include "kernel_defines.h"
+#include "msg.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define QUEUE_SIZE          (8U)
+#define ISR_PRODUCERS       (3U)
+#define ISR_MSGS            (64U)
+/* the first ISR producer sends with msg_send_bulk() */
+#define ISR_BULK_SIZE       (4U)
+#define ISR_INTERVAL        (100U)
+#define THREAD_MSGS         (64U)
+#define SENDERS_NUMOF       (3U)
+#define SENDER_MSGS         (2U)
+#define SEND_RECEIVE_NUMOF  (QUEUE_SIZE - 1)
+#define BULK_MSGS           (50U)
+#define BULK_SIZE           (6U)
+
+enum {
+    /* types below ISR_PRODUCERS are used by the ISR producers */
+    TYPE_THREAD = ISR_PRODUCERS,
+    TYPE_SELF,
+    TYPE_BLOCKED,
+    TYPE_NOTIFY,
+    TYPE_REQUEST,
+    TYPE_REPLY,
+    TYPE_STOP,
+    TYPE_BULK,
+};
+
+typedef struct {
+    xtimer_t timer;
+    uint16_t type;
+    unsigned seq;
+} _isr_producer_t;
+
+static msg_t _main_queue[QUEUE_SIZE];
+static kernel_pid_t _main_pid;
+static char _stacks[SENDERS_NUMOF][THREAD_STACKSIZE_DEFAULT];
+static _isr_producer_t _isr_producers[ISR_PRODUCERS];
+static msg_t _bulk_msgs[BULK_MSGS];
+
+static void _isr_send(void *arg)
+{
+    _isr_producer_t *producer = arg;
+    msg_t m[ISR_BULK_SIZE];
+    unsigned num = (producer->type == 0) ? ISR_BULK_SIZE : 1;
+    int res;
+
+    if (num > (ISR_MSGS - producer->seq)) {
+        num = ISR_MSGS - producer->seq;
+    }
+    for (unsigned i = 0; i < num; i++) {
+        m[i].type = producer->type;
+        m[i].content.value = producer->seq + i;
+    }
+    if (producer->type == 0) {
+        res = msg_send_bulk(m, num, _main_pid);
+    }
+    else {
+        res = msg_send(m, _main_pid);
+    }
+    /* retry whatever did not fit into the queue */
+    if (res > 0) {
+        producer->seq += res;
+    }
+    if (producer->seq < ISR_MSGS) {
+        xtimer_set(&producer->timer, ISR_INTERVAL);
+    }
+}
+
+static void *_thread_send(void *arg)
+{
+    msg_t m = { .type = TYPE_THREAD };
+
+    (void)arg;
+    for (unsigned i = 0; i < THREAD_MSGS; i++) {
+        m.content.value = i;
+        msg_send(&m, _main_pid);
+    }
+    return NULL;
+}
+
+static void *_blocked_send(void *arg)
+{
+    msg_t m = { .type = TYPE_BLOCKED };
+
+    (void)arg;
+    for (unsigned i = 0; i < SENDER_MSGS; i++) {
+        m.content.value = i;
+        msg_send(&m, _main_pid);
+    }
+    return NULL;
+}
+
+static void *_server(void *arg)
+{
+    msg_t queue[QUEUE_SIZE];
+    unsigned notified = 0;
+
+    (void)arg;
+    msg_init_queue(queue, QUEUE_SIZE);
+    while (1) {
+        msg_t m, reply = { .type = TYPE_REPLY };
+
+        msg_receive(&m);
+        switch (m.type) {
+            case TYPE_NOTIFY:
+                notified++;
+                break;
+            case TYPE_REQUEST:
+                /* number of notifications queued ahead of the request */
+                reply.content.value = notified;
+                notified = 0;
+                msg_reply(&m, &reply);
+                break;
+            case TYPE_STOP:
+                msg_reply(&m, &reply);
+                return NULL;
+            default:
+                break;
+        }
+    }
+}
+
+static void *_bulk_send(void *arg)
+{
+    unsigned sent = 0;
+
+    (void)arg;
+    for (unsigned i = 0; i < BULK_MSGS; i++) {
+        _bulk_msgs[i].type = TYPE_BULK;
+        _bulk_msgs[i].content.value = i;
+    }
+    while (sent < BULK_MSGS) {
+        int res = msg_send_bulk(&_bulk_msgs[sent], BULK_MSGS - sent,
+                                _main_pid);
+
+        if (res < 0) {
+            break;
+        }
+        sent += res;
+        if (res == 0) {
+            thread_yield();
+        }
+    }
+    return NULL;
+}
+
+static void _wait_stopped(kernel_pid_t pid)
+{
+    while (thread_getstatus(pid) != STATUS_NOT_FOUND) {
+        xtimer_usleep(ISR_INTERVAL);
+    }
+}
+
+static void test_msg_mpsc__isr_and_thread_producers(void)
+{
+    unsigned next[ISR_PRODUCERS + 1] = { 0 };
+    kernel_pid_t pid;
+
+    for (unsigned i = 0; i < ISR_PRODUCERS; i++) {
+        _isr_producers[i].timer.callback = _isr_send;
+        _isr_producers[i].timer.arg = &_isr_producers[i];
+        _isr_producers[i].type = i;
+        _isr_producers[i].seq = 0;
+        xtimer_set(&_isr_producers[i].timer, ISR_INTERVAL);
+    }
+    /* fills the queue and blocks while the ISRs keep sending */
+    pid = thread_create(_stacks[0], sizeof(_stacks[0]),
+                        THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST,
+                        _thread_send, NULL, "thread_send");
+    TEST_ASSERT(pid > KERNEL_PID_UNDEF);
+
+    for (unsigned i = 0; i < ((ISR_PRODUCERS * ISR_MSGS) + THREAD_MSGS); i++) {
+        msg_t m;
+
+        TEST_ASSERT_EQUAL_INT(1, msg_receive(&m));
+        TEST_ASSERT(m.type <= TYPE_THREAD);
+        TEST_ASSERT_EQUAL_INT((m.type == TYPE_THREAD) ? pid : KERNEL_PID_ISR,
+                              m.sender_pid);
+        /* every producer's messages arrive complete and in order */
+        TEST_ASSERT_EQUAL_INT(next[m.type], m.content.value);
+        next[m.type]++;
+    }
+    for (unsigned i = 0; i < ISR_PRODUCERS; i++) {
+        TEST_ASSERT_EQUAL_INT(ISR_MSGS, next[i]);
+    }
+    TEST_ASSERT_EQUAL_INT(THREAD_MSGS, next[TYPE_THREAD]);
+    TEST_ASSERT_EQUAL_INT(0, msg_avail());
+    _wait_stopped(pid);
+}
+
+static void test_msg_mpsc__blocked_senders(void)
+{
+    kernel_pid_t pids[SENDERS_NUMOF];
+    msg_t m = { .type = TYPE_SELF };
+
+    for (unsigned i = 0; i < QUEUE_SIZE; i++) {
+        m.content.value = i;
+        TEST_ASSERT_EQUAL_INT(1, msg_send_to_self(&m));
+    }
+    for (unsigned i = 0; i < SENDERS_NUMOF; i++) {
+        pids[i] = thread_create(_stacks[i], sizeof(_stacks[i]),
+                                THREAD_PRIORITY_MAIN - 1,
+                                THREAD_CREATE_STACKTEST, _blocked_send, NULL,
+                                "blocked_send");
+        TEST_ASSERT(pids[i] > KERNEL_PID_UNDEF);
+        /* higher priority than main, so it already ran into the full queue */
+        TEST_ASSERT_EQUAL_INT(STATUS_SEND_BLOCKED, thread_getstatus(pids[i]));
+    }
+
+    for (unsigned i = 0; i < QUEUE_SIZE; i++) {
+        TEST_ASSERT_EQUAL_INT(1, msg_receive(&m));
+        TEST_ASSERT_EQUAL_INT(TYPE_SELF, m.type);
+        TEST_ASSERT_EQUAL_INT(i, m.content.value);
+    }
+    /* a woken sender queues behind the other blocked senders again */
+    for (unsigned i = 0; i < SENDER_MSGS; i++) {
+        for (unsigned j = 0; j < SENDERS_NUMOF; j++) {
+            TEST_ASSERT_EQUAL_INT(1, msg_receive(&m));
+            TEST_ASSERT_EQUAL_INT(TYPE_BLOCKED, m.type);
+            TEST_ASSERT_EQUAL_INT(pids[j], m.sender_pid);
+            TEST_ASSERT_EQUAL_INT(i, m.content.value);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(0, msg_avail());
+    for (unsigned i = 0; i < SENDERS_NUMOF; i++) {
+        _wait_stopped(pids[i]);
+    }
+}
+
+static void test_msg_mpsc__send_receive_reply(void)
+{
+    /* server receives right away or only once main is reply blocked */
+    static const uint8_t prios[] = {
+        THREAD_PRIORITY_MAIN - 1, THREAD_PRIORITY_MAIN + 1
+    };
+
+    for (unsigned i = 0; i < ARRAY_SIZE(prios); i++) {
+        msg_t m = { .type = TYPE_NOTIFY };
+        msg_t req = { .type = TYPE_REQUEST };
+        msg_t reply;
+        kernel_pid_t pid;
+
+        pid = thread_create(_stacks[0], sizeof(_stacks[0]), prios[i],
+                            THREAD_CREATE_STACKTEST, _server, NULL, "server");
+        TEST_ASSERT(pid > KERNEL_PID_UNDEF);
+        for (unsigned j = 0; j < SEND_RECEIVE_NUMOF; j++) {
+            for (unsigned k = 0; k < j; k++) {
+                TEST_ASSERT_EQUAL_INT(1, msg_send(&m, pid));
+            }
+            TEST_ASSERT_EQUAL_INT(1, msg_send_receive(&req, &reply, pid));
+            TEST_ASSERT_EQUAL_INT(TYPE_REPLY, reply.type);
+            TEST_ASSERT_EQUAL_INT(j, reply.content.value);
+        }
+        m.type = TYPE_STOP;
+        TEST_ASSERT_EQUAL_INT(1, msg_send_receive(&m, &reply, pid));
+        TEST_ASSERT_EQUAL_INT(TYPE_REPLY, reply.type);
+        _wait_stopped(pid);
+    }
+}
+
+static void test_msg_mpsc__bulk(void)
+{
+    msg_t m[BULK_SIZE];
+    unsigned received = 0;
+    int max = 0;
+    kernel_pid_t pid;
+
+    /* sends whenever main blocks for messages */
+    pid = thread_create(_stacks[0], sizeof(_stacks[0]),
+                        THREAD_PRIORITY_MAIN + 1, THREAD_CREATE_STACKTEST,
+                        _bulk_send, NULL, "bulk_send");
+    TEST_ASSERT(pid > KERNEL_PID_UNDEF);
+
+    while (received < BULK_MSGS) {
+        int res = msg_receive_bulk(m, BULK_SIZE);
+
+        TEST_ASSERT(res >= 1);
+        TEST_ASSERT(res <= (int)BULK_SIZE);
+        for (int i = 0; i < res; i++) {
+            TEST_ASSERT_EQUAL_INT(TYPE_BULK, m[i].type);
+            TEST_ASSERT_EQUAL_INT(pid, m[i].sender_pid);
+            TEST_ASSERT_EQUAL_INT(received, m[i].content.value);
+            received++;
+        }
+        if (res > max) {
+            max = res;
+        }
+    }
+    /* the sender filled the queue while main was blocked */
+    TEST_ASSERT_EQUAL_INT(BULK_SIZE, max);
+    TEST_ASSERT_EQUAL_INT(0, msg_avail());
+    _wait_stopped(pid);
+}
+
+static Test *tests_msg_mpsc(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_msg_mpsc__isr_and_thread_producers),
+        new_TestFixture(test_msg_mpsc__blocked_senders),
+        new_TestFixture(test_msg_mpsc__send_receive_reply),
+        new_TestFixture(test_msg_mpsc__bulk),
+    };
+
+    EMB_UNIT_TESTCALLER(msg_mpsc_tests, NULL, NULL, fixtures);
+
+    return (Test *)&msg_mpsc_tests;
+}
+
+int main(void)
+{
+    msg_init_queue(_main_queue, QUEUE_SIZE);
+    _main_pid = thread_getpid();
+
+    TESTS_START();
+    TESTS_RUN(tests_msg_mpsc());
+    TESTS_END();
+    return 0;
+}
+/** @} */
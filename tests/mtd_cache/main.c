@@ -0,0 +1,346 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Test application for the mtd_cache device
+ *
+ * Checks that data accessed through mtd_cache on the board's MTD device
+ * stays consistent and that writes are coalesced.
+ */
+#include <errno.h>
+#include <string.h>
+
+#include "board.h"
+#include "embUnit.h"
+#include "mtd.h"
+#include "mtd_cache.h"
+
+/* Define MTD_0 in board.h to use the board mtd if any */
+#ifdef MTD_0
+#define _storage (MTD_0)
+#else
+/* Test mock object implementing a simple RAM-based mtd */
+#ifndef SECTOR_COUNT
+#define SECTOR_COUNT 32
+#endif
+#ifndef PAGE_PER_SECTOR
+#define PAGE_PER_SECTOR 4
+#endif
+#ifndef PAGE_SIZE
+#define PAGE_SIZE 64
+#endif
+
+static uint8_t dummy_memory[PAGE_PER_SECTOR * PAGE_SIZE * SECTOR_COUNT];
+
+static int _init(mtd_dev_t *dev)
+{
+    (void)dev;
+
+    return 0;
+}
+
+static int _read(mtd_dev_t *dev, void *buff, uint32_t addr, uint32_t size)
+{
+    (void)dev;
+
+    if (addr + size > sizeof(dummy_memory)) {
+        return -EOVERFLOW;
+    }
+    memcpy(buff, dummy_memory + addr, size);
+
+    return size;
+}
+
+static int _write(mtd_dev_t *dev, const void *buff, uint32_t addr, uint32_t size)
+{
+    (void)dev;
+
+    if (addr + size > sizeof(dummy_memory)) {
+        return -EOVERFLOW;
+    }
+    if (((addr % PAGE_SIZE) + size) > PAGE_SIZE) {
+        return -EOVERFLOW;
+    }
+    memcpy(dummy_memory + addr, buff, size);
+
+    return size;
+}
+
+static int _erase(mtd_dev_t *dev, uint32_t addr, uint32_t size)
+{
+    (void)dev;
+
+    if (size % (PAGE_PER_SECTOR * PAGE_SIZE) != 0) {
+        return -EOVERFLOW;
+    }
+    if (addr % (PAGE_PER_SECTOR * PAGE_SIZE) != 0) {
+        return -EOVERFLOW;
+    }
+    if (addr + size > sizeof(dummy_memory)) {
+        return -EOVERFLOW;
+    }
+    memset(dummy_memory + addr, 0xff, size);
+
+    return 0;
+}
+
+static int _power(mtd_dev_t *dev, enum mtd_power_state power)
+{
+    (void)dev;
+    (void)power;
+    return 0;
+}
+
+static const mtd_desc_t driver = {
+    .init = _init,
+    .read = _read,
+    .write = _write,
+    .erase = _erase,
+    .power = _power,
+};
+
+static mtd_dev_t dev = {
+    .driver = &driver,
+    .sector_count = SECTOR_COUNT,
+    .pages_per_sector = PAGE_PER_SECTOR,
+    .page_size = PAGE_SIZE,
+};
+
+static mtd_dev_t *_storage = (mtd_dev_t*) &dev;
+#endif /* MTD_0 */
+
+/* number of sectors used by the test */
+#ifndef TEST_SECTORS
+#ifdef MTD_0
+#define TEST_SECTORS    (16U)
+#else
+#define TEST_SECTORS    (SECTOR_COUNT)
+#endif
+#endif
+
+/* counts the calls to the storage driver */
+typedef struct {
+    mtd_dev_t base;
+    mtd_dev_t *parent;
+    unsigned reads;
+    unsigned writes;
+    unsigned erases;
+} counting_mtd_t;
+
+static int _count_init(mtd_dev_t *dev)
+{
+    counting_mtd_t *count = (counting_mtd_t *)dev;
+    int res = mtd_init(count->parent);
+
+    dev->sector_count = TEST_SECTORS;
+    dev->pages_per_sector = count->parent->pages_per_sector;
+    dev->page_size = count->parent->page_size;
+    return res;
+}
+
+static int _count_read(mtd_dev_t *dev, void *buff, uint32_t addr, uint32_t size)
+{
+    counting_mtd_t *count = (counting_mtd_t *)dev;
+    count->reads++;
+    return mtd_read(count->parent, buff, addr, size);
+}
+
+static int _count_write(mtd_dev_t *dev, const void *buff, uint32_t addr,
+                        uint32_t size)
+{
+    counting_mtd_t *count = (counting_mtd_t *)dev;
+    count->writes++;
+    return mtd_write(count->parent, buff, addr, size);
+}
+
+static int _count_erase(mtd_dev_t *dev, uint32_t addr, uint32_t size)
+{
+    counting_mtd_t *count = (counting_mtd_t *)dev;
+    count->erases++;
+    return mtd_erase(count->parent, addr, size);
+}
+
+static int _count_power(mtd_dev_t *dev, enum mtd_power_state power)
+{
+    counting_mtd_t *count = (counting_mtd_t *)dev;
+    return mtd_power(count->parent, power);
+}
+
+static const mtd_desc_t count_driver = {
+    .init = _count_init,
+    .read = _count_read,
+    .write = _count_write,
+    .erase = _count_erase,
+    .power = _count_power,
+};
+
+static counting_mtd_t _count = {
+    .base.driver = &count_driver,
+};
+
+static mtd_cache_t _cache = {
+    .base.driver = &mtd_cache_driver,
+    .parent = &_count.base,
+};
+
+#define BUF_SIZE        (1024U)
+
+static uint8_t _buf[BUF_SIZE];
+static uint8_t _ref[BUF_SIZE];
+
+static void _pattern(uint8_t *buf, size_t len, unsigned seed)
+{
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = (uint8_t)(i * 7 + seed * 13 + (i >> 8));
+    }
+}
+
+static void _reset_counts(void)
+{
+    _count.reads = 0;
+    _count.writes = 0;
+    _count.erases = 0;
+}
+
+static void setup(void)
+{
+    _count.parent = _storage;
+    TEST_ASSERT_EQUAL_INT(0, mtd_init(&_cache.base));
+    TEST_ASSERT_EQUAL_INT(0, mtd_erase(&_cache.base, 0, TEST_SECTORS *
+                                       _cache.base.pages_per_sector *
+                                       _cache.base.page_size));
+    _reset_counts();
+}
+
+static void test_mtd_cache_read_write(void)
+{
+    mtd_dev_t *mtd = &_cache.base;
+    uint32_t page_size = mtd->page_size;
+    uint32_t len = 4 * page_size;
+
+    TEST_ASSERT(len <= sizeof(_ref));
+    _pattern(_ref, len, 1);
+
+    /* write in small chunks, never crossing a page */
+    for (uint32_t pos = 0; pos < len;) {
+        uint32_t chunk = 1 + (pos % 23);
+        if (chunk > page_size - (pos % page_size)) {
+            chunk = page_size - (pos % page_size);
+        }
+        TEST_ASSERT_EQUAL_INT(chunk, mtd_write(mtd, &_ref[pos], pos, chunk));
+        pos += chunk;
+    }
+    TEST_ASSERT_EQUAL_INT(4, _count.writes);
+    TEST_ASSERT(_cache.stats.write_merged > 0);
+
+    /* unaligned reads of varying size are served consistently */
+    for (uint32_t pos = 0, i = 0; pos < len; i++) {
+        uint32_t chunk = 1 + ((i * 37) % (page_size + 17));
+        if (chunk > len - pos) {
+            chunk = len - pos;
+        }
+        memset(_buf, 0, chunk);
+        TEST_ASSERT_EQUAL_INT(chunk, mtd_read(mtd, _buf, pos, chunk));
+        TEST_ASSERT_EQUAL_INT(0, memcmp(&_ref[pos], _buf, chunk));
+        pos += chunk;
+    }
+
+    /* a pending write is visible to reads and reaches the device on flush */
+    const uint8_t tail[] = { 0x00, 0x11, 0x22 };
+    TEST_ASSERT_EQUAL_INT(sizeof(tail), mtd_write(mtd, tail, len, sizeof(tail)));
+    TEST_ASSERT_EQUAL_INT(sizeof(tail), mtd_read(mtd, _buf, len, sizeof(tail)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(tail, _buf, sizeof(tail)));
+    TEST_ASSERT_EQUAL_INT(0, mtd_cache_flush(&_cache));
+    TEST_ASSERT_EQUAL_INT(sizeof(tail), mtd_read(_storage, _buf, len,
+                                                 sizeof(tail)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(tail, _buf, sizeof(tail)));
+
+    /* erased lines are not served from the cache */
+    TEST_ASSERT_EQUAL_INT(0, mtd_erase(mtd, 0, mtd->pages_per_sector *
+                                       page_size));
+    TEST_ASSERT_EQUAL_INT(page_size, mtd_read(mtd, _buf, 0, page_size));
+    for (unsigned i = 0; i < page_size; i++) {
+        TEST_ASSERT_EQUAL_INT(0xff, _buf[i]);
+    }
+
+    /* writes crossing a page boundary are rejected like by the drivers */
+    TEST_ASSERT_EQUAL_INT(-EOVERFLOW, mtd_write(mtd, _ref, page_size - 1, 2));
+}
+
+static void test_mtd_cache_read_ahead_pending_write(void)
+{
+    mtd_dev_t *mtd = &_cache.base;
+    const uint8_t data[] = { 0x00, 0x11, 0x22 };
+    uint32_t line = MTD_CACHE_LINE_SIZE;
+
+    /* leave a partial write to line 2 pending */
+    TEST_ASSERT_EQUAL_INT(1, mtd_read(mtd, _buf, line - 1, 1));
+    TEST_ASSERT_EQUAL_INT(sizeof(data), mtd_write(mtd, data, 2 * line,
+                                                  sizeof(data)));
+
+    /* the miss on line 1 follows line 0, the read-ahead must stop before the
+     * line of the pending write */
+    uint32_t read_ahead = _cache.stats.read_ahead;
+    TEST_ASSERT_EQUAL_INT(1, mtd_read(mtd, _buf, line, 1));
+    TEST_ASSERT_EQUAL_INT(read_ahead, _cache.stats.read_ahead);
+    TEST_ASSERT_EQUAL_INT(sizeof(data), mtd_read(mtd, _buf, 2 * line,
+                                                 sizeof(data)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(data, _buf, sizeof(data)));
+
+    /* the read flushed the write, the data is on the device now */
+    TEST_ASSERT_EQUAL_INT(sizeof(data), mtd_read(_storage, _buf, 2 * line,
+                                                 sizeof(data)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(data, _buf, sizeof(data)));
+}
+
+static void test_mtd_cache_flush(void)
+{
+    mtd_dev_t *mtd = &_cache.base;
+    const uint8_t data[] = { 0x00, 0x11, 0x22 };
+
+    /* devices not buffering writes have nothing to flush */
+    TEST_ASSERT_EQUAL_INT(0, mtd_flush(_storage));
+
+    /* a partial page write is held back until the generic flush */
+    TEST_ASSERT_EQUAL_INT(sizeof(data), mtd_write(mtd, data, 0, sizeof(data)));
+    TEST_ASSERT_EQUAL_INT(0, _count.writes);
+    TEST_ASSERT_EQUAL_INT(0, mtd_flush(mtd));
+    TEST_ASSERT_EQUAL_INT(1, _count.writes);
+    TEST_ASSERT_EQUAL_INT(sizeof(data), mtd_read(_storage, _buf, 0,
+                                                 sizeof(data)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(data, _buf, sizeof(data)));
+
+    /* flushing again does not program anything */
+    TEST_ASSERT_EQUAL_INT(0, mtd_flush(mtd));
+    TEST_ASSERT_EQUAL_INT(1, _count.writes);
+}
+
+Test *tests_mtd_cache(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_mtd_cache_read_write),
+        new_TestFixture(test_mtd_cache_read_ahead_pending_write),
+        new_TestFixture(test_mtd_cache_flush),
+    };
+
+    EMB_UNIT_TESTCALLER(mtd_cache_tests, setup, NULL, fixtures);
+
+    return (Test *)&mtd_cache_tests;
+}
+
+int main(void)
+{
+    TESTS_START();
+    TESTS_RUN(tests_mtd_cache());
+    TESTS_END();
+    return 0;
+}
+/** @} */
@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Test and throughput benchmark for the mtd_spi_nor driver
+ *
+ * Uses the last sectors of the device, their content is lost.
+ */
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "board.h"
+#include "embUnit.h"
+#include "mtd.h"
+#include "mtd_spi_nor.h"
+#include "xtimer.h"
+#if MODULE_MTD_ASYNC
+#include "mtd_async.h"
+#endif
+
+/* MTD_0 is only used on boards declaring it as a mtd_spi_nor_t in the
+ * Makefile, on others (e.g. native) it is a different kind of device */
+#ifdef TEST_SPI_NOR_MTD_0
+#define dev (MTD_0)
+#else
+#ifndef TEST_SPI_NOR_SPI
+#define TEST_SPI_NOR_SPI        SPI_DEV(0)
+#endif
+#ifndef TEST_SPI_NOR_CS
+#define TEST_SPI_NOR_CS         GPIO_PIN(0, 0)
+#endif
+#ifndef TEST_SPI_NOR_SECTORS
+#define TEST_SPI_NOR_SECTORS    (512U)  /* 16 MBit */
+#endif
+
+static mtd_spi_nor_t _dev = {
+    .base = {
+        .driver = &mtd_spi_nor_driver,
+        .page_size = 256,
+        .pages_per_sector = 16,
+        .sector_count = TEST_SPI_NOR_SECTORS,
+    },
+    .opcode = &mtd_spi_nor_opcode_default,
+    .spi = TEST_SPI_NOR_SPI,
+    .cs = TEST_SPI_NOR_CS,
+    .addr_width = 3,
+    .mode = SPI_MODE_0,
+    .clk = SPI_CLK_10MHZ,
+    .flag = SPI_NOR_F_SECT_4K,
+};
+
+static mtd_dev_t *dev = (mtd_dev_t *)&_dev;
+#endif /* TEST_SPI_NOR_MTD_0 */
+
+/* size of the benchmark, must be a multiple of the sector size */
+#ifndef TEST_SIZE
+#define TEST_SIZE               (8192U)
+#endif
+
+static uint8_t _buf[TEST_SIZE];
+static uint8_t _ref[TEST_SIZE];
+
+static uint32_t _test_addr(void)
+{
+    uint32_t sector_size = dev->pages_per_sector * dev->page_size;
+    uint32_t sectors = (TEST_SIZE + sector_size - 1) / sector_size;
+
+    return (dev->sector_count - sectors) * sector_size;
+}
+
+static uint32_t _erase_size(void)
+{
+    uint32_t sector_size = dev->pages_per_sector * dev->page_size;
+
+    return ((TEST_SIZE + sector_size - 1) / sector_size) * sector_size;
+}
+
+static uint32_t _kibps(uint32_t bytes, uint32_t us)
+{
+    return (uint32_t)(((uint64_t)bytes * US_PER_SEC) / (1024 * (us ? us : 1)));
+}
+
+static void setup(void)
+{
+    for (unsigned i = 0; i < TEST_SIZE; i++) {
+        _ref[i] = i + (i >> 8);
+    }
+    TEST_ASSERT(dev->driver == &mtd_spi_nor_driver);
+    TEST_ASSERT_EQUAL_INT(0, mtd_init(dev));
+    TEST_ASSERT_EQUAL_INT(0, mtd_erase(dev, _test_addr(), _erase_size()));
+}
+
+static void test_mtd_spi_nor_read_across_pages(void)
+{
+    uint32_t addr = _test_addr();
+    uint32_t page_size = dev->page_size;
+
+    TEST_ASSERT(4 * page_size <= TEST_SIZE);
+    for (unsigned i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_INT(page_size, mtd_write(dev, &_ref[i * page_size],
+                                                   addr + i * page_size,
+                                                   page_size));
+    }
+
+    /* one read spanning all pages */
+    memset(_buf, 0, TEST_SIZE);
+    TEST_ASSERT_EQUAL_INT(4 * page_size, mtd_read(dev, _buf, addr, 4 * page_size));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_ref, _buf, 4 * page_size));
+
+    /* unaligned read crossing a page boundary */
+    memset(_buf, 0, TEST_SIZE);
+    TEST_ASSERT_EQUAL_INT(page_size, mtd_read(dev, _buf, addr + page_size / 2,
+                                              page_size));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&_ref[page_size / 2], _buf, page_size));
+
+    /* program does not cross pages */
+    TEST_ASSERT_EQUAL_INT(-EOVERFLOW, mtd_write(dev, _ref, addr + page_size - 1, 2));
+}
+
+static void test_mtd_spi_nor_throughput(void)
+{
+    uint32_t addr = _test_addr();
+    uint32_t page_size = dev->page_size;
+
+    /* erase in setup() included the wait for the device */
+    uint32_t start = xtimer_now_usec();
+    TEST_ASSERT_EQUAL_INT(0, mtd_erase(dev, addr, _erase_size()));
+    uint32_t t_erase = xtimer_now_usec() - start;
+
+    start = xtimer_now_usec();
+    for (uint32_t pos = 0; pos < TEST_SIZE; pos += page_size) {
+        TEST_ASSERT_EQUAL_INT(page_size, mtd_write(dev, &_ref[pos], addr + pos,
+                                                   page_size));
+    }
+    uint32_t t_prog = xtimer_now_usec() - start;
+
+    memset(_buf, 0, TEST_SIZE);
+    start = xtimer_now_usec();
+    for (uint32_t pos = 0; pos < TEST_SIZE; pos += page_size) {
+        TEST_ASSERT_EQUAL_INT(page_size, mtd_read(dev, &_buf[pos], addr + pos,
+                                                  page_size));
+    }
+    uint32_t t_read_page = xtimer_now_usec() - start;
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_ref, _buf, TEST_SIZE));
+
+    memset(_buf, 0, TEST_SIZE);
+    start = xtimer_now_usec();
+    TEST_ASSERT_EQUAL_INT(TEST_SIZE, mtd_read(dev, _buf, addr, TEST_SIZE));
+    uint32_t t_read_bulk = xtimer_now_usec() - start;
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_ref, _buf, TEST_SIZE));
+
+    printf("\nerase: %" PRIu32 " us for %" PRIu32 " bytes\n", t_erase, _erase_size());
+    printf("program: %" PRIu32 " KiB/s\n", _kibps(TEST_SIZE, t_prog));
+    printf("read: %" PRIu32 " KiB/s per page, %" PRIu32 " KiB/s bulk\n",
+           _kibps(TEST_SIZE, t_read_page), _kibps(TEST_SIZE, t_read_bulk));
+}
+
+#if MODULE_MTD_ASYNC
+static event_queue_t _queue;
+static volatile int _async_res;
+static volatile bool _async_done;
+
+static void _async_cb(void *arg, int res)
+{
+    (void)arg;
+    _async_res = res;
+    _async_done = true;
+}
+
+/* does some work while serving the queue until the operation is done,
+ * returns the number of work iterations */
+static uint32_t _work_until_done(void)
+{
+    uint32_t work = 0;
+
+    while (!_async_done) {
+        event_t *event = event_get(&_queue);
+        if (event) {
+            event->handler(event);
+        }
+        else {
+            xtimer_usleep(100);
+            work++;
+        }
+    }
+
+    return work;
+}
+
+static void test_mtd_spi_nor_async(void)
+{
+    uint32_t addr = _test_addr();
+    uint32_t page_size = dev->page_size;
+    mtd_async_t op;
+    mtd_async_t busy;
+
+    event_queue_init(&_queue);
+    mtd_async_init(&op, &_queue, _async_cb, NULL);
+    mtd_async_init(&busy, &_queue, _async_cb, NULL);
+
+    _async_done = false;
+    uint32_t start = xtimer_now_usec();
+    TEST_ASSERT_EQUAL_INT(0, mtd_erase_async(dev, &op, addr, _erase_size()));
+    /* the device is busy with the erase */
+    TEST_ASSERT_EQUAL_INT(-EBUSY, mtd_write(dev, _ref, addr, page_size));
+    TEST_ASSERT_EQUAL_INT(-EBUSY, mtd_read(dev, _buf, addr, page_size));
+    TEST_ASSERT_EQUAL_INT(-EBUSY, mtd_power(dev, MTD_POWER_DOWN));
+    TEST_ASSERT_EQUAL_INT(-EBUSY, mtd_erase_async(dev, &busy, addr,
+                                                  _erase_size()));
+    uint32_t work_erase = _work_until_done();
+    uint32_t t_erase = xtimer_now_usec() - start;
+    TEST_ASSERT_EQUAL_INT(0, _async_res);
+
+    uint32_t work_prog = 0;
+    start = xtimer_now_usec();
+    for (uint32_t pos = 0; pos < TEST_SIZE; pos += page_size) {
+        _async_done = false;
+        TEST_ASSERT_EQUAL_INT(0, mtd_write_async(dev, &op, &_ref[pos],
+                                                 addr + pos, page_size));
+        work_prog += _work_until_done();
+        TEST_ASSERT_EQUAL_INT(page_size, _async_res);
+    }
+    uint32_t t_prog = xtimer_now_usec() - start;
+
+    memset(_buf, 0, TEST_SIZE);
+    _async_done = false;
+    TEST_ASSERT_EQUAL_INT(0, mtd_read_async(dev, &op, _buf, addr, TEST_SIZE));
+    _work_until_done();
+    TEST_ASSERT_EQUAL_INT(TEST_SIZE, _async_res);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_ref, _buf, TEST_SIZE));
+
+    printf("\nasync erase: %" PRIu32 " us, %" PRIu32 " work iterations\n",
+           t_erase, work_erase);
+    printf("async program: %" PRIu32 " KiB/s, %" PRIu32 " work iterations\n",
+           _kibps(TEST_SIZE, t_prog), work_prog);
+}
+#endif
+
+Test *tests_mtd_spi_nor(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_mtd_spi_nor_read_across_pages),
+        new_TestFixture(test_mtd_spi_nor_throughput),
+#if MODULE_MTD_ASYNC
+        new_TestFixture(test_mtd_spi_nor_async),
+#endif
+    };
+
+    EMB_UNIT_TESTCALLER(mtd_spi_nor_tests, setup, NULL, fixtures);
+
+    return (Test *)&mtd_spi_nor_tests;
+}
+
+int main(void)
+{
+    TESTS_START();
+    TESTS_RUN(tests_mtd_spi_nor());
+    TESTS_END();
+    return 0;
+}
+/** @} */
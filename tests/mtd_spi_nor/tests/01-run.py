@@ -0,0 +1,22 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2020 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+def testfunc(child):
+    child.expect(r'program: \d+ KiB/s')
+    child.expect(r'read: \d+ KiB/s per page, \d+ KiB/s bulk')
+    child.expect(r'async erase: \d+ us, \d+ work iterations')
+    child.expect(r'async program: \d+ KiB/s, \d+ work iterations')
+    child.expect(r'OK \(\d+ tests\)')
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc, timeout=120))
@@ -0,0 +1,342 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Test for poll(), select() and non-blocking sockets
+ *
+ * All datagrams are sent to the IPv6 loopback address, so no network
+ * interface is needed.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+#include "embUnit.h"
+#include "thread.h"
+#include "vfs.h"
+#include "xtimer.h"
+
+#ifdef CPU_NATIVE
+/* fcntl() is the one of the host on native */
+#define fcntl(fd, cmd, arg)     vfs_fcntl(fd, cmd, arg)
+#endif
+
+#define TEST_PORT           (20000U)
+#define TEST_SOCKS          (3U)
+#define TEST_PROTO          (253U)  /* RFC 3692 experimentation */
+#define TEST_DELAY          (10U * US_PER_MS)
+
+static int _socks[TEST_SOCKS];
+static int _raw;
+static int _sender;
+static char _buf[16];
+
+static char _sender_stack[THREAD_STACKSIZE_DEFAULT];
+static volatile uint32_t _sent_at;
+
+static void _addr(struct sockaddr_in6 *addr, uint16_t port)
+{
+    memset(addr, 0, sizeof(*addr));
+    addr->sin6_family = AF_INET6;
+    addr->sin6_port = htons(port);
+}
+
+static int _send(unsigned i, const char *data)
+{
+    struct sockaddr_in6 dst;
+
+    _addr(&dst, TEST_PORT + i);
+    dst.sin6_addr = in6addr_loopback;
+    return sendto(_sender, data, strlen(data), 0, (struct sockaddr *)&dst,
+                  sizeof(dst));
+}
+
+static void *_sender_thread(void *arg)
+{
+    xtimer_usleep(TEST_DELAY);
+    _sent_at = xtimer_now_usec();
+    _send((uintptr_t)arg, "later");
+    return NULL;
+}
+
+static void _fill_pollfds(struct pollfd *fds)
+{
+    for (unsigned i = 0; i < TEST_SOCKS; i++) {
+        fds[i].fd = _socks[i];
+        fds[i].events = POLLIN;
+    }
+    fds[TEST_SOCKS].fd = _raw;
+    fds[TEST_SOCKS].events = POLLIN;
+}
+
+static void setup(void)
+{
+    struct sockaddr_in6 local;
+
+    for (unsigned i = 0; i < TEST_SOCKS; i++) {
+        /* the first socket is blocking */
+        _socks[i] = socket(AF_INET6, SOCK_DGRAM | ((i > 0) ? SOCK_NONBLOCK : 0),
+                           IPPROTO_UDP);
+        TEST_ASSERT(_socks[i] >= 0);
+        _addr(&local, TEST_PORT + i);
+        TEST_ASSERT_EQUAL_INT(0, bind(_socks[i], (struct sockaddr *)&local,
+                                      sizeof(local)));
+    }
+    _raw = socket(AF_INET6, SOCK_RAW | SOCK_NONBLOCK, TEST_PROTO);
+    TEST_ASSERT(_raw >= 0);
+    _addr(&local, 0);
+    TEST_ASSERT_EQUAL_INT(0, bind(_raw, (struct sockaddr *)&local,
+                                  sizeof(local)));
+    _sender = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+    TEST_ASSERT(_sender >= 0);
+
+    /* bind() only stores the address, datagrams are received once the
+     * sockets were polled or read from */
+    struct pollfd fds[TEST_SOCKS + 1];
+    _fill_pollfds(fds);
+    TEST_ASSERT_EQUAL_INT(0, poll(fds, TEST_SOCKS + 1, 0));
+}
+
+static void teardown(void)
+{
+    for (unsigned i = 0; i < TEST_SOCKS; i++) {
+        close(_socks[i]);
+    }
+    close(_raw);
+    close(_sender);
+}
+
+static void test_posix_select_nonblocking(void)
+{
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, recv(_socks[0], _buf, sizeof(_buf), MSG_DONTWAIT));
+    TEST_ASSERT_EQUAL_INT(EAGAIN, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, recv(_socks[1], _buf, sizeof(_buf), 0));
+    TEST_ASSERT_EQUAL_INT(EAGAIN, errno);
+
+    TEST_ASSERT_EQUAL_INT(0, fcntl(_socks[0], F_SETFL, O_NONBLOCK));
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, recv(_socks[0], _buf, sizeof(_buf), 0));
+    TEST_ASSERT_EQUAL_INT(EAGAIN, errno);
+}
+
+static void test_posix_select_poll(void)
+{
+    struct pollfd fds[TEST_SOCKS + 1];
+
+    TEST_ASSERT_EQUAL_INT(3, _send(1, "one"));
+    TEST_ASSERT_EQUAL_INT(3, _send(1, "two"));
+    _fill_pollfds(fds);
+    TEST_ASSERT_EQUAL_INT(1, poll(fds, TEST_SOCKS + 1, 100));
+    for (unsigned i = 0; i <= TEST_SOCKS; i++) {
+        TEST_ASSERT_EQUAL_INT((i == 1) ? POLLIN : 0, fds[i].revents);
+    }
+
+    /* both datagrams are read, then the socket is not readable anymore */
+    TEST_ASSERT_EQUAL_INT(3, recv(_socks[1], _buf, sizeof(_buf), 0));
+    TEST_ASSERT_EQUAL_INT(0, memcmp("one", _buf, 3));
+    TEST_ASSERT_EQUAL_INT(1, poll(fds, TEST_SOCKS + 1, 0));
+    TEST_ASSERT_EQUAL_INT(3, recv(_socks[1], _buf, sizeof(_buf), 0));
+    TEST_ASSERT_EQUAL_INT(0, memcmp("two", _buf, 3));
+    TEST_ASSERT_EQUAL_INT(-1, recv(_socks[1], _buf, sizeof(_buf), 0));
+    TEST_ASSERT_EQUAL_INT(0, poll(fds, TEST_SOCKS + 1, 0));
+
+    /* sockets are always writable */
+    fds[0].events = POLLOUT;
+    TEST_ASSERT_EQUAL_INT(1, poll(fds, 1, 0));
+    TEST_ASSERT_EQUAL_INT(POLLOUT, fds[0].revents);
+}
+
+static void test_posix_select_poll_wakeup(void)
+{
+    struct pollfd fds[TEST_SOCKS + 1];
+
+    thread_create(_sender_stack, sizeof(_sender_stack),
+                  THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST,
+                  _sender_thread, (void *)2, "sender");
+    _fill_pollfds(fds);
+    TEST_ASSERT_EQUAL_INT(1, poll(fds, TEST_SOCKS + 1, -1));
+    uint32_t latency = xtimer_now_usec() - _sent_at;
+    TEST_ASSERT_EQUAL_INT(POLLIN, fds[2].revents);
+    TEST_ASSERT_EQUAL_INT(5, recv(_socks[2], _buf, sizeof(_buf), 0));
+    printf("\npoll() wake-up after sendto(): %" PRIu32 " us\n", latency);
+}
+
+static void test_posix_select_poll_timeout(void)
+{
+    struct pollfd fds[TEST_SOCKS + 1];
+
+    _fill_pollfds(fds);
+    uint32_t start = xtimer_now_usec();
+    TEST_ASSERT_EQUAL_INT(0, poll(fds, TEST_SOCKS + 1, 20));
+    TEST_ASSERT(xtimer_now_usec() - start >= 20 * US_PER_MS);
+}
+
+static void test_posix_select_raw(void)
+{
+    struct pollfd fds[TEST_SOCKS + 1];
+    struct sockaddr_in6 dst;
+
+    _addr(&dst, 0);
+    dst.sin6_addr = in6addr_loopback;
+    TEST_ASSERT_EQUAL_INT(3, sendto(_raw, "raw", 3, 0, (struct sockaddr *)&dst,
+                                    sizeof(dst)));
+    _fill_pollfds(fds);
+    TEST_ASSERT_EQUAL_INT(1, poll(fds, TEST_SOCKS + 1, 100));
+    TEST_ASSERT_EQUAL_INT(POLLIN, fds[TEST_SOCKS].revents);
+    TEST_ASSERT_EQUAL_INT(3, recv(_raw, _buf, sizeof(_buf), 0));
+    TEST_ASSERT_EQUAL_INT(0, memcmp("raw", _buf, 3));
+}
+
+static void test_posix_select_select(void)
+{
+    fd_set readfds, writefds;
+    struct timeval timeout = { .tv_sec = 0, .tv_usec = 100 * US_PER_MS };
+    int nfds = 0;
+
+    FD_ZERO(&readfds);
+    for (unsigned i = 0; i < TEST_SOCKS; i++) {
+        FD_SET(_socks[i], &readfds);
+        nfds = (_socks[i] >= nfds) ? _socks[i] + 1 : nfds;
+    }
+    TEST_ASSERT_EQUAL_INT(4, _send(0, "zero"));
+    TEST_ASSERT_EQUAL_INT(1, select(nfds, &readfds, NULL, NULL, &timeout));
+    for (unsigned i = 0; i < TEST_SOCKS; i++) {
+        TEST_ASSERT_EQUAL_INT(i == 0, !!FD_ISSET(_socks[i], &readfds));
+    }
+    TEST_ASSERT_EQUAL_INT(4, recv(_socks[0], _buf, sizeof(_buf), 0));
+
+    /* times out with empty sets */
+    FD_ZERO(&readfds);
+    FD_SET(_socks[0], &readfds);
+    timeout.tv_usec = 10 * US_PER_MS;
+    TEST_ASSERT_EQUAL_INT(0, select(nfds, &readfds, NULL, NULL, &timeout));
+    TEST_ASSERT(!FD_ISSET(_socks[0], &readfds));
+
+    FD_ZERO(&writefds);
+    FD_SET(_socks[0], &writefds);
+    FD_SET(_socks[1], &writefds);
+    TEST_ASSERT_EQUAL_INT(2, select(nfds, NULL, &writefds, NULL, NULL));
+}
+
+static void test_posix_select_oversized(void)
+{
+    struct pollfd fds[TEST_SOCKS + 1];
+    fd_set readfds;
+    struct timeval timeout = { .tv_sec = 0, .tv_usec = 0 };
+
+    /* the datagram is dropped by the failing recv() */
+    TEST_ASSERT_EQUAL_INT(20, _send(1, "exceeds the buffer.."));
+    _fill_pollfds(fds);
+    TEST_ASSERT_EQUAL_INT(1, poll(fds, TEST_SOCKS + 1, 100));
+    TEST_ASSERT_EQUAL_INT(POLLIN, fds[1].revents);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, recv(_socks[1], _buf, sizeof(_buf), 0));
+    TEST_ASSERT_EQUAL_INT(ENOBUFS, errno);
+
+    TEST_ASSERT_EQUAL_INT(0, poll(fds, TEST_SOCKS + 1, 0));
+    FD_ZERO(&readfds);
+    FD_SET(_socks[1], &readfds);
+    TEST_ASSERT_EQUAL_INT(0, select(_socks[1] + 1, &readfds, NULL, NULL,
+                                    &timeout));
+}
+
+static void test_posix_select_wrong_peer(void)
+{
+    struct sockaddr_in6 addr;
+    fd_set readfds;
+    struct timeval timeout = { .tv_sec = 0, .tv_usec = 100 * US_PER_MS };
+
+    /* receives only from a peer that never sends */
+    int s = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+    TEST_ASSERT(s >= 0);
+    _addr(&addr, TEST_PORT + TEST_SOCKS);
+    TEST_ASSERT_EQUAL_INT(0, bind(s, (struct sockaddr *)&addr, sizeof(addr)));
+    _addr(&addr, TEST_PORT + TEST_SOCKS + 1);
+    addr.sin6_addr = in6addr_loopback;
+    TEST_ASSERT_EQUAL_INT(0, connect(s, (struct sockaddr *)&addr,
+                                     sizeof(addr)));
+
+    /* the datagram of the sender is dropped by the failing recv() */
+    TEST_ASSERT_EQUAL_INT(5, _send(TEST_SOCKS, "stray"));
+    FD_ZERO(&readfds);
+    FD_SET(s, &readfds);
+    TEST_ASSERT_EQUAL_INT(1, select(s + 1, &readfds, NULL, NULL, &timeout));
+    TEST_ASSERT(FD_ISSET(s, &readfds));
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, recv(s, _buf, sizeof(_buf), 0));
+    TEST_ASSERT_EQUAL_INT(EPROTO, errno);
+
+    /* a blocking recv() would wait for the next datagram now */
+    FD_SET(s, &readfds);
+    timeout.tv_usec = 0;
+    TEST_ASSERT_EQUAL_INT(0, select(s + 1, &readfds, NULL, NULL, &timeout));
+    struct pollfd fd = { .fd = s, .events = POLLIN };
+    TEST_ASSERT_EQUAL_INT(0, poll(&fd, 1, 0));
+
+    close(s);
+}
+
+static void test_posix_select_invalid(void)
+{
+    struct pollfd fds[] = {
+        { .fd = -1, .events = POLLIN },
+        { .fd = VFS_MAX_OPEN_FILES, .events = POLLIN },
+    };
+    fd_set readfds;
+
+    TEST_ASSERT_EQUAL_INT(1, poll(fds, ARRAY_SIZE(fds), 0));
+    TEST_ASSERT_EQUAL_INT(0, fds[0].revents);
+    TEST_ASSERT_EQUAL_INT(POLLNVAL, fds[1].revents);
+
+    /* stdin is not a socket */
+    FD_ZERO(&readfds);
+    FD_SET(0, &readfds);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, select(1, &readfds, NULL, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(EBADF, errno);
+}
+
+Test *tests_posix_select(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_posix_select_nonblocking),
+        new_TestFixture(test_posix_select_poll),
+        new_TestFixture(test_posix_select_poll_wakeup),
+        new_TestFixture(test_posix_select_poll_timeout),
+        new_TestFixture(test_posix_select_raw),
+        new_TestFixture(test_posix_select_select),
+        new_TestFixture(test_posix_select_oversized),
+        new_TestFixture(test_posix_select_wrong_peer),
+        new_TestFixture(test_posix_select_invalid),
+    };
+
+    EMB_UNIT_TESTCALLER(posix_select_tests, setup, teardown, fixtures);
+
+    return (Test *)&posix_select_tests;
+}
+
+int main(void)
+{
+    TESTS_START();
+    TESTS_RUN(tests_posix_select());
+    TESTS_END();
+    return 0;
+}
+/** @} */
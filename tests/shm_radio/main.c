@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Test application for the shm_radio network device driver
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "byteorder.h"
+#include "net/ieee802154.h"
+#include "shell.h"
+#include "shm_radio.h"
+#include "shm_radio_params.h"
+#include "thread.h"
+#include "thread_flags.h"
+#include "xtimer.h"
+
+#define FLAG_ISR        (0x1)
+
+static shm_radio_t _dev;
+static char _rx_stack[THREAD_STACKSIZE_DEFAULT];
+static thread_t *_rx_thread;
+static uint8_t _rx_buf[IEEE802154_FRAME_LEN_MAX];
+static uint32_t _rx_seq_errors;
+static uint32_t _rx_next_seq;
+/* continues over send commands, so receivers can check the order */
+static uint32_t _tx_seq;
+
+static void _event_cb(netdev_t *dev, netdev_event_t event)
+{
+    if (event == NETDEV_EVENT_ISR) {
+        thread_flags_set(_rx_thread, FLAG_ISR);
+    }
+    else if (event == NETDEV_EVENT_RX_COMPLETE) {
+        int len = dev->driver->recv(dev, _rx_buf, sizeof(_rx_buf), NULL);
+        int hdr_len = ieee802154_get_frame_hdr_len(_rx_buf);
+        uint32_t seq;
+
+        if ((hdr_len <= 0) || (len < (int)(hdr_len + sizeof(seq)))) {
+            return;
+        }
+        memcpy(&seq, &_rx_buf[hdr_len], sizeof(seq));
+        /* frames from one sender arrive in order, but may be dropped */
+        if (seq < _rx_next_seq) {
+            _rx_seq_errors++;
+        }
+        _rx_next_seq = seq + 1;
+    }
+}
+
+static void *_rx(void *arg)
+{
+    netdev_t *netdev = arg;
+
+    while (1) {
+        thread_flags_wait_any(FLAG_ISR);
+        netdev->driver->isr(netdev);
+    }
+    return NULL;
+}
+
+static int _send(int argc, char **argv)
+{
+    netdev_t *netdev = (netdev_t *)&_dev;
+    uint8_t hdr[IEEE802154_MAX_HDR_LEN];
+    uint8_t payload[IEEE802154_FRAME_LEN_MAX] = { 0 };
+    le_uint16_t pan = byteorder_btols(byteorder_htons(_dev.netdev.pan));
+    unsigned num, len = sizeof(uint32_t);
+    uint32_t gap = 0;
+
+    if (argc < 2) {
+        printf("usage: %s <num> [<payload len> [<gap in us>]]\n", argv[0]);
+        return 1;
+    }
+    num = atoi(argv[1]);
+    if (argc > 2) {
+        len = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        gap = atoi(argv[3]);
+    }
+    size_t hdr_len = ieee802154_set_frame_hdr(hdr, _dev.netdev.long_addr,
+                                              IEEE802154_LONG_ADDRESS_LEN,
+                                              ieee802154_addr_bcast,
+                                              IEEE802154_ADDR_BCAST_LEN,
+                                              pan, pan,
+                                              IEEE802154_FCF_TYPE_DATA, 0);
+    if ((len < sizeof(uint32_t)) ||
+        ((hdr_len + len) > (IEEE802154_FRAME_LEN_MAX - IEEE802154_FCS_LEN))) {
+        puts("invalid payload length");
+        return 1;
+    }
+    iolist_t iol_payload = { .iol_base = payload, .iol_len = len };
+    iolist_t iol_hdr = { .iol_next = &iol_payload, .iol_base = hdr,
+                         .iol_len = hdr_len };
+    uint64_t start = xtimer_now_usec64();
+
+    for (unsigned i = 0; i < num; i++, _tx_seq++) {
+        memcpy(payload, &_tx_seq, sizeof(_tx_seq));
+        if (netdev->driver->send(netdev, &iol_hdr) < 0) {
+            puts("send failed");
+            return 1;
+        }
+        if (gap) {
+            xtimer_usleep(gap);
+        }
+    }
+    printf("sent %u frames in %lu us\n", num,
+           (unsigned long)(xtimer_now_usec64() - start));
+    return 0;
+}
+
+static int _stats(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+    printf("rx %lu lost %lu filtered %lu dropped %lu seq_errors %lu "
+           "tx %lu copies %lu doorbells %lu\n",
+           (unsigned long)_dev.stats.rx_frames,
+           (unsigned long)_dev.stats.rx_lost,
+           (unsigned long)_dev.stats.rx_filtered,
+           (unsigned long)_dev.node->dropped,
+           (unsigned long)_rx_seq_errors,
+           (unsigned long)_dev.stats.tx_frames,
+           (unsigned long)_dev.stats.tx_copies,
+           (unsigned long)_dev.stats.doorbells);
+    return 0;
+}
+
+static const shell_command_t _commands[] = {
+    { "send", "send numbered broadcast frames", _send },
+    { "stats", "print device statistics", _stats },
+    { NULL, NULL, NULL }
+};
+
+int main(void)
+{
+    netdev_t *netdev = (netdev_t *)&_dev;
+    char line_buf[SHELL_DEFAULT_BUFSIZE];
+
+    puts("shm_radio device driver test");
+    shm_radio_setup(&_dev, &shm_radio_params[0]);
+    netdev->event_callback = _event_cb;
+    netdev->driver->init(netdev);
+    _rx_thread = (thread_t *)thread_get(thread_create(_rx_stack, sizeof(_rx_stack),
+                                                      THREAD_PRIORITY_MAIN - 1,
+                                                      0, _rx, netdev,
+                                                      "shm_radio_rx"));
+    printf("node %d on medium %s\n", _dev.node_idx, _dev.name);
+
+    shell_run(_commands, line_buf, SHELL_DEFAULT_BUFSIZE);
+    return 0;
+}
@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2020 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import os
+import sys
+import time
+import pexpect
+from testrunner import run
+
+
+MEDIUM = "test%d" % os.getpid()
+FRAMES = 10000
+LOSS = 500      # per mille
+# frames sent with a gap, so the receiver can keep up
+PACED_FRAMES = 1000
+PACED_GAP = 1000    # usec, SHM_RADIO_RING_SIZE frames take 32 ms
+
+
+def _stats(node):
+    node.sendline("stats")
+    node.expect(r"rx (\d+) lost (\d+) filtered (\d+) dropped (\d+) "
+                r"seq_errors (\d+) tx (\d+) copies (\d+) doorbells (\d+)")
+    keys = ("rx", "lost", "filtered", "dropped", "seq_errors", "tx",
+            "copies", "doorbells")
+    return dict(zip(keys, (int(v) for v in node.match.groups())))
+
+
+def _spawn(termflags):
+    elf = os.environ["ELFFILE"]
+    node = pexpect.spawnu("%s %s" % (elf, termflags), timeout=10)
+    node.expect_exact("shm_radio device driver test")
+    node.expect(r"node (\d+) on medium")
+    return node, int(node.match.group(1))
+
+
+def _diff(stats, base):
+    return {key: stats[key] - base[key] for key in stats}
+
+
+def _send(node, num, peer, gap=0):
+    """Returns the time in us until the receiver was done with all frames and
+    the change of the receiver's statistics"""
+    base = _stats(peer)
+    start = time.monotonic()
+    node.sendline("send %d 4 %d" % (num, gap))
+    node.expect(r"sent \d+ frames in \d+ us", timeout=10 + num * gap / 1e6)
+    # wait until the receiver is done with the frames
+    while True:
+        stats = _diff(_stats(peer), base)
+        if stats["rx"] + stats["lost"] + stats["dropped"] >= num:
+            return int((time.monotonic() - start) * 1000000), stats
+
+
+def testfunc(child):
+    child.expect_exact("shm_radio device driver test")
+    child.expect(r"node (\d+) on medium")
+    assert int(child.match.group(1)) == 0
+    sender, idx = _spawn("-r %s" % MEDIUM)
+    assert idx == 1
+    try:
+        # as fast as possible: the sender outruns the receiver, frames that
+        # do not fit into its ring are dropped like on a busy radio
+        usec, stats = _send(sender, FRAMES, child)
+        assert stats["seq_errors"] == 0
+        assert stats["rx"] + stats["dropped"] == FRAMES
+        assert stats["rx"] > 0
+        print("\n%d of %d frames delivered in %d us (%d frames/s), "
+              "%d dropped, %d doorbells"
+              % (stats["rx"], FRAMES, usec,
+                 stats["rx"] * 1000000 // max(usec, 1), stats["dropped"],
+                 _stats(sender)["doorbells"]))
+        assert _stats(sender)["tx"] == FRAMES
+
+        # paced: the receiver keeps up, allow for the odd host hiccup
+        _, stats = _send(sender, PACED_FRAMES, child, PACED_GAP)
+        assert stats["seq_errors"] == 0
+        assert stats["rx"] + stats["dropped"] == PACED_FRAMES
+        assert stats["dropped"] <= PACED_FRAMES // 100
+        assert _stats(sender)["tx"] == FRAMES + PACED_FRAMES
+
+        # a third node with simulated loss also receives from the sender
+        lossy, idx = _spawn("-r %s,node=5,loss=%d" % (MEDIUM, LOSS))
+        assert idx == 5
+        try:
+            _send(sender, FRAMES, lossy)
+            stats = _stats(lossy)
+            assert stats["rx"] + stats["lost"] + stats["dropped"] == FRAMES
+            assert abs(stats["lost"] - (FRAMES - stats["dropped"]) * LOSS
+                       // 1000) < FRAMES // 10
+        finally:
+            lossy.terminate(force=True)
+    finally:
+        sender.terminate(force=True)
+
+
+if __name__ == "__main__":
+    os.environ['TERMFLAGS'] = "-r %s,node=0" % MEDIUM
+    res = run(testfunc, timeout=10, echo=False)
+    # the medium outlives its nodes, remove it
+    try:
+        os.unlink("/dev/shm/riot-shm-radio.%s" % MEDIUM)
+    except FileNotFoundError:
+        pass
+    sys.exit(res)
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Test for sock_async_event with gcoap and emCute sharing the
+ *              event queue of the gcoap thread
+ *
+ * All datagrams are sent to the IPv6 loopback address, so no network
+ * interface is needed. A minimal MQTT-SN gateway is served on the same
+ * queue.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "embUnit.h"
+#include "mutex.h"
+#include "net/emcute.h"
+#include "net/gcoap.h"
+#include "net/ipv6/addr.h"
+#include "net/mqttsn.h"
+#include "net/sock/async/event.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define TEST_PORT           (20000U)
+#define TEST_EMCUTE_PORT    (20001U)
+#define TEST_GW_PORT        (20002U)
+#define TEST_TIMEOUT        (1U * US_PER_SEC)
+
+static sock_udp_t _sock;
+static sock_event_t _sock_event;
+static kernel_pid_t _handler_pid;
+static char _buf[16];
+
+static sock_udp_t _gw_sock;
+static sock_event_t _gw_event;
+static uint8_t _gw_buf[32];
+
+static mutex_t _done = MUTEX_INIT_LOCKED;
+static unsigned _resp_code;
+
+static void _ep(sock_udp_ep_t *ep, uint16_t port)
+{
+    memset(ep, 0, sizeof(*ep));
+    ep->family = AF_INET6;
+    ep->port = port;
+}
+
+static void _remote(sock_udp_ep_t *ep, uint16_t port)
+{
+    _ep(ep, port);
+    ipv6_addr_set_loopback((ipv6_addr_t *)ep->addr.ipv6);
+}
+
+static void _udp_handler(sock_udp_t *sock, sock_async_flags_t flags,
+                         void *arg)
+{
+    (void)arg;
+    if (flags & SOCK_ASYNC_MSG_RECV) {
+        while (sock_udp_recv(sock, _buf, sizeof(_buf), 0, NULL) > 0) {}
+        _handler_pid = thread_getpid();
+        mutex_unlock(&_done);
+    }
+}
+
+/* answers CONNECT and DISCONNECT of emCute */
+static void _gw_handler(sock_udp_t *sock, sock_async_flags_t flags, void *arg)
+{
+    sock_udp_ep_t remote;
+    ssize_t res;
+
+    (void)arg;
+    if (!(flags & SOCK_ASYNC_MSG_RECV)) {
+        return;
+    }
+    while ((res = sock_udp_recv(sock, _gw_buf, sizeof(_gw_buf), 0,
+                                &remote)) > 0) {
+        if ((res < 2) || (_gw_buf[0] != res)) {
+            continue;
+        }
+        if (_gw_buf[1] == MQTTSN_CONNECT) {
+            const uint8_t connack[] = { 3, MQTTSN_CONNACK, 0 };
+            sock_udp_send(sock, connack, sizeof(connack), &remote);
+        }
+        else if (_gw_buf[1] == MQTTSN_DISCONNECT) {
+            const uint8_t discon[] = { 2, MQTTSN_DISCONNECT };
+            sock_udp_send(sock, discon, sizeof(discon), &remote);
+        }
+    }
+}
+
+static void _resp_handler(unsigned req_state, coap_pkt_t *pdu,
+                          sock_udp_ep_t *remote)
+{
+    (void)remote;
+    _resp_code = (req_state == GCOAP_MEMO_RESP) ? coap_get_code(pdu) : 0;
+    _handler_pid = thread_getpid();
+    mutex_unlock(&_done);
+}
+
+static void setUp(void)
+{
+    _handler_pid = KERNEL_PID_UNDEF;
+}
+
+static void test_sock_udp_event(void)
+{
+    sock_udp_ep_t local, remote;
+
+    _ep(&local, TEST_PORT);
+    TEST_ASSERT_EQUAL_INT(0, sock_udp_create(&_sock, &local, NULL, 0));
+    sock_udp_event_init(&_sock, &_sock_event, gcoap_get_event_queue(),
+                        _udp_handler, NULL);
+
+    _remote(&remote, TEST_PORT);
+    TEST_ASSERT_EQUAL_INT(5, sock_udp_send(NULL, "hello", 5, &remote));
+    TEST_ASSERT_EQUAL_INT(0, xtimer_mutex_lock_timeout(&_done, TEST_TIMEOUT));
+    /* the handler ran in the gcoap thread */
+    TEST_ASSERT(_handler_pid != KERNEL_PID_UNDEF);
+    TEST_ASSERT(_handler_pid != thread_getpid());
+}
+
+static void test_gcoap(void)
+{
+    sock_udp_ep_t remote;
+    coap_pkt_t pdu;
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    ssize_t len;
+
+    _remote(&remote, GCOAP_PORT);
+    len = gcoap_request(&pdu, buf, sizeof(buf), COAP_METHOD_GET,
+                        "/.well-known/core");
+    TEST_ASSERT(len > 0);
+    TEST_ASSERT(gcoap_req_send(buf, len, &remote, _resp_handler) > 0);
+    TEST_ASSERT_EQUAL_INT(0, xtimer_mutex_lock_timeout(&_done, TEST_TIMEOUT));
+    TEST_ASSERT_EQUAL_INT(205, _resp_code);
+    TEST_ASSERT(_handler_pid != thread_getpid());
+
+    /* the UDP sock still works next to gcoap */
+    _remote(&remote, TEST_PORT);
+    TEST_ASSERT_EQUAL_INT(5, sock_udp_send(NULL, "again", 5, &remote));
+    TEST_ASSERT_EQUAL_INT(0, xtimer_mutex_lock_timeout(&_done, TEST_TIMEOUT));
+}
+
+static void test_emcute(void)
+{
+    sock_udp_ep_t local, gw;
+
+    _ep(&local, TEST_GW_PORT);
+    TEST_ASSERT_EQUAL_INT(0, sock_udp_create(&_gw_sock, &local, NULL, 0));
+    sock_udp_event_init(&_gw_sock, &_gw_event, gcoap_get_event_queue(),
+                        _gw_handler, NULL);
+    TEST_ASSERT_EQUAL_INT(0, emcute_init(gcoap_get_event_queue(),
+                                         TEST_EMCUTE_PORT, "riot"));
+
+    _remote(&gw, TEST_GW_PORT);
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, emcute_con(&gw, true, NULL, NULL, 0, 0));
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, emcute_discon());
+}
+
+static Test *tests_sock_async_event(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_sock_udp_event),
+        new_TestFixture(test_gcoap),
+        new_TestFixture(test_emcute),
+    };
+
+    EMB_UNIT_TESTCALLER(tests, setUp, NULL, fixtures);
+    return (Test *)&tests;
+}
+
+int main(void)
+{
+    TESTS_START();
+    TESTS_RUN(tests_sock_async_event());
+    TESTS_END();
+    return 0;
+}
+/** @} */
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "crypto/aes.h"
+#include "crypto/ciphers.h"
+#include "crypto/modes/ccm.h"
+#include "crypto/modes/ctr.h"
+#include "periph_conf.h"
+#include "xtimer.h"
+#include "tests-crypto.h"
+
+#define BENCH_LEN       (128U)
+#define BENCH_RUNS      (256U)
+#define BENCH_MAC_LEN   (8U)
+
+static uint8_t _in[BENCH_LEN];
+static uint8_t _out[BENCH_LEN + BENCH_MAC_LEN];
+
+static void _print(const char *name, uint32_t usec)
+{
+    uint32_t bytes = BENCH_LEN * BENCH_RUNS;
+
+    if (usec == 0) {
+        usec = 1;
+    }
+    printf("%-16s %6lu us %8lu KiB/s", name, (unsigned long)usec,
+           (unsigned long)(((uint64_t)bytes * US_PER_SEC) / usec / 1024));
+#ifdef CLOCK_CORECLOCK
+    uint64_t cycles = ((uint64_t)usec * (CLOCK_CORECLOCK / 1000)) / 1000;
+    uint32_t cpb = (uint32_t)((cycles * 100) / bytes);
+
+    printf(" %4lu.%02lu cycles/byte", (unsigned long)(cpb / 100),
+           (unsigned long)(cpb % 100));
+#endif
+    puts("");
+}
+
+void bench_crypto_aes(void)
+{
+    static const uint8_t key[AES_KEY_SIZE] = { 0 };
+    static const uint8_t nonce[13] = { 0 };
+    cipher_t cipher;
+    uint32_t start;
+
+    cipher_init(&cipher, CIPHER_AES_128, key, AES_KEY_SIZE);
+    printf("AES-128, %u bytes x %u runs\n", BENCH_LEN, BENCH_RUNS);
+
+    start = xtimer_now_usec();
+    for (unsigned run = 0; run < BENCH_RUNS; run++) {
+        for (unsigned i = 0; i < BENCH_LEN; i += AES_BLOCK_SIZE) {
+            cipher_encrypt(&cipher, &_in[i], &_out[i]);
+        }
+    }
+    _print("cipher_encrypt", xtimer_now_usec() - start);
+
+    start = xtimer_now_usec();
+    for (unsigned run = 0; run < BENCH_RUNS; run++) {
+        cipher_encrypt_blocks(&cipher, _in, _out, BENCH_LEN / AES_BLOCK_SIZE);
+    }
+    _print("encrypt_blocks", xtimer_now_usec() - start);
+
+    start = xtimer_now_usec();
+    for (unsigned run = 0; run < BENCH_RUNS; run++) {
+        uint8_t ctr[16] = { 0 };
+
+        cipher_encrypt_ctr(&cipher, ctr, 8, _in, BENCH_LEN, _out);
+    }
+    _print("ctr", xtimer_now_usec() - start);
+
+    start = xtimer_now_usec();
+    for (unsigned run = 0; run < BENCH_RUNS; run++) {
+        cipher_encrypt_ccm(&cipher, NULL, 0, BENCH_MAC_LEN, 2,
+                           nonce, sizeof(nonce), _in, BENCH_LEN, _out);
+    }
+    _print("ccm", xtimer_now_usec() - start);
+}
@@ -24,5 +24,6 @@ int main(void)
     TESTS_RUN(tests_crypto_modes_cbc_tests());
     TESTS_RUN(tests_crypto_modes_ctr_tests());
     TESTS_END();
+    bench_crypto_aes();
     return 0;
 }
@@ -44,6 +44,30 @@ static void test_crypto_cipher_aes_encrypt(void)
     TEST_ASSERT_MESSAGE(1 == cmp, "wrong ciphertext");
 }
 
+static void test_crypto_cipher_aes_encrypt_blocks(void)
+{
+    cipher_t cipher;
+    int err, cmp;
+    /* more blocks than processed in parallel by any implementation */
+    uint8_t data[5 * 16];
+
+    for (unsigned i = 0; i < sizeof(data); i += 16) {
+        memcpy(&data[i], TEST_INP, 16);
+    }
+
+    err = cipher_init(&cipher, CIPHER_AES_128, TEST_KEY, 16);
+    TEST_ASSERT_EQUAL_INT(1, err);
+
+    /* encrypt in place */
+    err = cipher_encrypt_blocks(&cipher, data, data, sizeof(data) / 16);
+    TEST_ASSERT_EQUAL_INT(1, err);
+
+    for (unsigned i = 0; i < sizeof(data); i += 16) {
+        cmp = compare(TEST_ENC_AES, &data[i], 16);
+        TEST_ASSERT_MESSAGE(1 == cmp, "wrong ciphertext");
+    }
+}
+
 static void test_crypto_cipher_aes_decrypt(void)
 {
     cipher_t cipher;
@@ -98,6 +122,7 @@ Test *tests_crypto_cipher_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
         new_TestFixture(test_crypto_cipher_aes_encrypt),
+        new_TestFixture(test_crypto_cipher_aes_encrypt_blocks),
         new_TestFixture(test_crypto_cipher_aes_decrypt),
         new_TestFixture(test_crypto_cipher_init_aes_key_length),
     };
@@ -823,8 +823,212 @@ static const uint8_t TEST_NIST_3_EXPECTED[] = {
 };
 static const size_t TEST_NIST_3_EXPECTED_LEN = 52;
 
+/*
+ * Messages longer than 255 bytes, so the length takes more than one byte in
+ * B0 and the CBC-MAC runs over more than 255 bytes. Generated with OpenSSL's
+ * EVP_aes_128_ccm() and checked against a plain implementation of RFC 3610.
+ */
+
+/* 300 byte message, L = 2 */
+static const uint8_t TEST_LONG_1_KEY[] = {
+    0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+    0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F,
+};
+static const size_t TEST_LONG_1_KEY_LEN = 16;
+static const uint8_t TEST_LONG_1_NONCE[] = {
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+    0x18, 0x19, 0x1A, 0x1B, 0x1C,
+};
+static const size_t TEST_LONG_1_NONCE_LEN = 13;
+static const size_t TEST_LONG_1_MAC_LEN = 8;
+static const uint8_t TEST_LONG_1_INPUT[] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x03, 0x0A, 0x11, 0x18, 0x1F, 0x26, 0x2D, 0x34,
+    0x3B, 0x42, 0x49, 0x50, 0x57, 0x5E, 0x65, 0x6C,
+    0x73, 0x7A, 0x81, 0x88, 0x8F, 0x96, 0x9D, 0xA4,
+    0xAB, 0xB2, 0xB9, 0xC0, 0xC7, 0xCE, 0xD5, 0xDC,
+    0xE3, 0xEA, 0xF1, 0xF8, 0xFF, 0x06, 0x0D, 0x14,
+    0x1B, 0x22, 0x29, 0x30, 0x37, 0x3E, 0x45, 0x4C,
+    0x53, 0x5A, 0x61, 0x68, 0x6F, 0x76, 0x7D, 0x84,
+    0x8B, 0x92, 0x99, 0xA0, 0xA7, 0xAE, 0xB5, 0xBC,
+    0xC3, 0xCA, 0xD1, 0xD8, 0xDF, 0xE6, 0xED, 0xF4,
+    0xFB, 0x02, 0x09, 0x10, 0x17, 0x1E, 0x25, 0x2C,
+    0x33, 0x3A, 0x41, 0x48, 0x4F, 0x56, 0x5D, 0x64,
+    0x6B, 0x72, 0x79, 0x80, 0x87, 0x8E, 0x95, 0x9C,
+    0xA3, 0xAA, 0xB1, 0xB8, 0xBF, 0xC6, 0xCD, 0xD4,
+    0xDB, 0xE2, 0xE9, 0xF0, 0xF7, 0xFE, 0x05, 0x0C,
+    0x13, 0x1A, 0x21, 0x28, 0x2F, 0x36, 0x3D, 0x44,
+    0x4B, 0x52, 0x59, 0x60, 0x67, 0x6E, 0x75, 0x7C,
+    0x83, 0x8A, 0x91, 0x98, 0x9F, 0xA6, 0xAD, 0xB4,
+    0xBB, 0xC2, 0xC9, 0xD0, 0xD7, 0xDE, 0xE5, 0xEC,
+    0xF3, 0xFA, 0x01, 0x08, 0x0F, 0x16, 0x1D, 0x24,
+    0x2B, 0x32, 0x39, 0x40, 0x47, 0x4E, 0x55, 0x5C,
+    0x63, 0x6A, 0x71, 0x78, 0x7F, 0x86, 0x8D, 0x94,
+    0x9B, 0xA2, 0xA9, 0xB0, 0xB7, 0xBE, 0xC5, 0xCC,
+    0xD3, 0xDA, 0xE1, 0xE8, 0xEF, 0xF6, 0xFD, 0x04,
+    0x0B, 0x12, 0x19, 0x20, 0x27, 0x2E, 0x35, 0x3C,
+    0x43, 0x4A, 0x51, 0x58, 0x5F, 0x66, 0x6D, 0x74,
+    0x7B, 0x82, 0x89, 0x90, 0x97, 0x9E, 0xA5, 0xAC,
+    0xB3, 0xBA, 0xC1, 0xC8, 0xCF, 0xD6, 0xDD, 0xE4,
+    0xEB, 0xF2, 0xF9, 0x00, 0x07, 0x0E, 0x15, 0x1C,
+    0x23, 0x2A, 0x31, 0x38, 0x3F, 0x46, 0x4D, 0x54,
+    0x5B, 0x62, 0x69, 0x70, 0x77, 0x7E, 0x85, 0x8C,
+    0x93, 0x9A, 0xA1, 0xA8, 0xAF, 0xB6, 0xBD, 0xC4,
+    0xCB, 0xD2, 0xD9, 0xE0, 0xE7, 0xEE, 0xF5, 0xFC,
+    0x03, 0x0A, 0x11, 0x18, 0x1F, 0x26, 0x2D, 0x34,
+    0x3B, 0x42, 0x49, 0x50, 0x57, 0x5E, 0x65, 0x6C,
+    0x73, 0x7A, 0x81, 0x88, 0x8F, 0x96, 0x9D, 0xA4,
+    0xAB, 0xB2, 0xB9, 0xC0, 0xC7, 0xCE, 0xD5, 0xDC,
+    0xE3, 0xEA, 0xF1, 0xF8, 0xFF, 0x06, 0x0D, 0x14,
+    0x1B, 0x22, 0x29, 0x30,
+};
+static const size_t TEST_LONG_1_INPUT_LEN = 300;
+static const size_t TEST_LONG_1_ADATA_LEN = 8;
+static const uint8_t TEST_LONG_1_EXPECTED[] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x4A, 0xBA, 0x6E, 0x96, 0x25, 0x87, 0xCD, 0x24,
+    0x79, 0x03, 0xA1, 0xED, 0x05, 0x3E, 0xE0, 0x22,
+    0x19, 0xAB, 0x4E, 0xA4, 0x15, 0x67, 0xE7, 0x57,
+    0x17, 0x09, 0x06, 0xD2, 0xBD, 0xCF, 0x24, 0x91,
+    0x91, 0x47, 0xCF, 0x02, 0x5B, 0x70, 0x18, 0x96,
+    0xFC, 0xDF, 0x81, 0xE1, 0x24, 0x1A, 0x31, 0x5F,
+    0x4C, 0xB6, 0x4F, 0x9F, 0x2C, 0x32, 0x8E, 0x56,
+    0xEC, 0x76, 0x75, 0x90, 0xC7, 0x1E, 0xE6, 0xBC,
+    0x26, 0x43, 0x4E, 0xE2, 0x4B, 0x28, 0xBD, 0x97,
+    0x98, 0x2D, 0x01, 0x4B, 0x35, 0x2F, 0x67, 0x4B,
+    0xDE, 0x7B, 0x77, 0xA8, 0x05, 0x6E, 0x77, 0xAB,
+    0x33, 0xE3, 0x1A, 0xA6, 0x67, 0xEC, 0x63, 0xC4,
+    0xDD, 0xA1, 0xEB, 0xFC, 0x50, 0x9B, 0xC7, 0xAB,
+    0x65, 0xD6, 0xBA, 0x5D, 0x36, 0x8D, 0x92, 0x33,
+    0x79, 0x37, 0xDC, 0x33, 0x88, 0xCD, 0xFD, 0x74,
+    0x74, 0xB2, 0xD0, 0xD7, 0x92, 0x98, 0x40, 0x98,
+    0x94, 0xE3, 0x6C, 0x87, 0x8E, 0xED, 0x77, 0x62,
+    0x8F, 0xD6, 0x36, 0xD4, 0x4C, 0x42, 0xFE, 0xE5,
+    0x05, 0x51, 0xC5, 0x1F, 0x7B, 0x23, 0x51, 0x45,
+    0xE1, 0xA5, 0x66, 0xA9, 0x63, 0xA7, 0xB8, 0x28,
+    0xD7, 0xD6, 0xC3, 0x9C, 0xC5, 0x64, 0xB2, 0xED,
+    0xEA, 0xED, 0x04, 0x7E, 0x4F, 0x11, 0x87, 0xC6,
+    0x74, 0x00, 0xEC, 0x22, 0x75, 0xB0, 0xD6, 0x62,
+    0x86, 0x07, 0x2E, 0xEA, 0x96, 0x3B, 0x62, 0x6B,
+    0xD7, 0x76, 0xA8, 0x0E, 0x5D, 0x22, 0xA9, 0x8C,
+    0x85, 0xFE, 0xA8, 0xB9, 0xA0, 0x72, 0x56, 0x68,
+    0x01, 0xB6, 0x7D, 0x85, 0x27, 0xFD, 0x12, 0x38,
+    0x4A, 0x07, 0xE8, 0xFB, 0x1E, 0xE7, 0xE8, 0x71,
+    0x1F, 0x6A, 0xFB, 0x23, 0xBA, 0x05, 0xB6, 0x83,
+    0xDA, 0x9B, 0x62, 0x34, 0xDA, 0x1B, 0x52, 0x25,
+    0x1D, 0x2D, 0x3C, 0x55, 0x98, 0x22, 0x99, 0x60,
+    0xAD, 0xC6, 0xFA, 0x86, 0x5C, 0x37, 0xFA, 0xB6,
+    0x71, 0x74, 0x0B, 0x92, 0x2C, 0xBD, 0x0A, 0xC8,
+    0x96, 0xD0, 0xB4, 0x34, 0x4A, 0x9D, 0x1A, 0x30,
+    0x75, 0x4F, 0x7D, 0x57, 0x05, 0x2A, 0xA7, 0xA5,
+    0xC9, 0xF2, 0x58, 0xEC, 0x1E, 0xBF, 0x1B, 0xF9,
+    0x83, 0xEE, 0xFD, 0x6D, 0xAE, 0x86, 0x0C, 0xBA,
+    0x81, 0xED, 0x2C, 0xE7, 0xB4, 0x2E, 0x8E, 0x99,
+    0x6D, 0x45, 0x21, 0xD2,
+};
+static const size_t TEST_LONG_1_EXPECTED_LEN = 316;
+
+/* 300 byte message, L = 3 */
+static const uint8_t TEST_LONG_2_KEY[] = {
+    0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+    0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F,
+};
+static const size_t TEST_LONG_2_KEY_LEN = 16;
+static const uint8_t TEST_LONG_2_NONCE[] = {
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+    0x18, 0x19, 0x1A, 0x1B,
+};
+static const size_t TEST_LONG_2_NONCE_LEN = 12;
+static const size_t TEST_LONG_2_MAC_LEN = 8;
+static const uint8_t TEST_LONG_2_INPUT[] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x03, 0x0A, 0x11, 0x18, 0x1F, 0x26, 0x2D, 0x34,
+    0x3B, 0x42, 0x49, 0x50, 0x57, 0x5E, 0x65, 0x6C,
+    0x73, 0x7A, 0x81, 0x88, 0x8F, 0x96, 0x9D, 0xA4,
+    0xAB, 0xB2, 0xB9, 0xC0, 0xC7, 0xCE, 0xD5, 0xDC,
+    0xE3, 0xEA, 0xF1, 0xF8, 0xFF, 0x06, 0x0D, 0x14,
+    0x1B, 0x22, 0x29, 0x30, 0x37, 0x3E, 0x45, 0x4C,
+    0x53, 0x5A, 0x61, 0x68, 0x6F, 0x76, 0x7D, 0x84,
+    0x8B, 0x92, 0x99, 0xA0, 0xA7, 0xAE, 0xB5, 0xBC,
+    0xC3, 0xCA, 0xD1, 0xD8, 0xDF, 0xE6, 0xED, 0xF4,
+    0xFB, 0x02, 0x09, 0x10, 0x17, 0x1E, 0x25, 0x2C,
+    0x33, 0x3A, 0x41, 0x48, 0x4F, 0x56, 0x5D, 0x64,
+    0x6B, 0x72, 0x79, 0x80, 0x87, 0x8E, 0x95, 0x9C,
+    0xA3, 0xAA, 0xB1, 0xB8, 0xBF, 0xC6, 0xCD, 0xD4,
+    0xDB, 0xE2, 0xE9, 0xF0, 0xF7, 0xFE, 0x05, 0x0C,
+    0x13, 0x1A, 0x21, 0x28, 0x2F, 0x36, 0x3D, 0x44,
+    0x4B, 0x52, 0x59, 0x60, 0x67, 0x6E, 0x75, 0x7C,
+    0x83, 0x8A, 0x91, 0x98, 0x9F, 0xA6, 0xAD, 0xB4,
+    0xBB, 0xC2, 0xC9, 0xD0, 0xD7, 0xDE, 0xE5, 0xEC,
+    0xF3, 0xFA, 0x01, 0x08, 0x0F, 0x16, 0x1D, 0x24,
+    0x2B, 0x32, 0x39, 0x40, 0x47, 0x4E, 0x55, 0x5C,
+    0x63, 0x6A, 0x71, 0x78, 0x7F, 0x86, 0x8D, 0x94,
+    0x9B, 0xA2, 0xA9, 0xB0, 0xB7, 0xBE, 0xC5, 0xCC,
+    0xD3, 0xDA, 0xE1, 0xE8, 0xEF, 0xF6, 0xFD, 0x04,
+    0x0B, 0x12, 0x19, 0x20, 0x27, 0x2E, 0x35, 0x3C,
+    0x43, 0x4A, 0x51, 0x58, 0x5F, 0x66, 0x6D, 0x74,
+    0x7B, 0x82, 0x89, 0x90, 0x97, 0x9E, 0xA5, 0xAC,
+    0xB3, 0xBA, 0xC1, 0xC8, 0xCF, 0xD6, 0xDD, 0xE4,
+    0xEB, 0xF2, 0xF9, 0x00, 0x07, 0x0E, 0x15, 0x1C,
+    0x23, 0x2A, 0x31, 0x38, 0x3F, 0x46, 0x4D, 0x54,
+    0x5B, 0x62, 0x69, 0x70, 0x77, 0x7E, 0x85, 0x8C,
+    0x93, 0x9A, 0xA1, 0xA8, 0xAF, 0xB6, 0xBD, 0xC4,
+    0xCB, 0xD2, 0xD9, 0xE0, 0xE7, 0xEE, 0xF5, 0xFC,
+    0x03, 0x0A, 0x11, 0x18, 0x1F, 0x26, 0x2D, 0x34,
+    0x3B, 0x42, 0x49, 0x50, 0x57, 0x5E, 0x65, 0x6C,
+    0x73, 0x7A, 0x81, 0x88, 0x8F, 0x96, 0x9D, 0xA4,
+    0xAB, 0xB2, 0xB9, 0xC0, 0xC7, 0xCE, 0xD5, 0xDC,
+    0xE3, 0xEA, 0xF1, 0xF8, 0xFF, 0x06, 0x0D, 0x14,
+    0x1B, 0x22, 0x29, 0x30,
+};
+static const size_t TEST_LONG_2_INPUT_LEN = 300;
+static const size_t TEST_LONG_2_ADATA_LEN = 8;
+static const uint8_t TEST_LONG_2_EXPECTED[] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0xC0, 0x99, 0x32, 0x92, 0xCE, 0xB4, 0x11, 0x69,
+    0x88, 0x77, 0x89, 0x97, 0xB6, 0xE4, 0xAC, 0x48,
+    0x22, 0x3D, 0x19, 0x62, 0x1F, 0xE1, 0x21, 0x36,
+    0xC7, 0x90, 0x52, 0x2F, 0xED, 0x09, 0xE7, 0x00,
+    0x4F, 0x9C, 0x1C, 0x9B, 0xD5, 0x21, 0x33, 0xFD,
+    0x17, 0x38, 0x4B, 0x39, 0x70, 0x16, 0x19, 0x70,
+    0x95, 0x3B, 0x6C, 0xA9, 0x6F, 0xC5, 0xE3, 0x5B,
+    0x9E, 0x1B, 0x5E, 0x27, 0x01, 0x37, 0x9A, 0x49,
+    0x04, 0xDF, 0xD0, 0xA0, 0x38, 0xA8, 0xA0, 0xD8,
+    0xF7, 0x96, 0x35, 0x92, 0x89, 0x14, 0x7C, 0xAE,
+    0xA9, 0xC3, 0x21, 0x79, 0xBB, 0xE5, 0x5E, 0x54,
+    0x6E, 0xB7, 0xD1, 0x05, 0x1E, 0xBB, 0xFC, 0x7B,
+    0xFE, 0x61, 0x53, 0x08, 0x44, 0xCE, 0x79, 0x86,
+    0x74, 0x16, 0x8A, 0x8C, 0x5B, 0xF6, 0x67, 0x20,
+    0xD4, 0x31, 0xF5, 0xAC, 0xA5, 0xCB, 0xBC, 0xFE,
+    0x51, 0xE1, 0x1C, 0x17, 0xE1, 0xE7, 0x21, 0xD4,
+    0x15, 0x66, 0x13, 0x55, 0x77, 0x25, 0x06, 0xDC,
+    0xF0, 0x97, 0x0F, 0xB7, 0xFA, 0x9B, 0xFD, 0x7D,
+    0x2A, 0x96, 0xDB, 0xD3, 0x2F, 0x51, 0x2B, 0x2D,
+    0xA7, 0xF5, 0x6E, 0xCB, 0x1F, 0x47, 0xCE, 0x0F,
+    0x66, 0x86, 0xC9, 0xCF, 0xF9, 0x33, 0xCD, 0xB6,
+    0xAC, 0x89, 0x23, 0x52, 0xD7, 0xC5, 0xA8, 0xDA,
+    0x5B, 0x62, 0x90, 0x69, 0x6F, 0x4D, 0xED, 0xCF,
+    0xAF, 0x37, 0x38, 0xE8, 0x8C, 0xB2, 0x06, 0x99,
+    0x6F, 0x37, 0x3E, 0xFB, 0xFE, 0x08, 0x70, 0xE2,
+    0xFE, 0x04, 0x35, 0x99, 0xFE, 0xAB, 0xFC, 0xF3,
+    0xDB, 0xFD, 0x46, 0x9C, 0x4D, 0x36, 0x1B, 0x97,
+    0x27, 0x7E, 0xA8, 0x76, 0xF4, 0xD1, 0x2B, 0x66,
+    0xC6, 0x8B, 0x28, 0x13, 0x0C, 0xED, 0x54, 0xAA,
+    0xB3, 0xC2, 0x6C, 0x83, 0x8C, 0xB7, 0x38, 0x9E,
+    0xB3, 0x56, 0xE2, 0x41, 0x41, 0xAC, 0xE1, 0x5C,
+    0xD2, 0x43, 0xB9, 0x87, 0xAA, 0xF6, 0x3B, 0xAD,
+    0x35, 0x95, 0x8F, 0x05, 0x1C, 0xFD, 0x20, 0x0D,
+    0xA5, 0x09, 0x13, 0x0A, 0xC7, 0xA4, 0xA0, 0x3C,
+    0xA7, 0x04, 0xD3, 0x69, 0x92, 0x62, 0xDA, 0xB9,
+    0xCA, 0xC0, 0xD3, 0xF5, 0x7D, 0x90, 0x98, 0x34,
+    0x7D, 0xCE, 0x23, 0x89, 0xAB, 0x45, 0x69, 0x48,
+    0xC4, 0x7A, 0x59, 0x72, 0x8A, 0xAB, 0xAC, 0x9C,
+    0xE7, 0x45, 0x83, 0x39,
+};
+static const size_t TEST_LONG_2_EXPECTED_LEN = 316;
+
 /* Share test buffer output */
-static uint8_t data[60];
+static uint8_t data[320];
 
 static void test_encrypt_op(const uint8_t *key, uint8_t key_len,
                             const uint8_t *adata, size_t adata_len,
@@ -930,6 +1134,9 @@ static void test_crypto_modes_ccm_encrypt(void)
     do_test_encrypt_op(NIST_1);
     do_test_encrypt_op(NIST_2);
     do_test_encrypt_op(NIST_3);
+
+    do_test_encrypt_op(LONG_1);
+    do_test_encrypt_op(LONG_2);
 }
 
 #define do_test_decrypt_op(name) do { \
@@ -977,6 +1184,9 @@ static void test_crypto_modes_ccm_decrypt(void)
     do_test_decrypt_op(NIST_1);
     do_test_decrypt_op(NIST_2);
     do_test_decrypt_op(NIST_3);
+
+    do_test_decrypt_op(LONG_1);
+    do_test_decrypt_op(LONG_2);
 }
 
 
@@ -64,6 +64,11 @@ Test* tests_crypto_modes_ecb_tests(void);
 Test* tests_crypto_modes_cbc_tests(void);
 Test* tests_crypto_modes_ctr_tests(void);
 
+/**
+ * @brief   Prints the AES throughput with the different cipher APIs and modes
+ */
+void bench_crypto_aes(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -12,6 +12,7 @@ from testrunner import run
 
 def testfunc(child):
     child.expect(r'OK \(\d+ tests\)')
+    child.expect(r'ccm\s+\d+ us')
 
 
 if __name__ == "__main__":
@@ -13,11 +13,14 @@
  */
 #include <errno.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 
+#include "benchmark.h"
 #include "embUnit.h"
 
 #include "net/gcoap.h"
+#include "_gcoap-internal.h"
 
 #include "unittests-constants.h"
 #include "tests-gcoap.h"
@@ -49,6 +52,17 @@ static gcoap_listener_t listener_second = {
     .next          = NULL
 };
 
+static const coap_resource_t resources_subtree[] = {
+    { .path = "/sensor", .methods = (COAP_PUT | COAP_MATCH_SUBTREE) },
+};
+
+static gcoap_listener_t listener_subtree = {
+    .resources     = &resources_subtree[0],
+    .resources_len = ARRAY_SIZE(resources_subtree),
+    .link_encoder  = NULL,
+    .next          = NULL
+};
+
 static const char *resource_list_str = "</act/switch>,</sensor/temp>,</test/info/all>,</second/part>";
 
 /*
@@ -392,6 +406,126 @@ static void test_gcoap__server_get_resource_list(void)
     TEST_ASSERT_EQUAL_STRING(resource_list_str, (char *)res);
 }
 
+/*
+ * Find resources of the listeners registered in
+ * test_gcoap__server_get_resource_list()
+ */
+static void test_gcoap__server_find_resource(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    const coap_resource_t *resource = NULL;
+    gcoap_listener_t *res_listener = NULL;
+
+    gcoap_request(&pdu, buf, sizeof(buf), COAP_METHOD_GET, "/second/part");
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_FOUND,
+                          _gcoap_find_resource(&pdu, &resource, &res_listener));
+    TEST_ASSERT(resource == &resources_second[0]);
+    TEST_ASSERT(res_listener == &listener_second);
+
+    gcoap_request(&pdu, buf, sizeof(buf), COAP_METHOD_POST, "/act/switch");
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_FOUND,
+                          _gcoap_find_resource(&pdu, &resource, &res_listener));
+    TEST_ASSERT(resource == &resources[0]);
+    TEST_ASSERT(res_listener == &listener);
+
+    gcoap_request(&pdu, buf, sizeof(buf), COAP_METHOD_PUT, "/sensor/temp");
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_WRONG_METHOD,
+                          _gcoap_find_resource(&pdu, &resource, &res_listener));
+
+    gcoap_request(&pdu, buf, sizeof(buf), COAP_METHOD_GET, "/sensor");
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_NO_PATH,
+                          _gcoap_find_resource(&pdu, &resource, &res_listener));
+}
+
+/*
+ * A resource for the exact path, but another method, must not hide a
+ * COAP_MATCH_SUBTREE resource for a prefix of the path
+ */
+static void test_gcoap__server_find_resource_subtree(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    const coap_resource_t *resource = NULL;
+    gcoap_listener_t *res_listener = NULL;
+
+    gcoap_register_listener(&listener_subtree);
+
+    gcoap_request(&pdu, buf, sizeof(buf), COAP_METHOD_PUT, "/sensor/temp");
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_FOUND,
+                          _gcoap_find_resource(&pdu, &resource, &res_listener));
+    TEST_ASSERT(resource == &resources_subtree[0]);
+    TEST_ASSERT(res_listener == &listener_subtree);
+
+    /* the exact match still takes precedence for its own method */
+    gcoap_request(&pdu, buf, sizeof(buf), COAP_METHOD_GET, "/sensor/temp");
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_FOUND,
+                          _gcoap_find_resource(&pdu, &resource, &res_listener));
+    TEST_ASSERT(resource == &resources[1]);
+    TEST_ASSERT(res_listener == &listener);
+
+    gcoap_request(&pdu, buf, sizeof(buf), COAP_METHOD_POST, "/sensor/temp");
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_WRONG_METHOD,
+                          _gcoap_find_resource(&pdu, &resource, &res_listener));
+}
+
+#define BENCH_RESOURCES_NUMOF   (256U)
+#define BENCH_PDUS_NUMOF        (16U)
+#define BENCH_RUNS              (10000U)
+
+static coap_resource_t _bench_resources[BENCH_RESOURCES_NUMOF];
+static char _bench_paths[BENCH_RESOURCES_NUMOF][sizeof("/obj/000")];
+static gcoap_listener_t _bench_listeners[3];
+static uint8_t _bench_bufs[BENCH_PDUS_NUMOF][GCOAP_PDU_BUF_SIZE];
+static coap_pkt_t _bench_pdus[BENCH_PDUS_NUMOF];
+
+static void _bench_find(const char *name, unsigned numof, bool hit)
+{
+    const coap_resource_t *resource;
+    gcoap_listener_t *res_listener;
+
+    for (unsigned i = 0; i < BENCH_PDUS_NUMOF; i++) {
+        char path[sizeof("/obj/0000")];
+
+        sprintf(path, (hit) ? "/obj/%03u" : "/obj/%03u0",
+                (i * numof) / BENCH_PDUS_NUMOF);
+        gcoap_request(&_bench_pdus[i], _bench_bufs[i], GCOAP_PDU_BUF_SIZE,
+                      COAP_METHOD_GET, path);
+        TEST_ASSERT_EQUAL_INT((hit) ? GCOAP_RESOURCE_FOUND
+                                    : GCOAP_RESOURCE_NO_PATH,
+                              _gcoap_find_resource(&_bench_pdus[i], &resource,
+                                                   &res_listener));
+    }
+    BENCHMARK_FUNC(name, BENCH_RUNS,
+                   _gcoap_find_resource(&_bench_pdus[i % BENCH_PDUS_NUMOF],
+                                        &resource, &res_listener));
+}
+
+/*
+ * Measures resource lookups for a growing number of registered resources
+ */
+static void test_gcoap__server_find_resource_benchmark(void)
+{
+    static const unsigned numofs[] = { 16, 64, BENCH_RESOURCES_NUMOF };
+    unsigned numof = 0;
+
+    for (unsigned i = 0; i < BENCH_RESOURCES_NUMOF; i++) {
+        sprintf(_bench_paths[i], "/obj/%03u", i);
+        _bench_resources[i].path = _bench_paths[i];
+        _bench_resources[i].methods = COAP_GET;
+    }
+    puts("");
+    for (unsigned i = 0; i < ARRAY_SIZE(numofs); i++) {
+        _bench_listeners[i].resources = &_bench_resources[numof];
+        _bench_listeners[i].resources_len = numofs[i] - numof;
+        gcoap_register_listener(&_bench_listeners[i]);
+        numof = numofs[i];
+        printf("%u resources:\n", numof);
+        _bench_find("  found", numof, true);
+        _bench_find("  not found", numof, false);
+    }
+}
+
 Test *tests_gcoap_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -405,7 +539,10 @@ Test *tests_gcoap_tests(void)
         new_TestFixture(test_gcoap__server_get_resp),
         new_TestFixture(test_gcoap__server_con_req),
         new_TestFixture(test_gcoap__server_con_resp),
-        new_TestFixture(test_gcoap__server_get_resource_list)
+        new_TestFixture(test_gcoap__server_get_resource_list),
+        new_TestFixture(test_gcoap__server_find_resource),
+        new_TestFixture(test_gcoap__server_find_resource_subtree),
+        new_TestFixture(test_gcoap__server_find_resource_benchmark),
     };
 
     EMB_UNIT_TESTCALLER(gcoap_tests, NULL, NULL, fixtures);
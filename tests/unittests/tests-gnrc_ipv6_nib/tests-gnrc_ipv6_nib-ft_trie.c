@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief   Tests and benchmark for the off-link entry lookup of the NIB
+ *
+ * Runs against the trie by default, see Makefile.include.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "benchmark.h"
+#include "net/ipv6/addr.h"
+#include "net/gnrc/ipv6/nib.h"
+#include "net/gnrc/ipv6/nib/ft.h"
+
+#include "_nib-internal.h"
+
+#include "unittests-constants.h"
+
+#include "tests-gnrc_ipv6_nib.h"
+
+#define LINK_LOCAL_PREFIX   { 0xfe, 0x08, 0, 0, 0, 0, 0, 0 }
+#define GLOBAL_PREFIX       { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0 }
+#define GLOBAL_PREFIX_LEN   (32)
+#define IFACE               (6)
+#define NEXT_HOP_NUMOF      (4)
+#define LOOKUP_NUMOF        (64)
+#define BENCHMARK_RUNS      (1000)
+
+static ipv6_addr_t _routes[GNRC_IPV6_NIB_OFFL_NUMOF];
+static uint8_t _route_lens[GNRC_IPV6_NIB_OFFL_NUMOF];
+static ipv6_addr_t _lookups[LOOKUP_NUMOF];
+static uint32_t _seed;
+
+static void set_up(void)
+{
+    evtimer_event_t *tmp;
+
+    for (evtimer_event_t *ptr = _nib_evtimer.events;
+         (ptr != NULL) && (tmp = (ptr->next), 1);
+         ptr = tmp) {
+        evtimer_del((evtimer_t *)(&_nib_evtimer), ptr);
+    }
+    _nib_init();
+    _seed = TEST_UINT32;
+}
+
+static uint32_t _rand(void)
+{
+    /* deterministic, so failures are reproducible */
+    _seed = (_seed * 1103515245U) + 12345U;
+    return _seed >> 8;
+}
+
+static void _set_bits_random(ipv6_addr_t *addr, unsigned from)
+{
+    for (unsigned i = from; i < IPV6_ADDR_BIT_LEN; i++) {
+        uint8_t mask = 0x80 >> (i & 0x7);
+
+        if (_rand() & 0x1) {
+            addr->u8[i >> 3] |= mask;
+        }
+        else {
+            addr->u8[i >> 3] &= ~mask;
+        }
+    }
+}
+
+/* Adds numof random routes below GLOBAL_PREFIX, about a quarter of them nested
+ * into a previously added route, and derives lookup addresses from them */
+static void _add_routes(unsigned numof)
+{
+    for (unsigned i = 0; i < numof; i++) {
+        ipv6_addr_t next_hop = { .u64 = { { .u8 = LINK_LOCAL_PREFIX },
+                                          { .u64 = TEST_UINT64 } } };
+
+        if ((i > 0) && ((_rand() & 0x3) == 0)) {
+            unsigned parent = _rand() % i;
+
+            _routes[i] = _routes[parent];
+            _route_lens[i] = _route_lens[parent] + 1 + (_rand() % 16);
+            if (_route_lens[i] > IPV6_ADDR_BIT_LEN) {
+                _route_lens[i] = IPV6_ADDR_BIT_LEN;
+            }
+        }
+        else {
+            _routes[i] = (ipv6_addr_t){ .u64 = { { .u8 = GLOBAL_PREFIX } } };
+            _route_lens[i] = GLOBAL_PREFIX_LEN + 1 + (_rand() % 32);
+        }
+        _set_bits_random(&_routes[i], _route_lens[i] - (_rand() % 8));
+        next_hop.u8[15] += _rand() % NEXT_HOP_NUMOF;
+        TEST_ASSERT_EQUAL_INT(0, gnrc_ipv6_nib_ft_add(&_routes[i],
+                                                      _route_lens[i],
+                                                      &next_hop, IFACE, 0));
+    }
+    for (unsigned i = 0; i < LOOKUP_NUMOF; i++) {
+        _lookups[i] = _routes[_rand() % numof];
+        _set_bits_random(&_lookups[i], GLOBAL_PREFIX_LEN + (_rand() % 64));
+    }
+}
+
+/* linear longest-prefix match over the off-link entries as reference, with
+ * the same filter as _nib_offl_get_match() */
+static const _nib_offl_entry_t *_ref_match(const ipv6_addr_t *dst)
+{
+    const _nib_offl_entry_t *res = NULL;
+    _nib_offl_entry_t *entry = NULL;
+
+    while ((entry = _nib_offl_iter(entry))) {
+        if ((entry->mode != _EMPTY) &&
+            (ipv6_addr_match_prefix(&entry->pfx, dst) >= entry->pfx_len) &&
+            ((res == NULL) || (entry->pfx_len > res->pfx_len))) {
+            res = entry;
+        }
+    }
+    return res;
+}
+
+static void _check_lookups(void)
+{
+    for (unsigned i = 0; i < LOOKUP_NUMOF; i++) {
+        gnrc_ipv6_nib_ft_t fte;
+        const _nib_offl_entry_t *exp = _ref_match(&_lookups[i]);
+
+        if (exp == NULL) {
+            TEST_ASSERT_EQUAL_INT(-ENETUNREACH,
+                                  gnrc_ipv6_nib_ft_get(&_lookups[i], NULL,
+                                                       &fte));
+            continue;
+        }
+        TEST_ASSERT_EQUAL_INT(0, gnrc_ipv6_nib_ft_get(&_lookups[i], NULL,
+                                                      &fte));
+        TEST_ASSERT_EQUAL_INT(exp->pfx_len, fte.dst_len);
+        TEST_ASSERT(ipv6_addr_equal(&exp->pfx, &fte.dst));
+        TEST_ASSERT(ipv6_addr_equal(&exp->next_hop->ipv6, &fte.next_hop));
+    }
+}
+
+/*
+ * Creates three nested routes, then removes the middle one
+ * Expected result: gnrc_ipv6_nib_ft_get() always returns the longest matching
+ * route
+ */
+static void test_nib_ft_trie__nested(void)
+{
+    gnrc_ipv6_nib_ft_t fte;
+    static const ipv6_addr_t next_hop = { .u64 = { { .u8 = LINK_LOCAL_PREFIX },
+                                                 { .u64 = TEST_UINT64 } } };
+    ipv6_addr_t pfx = { .u64 = { { .u8 = GLOBAL_PREFIX } } };
+    ipv6_addr_t dst = { .u64 = { { .u8 = GLOBAL_PREFIX },
+                                 { .u64 = TEST_UINT64 } } };
+
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ipv6_nib_ft_add(&pfx, 64, &next_hop,
+                                                  IFACE, 0));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ipv6_nib_ft_add(&pfx, GLOBAL_PREFIX_LEN,
+                                                  &next_hop, IFACE, 0));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ipv6_nib_ft_add(&pfx, 48, &next_hop,
+                                                  IFACE, 0));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ipv6_nib_ft_get(&dst, NULL, &fte));
+    TEST_ASSERT_EQUAL_INT(64, fte.dst_len);
+    dst.u8[7] = 0x01;   /* leave the /64 */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ipv6_nib_ft_get(&dst, NULL, &fte));
+    TEST_ASSERT_EQUAL_INT(48, fte.dst_len);
+    gnrc_ipv6_nib_ft_del(&pfx, 48);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ipv6_nib_ft_get(&dst, NULL, &fte));
+    TEST_ASSERT_EQUAL_INT(GLOBAL_PREFIX_LEN, fte.dst_len);
+    dst.u8[3] = 0x00;   /* leave the /32 */
+    TEST_ASSERT_EQUAL_INT(-ENETUNREACH, gnrc_ipv6_nib_ft_get(&dst, NULL, &fte));
+}
+
+/*
+ * Fills the forwarding table with random (partly nested) routes, then removes
+ * every other route
+ * Expected result: gnrc_ipv6_nib_ft_get() returns the same routes as a linear
+ * longest-prefix match over the forwarding table
+ */
+static void test_nib_ft_trie__random(void)
+{
+    _add_routes(GNRC_IPV6_NIB_OFFL_NUMOF);
+    _check_lookups();
+    for (unsigned i = 0; i < GNRC_IPV6_NIB_OFFL_NUMOF; i += 2) {
+        gnrc_ipv6_nib_ft_del(&_routes[i], _route_lens[i]);
+    }
+    _check_lookups();
+    for (unsigned i = 1; i < GNRC_IPV6_NIB_OFFL_NUMOF; i += 2) {
+        gnrc_ipv6_nib_ft_del(&_routes[i], _route_lens[i]);
+    }
+    TEST_ASSERT_NULL(_nib_offl_iter(NULL));
+    _check_lookups();
+}
+
+/*
+ * Compares the lookup time of gnrc_ipv6_nib_ft_get() with a linear
+ * longest-prefix match over the forwarding table for growing table sizes
+ */
+static void test_nib_ft_trie__benchmark(void)
+{
+    static const unsigned numofs[] = { 1, 4, 8, 16, 32, 64, 128, 256 };
+
+    puts("");
+    for (unsigned j = 0; j < ARRAY_SIZE(numofs); j++) {
+        gnrc_ipv6_nib_ft_t fte;
+        unsigned numof = (numofs[j] < GNRC_IPV6_NIB_OFFL_NUMOF) ?
+                         numofs[j] : GNRC_IPV6_NIB_OFFL_NUMOF;
+
+        set_up();
+        _add_routes(numof);
+        _check_lookups();
+        printf("%u routes:\n", numof);
+        BENCHMARK_FUNC("  ft_get()", BENCHMARK_RUNS,
+                       gnrc_ipv6_nib_ft_get(&_lookups[i % LOOKUP_NUMOF], NULL,
+                                            &fte));
+        BENCHMARK_FUNC("  linear search", BENCHMARK_RUNS,
+                       _ref_match(&_lookups[i % LOOKUP_NUMOF]));
+        if (numof == GNRC_IPV6_NIB_OFFL_NUMOF) {
+            break;
+        }
+    }
+}
+
+Test *tests_gnrc_ipv6_nib_ft_trie_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_nib_ft_trie__nested),
+        new_TestFixture(test_nib_ft_trie__random),
+        new_TestFixture(test_nib_ft_trie__benchmark),
+    };
+
+    EMB_UNIT_TESTCALLER(tests, set_up, NULL,
+                        fixtures);
+
+    return (Test *)&tests;
+}
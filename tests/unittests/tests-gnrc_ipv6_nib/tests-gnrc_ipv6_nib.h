@@ -50,6 +50,13 @@ Test *tests_gnrc_ipv6_nib_abr_tests(void);
  */
 Test *tests_gnrc_ipv6_nib_ft_tests(void);
 
+/**
+ * @brief   Generates tests for the forwarding table trie
+ *
+ * @return  embUnit tests if successful, NULL if not.
+ */
+Test *tests_gnrc_ipv6_nib_ft_trie_tests(void);
+
 /**
  * @brief   Generates tests for neighbor cache view
  *
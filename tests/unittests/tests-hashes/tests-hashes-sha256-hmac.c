@@ -7,6 +7,7 @@
  * directory for more details.
  */
 
+#include <inttypes.h>
 #include <limits.h>
 #include <string.h>
 #include <stdio.h>
@@ -15,6 +16,7 @@
 #include "embUnit/embUnit.h"
 
 #include "hashes/sha256.h"
+#include "xtimer.h"
 
 #include "tests-hashes.h"
 
@@ -328,6 +330,52 @@ static void test_hashes_hmac_sha256_ite_hash_PRF6_split(void)
                  "9b09ffa71b942fcb27635fbcd5b0e944bfdc63644f0713938a7f51535c3a35e2", hmac));
 }
 
+static void test_hashes_hmac_sha256_precomputed_PRF6(void)
+{
+    /* Test Case PRF-6, twice with the same precomputed key */
+    const unsigned char strPRF6[] = "Test Using Larger Than Block-Size Key - Hash Key First";
+    unsigned char longKey[131];
+    unsigned char hmac[SHA256_DIGEST_LENGTH];
+    hmac_sha256_key_t pkey;
+
+    memset(longKey, 0xaa, sizeof(longKey));
+    hmac_sha256_precompute(&pkey, longKey, sizeof(longKey));
+
+    for (unsigned i = 0; i < 2; i++) {
+        memset(hmac, 0, sizeof(hmac));
+        hmac_sha256_precomputed(&pkey, strPRF6, strlen((char*)strPRF6), hmac);
+        TEST_ASSERT(compare_str_vs_digest(
+                     "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54", hmac));
+    }
+}
+
+static void test_hashes_hmac_sha256_benchmark(void)
+{
+    /* e.g. a MAC per frame: short messages with the same key */
+    static const unsigned char key[32] = { 0x42 };
+    static const unsigned char msg[64] = { 0x5a };
+    unsigned char hmac[SHA256_DIGEST_LENGTH];
+    hmac_sha256_key_t pkey;
+    const unsigned runs = 256;
+
+    uint32_t start = xtimer_now_usec();
+    for (unsigned i = 0; i < runs; i++) {
+        hmac_sha256(key, sizeof(key), msg, sizeof(msg), hmac);
+    }
+    uint32_t time = xtimer_now_usec() - start;
+
+    hmac_sha256_precompute(&pkey, key, sizeof(key));
+    start = xtimer_now_usec();
+    for (unsigned i = 0; i < runs; i++) {
+        hmac_sha256_precomputed(&pkey, msg, sizeof(msg), hmac);
+    }
+    uint32_t time_pre = xtimer_now_usec() - start;
+
+    printf("\nhmac_sha256: %u x %u bytes in %" PRIu32 " us, "
+           "precomputed key: %" PRIu32 " us\n", runs, (unsigned)sizeof(msg),
+           time, time_pre);
+}
+
 Test *tests_hashes_sha256_hmac_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -346,6 +394,8 @@ Test *tests_hashes_sha256_hmac_tests(void)
         new_TestFixture(test_hashes_hmac_sha256_ite_hash_PRF5),
         new_TestFixture(test_hashes_hmac_sha256_ite_hash_PRF6),
         new_TestFixture(test_hashes_hmac_sha256_ite_hash_PRF6_split),
+        new_TestFixture(test_hashes_hmac_sha256_precomputed_PRF6),
+        new_TestFixture(test_hashes_hmac_sha256_benchmark),
     };
 
     EMB_UNIT_TESTCALLER(hashes_sha256_tests, NULL, NULL,
@@ -22,6 +22,7 @@
  * @}
  */
 
+#include <inttypes.h>
 #include <limits.h>
 #include <string.h>
 #include <stdio.h>
@@ -30,6 +31,7 @@
 #include "embUnit/embUnit.h"
 
 #include "hashes/sha256.h"
+#include "xtimer.h"
 
 #include "tests-hashes.h"
 
@@ -212,6 +214,59 @@ static void test_hashes_sha256_hash_long_sequence(void)
                     hlong_sequence));
 }
 
+static void test_hashes_sha256_hash_million_a_unaligned(void)
+{
+    /* FIPS 180-2 example, fed in odd sized chunks from an unaligned buffer,
+     * so that both buffered and direct multi-block transforms are used */
+    static const unsigned char expected[] = {
+        0xcd, 0xc7, 0x6e, 0x5c, 0x99, 0x14, 0xfb, 0x92,
+        0x81, 0xa1, 0xc7, 0xe2, 0x84, 0xd7, 0x3e, 0x67,
+        0xf1, 0x80, 0x9a, 0x48, 0xa4, 0x97, 0x20, 0x0e,
+        0x04, 0x6d, 0x39, 0xcc, 0xc7, 0x11, 0x2c, 0xd0
+    };
+    static unsigned char buf[1 + 1000];
+    unsigned char hash[SHA256_DIGEST_LENGTH];
+    sha256_context_t sha256;
+    size_t done = 0, chunk = 1;
+
+    memset(buf, 'a', sizeof(buf));
+    sha256_init(&sha256);
+    while (done < 1000000) {
+        if (chunk > 1000000 - done) {
+            chunk = 1000000 - done;
+        }
+        sha256_update(&sha256, &buf[1], chunk);
+        done += chunk;
+        chunk = (chunk * 7 + 13) % 1000;
+    }
+    sha256_final(&sha256, hash);
+
+    TEST_ASSERT_EQUAL_INT(0, memcmp(expected, hash, SHA256_DIGEST_LENGTH));
+}
+
+static void test_hashes_sha256_benchmark(void)
+{
+    static unsigned char buf[4096];
+    unsigned char hash[SHA256_DIGEST_LENGTH];
+    const unsigned runs = 32;
+
+    memset(buf, 0x5a, sizeof(buf));
+    uint32_t start = xtimer_now_usec();
+    for (unsigned i = 0; i < runs; i++) {
+        sha256(buf, sizeof(buf), hash);
+    }
+    uint32_t time = xtimer_now_usec() - start;
+
+    if (time == 0) {
+        time = 1;
+    }
+    /* bytes per usec equals MB/s */
+    uint32_t kbps = (uint32_t)(((uint64_t)sizeof(buf) * runs * 1000) / time);
+    printf("\nsha256: %u bytes in %" PRIu32 " us, %" PRIu32 ".%03" PRIu32
+           " MB/s\n", (unsigned)(sizeof(buf) * runs), time, kbps / 1000,
+           kbps % 1000);
+}
+
 Test *tests_hashes_sha256_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -227,6 +282,8 @@ Test *tests_hashes_sha256_tests(void)
         new_TestFixture(test_hashes_sha256_hash_sequence_failing_compare),
 
         new_TestFixture(test_hashes_sha256_hash_long_sequence),
+        new_TestFixture(test_hashes_sha256_hash_million_a_unaligned),
+        new_TestFixture(test_hashes_sha256_benchmark),
     };
 
     EMB_UNIT_TESTCALLER(hashes_sha256_tests, NULL, NULL,
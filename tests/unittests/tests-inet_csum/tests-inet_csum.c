@@ -12,8 +12,11 @@
  * @file
  */
 #include <errno.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "benchmark.h"
 #include "embUnit.h"
 
 #include "net/inet_csum.h"
@@ -165,6 +168,112 @@ static void test_inet_csum__empty_app_buffer(void)
     TEST_ASSERT_EQUAL_INT(hdr_expected, pyld_sum);
 }
 
+/* byte-wise reference implementation */
+static uint16_t _ref_csum_slice(uint16_t sum, const uint8_t *buf, uint16_t len,
+                                size_t accum_len)
+{
+    uint32_t csum = sum;
+
+    if (len == 0) {
+        return csum;
+    }
+    if (accum_len & 1) {
+        csum += *buf;
+        buf++;
+        len--;
+        accum_len++;
+    }
+    for (unsigned i = 0; i < (len >> 1); buf += 2, i++) {
+        csum += (uint16_t)(*buf << 8) + *(buf + 1);
+    }
+    if ((accum_len + len) & 1) {
+        csum += (uint16_t)(*buf << 8);
+    }
+    while (csum >> 16) {
+        csum = (csum & 0xffff) + (csum >> 16);
+    }
+    return csum;
+}
+
+#define BUF_LEN     (1280U)
+#define BENCH_RUNS  (1000U)
+
+static uint8_t _src[BUF_LEN + 8];
+static uint8_t _dst[BUF_LEN + 8];
+
+static void _fill_src(void)
+{
+    uint32_t seed = TEST_UINT32;
+
+    for (unsigned i = 0; i < sizeof(_src); i++) {
+        seed = (seed * 1103515245U) + 12345U;
+        _src[i] = seed >> 16;
+    }
+}
+
+static void test_inet_csum__all_alignments_and_lengths(void)
+{
+    _fill_src();
+    for (unsigned offset = 0; offset < 8; offset++) {
+        for (unsigned len = 0; len < 80; len++) {
+            for (unsigned accum_len = 0; accum_len < 2; accum_len++) {
+                TEST_ASSERT_EQUAL_INT(
+                    _ref_csum_slice(0x1234, &_src[offset], len, accum_len),
+                    inet_csum_slice(0x1234, &_src[offset], len, accum_len));
+            }
+        }
+        TEST_ASSERT_EQUAL_INT(_ref_csum_slice(0, &_src[offset], BUF_LEN, 0),
+                              inet_csum_slice(0, &_src[offset], BUF_LEN, 0));
+    }
+}
+
+static void test_inet_csum__all_ones(void)
+{
+    /* maximum carries */
+    memset(_src, 0xff, sizeof(_src));
+    TEST_ASSERT_EQUAL_INT(0xffff, inet_csum_slice(0xffff, _src, BUF_LEN, 0));
+    TEST_ASSERT_EQUAL_INT(_ref_csum_slice(0xffff, &_src[1], BUF_LEN - 1, 1),
+                          inet_csum_slice(0xffff, &_src[1], BUF_LEN - 1, 1));
+    memset(_src, 0, sizeof(_src));
+    TEST_ASSERT_EQUAL_INT(0, inet_csum_slice(0, &_src[3], BUF_LEN, 0));
+}
+
+static void test_inet_csum__copy(void)
+{
+    _fill_src();
+    for (unsigned offset = 0; offset < 8; offset++) {
+        for (unsigned len = 1; len < 80; len += 3) {
+            for (unsigned accum_len = 0; accum_len < 2; accum_len++) {
+                memset(_dst, 0, sizeof(_dst));
+                TEST_ASSERT_EQUAL_INT(
+                    _ref_csum_slice(0, &_src[offset], len, accum_len),
+                    inet_csum_slice_copy(0, &_dst[7 - offset], &_src[offset],
+                                         len, accum_len));
+                TEST_ASSERT_EQUAL_INT(0, memcmp(&_dst[7 - offset],
+                                                &_src[offset], len));
+                TEST_ASSERT_EQUAL_INT(0, _dst[7 - offset + len]);
+            }
+        }
+    }
+}
+
+static void test_inet_csum__benchmark(void)
+{
+    _fill_src();
+    puts("");
+    BENCHMARK_FUNC("byte-wise (aligned)", BENCH_RUNS,
+                   _ref_csum_slice(0, _src, BUF_LEN, 0));
+    BENCHMARK_FUNC("inet_csum_slice (aligned)", BENCH_RUNS,
+                   inet_csum_slice(0, _src, BUF_LEN, 0));
+    BENCHMARK_FUNC("inet_csum_slice (unaligned)", BENCH_RUNS,
+                   inet_csum_slice(0, &_src[1], BUF_LEN, 0));
+    BENCHMARK_FUNC("memcpy + inet_csum_slice", BENCH_RUNS,
+                   (memcpy(_dst, _src, BUF_LEN),
+                    inet_csum_slice(0, _dst, BUF_LEN, 0)));
+    BENCHMARK_FUNC("inet_csum_slice_copy", BENCH_RUNS,
+                   inet_csum_slice_copy(0, _dst, _src, BUF_LEN, 0));
+}
+
 Test *tests_inet_csum_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -176,6 +285,10 @@ Test *tests_inet_csum_tests(void)
         new_TestFixture(test_inet_csum__odd_len),
         new_TestFixture(test_inet_csum__two_app_snips),
         new_TestFixture(test_inet_csum__empty_app_buffer),
+        new_TestFixture(test_inet_csum__all_alignments_and_lengths),
+        new_TestFixture(test_inet_csum__all_ones),
+        new_TestFixture(test_inet_csum__copy),
+        new_TestFixture(test_inet_csum__benchmark),
     };
 
     EMB_UNIT_TESTCALLER(inet_csum_tests, NULL, NULL, fixtures);
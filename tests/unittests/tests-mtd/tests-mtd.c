@@ -19,6 +19,11 @@
 #include "mtd.h"
 #include "board.h"
 
+#if MODULE_MTD_ASYNC
+#include "kernel_defines.h"
+#include "mtd_async.h"
+#endif
+
 #if MODULE_VFS
 #include <fcntl.h>
 #include <stdio.h>
@@ -251,6 +256,125 @@ static void test_mtd_write_read_flash(void)
 }
 #endif
 
+#if MODULE_MTD_ASYNC
+static event_queue_t _queue;
+static int _async_res;
+static unsigned _async_calls;
+
+static void _async_cb(void *arg, int res)
+{
+    (void)arg;
+    _async_res = res;
+    _async_calls++;
+}
+
+/* serves the queue of the operations from the test thread until the
+ * callback was called */
+static void _async_wait(void)
+{
+    while (!_async_calls) {
+        event_t *event = event_wait(&_queue);
+        event->handler(event);
+    }
+}
+
+static void test_mtd_async(void)
+{
+    const char buf[] = "asynchronous";
+    char buf_read[sizeof(buf)];
+    mtd_async_t op;
+
+    event_queue_init(&_queue);
+    mtd_async_init(&op, &_queue, _async_cb, NULL);
+
+    _async_calls = 0;
+    int ret = mtd_write_async(dev, &op, buf, 0, sizeof(buf));
+    TEST_ASSERT_EQUAL_INT(0, ret);
+    _async_wait();
+    TEST_ASSERT_EQUAL_INT(1, _async_calls);
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), _async_res);
+
+    _async_calls = 0;
+    memset(buf_read, 0, sizeof(buf_read));
+    ret = mtd_read_async(dev, &op, buf_read, 0, sizeof(buf_read));
+    TEST_ASSERT_EQUAL_INT(0, ret);
+    _async_wait();
+    TEST_ASSERT_EQUAL_INT(sizeof(buf_read), _async_res);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(buf, buf_read, sizeof(buf)));
+
+    _async_calls = 0;
+    ret = mtd_erase_async(dev, &op, 0, dev->pages_per_sector * dev->page_size);
+    TEST_ASSERT_EQUAL_INT(0, ret);
+    _async_wait();
+    TEST_ASSERT_EQUAL_INT(0, _async_res);
+    TEST_ASSERT_EQUAL_INT(sizeof(buf_read), mtd_read(dev, buf_read, 0,
+                                                     sizeof(buf_read)));
+    TEST_ASSERT_EQUAL_INT(0xff, (uint8_t)buf_read[0]);
+
+    /* errors of the synchronous function are passed to the callback */
+    _async_calls = 0;
+    ret = mtd_erase_async(dev, &op, dev->page_size,
+                          dev->pages_per_sector * dev->page_size);
+    TEST_ASSERT_EQUAL_INT(0, ret);
+    _async_wait();
+    TEST_ASSERT_EQUAL_INT(-EOVERFLOW, _async_res);
+
+    TEST_ASSERT_EQUAL_INT(-ENODEV, mtd_read_async(NULL, &op, buf_read, 0, 1));
+}
+
+/* Mock of a driver only implementing asynchronous erase, it is done after
+ * a timeout */
+static uint8_t _async_only_memory[256];
+
+static void _async_only_erase_done(event_t *event)
+{
+    mtd_async_t *op = container_of(event, mtd_async_t, event);
+
+    memset(&_async_only_memory[op->addr], 0xff, op->size);
+    mtd_async_done(op, 0);
+}
+
+static int _async_only_erase(mtd_dev_t *dev, mtd_async_t *op)
+{
+    if ((op->addr % dev->page_size) || (op->size % dev->page_size) ||
+        (op->addr + op->size > sizeof(_async_only_memory))) {
+        return -EOVERFLOW;
+    }
+    op->event.handler = _async_only_erase_done;
+    event_timeout_set(&op->timeout, 1000);
+    return 0;
+}
+
+static const mtd_desc_t _async_only_driver = {
+    .erase_async = _async_only_erase,
+};
+
+static void test_mtd_async_to_sync(void)
+{
+    mtd_dev_t async_only = {
+        .driver = &_async_only_driver,
+        .sector_count = 4,
+        .pages_per_sector = 1,
+        .page_size = sizeof(_async_only_memory) / 4,
+    };
+
+    memset(_async_only_memory, 0, sizeof(_async_only_memory));
+    int ret = mtd_erase(&async_only, async_only.page_size, async_only.page_size);
+    TEST_ASSERT_EQUAL_INT(0, ret);
+    TEST_ASSERT_EQUAL_INT(0, _async_only_memory[async_only.page_size - 1]);
+    TEST_ASSERT_EQUAL_INT(0xff, _async_only_memory[async_only.page_size]);
+    TEST_ASSERT_EQUAL_INT(0xff, _async_only_memory[2 * async_only.page_size - 1]);
+    TEST_ASSERT_EQUAL_INT(0, _async_only_memory[2 * async_only.page_size]);
+
+    ret = mtd_erase(&async_only, 1, async_only.page_size);
+    TEST_ASSERT_EQUAL_INT(-EOVERFLOW, ret);
+
+    /* no synchronous nor asynchronous write */
+    ret = mtd_write(&async_only, _async_only_memory, 0, 1);
+    TEST_ASSERT_EQUAL_INT(-ENOTSUP, ret);
+}
+#endif
+
 #if MODULE_VFS
 static void test_mtd_vfs(void)
 {
@@ -290,6 +414,10 @@ Test *tests_mtd_tests(void)
 #ifdef MTD_0
         new_TestFixture(test_mtd_write_read_flash),
 #endif
+#if MODULE_MTD_ASYNC
+        new_TestFixture(test_mtd_async),
+        new_TestFixture(test_mtd_async_to_sync),
+#endif
 #if MODULE_VFS
         new_TestFixture(test_mtd_vfs),
 #endif
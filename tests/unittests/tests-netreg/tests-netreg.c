@@ -12,11 +12,14 @@
  * @file
  */
 #include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
 
 #include "embUnit.h"
 
 #include "net/gnrc/netreg.h"
 #include "net/gnrc/nettype.h"
+#include "xtimer.h"
 
 #include "unittests-constants.h"
 #include "tests-netreg.h"
@@ -26,6 +29,11 @@ static gnrc_netreg_entry_t entries[] = {
     GNRC_NETREG_ENTRY_INIT_PID(TEST_UINT16, TEST_UINT8 + 1)
 };
 
+#define MANY_NUMOF      (256U)
+#define BENCH_ROUNDS    (2000U)
+
+static gnrc_netreg_entry_t many[MANY_NUMOF];
+
 static void set_up(void)
 {
     gnrc_netreg_init();
@@ -139,6 +147,78 @@ void test_netreg_getnext__2_entries(void)
     TEST_ASSERT_NOT_NULL(gnrc_netreg_getnext(res));
 }
 
+void test_netreg_lookup__same_ctx_other_type(void)
+{
+    gnrc_netreg_entry_t other = GNRC_NETREG_ENTRY_INIT_PID(TEST_UINT16,
+                                                           TEST_UINT8 + 1);
+    gnrc_netreg_entry_t *res;
+
+    TEST_ASSERT_EQUAL_INT(0, gnrc_netreg_register(GNRC_NETTYPE_TEST, &entries[0]));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_netreg_register(GNRC_NETTYPE_UNDEF, &other));
+    TEST_ASSERT_EQUAL_INT(1, gnrc_netreg_num(GNRC_NETTYPE_TEST, TEST_UINT16));
+    TEST_ASSERT_EQUAL_INT(1, gnrc_netreg_num(GNRC_NETTYPE_UNDEF, TEST_UINT16));
+    TEST_ASSERT(&entries[0] == (res = gnrc_netreg_lookup(GNRC_NETTYPE_TEST,
+                                                         TEST_UINT16)));
+    TEST_ASSERT_NULL(gnrc_netreg_getnext(res));
+    TEST_ASSERT(&other == (res = gnrc_netreg_lookup(GNRC_NETTYPE_UNDEF,
+                                                    TEST_UINT16)));
+    TEST_ASSERT_NULL(gnrc_netreg_getnext(res));
+    gnrc_netreg_unregister(GNRC_NETTYPE_UNDEF, &other);
+    TEST_ASSERT_NULL(gnrc_netreg_lookup(GNRC_NETTYPE_UNDEF, TEST_UINT16));
+    TEST_ASSERT(&entries[0] == gnrc_netreg_lookup(GNRC_NETTYPE_TEST, TEST_UINT16));
+}
+
+void test_netreg_num__many(void)
+{
+    /* two entries per context */
+    for (unsigned i = 0; i < MANY_NUMOF; i++) {
+        gnrc_netreg_entry_init_pid(&many[i], i / 2, TEST_UINT8);
+        TEST_ASSERT_EQUAL_INT(0, gnrc_netreg_register(GNRC_NETTYPE_TEST, &many[i]));
+    }
+    for (unsigned i = 0; i < MANY_NUMOF / 2; i++) {
+        gnrc_netreg_entry_t *res = gnrc_netreg_lookup(GNRC_NETTYPE_TEST, i);
+        TEST_ASSERT(&many[2 * i + 1] == res);
+        TEST_ASSERT(&many[2 * i] == (res = gnrc_netreg_getnext(res)));
+        TEST_ASSERT_NULL(gnrc_netreg_getnext(res));
+        TEST_ASSERT_EQUAL_INT(2, gnrc_netreg_num(GNRC_NETTYPE_TEST, i));
+    }
+    TEST_ASSERT_EQUAL_INT(0, gnrc_netreg_num(GNRC_NETTYPE_TEST, MANY_NUMOF));
+    for (unsigned i = 0; i < MANY_NUMOF; i += 2) {
+        gnrc_netreg_unregister(GNRC_NETTYPE_TEST, &many[i]);
+        TEST_ASSERT_EQUAL_INT(1, gnrc_netreg_num(GNRC_NETTYPE_TEST, i / 2));
+    }
+}
+
+void test_netreg_benchmark(void)
+{
+    static const unsigned numof[] = { 1, 16, 64, 256 };
+    unsigned registered = 0;
+
+    puts("");
+    for (unsigned n = 0; n < ARRAY_SIZE(numof); n++) {
+        /* one entry per context, like one per bound UDP port */
+        for (; registered < numof[n]; registered++) {
+            gnrc_netreg_entry_init_pid(&many[registered], 1024 + registered,
+                                       TEST_UINT8);
+            gnrc_netreg_register(GNRC_NETTYPE_TEST, &many[registered]);
+        }
+
+        /* the lookups gnrc_netapi_dispatch() does for every packet */
+        uint32_t start = xtimer_now_usec();
+        for (unsigned i = 0; i < BENCH_ROUNDS; i++) {
+            uint32_t ctx = 1024 + (i % registered);
+            gnrc_netreg_entry_t *entry = gnrc_netreg_lookup(GNRC_NETTYPE_TEST, ctx);
+            while (entry) {
+                entry = gnrc_netreg_getnext(entry);
+            }
+        }
+        uint32_t t = xtimer_now_usec() - start;
+
+        printf("netreg: %3u entries: %5" PRIu32 " ns per dispatch lookup\n",
+               registered, (uint32_t)(((uint64_t)t * 1000) / BENCH_ROUNDS));
+    }
+}
+
 Test *tests_netreg_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -155,6 +235,9 @@ Test *tests_netreg_tests(void)
         new_TestFixture(test_netreg_num__2_entries),
         new_TestFixture(test_netreg_getnext__NULL),
         new_TestFixture(test_netreg_getnext__2_entries),
+        new_TestFixture(test_netreg_lookup__same_ctx_other_type),
+        new_TestFixture(test_netreg_num__many),
+        new_TestFixture(test_netreg_benchmark),
     };
 
     EMB_UNIT_TESTCALLER(netreg_tests, set_up, NULL, fixtures);
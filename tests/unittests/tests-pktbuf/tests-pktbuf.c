@@ -202,6 +202,7 @@ static void test_pktbuf_add__memfull(void)
 }
 #endif
 
+#ifndef MODULE_GNRC_PKTBUF_SLAB   /* number of large blocks is limited */
 static void test_pktbuf_add__success(void)
 {
     gnrc_pktsnip_t *pkt, *pkt_prev = NULL;
@@ -225,6 +226,7 @@ static void test_pktbuf_add__success(void)
     }
     TEST_ASSERT(gnrc_pktbuf_is_sane());
 }
+#endif
 
 static void test_pktbuf_add__packed_struct(void)
 {
@@ -245,7 +247,9 @@ static void test_pktbuf_add__packed_struct(void)
     TEST_ASSERT_EQUAL_INT(data.s64, data_cpy->s64);
 }
 
-#ifndef MODULE_GNRC_PKTBUF_MALLOC   /* alignment-handling left to malloc, so no certainty here */
+/* alignment-handling left to malloc, so no certainty here; slabs are
+ * never split */
+#if !defined(MODULE_GNRC_PKTBUF_MALLOC) && !defined(MODULE_GNRC_PKTBUF_SLAB)
 static void test_pktbuf_add__unaligned_in_aligned_hole(void)
 {
     gnrc_pktsnip_t *pkt1 = gnrc_pktbuf_add(NULL, NULL, 8, GNRC_NETTYPE_TEST);
@@ -653,7 +657,7 @@ static void test_pktbuf_realloc_data__success3(void)
     TEST_ASSERT(gnrc_pktbuf_is_empty());
 }
 
-#ifndef MODULE_GNRC_PKTBUF_MALLOC
+#if !defined(MODULE_GNRC_PKTBUF_MALLOC) && !defined(MODULE_GNRC_PKTBUF_SLAB)
 static void test_pktbuf_merge_data__memfull(void)
 {
     gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, NULL, (GNRC_PKTBUF_SIZE / 4),
@@ -813,7 +817,7 @@ static void test_pktbuf_start_write__pkt_users_2(void)
     TEST_ASSERT(gnrc_pktbuf_is_empty());
 }
 
-#ifndef MODULE_GNRC_PKTBUF_MALLOC
+#if !defined(MODULE_GNRC_PKTBUF_MALLOC) && !defined(MODULE_GNRC_PKTBUF_SLAB)
 static void test_pktbuf_reverse_snips__too_full(void)
 {
     gnrc_pktsnip_t *pkt, *pkt_next, *pkt_huge;
@@ -852,6 +856,176 @@ static void test_pktbuf_reverse_snips__success(void)
     TEST_ASSERT(gnrc_pktbuf_is_empty());
 }
 
+#ifdef MODULE_GNRC_PKTBUF_SLAB
+static void test_pktbuf_slab__spill(void)
+{
+    gnrc_pktsnip_t *pkt = NULL;
+
+    /* one more than fits into the small class */
+    for (unsigned i = 0; i <= GNRC_PKTBUF_SLAB_SMALL_NUMOF; i++) {
+        pkt = gnrc_pktbuf_add(pkt, TEST_STRING4, sizeof(TEST_STRING4),
+                              GNRC_NETTYPE_TEST);
+        TEST_ASSERT_NOT_NULL(pkt);
+    }
+    TEST_ASSERT_EQUAL_STRING(TEST_STRING4, pkt->data);
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_pktbuf_slab__class_full(void)
+{
+    gnrc_pktsnip_t *pkt = NULL, *small;
+
+    for (unsigned i = 0; i < GNRC_PKTBUF_SLAB_LARGE_NUMOF; i++) {
+        pkt = gnrc_pktbuf_add(pkt, NULL, GNRC_PKTBUF_SLAB_LARGE_SIZE,
+                              GNRC_NETTYPE_TEST);
+        TEST_ASSERT_NOT_NULL(pkt);
+    }
+    TEST_ASSERT_NULL(gnrc_pktbuf_add(NULL, NULL, GNRC_PKTBUF_SLAB_LARGE_SIZE,
+                                     GNRC_NETTYPE_TEST));
+    /* smaller classes are not affected */
+    small = gnrc_pktbuf_add(NULL, TEST_STRING8, sizeof(TEST_STRING8),
+                            GNRC_NETTYPE_TEST);
+    TEST_ASSERT_NOT_NULL(small);
+    /* a released block can be reused right away */
+    pkt = gnrc_pktbuf_remove_snip(pkt, pkt);
+    TEST_ASSERT_NOT_NULL((pkt = gnrc_pktbuf_add(pkt, NULL,
+                                                GNRC_PKTBUF_SLAB_LARGE_SIZE,
+                                                GNRC_NETTYPE_TEST)));
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+    gnrc_pktbuf_release(pkt);
+    gnrc_pktbuf_release(small);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_pktbuf_slab__mark_in_place(void)
+{
+    gnrc_pktsnip_t *pkt, *hdr;
+    uint8_t *data;
+
+    /* a medium block that is not filled up */
+    pkt = gnrc_pktbuf_add(NULL, NULL, GNRC_PKTBUF_SLAB_SMALL_SIZE + 1,
+                          GNRC_NETTYPE_TEST);
+    TEST_ASSERT_NOT_NULL(pkt);
+    data = pkt->data;
+    memcpy(data, TEST_STRING16, sizeof(TEST_STRING16));
+    TEST_ASSERT_NOT_NULL((hdr = gnrc_pktbuf_mark(pkt, 8, GNRC_NETTYPE_UNDEF)));
+    /* only the header is copied, the remainder stays where it was */
+    TEST_ASSERT(pkt->data == data + 8);
+    TEST_ASSERT(hdr->data != data);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(TEST_STRING16, hdr->data, 8));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(TEST_STRING16 + 8, pkt->data,
+                                    sizeof(TEST_STRING16) - 8));
+    /* remainder can still grow up to the end of its block */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_pktbuf_realloc_data(pkt, GNRC_PKTBUF_SLAB_MEDIUM_SIZE - 8));
+    TEST_ASSERT(pkt->data == data + 8);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(TEST_STRING16 + 8, pkt->data,
+                                    sizeof(TEST_STRING16) - 8));
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+    /* ... and moves beyond it */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_pktbuf_realloc_data(pkt, GNRC_PKTBUF_SLAB_MEDIUM_SIZE - 7));
+    TEST_ASSERT(pkt->data != data + 8);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(TEST_STRING16 + 8, pkt->data,
+                                    sizeof(TEST_STRING16) - 8));
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_pktbuf_slab__grow_in_block(void)
+{
+    gnrc_pktsnip_t *pkt;
+    void *data;
+
+    pkt = gnrc_pktbuf_add(NULL, TEST_STRING16, sizeof(TEST_STRING16),
+                          GNRC_NETTYPE_TEST);
+    TEST_ASSERT_NOT_NULL(pkt);
+    data = pkt->data;
+    /* block is only left when it becomes too small */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_pktbuf_realloc_data(pkt, GNRC_PKTBUF_SLAB_SMALL_SIZE));
+    TEST_ASSERT(data == pkt->data);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_pktbuf_realloc_data(pkt, GNRC_PKTBUF_SLAB_SMALL_SIZE + 1));
+    TEST_ASSERT(data != pkt->data);
+    TEST_ASSERT_EQUAL_STRING(TEST_STRING16, pkt->data);
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+#endif /* MODULE_GNRC_PKTBUF_SLAB */
+
+#ifdef MODULE_GNRC_PKTBUF_EXT
+static void _ext_released(void *arg)
+{
+    (*(unsigned *)arg)++;
+}
+
+static void test_pktbuf_add_ext__success(void)
+{
+    char data[] = TEST_STRING16;
+    unsigned released = 0;
+    gnrc_pktsnip_t *pkt, *hdr;
+
+    pkt = gnrc_pktbuf_add_ext(NULL, data, sizeof(data), GNRC_NETTYPE_TEST,
+                              _ext_released, &released);
+    TEST_ASSERT_NOT_NULL(pkt);
+    TEST_ASSERT(pkt->data == data);
+    TEST_ASSERT_EQUAL_INT(sizeof(data), pkt->size);
+    TEST_ASSERT_EQUAL_INT(1, pkt->users);
+    hdr = gnrc_pktbuf_add(pkt, TEST_STRING4, sizeof(TEST_STRING4),
+                          GNRC_NETTYPE_TEST);
+    TEST_ASSERT_NOT_NULL(hdr);
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+    /* the data is only released with the last user of the packet */
+    gnrc_pktbuf_hold(hdr, 1);
+    gnrc_pktbuf_release(hdr);
+    TEST_ASSERT_EQUAL_INT(0, released);
+    gnrc_pktbuf_release(hdr);
+    TEST_ASSERT_EQUAL_INT(1, released);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_pktbuf_add_ext__full(void)
+{
+    char data[] = TEST_STRING8;
+    unsigned released = 0;
+    gnrc_pktsnip_t *pkt = NULL;
+
+    for (unsigned i = 0; i < GNRC_PKTBUF_EXT_NUMOF; i++) {
+        pkt = gnrc_pktbuf_add_ext(pkt, data, sizeof(data), GNRC_NETTYPE_TEST,
+                                  _ext_released, &released);
+        TEST_ASSERT_NOT_NULL(pkt);
+    }
+    TEST_ASSERT_NULL(gnrc_pktbuf_add_ext(NULL, data, sizeof(data),
+                                         GNRC_NETTYPE_TEST, _ext_released,
+                                         &released));
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT_EQUAL_INT(GNRC_PKTBUF_EXT_NUMOF, released);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_pktbuf_add_ext__start_write(void)
+{
+    char data[] = TEST_STRING8;
+    unsigned released = 0;
+    gnrc_pktsnip_t *pkt, *copy;
+
+    pkt = gnrc_pktbuf_add_ext(NULL, data, sizeof(data), GNRC_NETTYPE_TEST,
+                              _ext_released, &released);
+    TEST_ASSERT_NOT_NULL(pkt);
+    gnrc_pktbuf_hold(pkt, 1);
+    copy = gnrc_pktbuf_start_write(pkt);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT(copy != pkt);
+    TEST_ASSERT(copy->data != data);
+    TEST_ASSERT_EQUAL_STRING(TEST_STRING8, copy->data);
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT_EQUAL_INT(1, released);
+    gnrc_pktbuf_release(copy);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+#endif /* MODULE_GNRC_PKTBUF_EXT */
+
 Test *tests_pktbuf_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -866,9 +1040,11 @@ Test *tests_pktbuf_tests(void)
 #ifndef MODULE_GNRC_PKTBUF_MALLOC
         new_TestFixture(test_pktbuf_add__memfull),
 #endif
+#ifndef MODULE_GNRC_PKTBUF_SLAB
         new_TestFixture(test_pktbuf_add__success),
+#endif
         new_TestFixture(test_pktbuf_add__packed_struct),
-#ifndef MODULE_GNRC_PKTBUF_MALLOC
+#if !defined(MODULE_GNRC_PKTBUF_MALLOC) && !defined(MODULE_GNRC_PKTBUF_SLAB)
         new_TestFixture(test_pktbuf_add__unaligned_in_aligned_hole),
 #endif
         new_TestFixture(test_pktbuf_add__0_sized_release),
@@ -892,7 +1068,7 @@ Test *tests_pktbuf_tests(void)
         new_TestFixture(test_pktbuf_realloc_data__success),
         new_TestFixture(test_pktbuf_realloc_data__success2),
         new_TestFixture(test_pktbuf_realloc_data__success3),
-#ifndef MODULE_GNRC_PKTBUF_MALLOC
+#if !defined(MODULE_GNRC_PKTBUF_MALLOC) && !defined(MODULE_GNRC_PKTBUF_SLAB)
         new_TestFixture(test_pktbuf_merge_data__memfull),
 #endif /* MODULE_GNRC_PKTBUF_MALLOC */
         new_TestFixture(test_pktbuf_merge_data__success1),
@@ -906,10 +1082,21 @@ Test *tests_pktbuf_tests(void)
         new_TestFixture(test_pktbuf_start_write__NULL),
         new_TestFixture(test_pktbuf_start_write__pkt_users_1),
         new_TestFixture(test_pktbuf_start_write__pkt_users_2),
-#ifndef MODULE_GNRC_PKTBUF_MALLOC
+#if !defined(MODULE_GNRC_PKTBUF_MALLOC) && !defined(MODULE_GNRC_PKTBUF_SLAB)
         new_TestFixture(test_pktbuf_reverse_snips__too_full),
 #endif /* MODULE_GNRC_PKTBUF_MALLOC */
         new_TestFixture(test_pktbuf_reverse_snips__success),
+#ifdef MODULE_GNRC_PKTBUF_SLAB
+        new_TestFixture(test_pktbuf_slab__spill),
+        new_TestFixture(test_pktbuf_slab__class_full),
+        new_TestFixture(test_pktbuf_slab__mark_in_place),
+        new_TestFixture(test_pktbuf_slab__grow_in_block),
+#endif
+#ifdef MODULE_GNRC_PKTBUF_EXT
+        new_TestFixture(test_pktbuf_add_ext__success),
+        new_TestFixture(test_pktbuf_add_ext__full),
+        new_TestFixture(test_pktbuf_add_ext__start_write),
+#endif
     };
 
     EMB_UNIT_TESTCALLER(gnrc_pktbuf_tests, set_up, NULL, fixtures);
@@ -12,8 +12,10 @@
  * @file
  */
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 
+#include "benchmark.h"
 #include "embUnit/embUnit.h"
 
 #include "unittests-constants.h"
@@ -25,6 +27,9 @@
 #define BUFFER_SIZE         (16)    /* intentionally not unsigned to easier
                                      * check for implicit casting problems */
 #define IO_BUFFER_CANARY    (0xb8)
+#define BENCH_BUFFER_SIZE   (256U)
+#define BENCH_CHUNK_SIZE    (100U)
+#define BENCH_RUNS          (10000UL)
 
 static uint8_t _tsrb_buffer[BUFFER_SIZE];
 static uint8_t _io_buffer[BUFFER_SIZE * 2];
@@ -162,6 +167,164 @@ static void test_add(void)
     }
 }
 
+static void _fill_io_buffer(void)
+{
+    for (int i = 0; i < (int)sizeof(_io_buffer); i++) {
+        _io_buffer[i] = TEST_INPUT + i;
+    }
+}
+
+static void test_add_get_wrap(void)
+{
+    uint8_t out[BUFFER_SIZE];
+
+    _fill_io_buffer();
+    /* move read and write position to all offsets, so that both copies are
+     * split at every position */
+    for (int offset = 0; offset < BUFFER_SIZE; offset++) {
+        for (int n = 1; n <= BUFFER_SIZE; n++) {
+            tsrb_init(&_tsrb, _tsrb_buffer, BUFFER_SIZE);
+            TEST_ASSERT_EQUAL_INT(offset, tsrb_add(&_tsrb, _io_buffer,
+                                                   offset));
+            TEST_ASSERT_EQUAL_INT(offset, tsrb_drop(&_tsrb, offset));
+            TEST_ASSERT_EQUAL_INT(n, tsrb_add(&_tsrb, _io_buffer, n));
+            TEST_ASSERT_EQUAL_INT(n, tsrb_avail(&_tsrb));
+            memset(out, IO_BUFFER_CANARY, sizeof(out));
+            TEST_ASSERT_EQUAL_INT(n, tsrb_get(&_tsrb, out, sizeof(out)));
+            TEST_ASSERT_EQUAL_INT(0, memcmp(out, _io_buffer, n));
+            if (n < BUFFER_SIZE) {
+                TEST_ASSERT_EQUAL_INT(IO_BUFFER_CANARY, out[n]);
+            }
+            TEST_ASSERT_EQUAL_INT(1, tsrb_empty(&_tsrb));
+        }
+    }
+}
+
+static void test_add_partial(void)
+{
+    _fill_io_buffer();
+    TEST_ASSERT_EQUAL_INT(BUFFER_SIZE - 3, tsrb_add(&_tsrb, _io_buffer,
+                                                    BUFFER_SIZE - 3));
+    TEST_ASSERT_EQUAL_INT(5, tsrb_drop(&_tsrb, 5));
+    /* only 8 bytes of free space left, 5 of them at the start */
+    TEST_ASSERT_EQUAL_INT(8, tsrb_add(&_tsrb, &_io_buffer[BUFFER_SIZE - 3],
+                                      BUFFER_SIZE));
+    TEST_ASSERT_EQUAL_INT(1, tsrb_full(&_tsrb));
+    for (int i = 5; i < BUFFER_SIZE + 5; i++) {
+        TEST_ASSERT_EQUAL_INT((uint8_t)(TEST_INPUT + i), tsrb_get_one(&_tsrb));
+    }
+}
+
+static void test_spans(void)
+{
+    uint8_t *data;
+
+    TEST_ASSERT_EQUAL_INT(0, tsrb_get_read_span(&_tsrb, &data));
+    TEST_ASSERT_EQUAL_INT(BUFFER_SIZE, tsrb_get_write_span(&_tsrb, &data));
+    TEST_ASSERT(data == _tsrb_buffer);
+
+    /* write 12 bytes in place, but only commit 10 of them */
+    memset(data, TEST_INPUT, 12);
+    tsrb_commit_write(&_tsrb, 10);
+    TEST_ASSERT_EQUAL_INT(10, tsrb_avail(&_tsrb));
+    TEST_ASSERT_EQUAL_INT(BUFFER_SIZE - 10, tsrb_get_write_span(&_tsrb, &data));
+    TEST_ASSERT(data == &_tsrb_buffer[10]);
+
+    TEST_ASSERT_EQUAL_INT(10, tsrb_get_read_span(&_tsrb, &data));
+    TEST_ASSERT(data == _tsrb_buffer);
+    tsrb_commit_read(&_tsrb, 8);
+
+    /* free space wraps around: span ends at the end of the buffer */
+    TEST_ASSERT_EQUAL_INT(BUFFER_SIZE - 10, tsrb_get_write_span(&_tsrb, &data));
+    tsrb_commit_write(&_tsrb, BUFFER_SIZE - 10);
+    TEST_ASSERT_EQUAL_INT(8, tsrb_get_write_span(&_tsrb, &data));
+    TEST_ASSERT(data == _tsrb_buffer);
+    tsrb_commit_write(&_tsrb, 8);
+    TEST_ASSERT_EQUAL_INT(1, tsrb_full(&_tsrb));
+    TEST_ASSERT_EQUAL_INT(0, tsrb_get_write_span(&_tsrb, &data));
+
+    /* data wraps around as well */
+    TEST_ASSERT_EQUAL_INT(BUFFER_SIZE - 8, tsrb_get_read_span(&_tsrb, &data));
+    TEST_ASSERT(data == &_tsrb_buffer[8]);
+    tsrb_commit_read(&_tsrb, BUFFER_SIZE - 8);
+    TEST_ASSERT_EQUAL_INT(8, tsrb_get_read_span(&_tsrb, &data));
+    TEST_ASSERT(data == _tsrb_buffer);
+    tsrb_commit_read(&_tsrb, 8);
+    TEST_ASSERT_EQUAL_INT(1, tsrb_empty(&_tsrb));
+}
+
+static uint8_t _bench_buffer[BENCH_BUFFER_SIZE];
+static tsrb_t _bench_tsrb = TSRB_INIT(_bench_buffer);
+static uint8_t _bench_in[BENCH_CHUNK_SIZE];
+
+static void _bench_bytewise(void)
+{
+    uint8_t out[BENCH_CHUNK_SIZE];
+    unsigned i;
+
+    for (i = 0; i < BENCH_CHUNK_SIZE; i++) {
+        if (tsrb_add_one(&_bench_tsrb, _bench_in[i])) {
+            break;
+        }
+    }
+    for (i = 0; i < BENCH_CHUNK_SIZE; i++) {
+        int c = tsrb_get_one(&_bench_tsrb);
+        if (c < 0) {
+            break;
+        }
+        out[i] = c;
+    }
+    (void)out;
+}
+
+static void _bench_block(void)
+{
+    uint8_t out[BENCH_CHUNK_SIZE];
+
+    tsrb_add(&_bench_tsrb, _bench_in, sizeof(_bench_in));
+    tsrb_get(&_bench_tsrb, out, sizeof(out));
+}
+
+static void _bench_span(void)
+{
+    uint8_t *data;
+    unsigned n;
+
+    for (unsigned todo = BENCH_CHUNK_SIZE; todo > 0; todo -= n) {
+        n = tsrb_get_write_span(&_bench_tsrb, &data);
+        if (n > todo) {
+            n = todo;
+        }
+        memset(data, TEST_INPUT, n);
+        tsrb_commit_write(&_bench_tsrb, n);
+    }
+    while ((n = tsrb_get_read_span(&_bench_tsrb, &data)) > 0) {
+        tsrb_commit_read(&_bench_tsrb, n);
+    }
+}
+
+static void test_benchmark(void)
+{
+    uint8_t out[BENCH_CHUNK_SIZE];
+
+    /* BENCH_CHUNK_SIZE is not a divisor of BENCH_BUFFER_SIZE, so the copies
+     * regularly wrap around */
+    for (unsigned i = 0; i < sizeof(_bench_in); i++) {
+        _bench_in[i] = TEST_INPUT + i;
+    }
+    puts("");
+    BENCHMARK_FUNC("tsrb_add_one/tsrb_get_one", BENCH_RUNS, _bench_bytewise());
+    BENCHMARK_FUNC("tsrb_add/tsrb_get", BENCH_RUNS, _bench_block());
+    BENCHMARK_FUNC("tsrb write/read spans", BENCH_RUNS, _bench_span());
+    TEST_ASSERT_EQUAL_INT(1, tsrb_empty(&_bench_tsrb));
+    /* the benchmarked copies left the buffer at an arbitrary offset */
+    TEST_ASSERT_EQUAL_INT(sizeof(_bench_in),
+                          tsrb_add(&_bench_tsrb, _bench_in, sizeof(_bench_in)));
+    TEST_ASSERT_EQUAL_INT(sizeof(out),
+                          tsrb_get(&_bench_tsrb, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(out, _bench_in, sizeof(out)));
+}
+
 static Test *tests_tsrb_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -174,6 +337,10 @@ static Test *tests_tsrb_tests(void)
         new_TestFixture(test_drop),
         new_TestFixture(test_add_one),
         new_TestFixture(test_add),
+        new_TestFixture(test_add_get_wrap),
+        new_TestFixture(test_add_partial),
+        new_TestFixture(test_spans),
+        new_TestFixture(test_benchmark),
     };
 
     EMB_UNIT_TESTCALLER(tsrb_tests, NULL, tear_down, fixtures);
@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Unittests and benchmark for mount, fd and path lookup
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "embUnit/embUnit.h"
+
+#include "fs/constfs.h"
+#include "vfs.h"
+#include "xtimer.h"
+
+#include "tests-vfs.h"
+
+#define BENCH_ROUNDS    (10000U)
+
+static const uint8_t _data[] = "lookup";
+
+#define FILE(name) { .path = name, .data = _data, .size = sizeof(_data) }
+
+static const constfs_file_t _files[] = {
+    FILE("/a.txt"), FILE("/b.txt"), FILE("/c.txt"), FILE("/d.txt"),
+    FILE("/e.txt"), FILE("/f.txt"), FILE("/g.txt"), FILE("/h.txt"),
+    FILE("/i.txt"), FILE("/j.txt"), FILE("/k.txt"), FILE("/l.txt"),
+    FILE("/m.txt"), FILE("/n.txt"), FILE("/o.txt"), FILE("/log.csv"),
+};
+
+static const constfs_t _fs = {
+    .files = _files,
+    .nfiles = ARRAY_SIZE(_files),
+};
+
+static vfs_mount_t _mounts[] = {
+    { .mount_point = "/", .fs = &constfs_file_system, .private_data = (void *)&_fs },
+    { .mount_point = "/nvm", .fs = &constfs_file_system, .private_data = (void *)&_fs },
+    { .mount_point = "/sd", .fs = &constfs_file_system, .private_data = (void *)&_fs },
+    { .mount_point = "/sd/log", .fs = &constfs_file_system, .private_data = (void *)&_fs },
+    { .mount_point = "/sd/logs", .fs = &constfs_file_system, .private_data = (void *)&_fs },
+    { .mount_point = "/flash", .fs = &constfs_file_system, .private_data = (void *)&_fs },
+};
+
+static void setup(void)
+{
+    for (unsigned i = 0; i < ARRAY_SIZE(_mounts); i++) {
+        TEST_ASSERT_EQUAL_INT(0, vfs_mount(&_mounts[i]));
+    }
+}
+
+static void teardown(void)
+{
+    for (unsigned i = 0; i < ARRAY_SIZE(_mounts); i++) {
+        TEST_ASSERT_EQUAL_INT(0, vfs_umount(&_mounts[i]));
+    }
+}
+
+static void test_vfs_lookup_longest_prefix(void)
+{
+    struct stat buf;
+
+    /* all mounts have the same files, the open file count tells which one
+     * was used */
+    static const struct {
+        const char *path;
+        unsigned mount;
+    } cases[] = {
+        { "/log.csv", 0 },
+        { "/nvm/log.csv", 1 },
+        { "/sd/log.csv", 2 },
+        { "/sd/log/log.csv", 3 },
+        { "/sd/logs/log.csv", 4 },
+        { "/flash/a.txt", 5 },
+    };
+
+    for (unsigned i = 0; i < ARRAY_SIZE(cases); i++) {
+        int fd = vfs_open(cases[i].path, O_RDONLY, 0);
+        TEST_ASSERT(fd >= 0);
+        for (unsigned m = 0; m < ARRAY_SIZE(_mounts); m++) {
+            TEST_ASSERT_EQUAL_INT((m == cases[i].mount) ? 1 : 0,
+                                  atomic_load(&_mounts[m].open_files));
+        }
+        TEST_ASSERT_EQUAL_INT(0, vfs_close(fd));
+    }
+
+    TEST_ASSERT_EQUAL_INT(0, vfs_stat("/sd/logs/o.txt", &buf));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, vfs_stat("/sd/logs/p.txt", &buf));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, vfs_stat("/sd/lo/a.txt", &buf));
+    /* not on /nvm, but on / without the file */
+    TEST_ASSERT_EQUAL_INT(-ENOENT, vfs_stat("/nvmx/a.txt", &buf));
+}
+
+static void test_vfs_lookup_fd_allocation(void)
+{
+    int fds[VFS_MAX_OPEN_FILES];
+    unsigned n = 0;
+
+    for (; n < VFS_MAX_OPEN_FILES; n++) {
+        fds[n] = vfs_open("/sd/log/a.txt", O_RDONLY, 0);
+        if (fds[n] < 0) {
+            TEST_ASSERT_EQUAL_INT(-ENFILE, fds[n]);
+            break;
+        }
+        /* stdio numbers are never allocated automatically */
+        TEST_ASSERT(fds[n] > STDERR_FILENO);
+    }
+    TEST_ASSERT(n > 0);
+
+    /* the lowest free number is reused */
+    TEST_ASSERT_EQUAL_INT(0, vfs_close(fds[n / 2]));
+    int fd = vfs_open("/sd/log/a.txt", O_RDONLY, 0);
+    TEST_ASSERT_EQUAL_INT(fds[n / 2], fd);
+
+    for (unsigned i = 0; i < n; i++) {
+        TEST_ASSERT_EQUAL_INT(0, vfs_close(fds[i]));
+    }
+}
+
+#if MODULE_VFS_DCACHE
+static void test_vfs_lookup_dcache(void)
+{
+    static int node_a, node_b;
+
+    vfs_dcache_invalidate(NULL, NULL);
+    TEST_ASSERT_NULL(vfs_dcache_lookup(&_mounts[1], "/x"));
+    vfs_dcache_add(&_mounts[1], "/x", &node_a);
+    vfs_dcache_add(&_mounts[2], "/x", &node_b);
+    TEST_ASSERT(vfs_dcache_lookup(&_mounts[1], "/x") == &node_a);
+    TEST_ASSERT(vfs_dcache_lookup(&_mounts[2], "/x") == &node_b);
+    TEST_ASSERT_NULL(vfs_dcache_lookup(&_mounts[1], "/y"));
+
+    /* replacing an entry */
+    vfs_dcache_add(&_mounts[1], "/x", &node_b);
+    TEST_ASSERT(vfs_dcache_lookup(&_mounts[1], "/x") == &node_b);
+
+    vfs_dcache_invalidate(&_mounts[1], "/x");
+    TEST_ASSERT_NULL(vfs_dcache_lookup(&_mounts[1], "/x"));
+    TEST_ASSERT(vfs_dcache_lookup(&_mounts[2], "/x") == &node_b);
+    vfs_dcache_invalidate(&_mounts[2], NULL);
+    TEST_ASSERT_NULL(vfs_dcache_lookup(&_mounts[2], "/x"));
+
+    /* the least recently used entry is replaced */
+    for (unsigned i = 0; i <= VFS_DCACHE_SIZE; i++) {
+        char path[8];
+        snprintf(path, sizeof(path), "/%u", i);
+        vfs_dcache_add(&_mounts[1], path, &node_a);
+        TEST_ASSERT(vfs_dcache_lookup(&_mounts[1], "/0") == &node_a);
+    }
+    TEST_ASSERT_NULL(vfs_dcache_lookup(&_mounts[1], "/1"));
+
+    /* paths too long are not cached */
+    char path[VFS_DCACHE_PATH_MAX + 2];
+    memset(path, 'p', sizeof(path) - 1);
+    path[sizeof(path) - 1] = '\0';
+    vfs_dcache_add(&_mounts[1], path, &node_a);
+    TEST_ASSERT_NULL(vfs_dcache_lookup(&_mounts[1], path));
+
+    /* constfs caches its files, cached entries are dropped on umount */
+    struct stat buf;
+    TEST_ASSERT_EQUAL_INT(0, vfs_stat("/flash/log.csv", &buf));
+    TEST_ASSERT(vfs_dcache_lookup(&_mounts[5], "/log.csv") == &_files[15]);
+    TEST_ASSERT_EQUAL_INT(0, vfs_umount(&_mounts[5]));
+    TEST_ASSERT_NULL(vfs_dcache_lookup(&_mounts[5], "/log.csv"));
+    TEST_ASSERT_EQUAL_INT(0, vfs_mount(&_mounts[5]));
+}
+#endif
+
+static void test_vfs_lookup_benchmark(void)
+{
+    struct stat buf;
+
+    uint32_t start = xtimer_now_usec();
+    for (unsigned i = 0; i < BENCH_ROUNDS; i++) {
+        vfs_stat("/sd/logs/log.csv", &buf);
+    }
+    uint32_t t_stat = xtimer_now_usec() - start;
+
+    int fds[4];
+    start = xtimer_now_usec();
+    for (unsigned i = 0; i < BENCH_ROUNDS; i++) {
+        for (unsigned j = 0; j < ARRAY_SIZE(fds); j++) {
+            fds[j] = vfs_open("/nvm/log.csv", O_RDONLY, 0);
+        }
+        for (unsigned j = 0; j < ARRAY_SIZE(fds); j++) {
+            vfs_close(fds[j]);
+        }
+    }
+    uint32_t t_open = xtimer_now_usec() - start;
+
+    printf("\nvfs_stat: %" PRIu32 " ns, vfs_open + vfs_close: %" PRIu32 " ns\n",
+           (uint32_t)(((uint64_t)t_stat * 1000) / BENCH_ROUNDS),
+           (uint32_t)(((uint64_t)t_open * 1000) / (BENCH_ROUNDS * ARRAY_SIZE(fds))));
+}
+
+Test *tests_vfs_lookup_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_vfs_lookup_longest_prefix),
+        new_TestFixture(test_vfs_lookup_fd_allocation),
+#if MODULE_VFS_DCACHE
+        new_TestFixture(test_vfs_lookup_dcache),
+#endif
+        new_TestFixture(test_vfs_lookup_benchmark),
+    };
+
+    EMB_UNIT_TESTCALLER(vfs_lookup_tests, setup, teardown, fixtures);
+
+    return (Test *)&vfs_lookup_tests;
+}
+
+/** @} */